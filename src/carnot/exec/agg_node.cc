@@ -20,9 +20,11 @@
 
 #include <arrow/array.h>
 #include <arrow/array/builder_base.h>
+#include <arrow/builder.h>
 #include <arrow/status.h>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 #include <magic_enum.hpp>
 
@@ -78,6 +80,29 @@ void ExtractToColumnWrapper(const std::vector<GroupArgs>& group_args,
   }
 }
 
+// The states of all the UDAs of a partial aggregate are packed into a single string, where each
+// serialized state is prefixed by its length.
+void AppendSerializedState(std::string_view state, std::string* out) {
+  uint32_t len = state.size();
+  out->append(reinterpret_cast<const char*>(&len), sizeof(len));
+  out->append(state);
+}
+
+StatusOr<std::string_view> ConsumeSerializedState(std::string_view* packed) {
+  uint32_t len;
+  if (packed->size() < sizeof(len)) {
+    return error::Internal("Serialized aggregate state is truncated");
+  }
+  std::memcpy(&len, packed->data(), sizeof(len));
+  packed->remove_prefix(sizeof(len));
+  if (packed->size() < len) {
+    return error::Internal("Serialized aggregate state is truncated");
+  }
+  std::string_view state = packed->substr(0, len);
+  packed->remove_prefix(len);
+  return state;
+}
+
 }  // namespace
 
 std::string AggNode::DebugStringImpl() {
@@ -99,6 +124,17 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
   }
   input_descriptor_ = std::make_unique<RowDescriptor>(input_descriptors_[0]);
 
+  emit_partial_ = plan_node_->partial_agg() && !plan_node_->finalize_results();
+  merge_partial_ = plan_node_->finalize_results() && !plan_node_->partial_agg();
+  if (merge_partial_) {
+    // The serialized UDA states follow the group columns.
+    serialized_col_idx_ = static_cast<int64_t>(input_descriptor_->size()) - 1;
+    if (serialized_col_idx_ < 0 || input_descriptor_->type(serialized_col_idx_) != types::STRING) {
+      return error::InvalidArgument(
+          "Finalizing aggregate expects the serialized UDA states as the last input column");
+    }
+  }
+
   // Check the value expressions and make sure they are correct.
   for (const auto& value : plan_node_->values()) {
     if (value->ExpressionType() != plan::Expression::kAgg) {
@@ -106,7 +142,8 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
     }
   }
 
-  size_t output_size = plan_node_->values().size() + plan_node_->groups().size();
+  size_t values_size = emit_partial_ ? 1 : plan_node_->values().size();
+  size_t output_size = values_size + plan_node_->groups().size();
   if (output_size != output_descriptor_->size()) {
     return error::InvalidArgument("Output size mismatch in aggregate");
   }
@@ -128,7 +165,6 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
     group_data_types_.emplace_back(input_descriptor_->type(group.idx));
   }
 
-  auto values_size = plan_node_->values().size();
   for (size_t i = 0; i < values_size; ++i) {
     auto values_idx = i + groups_size;
     DCHECK(values_idx < output_descriptor_->size());
@@ -181,22 +217,41 @@ Status AggNode::ClearAggState(ExecState* exec_state) {
 
 Status AggNode::AggregateGroupByNone(ExecState* exec_state, const RowBatch& rb) {
   auto values = plan_node_->values();
-  for (size_t i = 0; i < values.size(); ++i) {
-    PL_RETURN_IF_ERROR(
-        EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+  if (merge_partial_) {
+    auto* states = rb.ColumnAt(serialized_col_idx_).get();
+    for (int64_t row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+      PL_RETURN_IF_ERROR(MergeSerializedUDAs(
+          exec_state, types::GetValueFromArrowArray<types::STRING>(states, row_idx),
+          &udas_no_groups_));
+    }
+  } else {
+    for (size_t i = 0; i < values.size(); ++i) {
+      PL_RETURN_IF_ERROR(
+          EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+    }
   }
 
   if (ReadyToEmitBatches(rb)) {
     RowBatch output_rb(*output_descriptor_, 1);
-    for (size_t i = 0; i < values.size(); ++i) {
-      const auto& uda_info = udas_no_groups_[i];
-      auto builder = types::MakeArrowBuilder(uda_info.def->finalize_return_type(),
-                                             exec_state->exec_mem_pool());
-      PL_RETURN_IF_ERROR(
-          uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(), builder.get()));
+    if (emit_partial_) {
+      auto builder = types::MakeArrowBuilder(types::STRING, exec_state->exec_mem_pool());
+      std::string packed;
+      PL_RETURN_IF_ERROR(SerializeUDAs(udas_no_groups_, &packed));
+      PL_RETURN_IF_ERROR(static_cast<arrow::StringBuilder*>(builder.get())->Append(packed));
       SharedArray out_col;
       PL_RETURN_IF_ERROR(builder->Finish(&out_col));
       PL_RETURN_IF_ERROR(output_rb.AddColumn(out_col));
+    } else {
+      for (size_t i = 0; i < values.size(); ++i) {
+        const auto& uda_info = udas_no_groups_[i];
+        auto builder = types::MakeArrowBuilder(uda_info.def->finalize_return_type(),
+                                               exec_state->exec_mem_pool());
+        PL_RETURN_IF_ERROR(
+            uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(), builder.get()));
+        SharedArray out_col;
+        PL_RETURN_IF_ERROR(builder->Finish(&out_col));
+        PL_RETURN_IF_ERROR(output_rb.AddColumn(out_col));
+      }
     }
     output_rb.set_eow(rb.eow());
     output_rb.set_eos(rb.eos());
@@ -313,6 +368,7 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
   }
 
   // Agg into agg values and emit!
+  std::string packed;
   for (const auto& kv : agg_hash_map_) {
     auto* groups_rt = kv.first;
     auto* val = kv.second;
@@ -326,6 +382,12 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
     }
     // Actually Finalize the UDA based on the column wrapper chunks.
     PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, val));
+    if (emit_partial_) {
+      PL_RETURN_IF_ERROR(SerializeUDAs(val->udas, &packed));
+      PL_RETURN_IF_ERROR(
+          static_cast<arrow::StringBuilder*>(value_builders[0].get())->Append(packed));
+      continue;
+    }
     for (size_t i = 0; i < val->udas.size(); ++i) {
       const auto& uda_info = val->udas[i];
       PL_RETURN_IF_ERROR(uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(),
@@ -432,6 +494,16 @@ Status AggNode::EvaluateSingleExpressionNoGroups(ExecState* exec_state, const UD
 }
 
 Status AggNode::EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val) {
+  if (merge_partial_) {
+    auto* states = val->agg_cols[0].get();
+    for (size_t i = 0; i < states->Size(); ++i) {
+      PL_RETURN_IF_ERROR(
+          MergeSerializedUDAs(exec_state, states->Get<types::StringValue>(i), &val->udas));
+    }
+    states->Clear();
+    return Status::OK();
+  }
+
   size_t values_size = plan_node_->values().size();
   for (size_t i = 0; i < values_size; ++i) {
     const auto& uda_info = val->udas[i];
@@ -481,6 +553,14 @@ Status AggNode::EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val) {
 }
 
 Status AggNode::CreateColumnMapping() {
+  if (merge_partial_) {
+    // The value expressions refer to the input of the partial aggregate, so the only column that
+    // needs to be stored is the one with the serialized UDA states.
+    plan_cols_to_stored_map_[serialized_col_idx_] = 0;
+    stored_cols_to_plan_idx_.emplace_back(serialized_col_idx_);
+    stored_cols_data_types_.emplace_back(types::STRING);
+    return Status::OK();
+  }
   for (const auto& expr : plan_node_->values()) {
     plan::ExpressionWalker<int> walker;
 
@@ -520,11 +600,11 @@ Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_s
   CHECK_EQ(val->size(), 0ULL);
 
   for (const auto& value : plan_node_->values()) {
-    std::vector<types::DataType> types;
-    types.reserve(value->Deps().size());
-    for (auto* dep : value->Deps()) {
-      PL_ASSIGN_OR_RETURN(auto type, GetTypeOfDep(*dep));
-      types.push_back(type);
+    // The deps of a finalizing aggregate refer to the input of the partial aggregate.
+    if (!merge_partial_) {
+      for (auto* dep : value->Deps()) {
+        PL_RETURN_IF_ERROR(GetTypeOfDep(*dep));
+      }
     }
     auto def = exec_state->GetUDADefinition(value->uda_id());
     auto uda = def->Make();
@@ -541,6 +621,40 @@ Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_s
   return Status::OK();
 }
 
+Status AggNode::SerializeUDAs(const std::vector<UDAInfo>& udas, std::string* out) {
+  out->clear();
+  types::StringValue state;
+  for (const auto& uda_info : udas) {
+    PL_RETURN_IF_ERROR(uda_info.def->Serialize(uda_info.uda.get(), function_ctx_.get(), &state));
+    AppendSerializedState(state, out);
+  }
+  return Status::OK();
+}
+
+Status AggNode::MergeSerializedUDAs(ExecState* exec_state, std::string_view packed,
+                                    std::vector<UDAInfo>* udas) {
+  // Deserialize replaces the state of a UDA rather than merging into it, so each partial state is
+  // loaded into the scratch UDAs and then merged. The scratch UDAs are reused across rows.
+  if (partial_udas_.empty()) {
+    PL_RETURN_IF_ERROR(CreateUDAInfoValues(&partial_udas_, exec_state));
+  }
+  DCHECK_EQ(partial_udas_.size(), udas->size());
+  for (size_t i = 0; i < partial_udas_.size(); ++i) {
+    PL_ASSIGN_OR_RETURN(std::string_view state, ConsumeSerializedState(&packed));
+    auto& partial = partial_udas_[i];
+    PL_RETURN_IF_ERROR(partial.def->Deserialize(partial.uda.get(), function_ctx_.get(),
+                                                types::StringValue(state.data(), state.size())));
+    auto& uda_info = (*udas)[i];
+    PL_RETURN_IF_ERROR(
+        uda_info.def->Merge(uda_info.uda.get(), partial.uda.get(), function_ctx_.get()));
+  }
+  if (!packed.empty()) {
+    return error::Internal("Serialized aggregate state has $0 unexpected trailing bytes",
+                           packed.size());
+  }
+  return Status::OK();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -21,6 +21,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -85,6 +86,13 @@ class AggNode : public ProcessingNode {
  private:
   AggHashMap agg_hash_map_;
   bool HasNoGroups() const { return plan_node_->groups().empty(); }
+  // A partial aggregate emits the groups followed by a single column with the serialized state
+  // of all the UDAs. A finalizing aggregate consumes that output and merges the UDA states.
+  // Both flags are false for a regular aggregate.
+  bool emit_partial_ = false;
+  bool merge_partial_ = false;
+  // The input column holding the serialized UDA states when merge_partial_ is set.
+  int64_t serialized_col_idx_ = -1;
   // ReadyToEmitBatches returns true when the input stream has reached a point where output batches
   // can be emitted. In the windowed aggregate case, this happens whenever end of window (eow) is
   // reached. In the blocking aggregate case, this happens at eos only.
@@ -104,6 +112,9 @@ class AggNode : public ProcessingNode {
 
   std::unique_ptr<udf::FunctionContext> function_ctx_;
 
+  // Scratch UDAs that serialized partial states are deserialized into before being merged.
+  std::vector<UDAInfo> partial_udas_;
+
   // Variables specific to GroupByNone Agg.
   std::vector<UDAInfo> udas_no_groups_;
   // END: Variables specific to GroupByNone Agg.
@@ -149,6 +160,12 @@ class AggNode : public ProcessingNode {
   }
 
   Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
+
+  // Packs the serialized state of each of the UDAs into out.
+  Status SerializeUDAs(const std::vector<UDAInfo>& udas, std::string* out);
+  // Merges the UDA states packed by SerializeUDAs into udas.
+  Status MergeSerializedUDAs(ExecState* exec_state, std::string_view packed,
+                             std::vector<UDAInfo>* udas);
 };
 
 }  // namespace exec
@@ -19,6 +19,8 @@
 #include "src/carnot/exec/agg_node.h"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
@@ -48,6 +50,11 @@ class MinSumUDA : public udf::UDA {
   }
   void Merge(udf::FunctionContext*, const MinSumUDA& other) { sum_ = sum_.val + other.sum_.val; }
   types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+  types::StringValue Serialize(udf::FunctionContext*) { return std::to_string(sum_.val); }
+  Status Deserialize(udf::FunctionContext*, const types::StringValue& data) {
+    sum_ = std::stoll(data);
+    return Status::OK();
+  }
 
  protected:
   types::Int64Value sum_ = 0;
@@ -270,6 +277,112 @@ agg_op {
   value_names: "value1"
 })";
 
+constexpr char kPartialNoGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+  }
+  value_names: "value1"
+  partial_agg: true
+  finalize_results: false
+})";
+
+constexpr char kFinalizeNoGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+  }
+  value_names: "value1"
+  partial_agg: false
+  finalize_results: true
+})";
+
+constexpr char kPartialSingleGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "value1"
+  partial_agg: true
+  finalize_results: false
+})";
+
+constexpr char kFinalizeSingleGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "minsum"
+    args {
+      column {
+        node:0
+        index: 0
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "value1"
+  partial_agg: false
+  finalize_results: true
+})";
+
 std::unique_ptr<ExecState> MakeTestExecState(udf::Registry* registry) {
   auto table_store = std::make_shared<table_store::TableStore>();
   return std::make_unique<ExecState>(registry, table_store, MockResultSinkStubGenerator,
@@ -327,6 +440,50 @@ TEST_F(AggNodeTest, no_groups_blocking) {
       .Close();
 }
 
+TEST_F(AggNodeTest, no_groups_partial_then_finalize) {
+  auto partial_plan_node = PlanNodeFromPbtxt(kPartialNoGroupAgg);
+  auto finalize_plan_node = PlanNodeFromPbtxt(kFinalizeNoGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor partial_rd({types::DataType::STRING});
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  // Each partial aggregate sees a subset of the data, as it would on separate agents.
+  auto partial1 = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *partial_plan_node, partial_rd, {input_rd}, exec_state_.get());
+  partial1.ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ true, /*eos*/ true)
+                           .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                           .AddColumn<types::Int64Value>({2, 5, 6, 8})
+                           .get(),
+                       0);
+  auto partial1_rb = partial1.PopRowBatch();
+  partial1.Close();
+
+  auto partial2 = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *partial_plan_node, partial_rd, {input_rd}, exec_state_.get());
+  partial2.ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ true, /*eos*/ true)
+                           .AddColumn<types::Int64Value>({5, 6, 3, 4})
+                           .AddColumn<types::Int64Value>({1, 5, 3, 8})
+                           .get(),
+                       0);
+  auto partial2_rb = partial2.PopRowBatch();
+  partial2.Close();
+
+  ASSERT_EQ(partial1_rb->num_rows(), 1);
+  ASSERT_EQ(partial2_rb->num_rows(), 1);
+  partial1_rb->set_eow(false);
+  partial1_rb->set_eos(false);
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *finalize_plan_node, output_rd, {partial_rd}, exec_state_.get());
+  tester.ConsumeNext(*partial1_rb, 0, 0)
+      .ConsumeNext(*partial2_rb, 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, true, true)
+                          .AddColumn<types::Int64Value>({Int64Value(23)})
+                          .get(),
+                      false)
+      .Close();
+}
+
 TEST_F(AggNodeTest, zero_row_row_batch) {
   auto plan_node = PlanNodeFromPbtxt(kBlockingNoGroupAgg);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
@@ -382,6 +539,94 @@ TEST_F(AggNodeTest, single_group_blocking) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_partial_then_finalize) {
+  auto partial_plan_node = PlanNodeFromPbtxt(kPartialSingleGroupAgg);
+  auto finalize_plan_node = PlanNodeFromPbtxt(kFinalizeSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor partial_rd({types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  // Each partial aggregate sees a subset of the data, as it would on separate agents.
+  auto partial1 = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *partial_plan_node, partial_rd, {input_rd}, exec_state_.get());
+  partial1
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                       .AddColumn<types::Int64Value>({2, 3, 3, 1})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({5, 3})
+                       .AddColumn<types::Int64Value>({1, 3})
+                       .get(),
+                   0);
+  auto partial1_rb = partial1.PopRowBatch();
+  partial1.Close();
+
+  auto partial2 = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *partial_plan_node, partial_rd, {input_rd}, exec_state_.get());
+  partial2.ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                           .AddColumn<types::Int64Value>({6, 4})
+                           .AddColumn<types::Int64Value>({5, 8})
+                           .get(),
+                       0);
+  auto partial2_rb = partial2.PopRowBatch();
+  partial2.Close();
+
+  // Groups 1, 2, 3, 5 from the first partial and 4, 6 from the second.
+  ASSERT_EQ(partial1_rb->num_rows(), 4);
+  ASSERT_EQ(partial2_rb->num_rows(), 2);
+  partial1_rb->set_eow(false);
+  partial1_rb->set_eos(false);
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *finalize_plan_node, output_rd, {partial_rd}, exec_state_.get());
+  tester.ConsumeNext(*partial1_rb, 0, 0)
+      .ConsumeNext(*partial2_rb, 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 6, true, true)
+                          .AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6})
+                          .AddColumn<types::Int64Value>({2, 3, 3, 4, 1, 5})
+                          .get(),
+                      false)
+      .Close();
+}
+
+TEST_F(AggNodeTest, partial_groups_merged_across_partials) {
+  auto partial_plan_node = PlanNodeFromPbtxt(kPartialSingleGroupAgg);
+  auto finalize_plan_node = PlanNodeFromPbtxt(kFinalizeSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor partial_rd({types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  std::vector<std::unique_ptr<table_store::schema::RowBatch>> partial_rbs;
+  for (int i = 0; i < 3; ++i) {
+    auto partial = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+        *partial_plan_node, partial_rd, {input_rd}, exec_state_.get());
+    partial.ConsumeNext(RowBatchBuilder(input_rd, 3, /*eow*/ true, /*eos*/ true)
+                            .AddColumn<types::Int64Value>({1, 2, 1})
+                            .AddColumn<types::Int64Value>({2, 3, 4})
+                            .get(),
+                        0);
+    partial_rbs.push_back(partial.PopRowBatch());
+    partial.Close();
+    partial_rbs.back()->set_eow(i == 2);
+    partial_rbs.back()->set_eos(i == 2);
+  }
+
+  // Every partial emits the same groups, which the finalizing aggregate has to merge.
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *finalize_plan_node, output_rd, {partial_rd}, exec_state_.get());
+  tester.ConsumeNext(*partial_rbs[0], 0, 0)
+      .ConsumeNext(*partial_rbs[1], 0, 0)
+      .ConsumeNext(*partial_rbs[2], 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .AddColumn<types::Int64Value>({6, 6})
+                          .get(),
+                      false)
+      .Close();
+}
+
 TEST_F(AggNodeTest, multiple_groups_blocking) {
   auto plan_node = PlanNodeFromPbtxt(kBlockingMultipleGroupAgg);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64});
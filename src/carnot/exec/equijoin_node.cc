@@ -61,12 +61,16 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
   output_rows_per_batch_ =
       plan_node_->rows_per_batch() == 0 ? kDefaultJoinRowBatchSize : plan_node_->rows_per_batch();
 
-  if (plan_node_->order_by_time() && plan_node_->time_column().parent_index() == 0) {
-    // Make the probe table the left table when we need to preserve the order of the left table in
-    // the output.
-    probe_table_ = EquijoinNode::JoinInputTable::kLeftTable;
+  if (plan_node_->order_by_time()) {
+    // Probe the table whose time order has to be preserved in the output.
+    probe_table_ = plan_node_->time_column().parent_index() == 0
+                       ? EquijoinNode::JoinInputTable::kLeftTable
+                       : EquijoinNode::JoinInputTable::kRightTable;
   } else {
-    probe_table_ = EquijoinNode::JoinInputTable::kRightTable;
+    // Otherwise build from the parent the planner expects to be smaller.
+    probe_table_ = plan_node_->build_parent_index() == 1
+                       ? EquijoinNode::JoinInputTable::kLeftTable
+                       : EquijoinNode::JoinInputTable::kRightTable;
   }
 
   switch (plan_node_->type()) {
@@ -29,6 +29,7 @@
 
 #include <absl/strings/substitute.h>
 
+#include "src/carnot/exec/row_selection.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udf/udf_wrapper.h"
@@ -75,60 +76,6 @@ Status FilterNode::CloseImpl(ExecState* exec_state) {
   return Status::OK();
 }
 
-template <types::DataType T>
-Status PredicateCopyValues(const types::BoolValueColumnWrapper& pred, const arrow::Array* input_col,
-                           RowBatch* output_rb) {
-  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
-  size_t num_output_records = output_rb->num_rows();
-  size_t num_input_records = input_col->length();
-  auto output_col_builder_generic = MakeArrowBuilder(T, arrow::default_memory_pool());
-  auto* output_col_builder = static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(
-      output_col_builder_generic.get());
-  PL_RETURN_IF_ERROR(output_col_builder->Reserve(num_output_records));
-  for (size_t idx = 0; idx < num_input_records; ++idx) {
-    if (udf::UnWrap(pred[idx])) {
-      output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_col, idx));
-    }
-  }
-  std::shared_ptr<arrow::Array> output_array;
-  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
-  PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
-  return Status::OK();
-}
-
-template <>
-Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& pred,
-                                          const arrow::Array* input_col, RowBatch* output_rb) {
-  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
-  size_t num_output_records = output_rb->num_rows();
-  size_t num_input_records = input_col->length();
-  size_t reserved =
-      100;  // This can be an arbritrary number, since we do exponential doubling below.
-  size_t total_size = 0;
-
-  auto output_col_builder_generic = MakeArrowBuilder(types::STRING, arrow::default_memory_pool());
-  auto* output_col_builder = static_cast<types::DataTypeTraits<types::STRING>::arrow_builder_type*>(
-      output_col_builder_generic.get());
-
-  PL_RETURN_IF_ERROR(output_col_builder->Reserve(num_output_records));
-  PL_RETURN_IF_ERROR(output_col_builder->ReserveData(reserved));
-  for (size_t idx = 0; idx < num_input_records; ++idx) {
-    if (udf::UnWrap(pred[idx])) {
-      auto res = types::GetValueFromArrowArray<types::STRING>(input_col, idx);
-      total_size += res.size();
-      while (total_size >= reserved) {
-        reserved *= 2;
-      }
-      PL_RETURN_IF_ERROR(output_col_builder->ReserveData(reserved));
-      output_col_builder->UnsafeAppend(std::move(res));
-    }
-  }
-  std::shared_ptr<arrow::Array> output_array;
-  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
-  PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
-  return Status::OK();
-}
-
 Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
   // Current implementation does not merge across row batches, we should
   // consider this for cases where the filter has really low selectivity.
@@ -144,22 +91,21 @@ Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, si
 
   DCHECK_EQ(static_cast<size_t>(rb.num_rows()), num_pred);
 
-  // Find out how many of them returned true;
-  size_t num_output_records = 0;
+  selected_rows_.clear();
   for (size_t i = 0; i < num_pred; ++i) {
     if (pred_col_wrapper[i].val) {
-      ++num_output_records;
+      selected_rows_.push_back(i);
     }
   }
 
-  RowBatch output_rb(*output_descriptor_, num_output_records);
+  RowBatch output_rb(*output_descriptor_, selected_rows_.size());
   DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
 
   for (const auto& [output_col_idx, input_col_idx] : Enumerate(plan_node_->selected_cols())) {
     auto input_col = rb.ColumnAt(input_col_idx);
     auto col_type = output_descriptor_->type(output_col_idx);
 #define TYPE_CASE(_dt_) \
-  PL_RETURN_IF_ERROR(PredicateCopyValues<_dt_>(pred_col_wrapper, input_col.get(), &output_rb));
+  PL_RETURN_IF_ERROR(CopySelectedRows<_dt_>(input_col.get(), selected_rows_, &output_rb));
     PL_SWITCH_FOREACH_DATATYPE(col_type, TYPE_CASE);
 #undef TYPE_CASE
   }
@@ -54,6 +54,8 @@ class FilterNode : public ProcessingNode {
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
   std::unique_ptr<plan::FilterOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
+  // The indices of the rows of the current batch that pass the filter.
+  std::vector<int64_t> selected_rows_;
 };
 
 }  // namespace exec
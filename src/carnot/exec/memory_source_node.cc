@@ -18,14 +18,20 @@
 
 #include "src/carnot/exec/memory_source_node.h"
 
+#include <arrow/array.h>
+#include <functional>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <absl/strings/substitute.h>
 
+#include "src/carnot/exec/row_selection.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
 
 namespace px {
 namespace carnot {
@@ -78,9 +84,121 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
 
 Status MemorySourceNode::CloseImpl(ExecState*) {
   stats()->AddExtraInfo("infinite_stream", infinite_stream_ ? "true" : "false");
+  if (plan_node_->HasPredicates()) {
+    stats()->AddExtraInfo("rows_pruned", absl::Substitute("$0", rows_pruned_));
+  }
   return Status::OK();
 }
 
+namespace {
+
+using ColumnPredicate = planpb::MemorySourceOperator::ColumnPredicate;
+
+template <types::DataType DT>
+using NativeType = typename types::DataTypeTraits<DT>::native_type;
+
+// Unpacks the constant of a predicate into the native type of the column it is compared to.
+template <types::DataType DT>
+NativeType<DT> PredicateConstant(const planpb::ScalarValue& value);
+template <>
+bool PredicateConstant<types::BOOLEAN>(const planpb::ScalarValue& value) {
+  return value.bool_value();
+}
+template <>
+int64_t PredicateConstant<types::INT64>(const planpb::ScalarValue& value) {
+  return value.int64_value();
+}
+template <>
+absl::uint128 PredicateConstant<types::UINT128>(const planpb::ScalarValue& value) {
+  return types::UInt128Value(value.uint128_value()).val;
+}
+template <>
+int64_t PredicateConstant<types::TIME64NS>(const planpb::ScalarValue& value) {
+  return value.time64_ns_value();
+}
+template <>
+double PredicateConstant<types::FLOAT64>(const planpb::ScalarValue& value) {
+  return value.float64_value();
+}
+template <>
+std::string PredicateConstant<types::STRING>(const planpb::ScalarValue& value) {
+  return value.string_value();
+}
+
+template <types::DataType DT>
+inline auto ColumnValue(const arrow::Array* col, int64_t idx) {
+  return types::GetValueFromArrowArray<DT>(col, idx);
+}
+// Compare strings in place instead of copying each value out of the arrow array.
+template <>
+inline auto ColumnValue<types::STRING>(const arrow::Array* col, int64_t idx) {
+  int32_t length = 0;
+  const uint8_t* data = static_cast<const arrow::StringArray*>(col)->GetValue(idx, &length);
+  return std::string_view(reinterpret_cast<const char*>(data), length);
+}
+
+template <types::DataType DT, typename TCompare>
+void SelectMatchingRows(const arrow::Array* col, const NativeType<DT>& constant, TCompare compare,
+                        std::vector<uint8_t>* selection) {
+  for (int64_t idx = 0; idx < col->length(); ++idx) {
+    (*selection)[idx] &= compare(ColumnValue<DT>(col, idx), constant);
+  }
+}
+
+// ANDs the result of the predicate on every row of the column into the row selection. The switch
+// on the comparison happens once per batch so that the inner loops stay branch free.
+template <types::DataType DT>
+void ApplyPredicate(const arrow::Array* col, const ColumnPredicate& predicate,
+                    std::vector<uint8_t>* selection) {
+  auto constant = PredicateConstant<DT>(predicate.value());
+  switch (predicate.op()) {
+    case ColumnPredicate::EQUAL:
+      return SelectMatchingRows<DT>(col, constant, std::equal_to<>(), selection);
+    case ColumnPredicate::NOT_EQUAL:
+      return SelectMatchingRows<DT>(col, constant, std::not_equal_to<>(), selection);
+    case ColumnPredicate::LESS_THAN:
+      return SelectMatchingRows<DT>(col, constant, std::less<>(), selection);
+    case ColumnPredicate::LESS_THAN_EQUAL:
+      return SelectMatchingRows<DT>(col, constant, std::less_equal<>(), selection);
+    case ColumnPredicate::GREATER_THAN:
+      return SelectMatchingRows<DT>(col, constant, std::greater<>(), selection);
+    case ColumnPredicate::GREATER_THAN_EQUAL:
+      return SelectMatchingRows<DT>(col, constant, std::greater_equal<>(), selection);
+    default:
+      LOG(DFATAL) << "Unknown MemorySource predicate op " << predicate.op();
+  }
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::ApplyPredicates(const RowBatch& rb) {
+  row_selection_.assign(rb.num_rows(), 1);
+  for (const auto& predicate : plan_node_->predicates()) {
+    auto col = rb.ColumnAt(predicate.column_idx()).get();
+#define TYPE_CASE(_dt_) ApplyPredicate<_dt_>(col, predicate, &row_selection_);
+    PL_SWITCH_FOREACH_DATATYPE(rb.desc().type(predicate.column_idx()), TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  selected_rows_.clear();
+  for (const auto& [row_idx, selected] : Enumerate(row_selection_)) {
+    if (selected) {
+      selected_rows_.push_back(row_idx);
+    }
+  }
+  rows_pruned_ += rb.num_rows() - static_cast<int64_t>(selected_rows_.size());
+
+  auto output_rb = std::make_unique<RowBatch>(rb.desc(), selected_rows_.size());
+  for (int64_t col_idx = 0; col_idx < rb.num_columns(); ++col_idx) {
+    auto col = rb.ColumnAt(col_idx).get();
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(CopySelectedRows<_dt_>(col, selected_rows_, output_rb.get()));
+    PL_SWITCH_FOREACH_DATATYPE(rb.desc().type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+  }
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState* exec_state) {
   DCHECK(table_ != nullptr);
 
@@ -108,6 +226,9 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
 
   rows_processed_ += row_batch->num_rows();
   bytes_processed_ += row_batch->NumBytes();
+  if (plan_node_->HasPredicates()) {
+    PL_ASSIGN_OR_RETURN(row_batch, ApplyPredicates(*row_batch));
+  }
   auto next_batch = table_->NextBatch(current_batch_, stop_);
   if (infinite_stream_ && !next_batch.IsValid()) {
     wait_for_valid_next_ = true;
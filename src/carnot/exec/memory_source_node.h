@@ -54,6 +54,9 @@ class MemorySourceNode : public SourceNode {
 
  private:
   StatusOr<std::unique_ptr<RowBatch>> GetNextRowBatch(ExecState* exec_state);
+  // Returns a copy of the row batch with only the rows that match all of the pushed down
+  // predicates.
+  StatusOr<std::unique_ptr<RowBatch>> ApplyPredicates(const RowBatch& rb);
   bool InfiniteStreamNextBatchReady();
   // Whether this memory source will stream infinitely. Can be stopped by the
   // exec_state_->keep_running() call in exec_graph.
@@ -66,6 +69,12 @@ class MemorySourceNode : public SourceNode {
 
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
   table_store::Table* table_ = nullptr;
+
+  // Number of scanned rows that were dropped by the pushed down predicates.
+  int64_t rows_pruned_ = 0;
+  // Scratch space for predicate evaluation, reused across batches to avoid reallocating.
+  std::vector<uint8_t> row_selection_;
+  std::vector<int64_t> selected_rows_;
 };
 
 }  // namespace exec
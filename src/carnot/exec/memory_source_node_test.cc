@@ -222,6 +222,53 @@ TEST_F(MemorySourceNodeTest, all_range) {
   tester.Close();
 }
 
+TEST_F(MemorySourceNodeTest, pushed_down_predicates) {
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto mem_src_pb = op_proto.mutable_mem_source_op();
+  mem_src_pb->clear_column_idxs();
+  mem_src_pb->clear_column_names();
+  mem_src_pb->clear_column_types();
+  mem_src_pb->add_column_idxs(0);
+  mem_src_pb->add_column_names("col1");
+  mem_src_pb->add_column_types(types::BOOLEAN);
+  mem_src_pb->add_column_idxs(1);
+  mem_src_pb->add_column_names("time_");
+  mem_src_pb->add_column_types(types::TIME64NS);
+
+  // col1 == false and time_ >= 2.
+  auto col1_predicate = mem_src_pb->add_predicates();
+  col1_predicate->set_column_idx(0);
+  col1_predicate->set_op(planpb::MemorySourceOperator::ColumnPredicate::EQUAL);
+  col1_predicate->mutable_value()->set_data_type(types::BOOLEAN);
+  col1_predicate->mutable_value()->set_bool_value(false);
+  auto time_predicate = mem_src_pb->add_predicates();
+  time_predicate->set_column_idx(1);
+  time_predicate->set_op(planpb::MemorySourceOperator::ColumnPredicate::GREATER_THAN_EQUAL);
+  time_predicate->mutable_value()->set_data_type(types::TIME64NS);
+  time_predicate->mutable_value()->set_time64_ns_value(2);
+
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  ASSERT_NE(nullptr, plan_node);
+  RowDescriptor output_rd({types::DataType::BOOLEAN, types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::BoolValue>({false})
+          .AddColumn<types::Time64NSValue>({2})
+          .get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 2, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::BoolValue>({false, false})
+          .AddColumn<types::Time64NSValue>({5, 6})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+  // All scanned rows count as processed, including the ones dropped by the predicates.
+  EXPECT_EQ(5, tester.node()->RowsProcessed());
+}
+
 class MemorySourceNodeTabletTest : public ::testing::Test {
  protected:
   void SetUp() override {
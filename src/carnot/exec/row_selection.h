@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * Adds a column to output_rb made of the given rows of input_col, in the given order.
+ * Used by the nodes that forward a subset of the rows of each batch they receive.
+ *
+ * @tparam DT The data type of input_col.
+ * @param input_col The column to copy from.
+ * @param rows The indices of the rows to copy.
+ * @param output_rb The row batch to add the new column to.
+ */
+template <types::DataType DT>
+Status CopySelectedRows(const arrow::Array* input_col, const std::vector<int64_t>& rows,
+                        table_store::schema::RowBatch* output_rb) {
+  auto output_col_builder_generic = MakeArrowBuilder(DT, arrow::default_memory_pool());
+  auto* output_col_builder = static_cast<typename types::DataTypeTraits<DT>::arrow_builder_type*>(
+      output_col_builder_generic.get());
+  PL_RETURN_IF_ERROR(output_col_builder->Reserve(rows.size()));
+  for (int64_t row : rows) {
+    output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<DT>(input_col, row));
+  }
+  std::shared_ptr<arrow::Array> output_array;
+  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
+  PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
+  return Status::OK();
+}
+
+// Strings also reserve their whole data buffer up front, rather than growing it while appending.
+template <>
+inline Status CopySelectedRows<types::STRING>(const arrow::Array* input_col,
+                                              const std::vector<int64_t>& rows,
+                                              table_store::schema::RowBatch* output_rb) {
+  const auto* input_str_col = static_cast<const arrow::StringArray*>(input_col);
+  int64_t total_size = 0;
+  for (int64_t row : rows) {
+    total_size += input_str_col->value_length(row);
+  }
+
+  auto output_col_builder_generic = MakeArrowBuilder(types::STRING, arrow::default_memory_pool());
+  auto* output_col_builder = static_cast<types::DataTypeTraits<types::STRING>::arrow_builder_type*>(
+      output_col_builder_generic.get());
+  PL_RETURN_IF_ERROR(output_col_builder->Reserve(rows.size()));
+  PL_RETURN_IF_ERROR(output_col_builder->ReserveData(total_size));
+  for (int64_t row : rows) {
+    output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<types::STRING>(input_col, row));
+  }
+  std::shared_ptr<arrow::Array> output_array;
+  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
+  PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -26,6 +26,7 @@
 #include "src/carnot/funcs/builtins/regex_ops.h"
 #include "src/carnot/funcs/builtins/request_path_ops.h"
 #include "src/carnot/funcs/builtins/sql_ops.h"
+#include "src/carnot/funcs/builtins/stack_trace_ops.h"
 #include "src/carnot/funcs/builtins/string_ops.h"
 
 #include "src/carnot/udf/registry.h"
@@ -45,6 +46,7 @@ void RegisterBuiltinsOrDie(udf::Registry* registry) {
   RegisterRequestPathOpsOrDie(registry);
   RegisterSQLOpsOrDie(registry);
   RegisterRegexOpsOrDie(registry);
+  RegisterStackTraceOpsOrDie(registry);
 }
 
 }  // namespace builtins
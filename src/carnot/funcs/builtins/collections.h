@@ -17,6 +17,10 @@
  */
 
 #pragma once
+#include <cstring>
+#include <string>
+#include <type_traits>
+
 #include "src/carnot/udf/registry.h"
 #include "src/shared/types/types.h"
 
@@ -42,12 +46,47 @@ class AnyUDA : public udf::UDA {
     }
   }
 
-  void Merge(FunctionContext*, const AnyUDA&) {
-    // Does nothing.
+  void Merge(FunctionContext*, const AnyUDA& other) {
+    if (!picked && other.picked) {
+      val_ = other.val_;
+      picked = true;
+    }
   }
 
   TArg Finalize(FunctionContext*) { return val_; }
 
+  // An empty string means no value has been picked yet.
+  StringValue Serialize(FunctionContext*) {
+    if (!picked) {
+      return "";
+    }
+    std::string out("v");
+    if constexpr (std::is_same_v<TArg, StringValue>) {
+      out.append(val_);
+    } else {
+      out.append(reinterpret_cast<const char*>(&val_), sizeof(val_));
+    }
+    return out;
+  }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    if (data.empty()) {
+      picked = false;
+      return Status::OK();
+    }
+    if constexpr (std::is_same_v<TArg, StringValue>) {
+      val_ = data.substr(1);
+    } else {
+      if (data.size() != 1 + sizeof(val_)) {
+        return error::InvalidArgument("Serialized value of size $0 is not the expected size $1",
+                                      data.size(), 1 + sizeof(val_));
+      }
+      std::memcpy(&val_, data.data() + 1, sizeof(val_));
+    }
+    picked = true;
+    return Status::OK();
+  }
+
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::InheritTypeFromArgs<AnyUDA>::CreateGeneric()};
   }
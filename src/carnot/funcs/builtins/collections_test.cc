@@ -23,6 +23,7 @@
 
 #include "src/carnot/funcs/builtins/collections.h"
 #include "src/carnot/udf/test_utils.h"
+#include "src/common/base/test_utils.h"
 
 namespace px {
 namespace carnot {
@@ -41,6 +42,27 @@ TEST(CollectionsTest, AnyUDA) {
   EXPECT_THAT(vals, ::testing::Contains(uda_tester.Result()));
 }
 
+TEST(CollectionsTest, AnyUDAPartial) {
+  auto uda_tester = udf::UDATester<AnyUDA<types::StringValue>>();
+  auto partial = udf::UDATester<AnyUDA<types::StringValue>>();
+  partial.ForInput("abc");
+  // A UDA that hasn't seen any values should pick up the value from the merged state.
+  ASSERT_OK(uda_tester.Deserialize(partial.Serialize()));
+  EXPECT_EQ(uda_tester.Result(), "abc");
+
+  // Merging in an empty state keeps the picked value.
+  auto empty = udf::UDATester<AnyUDA<types::StringValue>>();
+  ASSERT_OK(uda_tester.Deserialize(empty.Serialize()));
+  EXPECT_EQ(uda_tester.Result(), "abc");
+
+  auto int_tester = udf::UDATester<AnyUDA<types::Int64Value>>();
+  auto int_partial = udf::UDATester<AnyUDA<types::Int64Value>>();
+  int_partial.ForInput(123);
+  ASSERT_OK(int_tester.Deserialize(int_partial.Serialize()));
+  EXPECT_EQ(int_tester.Result(), 123);
+  EXPECT_NOT_OK(int_tester.Deserialize("v12"));
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -17,6 +17,9 @@
  */
 
 #pragma once
+#include <cstring>
+#include <string>
+
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
@@ -33,7 +36,7 @@ namespace builtins {
 template <typename TArg>
 class QuantilesUDA : public udf::UDA {
  public:
-  QuantilesUDA() : digest_(1000) {}
+  QuantilesUDA() : digest_(kCompression) {}
   void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
   void Merge(FunctionContext*, const QuantilesUDA& other) { digest_.merge(&other.digest_); }
 
@@ -53,6 +56,37 @@ class QuantilesUDA : public udf::UDA {
     return sb.GetString();
   }
 
+  // The digest is serialized as a packed array of (mean, weight) pairs, one per centroid.
+  StringValue Serialize(FunctionContext*) {
+    std::string out;
+    out.reserve((digest_.processed().size() + digest_.unprocessed().size()) * kCentroidSize);
+    auto append_centroid = [&out](const tdigest::Centroid& c) {
+      double vals[2] = {c.mean(), c.weight()};
+      out.append(reinterpret_cast<const char*>(vals), kCentroidSize);
+    };
+    for (const auto& c : digest_.processed()) {
+      append_centroid(c);
+    }
+    for (const auto& c : digest_.unprocessed()) {
+      append_centroid(c);
+    }
+    return out;
+  }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    if (data.size() % kCentroidSize != 0) {
+      return error::InvalidArgument("Serialized quantiles of size $0 is not a multiple of $1",
+                                    data.size(), kCentroidSize);
+    }
+    digest_ = tdigest::TDigest(kCompression);
+    for (size_t offset = 0; offset < data.size(); offset += kCentroidSize) {
+      double vals[2];
+      std::memcpy(vals, data.data() + offset, kCentroidSize);
+      digest_.add(vals[0], vals[1]);
+    }
+    return Status::OK();
+  }
+
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<QuantilesUDA>(types::ST_QUANTILES, {types::ST_NONE}),
             udf::ExplicitRule::Create<QuantilesUDA>(types::ST_DURATION_NS_QUANTILES,
@@ -78,6 +112,8 @@ class QuantilesUDA : public udf::UDA {
   }
 
  protected:
+  static constexpr size_t kCentroidSize = 2 * sizeof(double);
+  static constexpr double kCompression = 1000;
   tdigest::TDigest digest_;
 };
 
@@ -19,9 +19,12 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 
+#include <vector>
+
 #include "src/carnot/funcs/builtins/math_sketches.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/common/base/test_utils.h"
 
 namespace px {
 namespace carnot {
@@ -69,6 +72,38 @@ TEST(MathSketches, quantiles_int64) {
   EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6);
 }
 
+TEST(MathSketches, quantiles_partial) {
+  std::vector<double> vals = {1.234, 2.442, 1.04, 5.322, 6.333, 3.1, 0.5, 9.2};
+  auto full_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  auto partial1 = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  auto partial2 = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  for (const auto& [i, val] : Enumerate(vals)) {
+    full_tester.ForInput(val);
+    if (i % 2 == 0) {
+      partial1.ForInput(val);
+    } else {
+      partial2.ForInput(val);
+    }
+  }
+  // Merge the serialized state of one partial into the other.
+  ASSERT_OK(partial1.Deserialize(partial2.Serialize()));
+
+  rapidjson::Document expected;
+  auto expected_str = full_tester.Result();
+  expected.Parse(expected_str.data());
+  rapidjson::Document actual;
+  auto actual_str = partial1.Result();
+  actual.Parse(actual_str.data());
+  for (const char* q : {"p01", "p10", "p25", "p50", "p75", "p90", "p99"}) {
+    EXPECT_DOUBLE_EQ(actual[q].GetDouble(), expected[q].GetDouble()) << q;
+  }
+}
+
+TEST(MathSketches, quantiles_deserialize_invalid) {
+  auto uda_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  EXPECT_NOT_OK(uda_tester.Deserialize("abc"));
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
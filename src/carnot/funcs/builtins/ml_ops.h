@@ -24,8 +24,11 @@
 #include <rapidjson/writer.h>
 #include <sentencepiece/sentencepiece_processor.h>
 
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "src/carnot/exec/ml/coreset.h"
@@ -99,7 +102,12 @@ class KMeansUDA : public udf::UDA {
     DCHECK_EQ(d_, d);
     coreset_.Update(point);
   }
-  void Merge(FunctionContext*, const KMeansUDA& other) { coreset_.Merge(other.coreset_); }
+  void Merge(FunctionContext*, const KMeansUDA& other) {
+    if (k_ == -1) {
+      k_ = other.k_;
+    }
+    coreset_.Merge(other.coreset_);
+  }
   StringValue Finalize(FunctionContext*) {
     auto point_set = coreset_.Query();
     KMeans kmeans(k_);
@@ -107,10 +115,19 @@ class KMeansUDA : public udf::UDA {
     return kmeans.ToJSON();
   }
 
-  StringValue Serialize(FunctionContext*) { return coreset_.ToJSON(); }
+  // The number of clusters is serialized ahead of the coreset, so that the merged UDA can finalize.
+  StringValue Serialize(FunctionContext*) {
+    std::string out(reinterpret_cast<const char*>(&k_), sizeof(k_));
+    out.append(coreset_.ToJSON());
+    return out;
+  }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    coreset_.FromJSON(data);
+    if (data.size() < sizeof(k_)) {
+      return error::InvalidArgument("Serialized kmeans state is too short: $0 bytes", data.size());
+    }
+    std::memcpy(&k_, data.data(), sizeof(k_));
+    coreset_.FromJSON(data.substr(sizeof(k_)));
     return Status::OK();
   }
 
@@ -143,6 +160,9 @@ class KMeansUDF : public udf::ScalarUDF {
 
 template <typename TArg>
 class ReservoirSampleUDA : public udf::UDA {
+  static_assert(std::is_same_v<TArg, types::StringValue>,
+                "ReservoirSampleUDA only supports string values");
+
  public:
   ReservoirSampleUDA() : ReservoirSampleUDA(1) {}
   explicit ReservoirSampleUDA(size_t k) : k_(k), count_(0) {}
@@ -175,6 +195,41 @@ class ReservoirSampleUDA : public udf::UDA {
     return reservoir_[0];
   }
 
+  // Serialized as the number of values seen, followed by each length-prefixed sample.
+  StringValue Serialize(FunctionContext*) {
+    std::string out(reinterpret_cast<const char*>(&count_), sizeof(count_));
+    for (const auto& val : reservoir_) {
+      uint32_t len = val.size();
+      out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+      out.append(val);
+    }
+    return out;
+  }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    std::string_view buf(data);
+    if (buf.size() < sizeof(count_)) {
+      return error::InvalidArgument("Serialized sample state is too short: $0 bytes", buf.size());
+    }
+    std::memcpy(&count_, buf.data(), sizeof(count_));
+    buf.remove_prefix(sizeof(count_));
+    reservoir_.clear();
+    while (!buf.empty()) {
+      uint32_t len;
+      if (buf.size() < sizeof(len)) {
+        return error::InvalidArgument("Truncated sample in serialized sample state");
+      }
+      std::memcpy(&len, buf.data(), sizeof(len));
+      buf.remove_prefix(sizeof(len));
+      if (buf.size() < len) {
+        return error::InvalidArgument("Truncated sample in serialized sample state");
+      }
+      reservoir_.emplace_back(std::string(buf.substr(0, len)));
+      buf.remove_prefix(len);
+    }
+    return Status::OK();
+  }
+
  private:
   size_t k_;
   size_t count_;
@@ -28,6 +28,7 @@
 #include "src/carnot/funcs/builtins/ml_ops.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/common/base/test_utils.h"
 
 #include "src/carnot/exec/ml/eigen_test_utils.h"
 
@@ -71,6 +72,16 @@ TEST(KMeans, basic) {
   EXPECT_THAT(kmeans.centroids(), UnorderedRowsAre(expected_centroids, 0.1));
 }
 
+TEST(ReservoirSample, partial) {
+  auto uda_tester = udf::UDATester<ReservoirSampleUDA<types::StringValue>>();
+  auto partial = udf::UDATester<ReservoirSampleUDA<types::StringValue>>();
+  partial.ForInput("abc").ForInput("def");
+  ASSERT_OK(uda_tester.Deserialize(partial.Serialize()));
+  EXPECT_THAT(std::vector<std::string>({"abc", "def"}),
+              ::testing::Contains(std::string(uda_tester.Result())));
+  EXPECT_NOT_OK(uda_tester.Deserialize("abc"));
+}
+
 TEST(SentencePiece, basic) {
   auto udf_tester = udf::UDFTester<SentencePieceUDF>(FLAGS_sentencepiece_dir);
   udf_tester.ForInput("Test 123!");
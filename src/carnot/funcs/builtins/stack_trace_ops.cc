@@ -0,0 +1,156 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/funcs/builtins/stack_trace_ops.h"
+
+#include <farmhash.h>
+
+#include <absl/strings/match.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+#include <absl/strings/strip.h>
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+namespace {
+constexpr std::string_view kFrameSeparator = ";";
+constexpr std::string_view kDictionaryIDPrefix = "#";
+
+// Consumes "<number>:" from the front of str.
+bool ConsumeNumber(std::string_view* str, int64_t* val) {
+  size_t pos = str->find(':');
+  if (pos == std::string_view::npos || !absl::SimpleAtoi(str->substr(0, pos), val)) {
+    return false;
+  }
+  str->remove_prefix(pos + 1);
+  return true;
+}
+
+// Consumes the "#<id>:" header, if any, from the front of dictionary.
+bool ConsumeDictionaryID(std::string_view* dictionary, uint64_t* id) {
+  if (!absl::ConsumePrefix(dictionary, kDictionaryIDPrefix)) {
+    return false;
+  }
+  size_t pos = dictionary->find(':');
+  if (pos == std::string_view::npos || !absl::SimpleAtoi(dictionary->substr(0, pos), id)) {
+    return false;
+  }
+  dictionary->remove_prefix(pos + 1);
+  return true;
+}
+}  // namespace
+
+void AppendStackFrame(int64_t frame_id, std::string_view frame, std::string* dictionary) {
+  absl::StrAppend(dictionary, frame_id, ":", frame.size(), ":", frame);
+}
+
+Status ParseStackFrameDictionary(std::string_view dictionary,
+                                 absl::flat_hash_map<int64_t, std::string_view>* frames) {
+  if (absl::StartsWith(dictionary, kDictionaryIDPrefix)) {
+    uint64_t id = 0;
+    if (!ConsumeDictionaryID(&dictionary, &id)) {
+      return error::InvalidArgument("Malformed stack frame dictionary header.");
+    }
+  }
+  while (!dictionary.empty()) {
+    int64_t frame_id = 0;
+    int64_t length = 0;
+    if (!ConsumeNumber(&dictionary, &frame_id) || !ConsumeNumber(&dictionary, &length) ||
+        length < 0 || static_cast<size_t>(length) > dictionary.size()) {
+      return error::InvalidArgument("Malformed stack frame dictionary.");
+    }
+    frames->try_emplace(frame_id, dictionary.substr(0, length));
+    dictionary.remove_prefix(length);
+  }
+  return Status::OK();
+}
+
+bool StackFrameDictionaryID(std::string_view dictionary, uint64_t* id) {
+  return ConsumeDictionaryID(&dictionary, id);
+}
+
+StringValue StackFrameDictionaryUDA::Serialize(FunctionContext*) {
+  std::string entries;
+  for (const auto& [frame_id, frame] : frames_) {
+    AppendStackFrame(frame_id, frame, &entries);
+  }
+  return absl::StrCat(kDictionaryIDPrefix, ::util::Hash64(entries.data(), entries.size()), ":",
+                      entries);
+}
+
+Status StackFrameDictionaryUDA::Deserialize(FunctionContext*, const StringValue& data) {
+  absl::flat_hash_map<int64_t, std::string_view> frames;
+  PL_RETURN_IF_ERROR(ParseStackFrameDictionary(data, &frames));
+  frames_.clear();
+  for (const auto& [frame_id, frame] : frames) {
+    frames_.try_emplace(frame_id, frame);
+  }
+  return Status::OK();
+}
+
+StringValue ExpandStackTraceUDF::Exec(FunctionContext*, StringValue frame_ids,
+                                      StringValue dictionary) {
+  // A different id means a different dictionary. The ids are hashes, so a matching id is
+  // confirmed by comparing the contents, to not expand frames with a colliding dictionary.
+  uint64_t dictionary_id = 0;
+  bool has_id = StackFrameDictionaryID(dictionary, &dictionary_id);
+  bool same_dictionary = has_id == has_dictionary_id_ && dictionary_id == dictionary_id_ &&
+                         dictionary == dictionary_;
+  if (!same_dictionary) {
+    has_dictionary_id_ = has_id;
+    dictionary_id_ = dictionary_id;
+    dictionary_ = std::move(dictionary);
+    frames_.clear();
+    Status s = ParseStackFrameDictionary(dictionary_, &frames_);
+    LOG_IF(ERROR, !s.ok()) << s.msg();
+  }
+
+  std::string stack_trace;
+  if (frame_ids.empty()) {
+    return stack_trace;
+  }
+  bool first = true;
+  for (std::string_view frame_id_str : absl::StrSplit(frame_ids, kFrameSeparator)) {
+    if (!first) {
+      stack_trace += kFrameSeparator;
+    }
+    first = false;
+    int64_t frame_id = 0;
+    auto iter = absl::SimpleAtoi(frame_id_str, &frame_id) ? frames_.find(frame_id) : frames_.end();
+    if (iter != frames_.end()) {
+      stack_trace += iter->second;
+    } else {
+      // Name the missing id, so that frames lost from the dictionary show up in the output.
+      absl::StrAppend(&stack_trace, "<unknown frame ", frame_id_str, ">");
+    }
+  }
+  return stack_trace;
+}
+
+void RegisterStackTraceOpsOrDie(udf::Registry* registry) {
+  CHECK(registry != nullptr);
+  registry->RegisterOrDie<StackFrameDictionaryUDA>("stack_frame_dictionary");
+  registry->RegisterOrDie<ExpandStackTraceUDF>("expand_stack_trace");
+}
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
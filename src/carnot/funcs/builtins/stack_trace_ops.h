@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+/**
+ * Registers UDF operations that work on profiler stack traces.
+ * @param registry pointer to the registry.
+ */
+void RegisterStackTraceOpsOrDie(udf::Registry* registry);
+
+// A stack frame dictionary is serialized as a sequence of "<frame_id>:<length>:<frame>" entries,
+// so that frames may contain any character. Dictionaries built by StackFrameDictionaryUDA start
+// with a "#<id>:" header, where the id is a hash of the entries, so that readers can usually tell
+// two dictionaries apart without comparing them. Ids may collide, so equal ids don't imply equal
+// dictionaries.
+void AppendStackFrame(int64_t frame_id, std::string_view frame, std::string* dictionary);
+Status ParseStackFrameDictionary(std::string_view dictionary,
+                                 absl::flat_hash_map<int64_t, std::string_view>* frames);
+// Returns the id from the header of the dictionary, or false if it has none.
+bool StackFrameDictionaryID(std::string_view dictionary, uint64_t* id);
+
+class StackFrameDictionaryUDA : public udf::UDA {
+ public:
+  void Update(FunctionContext*, Int64Value frame_id, StringValue frame) {
+    frames_.try_emplace(frame_id.val, std::move(frame));
+  }
+
+  void Merge(FunctionContext*, const StackFrameDictionaryUDA& other) {
+    for (const auto& [frame_id, frame] : other.frames_) {
+      frames_.try_emplace(frame_id, frame);
+    }
+  }
+
+  StringValue Finalize(FunctionContext* ctx) { return Serialize(ctx); }
+
+  StringValue Serialize(FunctionContext*);
+  Status Deserialize(FunctionContext*, const StringValue& data);
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder("Builds a dictionary of interned stack frames.")
+        .Details(
+            "When the profiler interns stack frames, stack traces are recorded as lists of frame "
+            "IDs, and the frames are recorded in the `stack_frames.beta` table. This aggregate "
+            "collects the frames into a dictionary, which `px.expand_stack_trace` uses to recover "
+            "the folded stack trace strings. Frame IDs are local to a node, so the dictionary "
+            "should be built per node.")
+        .Example(R"doc(
+        | frames = px.DataFrame(table='stack_frames.beta', start_time='-5m')
+        | frames.node = px._exec_hostname()
+        | frames = frames.groupby('node').agg(dict=('frame_id', 'frame', px.stack_frame_dictionary))
+        )doc")
+        .Arg("frame_id", "The ID of the frame.")
+        .Arg("frame", "The symbol of the frame.")
+        .Returns("The serialized frame dictionary.");
+  }
+
+ private:
+  // Ordered, so that the serialized dictionary does not depend on the order of updates.
+  std::map<int64_t, std::string> frames_;
+};
+
+class ExpandStackTraceUDF : public udf::ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext*, StringValue frame_ids, StringValue dictionary);
+
+  static udf::ScalarUDFDocBuilder Doc() {
+    return udf::ScalarUDFDocBuilder("Expands an interned stack trace into a folded stack trace.")
+        .Details(
+            "Replaces each frame ID of the `frame_ids` column of `stack_traces.beta` with its "
+            "frame from a dictionary built by `px.stack_frame_dictionary`. Frames missing from "
+            "the dictionary are replaced with `<unknown frame ID>`.")
+        .Example(R"doc(
+        | df = df.merge(frames, how='inner', left_on='node', right_on='node')
+        | df.stack_trace = px.expand_stack_trace(df.frame_ids, df.dict)
+        )doc")
+        .Arg("frame_ids", "The semicolon separated frame IDs of the stack trace.")
+        .Arg("dictionary", "The frame dictionary.")
+        .Returns("The folded stack trace, with symbols separated by semicolons.");
+  }
+
+ private:
+  // The frame dictionary is typically the same for every row, so the parsed form is kept. The
+  // dictionary id rejects most other dictionaries without comparing them.
+  bool has_dictionary_id_ = false;
+  uint64_t dictionary_id_ = 0;
+  std::string dictionary_;
+  absl::flat_hash_map<int64_t, std::string_view> frames_;
+};
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <absl/strings/str_cat.h>
+
+#include "src/carnot/funcs/builtins/stack_trace_ops.h"
+#include "src/carnot/udf/test_utils.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(StackTraceOps, FrameDictionaryRoundTrip) {
+  std::string dictionary;
+  AppendStackFrame(1, "main", &dictionary);
+  AppendStackFrame(2, "foo(int, char const*)", &dictionary);
+  AppendStackFrame(3, "a:b;c", &dictionary);
+  AppendStackFrame(4, "", &dictionary);
+
+  absl::flat_hash_map<int64_t, std::string_view> frames;
+  ASSERT_OK(ParseStackFrameDictionary(dictionary, &frames));
+  EXPECT_THAT(frames, UnorderedElementsAre(Pair(1, "main"), Pair(2, "foo(int, char const*)"),
+                                           Pair(3, "a:b;c"), Pair(4, "")));
+
+  EXPECT_NOT_OK(ParseStackFrameDictionary("1:10:main", &frames));
+  EXPECT_NOT_OK(ParseStackFrameDictionary("1:main", &frames));
+
+  frames.clear();
+  ASSERT_OK(ParseStackFrameDictionary("#123:1:4:main", &frames));
+  EXPECT_THAT(frames, UnorderedElementsAre(Pair(1, "main")));
+  EXPECT_NOT_OK(ParseStackFrameDictionary("#abc:1:4:main", &frames));
+
+  uint64_t id = 0;
+  EXPECT_TRUE(StackFrameDictionaryID("#123:1:4:main", &id));
+  EXPECT_EQ(123, id);
+  EXPECT_FALSE(StackFrameDictionaryID(dictionary, &id));
+}
+
+TEST(StackTraceOps, StackFrameDictionaryUDA) {
+  auto uda_tester = udf::UDATester<StackFrameDictionaryUDA>();
+  uda_tester.ForInput(2, "foo").ForInput(1, "main").ForInput(3, "bar").ForInput(1, "main");
+  std::string dictionary = uda_tester.Result();
+
+  absl::flat_hash_map<int64_t, std::string_view> frames;
+  ASSERT_OK(ParseStackFrameDictionary(dictionary, &frames));
+  EXPECT_THAT(frames, UnorderedElementsAre(Pair(1, "main"), Pair(2, "foo"), Pair(3, "bar")));
+
+  // The id depends only on the frames, not on the order of updates.
+  auto other_tester = udf::UDATester<StackFrameDictionaryUDA>();
+  other_tester.ForInput(3, "bar").ForInput(1, "main").ForInput(2, "foo");
+  uint64_t id = 0;
+  uint64_t other_id = 0;
+  ASSERT_TRUE(StackFrameDictionaryID(dictionary, &id));
+  ASSERT_TRUE(StackFrameDictionaryID(other_tester.Result(), &other_id));
+  EXPECT_EQ(id, other_id);
+  EXPECT_EQ(dictionary, other_tester.Result());
+
+  auto different_tester = udf::UDATester<StackFrameDictionaryUDA>();
+  different_tester.ForInput(1, "start_thread");
+  ASSERT_TRUE(StackFrameDictionaryID(different_tester.Result(), &other_id));
+  EXPECT_NE(id, other_id);
+}
+
+TEST(StackTraceOps, ExpandStackTraceUDF) {
+  std::string dictionary;
+  AppendStackFrame(1, "main", &dictionary);
+  AppendStackFrame(2, "foo", &dictionary);
+  AppendStackFrame(3, "do_syscall_64_[k]", &dictionary);
+
+  auto udf_tester = udf::UDFTester<ExpandStackTraceUDF>();
+  udf_tester.ForInput("1;2;3", dictionary).Expect("main;foo;do_syscall_64_[k]");
+  udf_tester.ForInput("1;7", dictionary).Expect("main;<unknown frame 7>");
+  udf_tester.ForInput("x;2", dictionary).Expect("<unknown frame x>;foo");
+  udf_tester.ForInput("", dictionary).Expect("");
+
+  // A different dictionary for the same IDs.
+  std::string other_dictionary;
+  AppendStackFrame(1, "start_thread", &other_dictionary);
+  udf_tester.ForInput("1", other_dictionary).Expect("start_thread");
+
+  // Dictionaries from the UDA are told apart by their ids.
+  auto uda_tester = udf::UDATester<StackFrameDictionaryUDA>();
+  std::string uda_dictionary = uda_tester.ForInput(1, "main").ForInput(2, "foo").Result();
+  std::string other_uda_dictionary = uda_tester.ForInput(3, "bar").Result();
+  udf_tester.ForInput("1;2", uda_dictionary).Expect("main;foo");
+  udf_tester.ForInput("1;3", uda_dictionary).Expect("main;<unknown frame 3>");
+  udf_tester.ForInput("1;3", other_uda_dictionary).Expect("main;bar");
+  udf_tester.ForInput("1;3", other_dictionary).Expect("start_thread;<unknown frame 3>");
+
+  // A dictionary whose id collides with the current one is still parsed.
+  uint64_t id = 0;
+  ASSERT_TRUE(StackFrameDictionaryID(uda_dictionary, &id));
+  std::string colliding_dictionary = absl::StrCat("#", id, ":");
+  AppendStackFrame(1, "main", &colliding_dictionary);
+  AppendStackFrame(2, "bar", &colliding_dictionary);
+  udf_tester.ForInput("1;2", uda_dictionary).Expect("main;foo");
+  udf_tester.ForInput("1;2", colliding_dictionary).Expect("main;bar");
+}
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -20,6 +20,7 @@
 
 #include <sys/sysinfo.h>
 
+#include <absl/container/flat_hash_map.h>
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
@@ -62,6 +63,62 @@ inline const px::md::AgentMetadataState* GetMetadataState(px::carnot::udf::Funct
   return md;
 }
 
+inline md::UPID ToUPID(types::UInt128Value upid_value) {
+  return md::UPID(absl::MakeUint128(upid_value.High64(), upid_value.Low64()));
+}
+
+/**
+ * Resolves a UPID to its process, container and pod. The result is cached in the function context
+ * and shared by all the UPID metadata functions that execute with it.
+ */
+inline px::carnot::udf::FunctionContext::UPIDMetadata ResolveUPID(
+    px::carnot::udf::FunctionContext* ctx, types::UInt128Value upid_value) {
+  DCHECK(ctx != nullptr && ctx->metadata_state() != nullptr);
+  return ctx->ResolveUPID(ToUPID(upid_value));
+}
+
+/**
+ * UPIDMemo caches the output of a UPID metadata function by UPID. A column usually holds only a
+ * few distinct UPIDs, and the metadata state behind a function context does not change while a
+ * query runs, so the output for each distinct UPID only needs to be built once rather than once
+ * per row. The cache is dropped if the state is modified in place, as tests do.
+ */
+class UPIDMemo {
+ public:
+  template <typename TComputeFn>
+  types::StringValue Get(px::carnot::udf::FunctionContext* ctx, types::UInt128Value upid_value,
+                         TComputeFn compute) {
+    // A UDF instance is only used with one context, but don't rely on it.
+    const px::md::AgentMetadataState* state = ctx->metadata_state();
+    uint64_t generation = state == nullptr ? 0 : state->generation();
+    if (state != metadata_state_ || generation != generation_) {
+      values_.clear();
+      metadata_state_ = state;
+      generation_ = generation;
+    }
+
+    md::UPID upid = ToUPID(upid_value);
+    auto it = values_.find(upid);
+    if (it != values_.end()) {
+      return it->second;
+    }
+
+    if (values_.size() >= kMaxEntries) {
+      values_.clear();
+    }
+    types::StringValue value = compute();
+    values_.emplace(upid, value);
+    return value;
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 4096;
+
+  const px::md::AgentMetadataState* metadata_state_ = nullptr;
+  uint64_t generation_ = 0;
+  absl::flat_hash_map<md::UPID, types::StringValue> values_;
+};
+
 class ASIDUDF : public ScalarUDF {
  public:
   Int64Value Exec(FunctionContext* ctx) {
@@ -214,11 +271,7 @@ class PodNameToNamespaceUDF : public ScalarUDF {
 class UPIDToContainerIDUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-
-    auto upid_uint128 = absl::MakeUint128(upid_value.High64(), upid_value.Low64());
-    auto upid = md::UPID(upid_uint128);
-    auto pid = md->GetPIDByUPID(upid);
+    auto pid = ResolveUPID(ctx, upid_value).pid_info;
     if (pid == nullptr) {
       return "";
     }
@@ -241,22 +294,15 @@ class UPIDToContainerIDUDF : public ScalarUDF {
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
 };
 
-inline const md::ContainerInfo* UPIDToContainer(const px::md::AgentMetadataState* md,
+inline const md::ContainerInfo* UPIDToContainer(px::carnot::udf::FunctionContext* ctx,
                                                 types::UInt128Value upid_value) {
-  auto upid_uint128 = absl::MakeUint128(upid_value.High64(), upid_value.Low64());
-  auto upid = md::UPID(upid_uint128);
-  auto pid = md->GetPIDByUPID(upid);
-  if (pid == nullptr) {
-    return nullptr;
-  }
-  return md->k8s_metadata_state().ContainerInfoByID(pid->cid());
+  return ResolveUPID(ctx, upid_value).container_info;
 }
 
 class UPIDToContainerNameUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto container_info = UPIDToContainer(md, upid_value);
+    auto container_info = UPIDToContainer(ctx, upid_value);
     if (container_info == nullptr) {
       return "";
     }
@@ -284,14 +330,9 @@ class UPIDToContainerNameUDF : public ScalarUDF {
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
 };
 
-inline const px::md::PodInfo* UPIDtoPod(const px::md::AgentMetadataState* md,
+inline const px::md::PodInfo* UPIDtoPod(px::carnot::udf::FunctionContext* ctx,
                                         types::UInt128Value upid_value) {
-  auto container_info = UPIDToContainer(md, upid_value);
-  if (container_info == nullptr) {
-    return nullptr;
-  }
-  auto pod_info = md->k8s_metadata_state().PodInfoByID(container_info->pod_id());
-  return pod_info;
+  return ResolveUPID(ctx, upid_value).pod_info;
 }
 
 inline types::StringValue StringifyVector(const std::vector<std::string>& vec) {
@@ -314,8 +355,7 @@ inline types::StringValue StringifyVector(const std::vector<std::string>& vec) {
 class UPIDToNamespaceUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
+    auto pod_info = UPIDtoPod(ctx, upid_value);
     if (pod_info == nullptr) {
       return "";
     }
@@ -346,8 +386,7 @@ class UPIDToNamespaceUDF : public ScalarUDF {
 class UPIDToPodIDUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto container_info = UPIDToContainer(md, upid_value);
+    auto container_info = UPIDToContainer(ctx, upid_value);
     if (container_info == nullptr) {
       return "";
     }
@@ -373,12 +412,7 @@ class UPIDToPodIDUDF : public ScalarUDF {
 class UPIDToPodNameUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr) {
-      return "";
-    }
-    return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
+    return memo_.Get(ctx, upid_value, [&] { return Compute(ctx, upid_value); });
   }
 
   static udf::InfRuleVec SemanticInferenceRules() {
@@ -399,6 +433,17 @@ class UPIDToPodNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  StringValue Compute(FunctionContext* ctx, UInt128Value upid_value) {
+    auto pod_info = UPIDtoPod(ctx, upid_value);
+    if (pod_info == nullptr) {
+      return "";
+    }
+    return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
+  }
+
+  UPIDMemo memo_;
 };
 
 class ServiceIDToServiceNameUDF : public ScalarUDF {
@@ -484,23 +529,7 @@ class ServiceNameToNamespaceUDF : public ScalarUDF {
 class UPIDToServiceIDUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
-    if (pod_info == nullptr || pod_info->services().size() == 0) {
-      return "";
-    }
-    std::vector<std::string> running_service_ids;
-    for (const auto& service_id : pod_info->services()) {
-      auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
-      if (service_info == nullptr) {
-        continue;
-      }
-      if (service_info->stop_time_ns() == 0) {
-        running_service_ids.push_back(service_id);
-      }
-    }
-
-    return StringifyVector(running_service_ids);
+    return memo_.Get(ctx, upid_value, [&] { return Compute(ctx, upid_value); });
   }
 
   static udf::ScalarUDFDocBuilder Doc() {
@@ -518,31 +547,38 @@ class UPIDToServiceIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
-};
 
-/**
- * @brief Returns the service names for services that are currently running.
- */
-class UPIDToServiceNameUDF : public ScalarUDF {
- public:
-  StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
+ private:
+  StringValue Compute(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
+    auto pod_info = UPIDtoPod(ctx, upid_value);
     if (pod_info == nullptr || pod_info->services().size() == 0) {
       return "";
     }
-    std::vector<std::string> running_service_names;
+    std::vector<std::string> running_service_ids;
     for (const auto& service_id : pod_info->services()) {
       auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
       if (service_info == nullptr) {
         continue;
       }
       if (service_info->stop_time_ns() == 0) {
-        running_service_names.push_back(
-            absl::Substitute("$0/$1", service_info->ns(), service_info->name()));
+        running_service_ids.push_back(service_id);
       }
     }
-    return StringifyVector(running_service_names);
+
+    return StringifyVector(running_service_ids);
+  }
+
+  UPIDMemo memo_;
+};
+
+/**
+ * @brief Returns the service names for services that are currently running.
+ */
+class UPIDToServiceNameUDF : public ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
+    return memo_.Get(ctx, upid_value, [&] { return Compute(ctx, upid_value); });
   }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
@@ -564,6 +600,29 @@ class UPIDToServiceNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  StringValue Compute(FunctionContext* ctx, UInt128Value upid_value) {
+    auto md = GetMetadataState(ctx);
+    auto pod_info = UPIDtoPod(ctx, upid_value);
+    if (pod_info == nullptr || pod_info->services().size() == 0) {
+      return "";
+    }
+    std::vector<std::string> running_service_names;
+    for (const auto& service_id : pod_info->services()) {
+      auto service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
+      if (service_info == nullptr) {
+        continue;
+      }
+      if (service_info->stop_time_ns() == 0) {
+        running_service_names.push_back(
+            absl::Substitute("$0/$1", service_info->ns(), service_info->name()));
+      }
+    }
+    return StringifyVector(running_service_names);
+  }
+
+  UPIDMemo memo_;
 };
 
 /**
@@ -572,8 +631,7 @@ class UPIDToServiceNameUDF : public ScalarUDF {
 class UPIDToNodeNameUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
+    auto pod_info = UPIDtoPod(ctx, upid_value);
     if (pod_info == nullptr) {
       return "";
     }
@@ -604,8 +662,7 @@ class UPIDToNodeNameUDF : public ScalarUDF {
 class UPIDToHostnameUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto pod_info = UPIDtoPod(md, upid_value);
+    auto pod_info = UPIDtoPod(ctx, upid_value);
     if (pod_info == nullptr) {
       return "";
     }
@@ -1271,8 +1328,7 @@ class UPIDToPodStatusUDF : public ScalarUDF {
    * @return StringValue: the status of the pod.
    */
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    return PodInfoToPodStatus(UPIDtoPod(md, upid_value));
+    return memo_.Get(ctx, upid_value, [&] { return Compute(ctx, upid_value); });
   }
 
   static udf::InfRuleVec SemanticInferenceRules() {
@@ -1298,6 +1354,13 @@ class UPIDToPodStatusUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+ private:
+  StringValue Compute(FunctionContext* ctx, UInt128Value upid_value) {
+    return PodInfoToPodStatus(UPIDtoPod(ctx, upid_value));
+  }
+
+  UPIDMemo memo_;
 };
 
 class UPIDToCmdLineUDF : public ScalarUDF {
@@ -1310,10 +1373,7 @@ class UPIDToCmdLineUDF : public ScalarUDF {
    * @return StringValue: the cmdline for the UPID.
    */
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    auto upid_uint128 = absl::MakeUint128(upid_value.High64(), upid_value.Low64());
-    auto upid = md::UPID(upid_uint128);
-    auto pid_info = md->GetPIDByUPID(upid);
+    auto pid_info = ResolveUPID(ctx, upid_value).pid_info;
     if (pid_info == nullptr) {
       return "";
     }
@@ -1351,8 +1411,7 @@ class UPIDToPodQoSUDF : public ScalarUDF {
    * @return StringValue: the cmdline for the UPID.
    */
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
-    auto md = GetMetadataState(ctx);
-    return PodInfoToPodQoS(UPIDtoPod(md, upid_value));
+    return PodInfoToPodQoS(UPIDtoPod(ctx, upid_value));
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the Kubernetes QOS class for the UPID.")
@@ -197,6 +197,35 @@ TEST_F(MetadataOpsTest, upid_to_service_name_test) {
   udf_tester.ForInput(upid2).Expect("");
 }
 
+TEST_F(MetadataOpsTest, upid_metadata_shared_across_udfs) {
+  FunctionContext function_ctx(metadata_state_, nullptr);
+  UPIDToPodNameUDF pod_name_udf;
+  UPIDToNamespaceUDF namespace_udf;
+  UPIDToServiceNameUDF service_name_udf;
+  auto upid1 = types::UInt128Value(528280977975, 89101);
+  auto upid2 = types::UInt128Value(528280977975, 468);
+
+  // Repeated UPIDs, as in a column of a record batch, should give the same outputs.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(pod_name_udf.Exec(&function_ctx, upid1), "pl/running_pod");
+    EXPECT_EQ(namespace_udf.Exec(&function_ctx, upid1), "pl");
+    EXPECT_EQ(service_name_udf.Exec(&function_ctx, upid1), "pl/running_service");
+    EXPECT_EQ(pod_name_udf.Exec(&function_ctx, upid2), "pl/terminating_pod");
+    EXPECT_EQ(service_name_udf.Exec(&function_ctx, upid2), "pl/terminating_service");
+  }
+
+  auto resolved = function_ctx.ResolveUPID(md::UPID(123, 567, 89101));
+  ASSERT_NE(resolved.pod_info, nullptr);
+  EXPECT_EQ(resolved.pod_info->name(), "running_pod");
+  EXPECT_EQ(resolved.pod_info, metadata_state_->k8s_metadata_state().PodInfoByID("1_uid"));
+
+  // Modifying the state in place drops the cached outputs.
+  updates_->enqueue(px::metadatapb::testutils::CreateTerminatedServiceUpdatePB());
+  EXPECT_OK(px::md::ApplyK8sUpdates(11, metadata_state_.get(), &md_filter_, updates_.get()));
+  EXPECT_EQ(service_name_udf.Exec(&function_ctx, upid2), "");
+  EXPECT_EQ(pod_name_udf.Exec(&function_ctx, upid2), "pl/terminating_pod");
+}
+
 TEST_F(MetadataOpsTest, upid_to_node_name_test) {
   auto function_ctx = std::make_unique<FunctionContext>(metadata_state_, nullptr);
   auto udf_tester = px::carnot::udf::UDFTester<UPIDToNodeNameUDF>(std::move(function_ctx));
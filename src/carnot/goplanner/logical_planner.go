@@ -24,10 +24,13 @@ package goplanner
 // // If you delete it, the planner will break.
 // #include <stdlib.h>
 // #include "src/carnot/planner/cgo_export.h"
+//
+// extern void goExecFuncPlanCallback(uintptr_t callback_ctx, int exec_func_idx, char* result, int result_len);
 import "C"
 import (
 	"errors"
 	"fmt"
+	"sync"
 	"unsafe"
 
 	"github.com/gogo/protobuf/proto"
@@ -95,6 +98,104 @@ func (cm GoPlanner) Plan(planState *distributedpb.LogicalPlannerState, queryRequ
 	return plan, nil
 }
 
+// ExecFuncPlanFunc is called with the result of planning an exec func, see PlanExecFuncsStream.
+type ExecFuncPlanFunc func(execFuncIdx int, result *distributedpb.LogicalPlannerResult)
+
+// The callbacks of the PlanExecFuncsStream calls in flight. C code can't hold Go pointers, so the
+// planner is handed an ID that goExecFuncPlanCallback looks the callback up by.
+var (
+	execFuncCallbacksMu    sync.Mutex
+	execFuncCallbacks      = make(map[uintptr]func(int, []byte))
+	nextExecFuncCallbackID uintptr
+)
+
+//export goExecFuncPlanCallback
+func goExecFuncPlanCallback(callbackCtx C.uintptr_t, execFuncIdx C.int, result *C.char, resultLen C.int) {
+	execFuncCallbacksMu.Lock()
+	callback := execFuncCallbacks[uintptr(callbackCtx)]
+	execFuncCallbacksMu.Unlock()
+	// The result is only valid during the call, so it is copied out before it is used.
+	callback(int(execFuncIdx), C.GoBytes(unsafe.Pointer(result), resultLen))
+}
+
+// PlanExecFuncsStream plans each exec func of the query into its own plan. The exec funcs are planned
+// in parallel and the result of each is passed to onPlan as soon as it is ready, so that the caller
+// can start on a plan while the rest are still being planned. onPlan is never called concurrently and
+// the function returns once every exec func is planned, with the status of the request as a whole.
+func (cm GoPlanner) PlanExecFuncsStream(planState *distributedpb.LogicalPlannerState, queryRequest *plannerpb.QueryRequest, onPlan ExecFuncPlanFunc) (*statuspb.Status, error) {
+	var resultLen C.int
+	stateBytes, err := proto.Marshal(planState)
+	if err != nil {
+		return nil, err
+	}
+	stateData := C.CBytes(stateBytes)
+	defer C.free(stateData)
+
+	queryRequestBytes, err := proto.Marshal(queryRequest)
+	if err != nil {
+		return nil, err
+	}
+	queryRequestData := C.CBytes(queryRequestBytes)
+	defer C.free(queryRequestData)
+
+	var callbackErr error
+	execFuncCallbacksMu.Lock()
+	callbackID := nextExecFuncCallbackID
+	nextExecFuncCallbackID++
+	execFuncCallbacks[callbackID] = func(execFuncIdx int, resultBytes []byte) {
+		resultPB := &distributedpb.LogicalPlannerResult{}
+		if err := proto.Unmarshal(resultBytes, resultPB); err != nil {
+			if callbackErr == nil {
+				callbackErr = fmt.Errorf("error: '%s'; exec func: %d", err, execFuncIdx)
+			}
+			return
+		}
+		onPlan(execFuncIdx, resultPB)
+	}
+	execFuncCallbacksMu.Unlock()
+	defer func() {
+		execFuncCallbacksMu.Lock()
+		delete(execFuncCallbacks, callbackID)
+		execFuncCallbacksMu.Unlock()
+	}()
+
+	res := C.PlannerPlanExecFuncs(cm.planner, (*C.char)(stateData), C.int(len(stateBytes)), (*C.char)(queryRequestData), C.int(len(queryRequestBytes)),
+		C.ExecFuncPlanCallbackFn(C.goExecFuncPlanCallback), C.uintptr_t(callbackID), &resultLen)
+	defer C.StrFree(res)
+	resultBytes := C.GoBytes(unsafe.Pointer(res), resultLen)
+	if resultLen == 0 {
+		return nil, errors.New("no result returned")
+	}
+
+	resultPB := &distributedpb.LogicalPlannerExecFuncsResult{}
+	if err := proto.Unmarshal(resultBytes, resultPB); err != nil {
+		return nil, fmt.Errorf("error: '%s'; string: '%s'", err, string(resultBytes))
+	}
+	if callbackErr != nil {
+		return nil, callbackErr
+	}
+	return resultPB.Status, nil
+}
+
+// PlanExecFuncs plans each exec func of the query into its own plan, then returns the results as a
+// planner exec funcs result protobuf. The exec funcs are planned in parallel, see PlanExecFuncsStream
+// to get each plan as soon as it is ready.
+func (cm GoPlanner) PlanExecFuncs(planState *distributedpb.LogicalPlannerState, queryRequest *plannerpb.QueryRequest) (*distributedpb.LogicalPlannerExecFuncsResult, error) {
+	resultPB := &distributedpb.LogicalPlannerExecFuncsResult{}
+	results := make([]*distributedpb.LogicalPlannerResult, len(queryRequest.ExecFuncs))
+	status, err := cm.PlanExecFuncsStream(planState, queryRequest, func(execFuncIdx int, result *distributedpb.LogicalPlannerResult) {
+		results[execFuncIdx] = result
+	})
+	if err != nil {
+		return nil, err
+	}
+	resultPB.Status = status
+	if status.ErrCode == statuspb.OK {
+		resultPB.ExecFuncResults = results
+	}
+	return resultPB, nil
+}
+
 // GetMainFuncArgsSpec returns the FuncArgSpec of the main function if it exists, otherwise throws a Compiler Error.
 func (cm GoPlanner) GetMainFuncArgsSpec(queryRequest *plannerpb.QueryRequest) (*scriptspb.MainFuncSpecResult, error) {
 	var resultLen C.int
@@ -47,6 +47,21 @@ func (cm GoPlanner) Plan(planState *distributedpb.LogicalPlannerState, queryRequ
 	return nil, errorUnimplemented
 }
 
+// ExecFuncPlanFunc is called with the result of planning an exec func, see PlanExecFuncsStream.
+type ExecFuncPlanFunc func(execFuncIdx int, result *distributedpb.LogicalPlannerResult)
+
+// PlanExecFuncsStream plans each exec func of the query into its own plan. The exec funcs are planned
+// in parallel and the result of each is passed to onPlan as soon as it is ready.
+func (cm GoPlanner) PlanExecFuncsStream(planState *distributedpb.LogicalPlannerState, queryRequest *plannerpb.QueryRequest, onPlan ExecFuncPlanFunc) (*statuspb.Status, error) {
+	return nil, errorUnimplemented
+}
+
+// PlanExecFuncs plans each exec func of the query into its own plan, then returns the results as a
+// planner exec funcs result protobuf. The exec funcs are planned in parallel.
+func (cm GoPlanner) PlanExecFuncs(planState *distributedpb.LogicalPlannerState, queryRequest *plannerpb.QueryRequest) (*distributedpb.LogicalPlannerExecFuncsResult, error) {
+	return nil, errorUnimplemented
+}
+
 // GetMainFuncArgsSpec returns the FuncArgSpec of the main function if it exists, otherwise throws a Compiler Error.
 func (cm GoPlanner) GetMainFuncArgsSpec(queryRequest *plannerpb.QueryRequest) (*scriptspb.MainFuncSpecResult, error) {
 	return nil, errorUnimplemented
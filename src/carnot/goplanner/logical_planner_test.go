@@ -242,6 +242,114 @@ func TestPlanner_EmptyString(t *testing.T) {
 	assert.Regexp(t, "Query should not be empty", status.Msg)
 }
 
+const execFuncsQuery = `
+import px
+
+def cycles():
+	return px.DataFrame(table='table1', select=['cpu_cycles'])
+
+def upids():
+	return px.DataFrame(table='table1', select=['upid'])
+`
+
+func TestPlanner_PlanExecFuncs(t *testing.T) {
+	// Create the compiler.
+	var udfInfoPb udfspb.UDFInfo
+	b, err := funcs.Asset("src/vizier/funcs/data/udf.pb")
+	require.NoError(t, err)
+
+	err = proto.Unmarshal(b, &udfInfoPb)
+	require.NoError(t, err)
+
+	c, err := goplanner.New(&udfInfoPb)
+	require.NoError(t, err)
+	defer c.Free()
+
+	plannerStatePB := new(distributedpb.LogicalPlannerState)
+	err = proto.UnmarshalText(plannerStatePBStr, plannerStatePB)
+	require.NoError(t, err)
+
+	queryRequestPB := &plannerpb.QueryRequest{
+		QueryStr: execFuncsQuery,
+		ExecFuncs: []*plannerpb.FuncToExecute{
+			{FuncName: "cycles", OutputTablePrefix: "cycles_out"},
+			{FuncName: "dne", OutputTablePrefix: "dne_out"},
+			{FuncName: "upids", OutputTablePrefix: "upids_out"},
+		},
+	}
+	resultPB, err := c.PlanExecFuncs(plannerStatePB, queryRequestPB)
+	require.NoError(t, err)
+	assert.Equal(t, statuspb.OK, resultPB.Status.ErrCode)
+
+	// The exec func that doesn't exist fails without failing the others.
+	require.Equal(t, 3, len(resultPB.ExecFuncResults))
+	assert.Equal(t, statuspb.OK, resultPB.ExecFuncResults[0].Status.ErrCode)
+	assert.Contains(t, resultPB.ExecFuncResults[0].Plan.String(), "cycles_out")
+	assert.NotEqual(t, statuspb.OK, resultPB.ExecFuncResults[1].Status.ErrCode)
+	assert.Nil(t, resultPB.ExecFuncResults[1].Plan)
+	assert.Equal(t, statuspb.OK, resultPB.ExecFuncResults[2].Status.ErrCode)
+	assert.Contains(t, resultPB.ExecFuncResults[2].Plan.String(), "upids_out")
+}
+
+func TestPlanner_PlanExecFuncsStream(t *testing.T) {
+	// Create the compiler.
+	var udfInfoPb udfspb.UDFInfo
+	b, err := funcs.Asset("src/vizier/funcs/data/udf.pb")
+	require.NoError(t, err)
+
+	err = proto.Unmarshal(b, &udfInfoPb)
+	require.NoError(t, err)
+
+	c, err := goplanner.New(&udfInfoPb)
+	require.NoError(t, err)
+	defer c.Free()
+
+	plannerStatePB := new(distributedpb.LogicalPlannerState)
+	err = proto.UnmarshalText(plannerStatePBStr, plannerStatePB)
+	require.NoError(t, err)
+
+	queryRequestPB := &plannerpb.QueryRequest{
+		QueryStr: execFuncsQuery,
+		ExecFuncs: []*plannerpb.FuncToExecute{
+			{FuncName: "cycles", OutputTablePrefix: "cycles_out"},
+			{FuncName: "upids", OutputTablePrefix: "upids_out"},
+		},
+	}
+	results := make(map[int]*distributedpb.LogicalPlannerResult)
+	status, err := c.PlanExecFuncsStream(plannerStatePB, queryRequestPB, func(execFuncIdx int, result *distributedpb.LogicalPlannerResult) {
+		assert.NotContains(t, results, execFuncIdx)
+		results[execFuncIdx] = result
+	})
+	require.NoError(t, err)
+	assert.Equal(t, statuspb.OK, status.ErrCode)
+
+	// Every exec func is passed to the callback before the call returns.
+	require.Equal(t, 2, len(results))
+	assert.Equal(t, statuspb.OK, results[0].Status.ErrCode)
+	assert.Contains(t, results[0].Plan.String(), "cycles_out")
+	assert.Equal(t, statuspb.OK, results[1].Status.ErrCode)
+	assert.Contains(t, results[1].Plan.String(), "upids_out")
+}
+
+func TestPlanner_PlanExecFuncs_BadQuery(t *testing.T) {
+	c, err := goplanner.New(&udfspb.UDFInfo{})
+	require.NoError(t, err)
+	defer c.Free()
+
+	plannerStatePB := new(distributedpb.LogicalPlannerState)
+	err = proto.UnmarshalText(plannerStatePBStr, plannerStatePB)
+	require.NoError(t, err)
+
+	// A request without exec funcs fails as a whole.
+	queryRequestPB := &plannerpb.QueryRequest{
+		QueryStr: execFuncsQuery,
+	}
+	resultPB, err := c.PlanExecFuncs(plannerStatePB, queryRequestPB)
+	require.NoError(t, err)
+	assert.NotEqual(t, statuspb.OK, resultPB.Status.ErrCode)
+	assert.Equal(t, 0, len(resultPB.ExecFuncResults))
+}
+
 const mainFuncArgsQuery = `
 import px
 
@@ -92,7 +92,18 @@ std::unique_ptr<Operator> Operator::FromProto(const planpb::Operator& pb, int64_
  * Memory Source Operator Implementation.
  */
 
-std::string MemorySourceOperator::DebugString() const { return "Op:MemorySource"; }
+std::string MemorySourceOperator::DebugString() const {
+  if (!HasPredicates()) {
+    return "Op:MemorySource";
+  }
+  std::vector<std::string> predicates;
+  for (const auto& predicate : pb_.predicates()) {
+    predicates.push_back(absl::Substitute("$0 $1 $2", pb_.column_names(predicate.column_idx()),
+                                          magic_enum::enum_name(predicate.op()),
+                                          predicate.value().ShortDebugString()));
+  }
+  return absl::Substitute("Op:MemorySource(where $0)", absl::StrJoin(predicates, " and "));
+}
 
 Status MemorySourceOperator::Init(const planpb::MemorySourceOperator& pb) {
   pb_ = pb;
@@ -100,6 +111,19 @@ Status MemorySourceOperator::Init(const planpb::MemorySourceOperator& pb) {
   for (int i = 0; i < pb_.column_idxs_size(); ++i) {
     column_idxs_.emplace_back(pb_.column_idxs(i));
   }
+  for (const auto& predicate : pb_.predicates()) {
+    if (predicate.column_idx() < 0 || predicate.column_idx() >= pb_.column_idxs_size()) {
+      return error::InvalidArgument("MemorySource predicate column $0 out of range [0, $1)",
+                                    predicate.column_idx(), pb_.column_idxs_size());
+    }
+    if (predicate.value().data_type() != pb_.column_types(predicate.column_idx())) {
+      return error::InvalidArgument(
+          "MemorySource predicate on column '$0' compares $1 to a value of type $2",
+          pb_.column_names(predicate.column_idx()),
+          magic_enum::enum_name(pb_.column_types(predicate.column_idx())),
+          magic_enum::enum_name(predicate.value().data_type()));
+    }
+  }
   is_initialized_ = true;
   return Status::OK();
 }
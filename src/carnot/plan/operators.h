@@ -96,6 +96,11 @@ class MemorySourceOperator : public Operator {
   std::vector<int64_t> Columns() const { return column_idxs_; }
   const types::TabletID& Tablet() const { return pb_.tablet(); }
   bool infinite_stream() const { return pb_.streaming(); }
+  bool HasPredicates() const { return pb_.predicates_size() > 0; }
+  const ::google::protobuf::RepeatedPtrField<planpb::MemorySourceOperator::ColumnPredicate>&
+  predicates() const {
+    return pb_.predicates();
+  }
 
  private:
   planpb::MemorySourceOperator pb_;
@@ -143,6 +148,8 @@ class AggregateOperator : public Operator {
   const std::vector<GroupInfo>& groups() const { return groups_; }
   const std::vector<std::shared_ptr<AggregateExpression>>& values() const { return values_; }
   bool windowed() const { return pb_.windowed(); }
+  bool partial_agg() const { return pb_.partial_agg(); }
+  bool finalize_results() const { return pb_.finalize_results(); }
 
  private:
   std::vector<std::shared_ptr<AggregateExpression>> values_;
@@ -312,6 +319,7 @@ class JoinOperator : public Operator {
   }
   std::vector<planpb::JoinOperator::ParentColumn> output_columns() const { return output_columns_; }
   size_t rows_per_batch() const { return pb_.rows_per_batch(); }
+  int64_t build_parent_index() const { return pb_.build_parent_index(); }
 
   bool order_by_time() const;
   planpb::JoinOperator::ParentColumn time_column() const;
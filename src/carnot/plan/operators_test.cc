@@ -131,6 +131,33 @@ TEST_F(OperatorTest, from_proto_streaming_source) {
   EXPECT_TRUE(src_plan_node->infinite_stream());
 }
 
+TEST_F(OperatorTest, from_proto_mem_src_with_predicates) {
+  auto src_pb = planpb::testutils::CreateTestSource1PB();
+  auto predicate = src_pb.mutable_mem_source_op()->add_predicates();
+  predicate->set_column_idx(0);
+  predicate->set_op(planpb::MemorySourceOperator::ColumnPredicate::GREATER_THAN);
+  predicate->mutable_value()->set_data_type(types::FLOAT64);
+  predicate->mutable_value()->set_float64_value(0.5);
+
+  auto src_op = Operator::FromProto(src_pb, 1);
+  ASSERT_NE(nullptr, src_op);
+  const auto* src_plan_node = static_cast<const plan::MemorySourceOperator*>(src_op.get());
+  EXPECT_TRUE(src_plan_node->HasPredicates());
+  ASSERT_EQ(1, src_plan_node->predicates().size());
+  EXPECT_EQ(0.5, src_plan_node->predicates()[0].value().float64_value());
+
+  // The constant has to have the same type as the column.
+  predicate->mutable_value()->set_data_type(types::INT64);
+  predicate->mutable_value()->set_int64_value(1);
+  EXPECT_EQ(nullptr, Operator::FromProto(src_pb, 1));
+
+  // The column has to be one of the output columns.
+  predicate->set_column_idx(1);
+  predicate->mutable_value()->set_data_type(types::FLOAT64);
+  predicate->mutable_value()->set_float64_value(0.5);
+  EXPECT_EQ(nullptr, Operator::FromProto(src_pb, 1));
+}
+
 TEST_F(OperatorTest, from_proto_mem_sink) {
   auto sink_pb = planpb::testutils::CreateTestSink1PB();
   auto sink_op = Operator::FromProto(sink_pb, 1);
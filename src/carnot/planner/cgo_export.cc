@@ -36,6 +36,8 @@
 #include "src/table_store/schema/relation.h"
 #include "src/table_store/schemapb/schema.pb.h"
 
+using px::carnot::planner::distributedpb::DistributedPlan;
+using px::carnot::planner::distributedpb::LogicalPlannerExecFuncsResult;
 using px::carnot::planner::distributedpb::LogicalPlannerResult;
 using px::carnot::planner::plannerpb::CompileMutationsResponse;
 using px::shared::scriptspb::MainFuncSpecResult;
@@ -98,32 +100,64 @@ char* PlannerPlan(PlannerPtr planner_ptr, const char* planner_state_str_c,
 
   auto planner = reinterpret_cast<px::carnot::planner::LogicalPlanner*>(planner_ptr);
 
-  auto distributed_plan_status = planner->Plan(planner_state_pb, query_request_pb);
-  if (!distributed_plan_status.ok()) {
-    return ExitEarly<LogicalPlannerResult>(distributed_plan_status.status(), resultLen);
-  }
-  std::unique_ptr<px::carnot::planner::distributed::DistributedPlan> distributed_plan =
-      distributed_plan_status.ConsumeValueOrDie();
-
-  // If the response is ok, then we can go ahead and set this up.
-  LogicalPlannerResult planner_result_pb;
-  WrapStatus(&planner_result_pb, distributed_plan_status.status());
-  // In the future, if we actually have plan options that will actually determine how the plan is
-  // constructed, we may want to pass the planOptions to planner.Plan. However, this
-  // will need to go through many more layers (such as the coordinator), so this is fine for now.
-  distributed_plan->SetPlanOptions(planner_state_pb.plan_options());
-
-  auto plan_pb_status = distributed_plan->ToProto();
+  // PlanToProto applies the plan options of the planner state to the finished plan.
+  auto plan_pb_status = planner->PlanToProto(planner_state_pb, query_request_pb);
   if (!plan_pb_status.ok()) {
     return ExitEarly<LogicalPlannerResult>(plan_pb_status.status(), resultLen);
   }
 
+  // If the response is ok, then we can go ahead and set this up.
+  LogicalPlannerResult planner_result_pb;
+  WrapStatus(&planner_result_pb, plan_pb_status.status());
   *(planner_result_pb.mutable_plan()) = plan_pb_status.ConsumeValueOrDie();
 
   // Serialize the logical plan into bytes.
   return PrepareResult(&planner_result_pb, resultLen);
 }
 
+char* PlannerPlanExecFuncs(PlannerPtr planner_ptr, const char* planner_state_str_c,
+                           int planner_state_str_len, const char* query_request_str_c,
+                           int query_request_str_len, ExecFuncPlanCallbackFn callback,
+                           uintptr_t callback_ctx, int* resultLen) {
+  DCHECK(planner_state_str_c != nullptr);
+  DCHECK(callback != nullptr);
+  std::string planner_state_pb_str(planner_state_str_c,
+                                   planner_state_str_c + planner_state_str_len);
+  std::string query_request_pb_str(query_request_str_c,
+                                   query_request_str_c + query_request_str_len);
+
+  // Load in the planner state protobuf.
+  px::carnot::planner::distributedpb::LogicalPlannerState planner_state_pb;
+  PLANNER_RETURN_IF_ERROR(LogicalPlannerExecFuncsResult, resultLen,
+                          LoadProto(planner_state_pb_str, &planner_state_pb,
+                                    "Failed to process the logical planner state"));
+
+  // Load in the query request protobuf.
+  px::carnot::planner::plannerpb::QueryRequest query_request_pb;
+  PLANNER_RETURN_IF_ERROR(
+      LogicalPlannerExecFuncsResult, resultLen,
+      LoadProto(query_request_pb_str, &query_request_pb, "Failed to process the query request"));
+
+  auto planner = reinterpret_cast<px::carnot::planner::LogicalPlanner*>(planner_ptr);
+
+  auto status = planner->PlanExecFuncs(
+      planner_state_pb, query_request_pb,
+      [callback, callback_ctx](int64_t exec_func_idx, px::StatusOr<DistributedPlan> plan_or_s) {
+        LogicalPlannerResult result_pb;
+        WrapStatus(&result_pb, plan_or_s.status());
+        if (plan_or_s.ok()) {
+          *(result_pb.mutable_plan()) = plan_or_s.ConsumeValueOrDie();
+        }
+        std::string result = result_pb.SerializeAsString();
+        callback(callback_ctx, exec_func_idx, result.data(), result.size());
+      });
+  PLANNER_RETURN_IF_ERROR(LogicalPlannerExecFuncsResult, resultLen, status);
+
+  LogicalPlannerExecFuncsResult exec_funcs_result_pb;
+  WrapStatus(&exec_funcs_result_pb, status);
+  return PrepareResult(&exec_funcs_result_pb, resultLen);
+}
+
 char* PlannerCompileMutations(PlannerPtr planner_ptr, const char* planner_state_str_c,
                               int planner_state_str_len, const char* mutation_request_str_c,
                               int mutation_request_str_len, int* resultLen) {
@@ -22,6 +22,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef void* PlannerPtr;
 
@@ -45,6 +46,40 @@ PlannerPtr PlannerNew(const char* udf_info_str_data, int udf_info_str_len);
 char* PlannerPlan(PlannerPtr planner_ptr, const char* planner_state_str_c,
                   int planner_state_str_len, const char* query, int query_len, int* resultLen);
 
+/**
+ * @brief Called by PlannerPlanExecFuncs with the plan of each exec func as soon as it is ready.
+ *
+ * @param callback_ctx    The context passed to PlannerPlanExecFuncs.
+ * @param exec_func_idx   The index of the exec func in the query request.
+ * @param result          The LogicalPlannerResult proto, serialized as a string. It is only valid
+ * for the duration of the call.
+ * @param result_len      The length of the serialized result.
+ */
+typedef void (*ExecFuncPlanCallbackFn)(uintptr_t callback_ctx, int exec_func_idx, char* result,
+                                       int result_len);
+
+/**
+ * @brief Plans every exec func of the query request into its own distributed plan. The exec funcs
+ * are planned in parallel, see LogicalPlanner::PlanExecFuncs. Each plan is passed to the callback
+ * as soon as it is ready, the calls are never concurrent and the function returns once every exec
+ * func has been planned.
+ *
+ * @param planner                 Pointer to the Planner.
+ * @param planner_state_str_c     The planner state proto, seralized as a string.
+ * @param planner_state_str_len   Length of the planner state proto serialized string.
+ * @param query_request_str_c     The query request proto to plan, seralized as a string.
+ * @param query_request_str_len   The length of the query request serialized string.
+ * @param callback                Called with the result of each exec func, so that an exec func
+ * that fails to plan doesn't fail the rest.
+ * @param callback_ctx            Passed through to the callback.
+ * @return char*                  The LogicalPlannerExecFuncsResult proto, serialized as a string.
+ * It only holds the status of the request as a whole, the plans go to the callback.
+ */
+char* PlannerPlanExecFuncs(PlannerPtr planner_ptr, const char* planner_state_str_c,
+                           int planner_state_str_len, const char* query_request_str_c,
+                           int query_request_str_len, ExecFuncPlanCallbackFn callback,
+                           uintptr_t callback_ctx, int* resultLen);
+
 /**
  * @brief Returns the Main Function argument's Specification. Fails if the main function doesn't
  * exist in the query argument.
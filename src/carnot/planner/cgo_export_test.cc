@@ -23,6 +23,8 @@
 #include <string>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_cat.h>
 #include <absl/strings/str_join.h>
 #include "src/carnot/planner/compiler/test_utils.h"
 #include "src/carnot/planner/compilerpb/compiler_status.pb.h"
@@ -169,6 +171,81 @@ TEST_F(PlannerExportTest, pass_query_string_instead_of_req_should_fail) {
               ::testing::ContainsRegex("Failed to process the query request.*"));
 }
 
+constexpr char kExecFuncsQuery[] = R"pxl(
+import px
+
+def cycles():
+    return px.DataFrame(table='table1', select=['cpu_cycles'])
+
+def filtered_cycles():
+    df = px.DataFrame(table='table1', select=['cpu_cycles'])
+    return df[df.cpu_cycles >= 0]
+)pxl";
+
+// Collects the results that PlannerPlanExecFuncs passes to its callback.
+void CollectExecFuncResult(uintptr_t callback_ctx, int exec_func_idx, char* result,
+                           int result_len) {
+  auto results =
+      reinterpret_cast<absl::flat_hash_map<int, distributedpb::LogicalPlannerResult>*>(
+          callback_ctx);
+  ASSERT_FALSE(results->contains(exec_func_idx));
+  ASSERT_TRUE((*results)[exec_func_idx].ParseFromString(std::string(result, result_len)));
+}
+
+TEST_F(PlannerExportTest, plan_exec_funcs) {
+  planner_ = MakePlanner();
+  int result_len;
+  std::string logical_planner_state;
+  ASSERT_TRUE(
+      testutils::CreateTwoPEMsOneKelvinPlannerState().SerializeToString(&logical_planner_state));
+  plannerpb::QueryRequest query_request_pb = MakeQueryRequest(kExecFuncsQuery);
+  for (const auto& name : {"cycles", "dne", "filtered_cycles"}) {
+    auto exec_func = query_request_pb.add_exec_funcs();
+    exec_func->set_func_name(name);
+    exec_func->set_output_table_prefix(absl::StrCat(name, "_out"));
+  }
+  std::string query_request;
+  ASSERT_TRUE(query_request_pb.SerializeToString(&query_request));
+
+  absl::flat_hash_map<int, distributedpb::LogicalPlannerResult> exec_func_results;
+  auto interface_result = PlannerPlanExecFuncs(
+      planner_, logical_planner_state.c_str(), logical_planner_state.length(),
+      query_request.c_str(), query_request.length(), &CollectExecFuncResult,
+      reinterpret_cast<uintptr_t>(&exec_func_results), &result_len);
+  ASSERT_GT(result_len, 0);
+  distributedpb::LogicalPlannerExecFuncsResult result_pb;
+  ASSERT_TRUE(
+      result_pb.ParseFromString(std::string(interface_result, interface_result + result_len)));
+  delete[] interface_result;
+  ASSERT_OK(result_pb.status());
+  // The plans only go to the callback.
+  EXPECT_EQ(0, result_pb.exec_func_results_size());
+
+  // The exec func that doesn't exist fails without failing the others.
+  ASSERT_EQ(3, exec_func_results.size());
+  EXPECT_OK(exec_func_results[0].status());
+  EXPECT_THAT(exec_func_results[0].plan().DebugString(), ::testing::HasSubstr("\"cycles_out\""));
+  EXPECT_NOT_OK(exec_func_results[1].status());
+  EXPECT_FALSE(exec_func_results[1].has_plan());
+  EXPECT_OK(exec_func_results[2].status());
+  EXPECT_THAT(exec_func_results[2].plan().DebugString(),
+              ::testing::HasSubstr("\"filtered_cycles_out\""));
+
+  // A request without exec funcs fails as a whole.
+  exec_func_results.clear();
+  ASSERT_TRUE(MakeQueryRequest(kExecFuncsQuery).SerializeToString(&query_request));
+  interface_result = PlannerPlanExecFuncs(
+      planner_, logical_planner_state.c_str(), logical_planner_state.length(),
+      query_request.c_str(), query_request.length(), &CollectExecFuncResult,
+      reinterpret_cast<uintptr_t>(&exec_func_results), &result_len);
+  ASSERT_GT(result_len, 0);
+  ASSERT_TRUE(
+      result_pb.ParseFromString(std::string(interface_result, interface_result + result_len)));
+  delete[] interface_result;
+  EXPECT_NOT_OK(result_pb.status());
+  EXPECT_EQ(0, exec_func_results.size());
+}
+
 constexpr char kMainFuncArgsQuery[] = R"pxl(
 import px
 
@@ -107,7 +107,12 @@ StatusOr<ExpressionIR*> ConvertStringTimesRule::ConvertStringTimes(ExpressionIR*
     PL_ASSIGN_OR_RETURN(
         int64_t time,
         ParseStringToTime(str_node, relative_time ? compiler_state_->time_now().val : 0));
-    return node->graph()->CreateNode<IntIR>(node->ast(), time);
+    PL_ASSIGN_OR_RETURN(IntIR * time_ir, node->graph()->CreateNode<IntIR>(node->ast(), time));
+    // Durations such as "-5m" are relative to the compile time, absolute times aren't.
+    if (relative_time && ParseDurationFmt(str_node, 0).ok()) {
+      time_ir->set_time_dependence(DataIR::TimeDependence::kRelative);
+    }
+    return time_ir;
   } else if (Match(node, Func())) {
     auto func_node = static_cast<FuncIR*>(node);
     for (const auto& [idx, arg] : Enumerate(func_node->all_args())) {
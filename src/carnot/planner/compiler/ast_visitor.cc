@@ -964,6 +964,35 @@ StatusOr<udf::ScalarUDFDefinition*> GetUDFDefinition(const std::shared_ptr<udf::
   return udf_or_s;
 }
 
+// Returns how the result of a UDF evaluated at compile time depends on the compile time. Adding a
+// constant to a relative time, or subtracting one from it, keeps the result relative. The
+// difference of two relative times doesn't depend on the compile time at all.
+DataIR::TimeDependence EvaluatedTimeDependence(const udf::ScalarUDFDefinition* def,
+                                               const std::vector<ExpressionIR*>& args) {
+  using TimeDependence = DataIR::TimeDependence;
+  std::vector<TimeDependence> arg_dependences;
+  for (ExpressionIR* arg : args) {
+    arg_dependences.push_back(static_cast<DataIR*>(arg)->time_dependence());
+  }
+  auto count = [&arg_dependences](TimeDependence dependence) {
+    return std::count(arg_dependences.begin(), arg_dependences.end(), dependence);
+  };
+  if (count(TimeDependence::kNone) == static_cast<int64_t>(args.size())) {
+    return TimeDependence::kNone;
+  }
+  if (count(TimeDependence::kOpaque) > 0 || args.size() != 2) {
+    return TimeDependence::kOpaque;
+  }
+  if (def->name() == "add" && count(TimeDependence::kRelative) == 1) {
+    return TimeDependence::kRelative;
+  }
+  if (def->name() == "subtract" && arg_dependences[0] == TimeDependence::kRelative) {
+    return arg_dependences[1] == TimeDependence::kRelative ? TimeDependence::kNone
+                                                           : TimeDependence::kRelative;
+  }
+  return TimeDependence::kOpaque;
+}
+
 StatusOr<ExpressionIR*> ExecUDF(IR* graph, const pypa::AstPtr& ast, udf::ScalarUDFDefinition* def,
                                 const std::vector<ExpressionIR*>& args) {
   std::vector<std::shared_ptr<types::ColumnWrapper>> column_pool;
@@ -1007,22 +1036,43 @@ StatusOr<ExpressionIR*> ExecUDF(IR* graph, const pypa::AstPtr& ast, udf::ScalarU
   PL_RETURN_IF_ERROR(def->ExecBatch(udf.get(), function_ctx.get(), columns, output.get(), 1));
 
   // Convert the output type into a DataIR.
+  DataIR* result;
   switch (def->exec_return_type()) {
-    case types::INT64:
-      return graph->CreateNode<IntIR>(ast, output->Get<types::Int64Value>(0).val);
-    case types::FLOAT64:
-      return graph->CreateNode<FloatIR>(ast, output->Get<types::Float64Value>(0).val);
-    case types::STRING:
-      return graph->CreateNode<StringIR>(ast, output->Get<types::StringValue>(0));
-    case types::UINT128:
-      return graph->CreateNode<UInt128IR>(ast, output->Get<types::UInt128Value>(0).val);
-    case types::BOOLEAN:
-      return graph->CreateNode<BoolIR>(ast, output->Get<types::BoolValue>(0).val);
-    case types::TIME64NS:
-      return graph->CreateNode<TimeIR>(ast, output->Get<types::Time64NSValue>(0).val);
+    case types::INT64: {
+      PL_ASSIGN_OR_RETURN(result,
+                          graph->CreateNode<IntIR>(ast, output->Get<types::Int64Value>(0).val));
+      break;
+    }
+    case types::FLOAT64: {
+      PL_ASSIGN_OR_RETURN(result,
+                          graph->CreateNode<FloatIR>(ast, output->Get<types::Float64Value>(0).val));
+      break;
+    }
+    case types::STRING: {
+      PL_ASSIGN_OR_RETURN(result,
+                          graph->CreateNode<StringIR>(ast, output->Get<types::StringValue>(0)));
+      break;
+    }
+    case types::UINT128: {
+      PL_ASSIGN_OR_RETURN(
+          result, graph->CreateNode<UInt128IR>(ast, output->Get<types::UInt128Value>(0).val));
+      break;
+    }
+    case types::BOOLEAN: {
+      PL_ASSIGN_OR_RETURN(result,
+                          graph->CreateNode<BoolIR>(ast, output->Get<types::BoolValue>(0).val));
+      break;
+    }
+    case types::TIME64NS: {
+      PL_ASSIGN_OR_RETURN(result,
+                          graph->CreateNode<TimeIR>(ast, output->Get<types::Time64NSValue>(0).val));
+      break;
+    }
     default:
       return CreateAstError(ast, "Unable to find a matching return type for the UDF");
   }
+  result->set_time_dependence(EvaluatedTimeDependence(def, args));
+  return result;
 }
 
 StatusOr<QLObjectPtr> ASTVisitorImpl::ProcessDataBinOp(const pypa::AstBinOpPtr& node,
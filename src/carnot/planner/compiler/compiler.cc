@@ -28,9 +28,12 @@
 #include <pypa/parser/parser.hh>
 
 #include "src/carnot/planner/compiler/analyzer/analyzer.h"
+#include "src/carnot/planner/compiler/analyzer/unique_sink_names_rule.h"
 #include "src/carnot/planner/compiler/compiler.h"
 #include "src/carnot/planner/compiler/optimizer/optimizer.h"
+#include "src/carnot/planner/ir/grpc_sink_ir.h"
 #include "src/carnot/planner/ir/ir.h"
+#include "src/carnot/planner/ir/memory_sink_ir.h"
 #include "src/carnot/planner/objects/pixie_module.h"
 #include "src/carnot/planner/parser/parser.h"
 #include "src/carnot/planpb/plan.pb.h"
@@ -41,6 +44,25 @@ namespace carnot {
 namespace planner {
 namespace compiler {
 
+namespace {
+
+std::string ResultSinkName(IRNode* sink) {
+  if (Match(sink, MemorySink())) {
+    return static_cast<MemorySinkIR*>(sink)->name();
+  }
+  return static_cast<GRPCSinkIR*>(sink)->name();
+}
+
+void SetResultSinkName(IRNode* sink, const std::string& name) {
+  if (Match(sink, MemorySink())) {
+    static_cast<MemorySinkIR*>(sink)->set_name(name);
+    return;
+  }
+  static_cast<GRPCSinkIR*>(sink)->set_name(name);
+}
+
+}  // namespace
+
 StatusOr<planpb::Plan> Compiler::Compile(const std::string& query, CompilerState* compiler_state) {
   return Compile(query, compiler_state, /* exec_funcs */ {});
 }
@@ -59,7 +81,15 @@ StatusOr<std::shared_ptr<IR>> Compiler::CompileToIR(const std::string& query,
 StatusOr<std::shared_ptr<IR>> Compiler::CompileToIR(const std::string& query,
                                                     CompilerState* compiler_state,
                                                     const ExecFuncs& exec_funcs) {
-  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> ir, QueryToIR(query, compiler_state, exec_funcs));
+  Parser parser;
+  PL_ASSIGN_OR_RETURN(pypa::AstModulePtr ast, parser.Parse(query));
+  return CompileToIR(ast, compiler_state, exec_funcs);
+}
+
+StatusOr<std::shared_ptr<IR>> Compiler::CompileToIR(const pypa::AstModulePtr& ast,
+                                                    CompilerState* compiler_state,
+                                                    const ExecFuncs& exec_funcs) {
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> ir, QueryToIR(ast, compiler_state, exec_funcs));
   PL_RETURN_IF_ERROR(Analyze(ir.get(), compiler_state));
   PL_RETURN_IF_ERROR(Optimize(ir.get(), compiler_state));
 
@@ -77,6 +107,72 @@ Status Compiler::Optimize(IR* ir, CompilerState* compiler_state) {
   return optimizer->Execute(ir);
 }
 
+StatusOr<AnalyzedExecFuncs> Compiler::AnalyzeExecFuncs(const pypa::AstModulePtr& ast,
+                                                       CompilerState* compiler_state,
+                                                       const ExecFuncs& exec_funcs) {
+  AnalyzedExecFuncs analyzed;
+  analyzed.ir = std::make_shared<IR>();
+  absl::flat_hash_set<std::string> reserved_names;
+  for (const auto& func : exec_funcs) {
+    reserved_names.insert(func.output_table_prefix());
+  }
+  MutationsIR dynamic_trace;
+  ModuleHandler module_handler;
+  PL_ASSIGN_OR_RETURN(auto ast_walker,
+                      ASTVisitorImpl::Create(analyzed.ir.get(), &dynamic_trace, compiler_state,
+                                             &module_handler, /* func_based_exec */ true,
+                                             reserved_names));
+
+  PL_RETURN_IF_ERROR(ast_walker->ProcessModuleNode(ast));
+  for (IRNode* sink : analyzed.ir->FindNodesThatMatch(ResultSink())) {
+    analyzed.module_sink_ids.insert(sink->id());
+  }
+  // The exec funcs are called one at a time to find the sinks that each of them writes.
+  absl::flat_hash_set<int64_t> seen_sink_ids = analyzed.module_sink_ids;
+  for (const auto& func : exec_funcs) {
+    PL_RETURN_IF_ERROR(ast_walker->ProcessExecFuncs({func}));
+    auto& func_sink_ids = analyzed.exec_func_sink_ids.emplace_back();
+    for (IRNode* sink : analyzed.ir->FindNodesThatMatch(ResultSink())) {
+      if (seen_sink_ids.insert(sink->id()).second) {
+        func_sink_ids.insert(sink->id());
+      }
+    }
+  }
+  for (IRNode* sink : analyzed.ir->FindNodesThatMatch(ResultSink())) {
+    analyzed.sink_names[sink->id()] = ResultSinkName(sink);
+  }
+
+  PL_RETURN_IF_ERROR(Analyze(analyzed.ir.get(), compiler_state));
+  return analyzed;
+}
+
+StatusOr<std::shared_ptr<IR>> Compiler::CompileExecFunc(const AnalyzedExecFuncs& analyzed,
+                                                        int64_t exec_func_idx,
+                                                        CompilerState* compiler_state) {
+  DCHECK_LT(exec_func_idx, static_cast<int64_t>(analyzed.exec_func_sink_ids.size()));
+  const auto& func_sink_ids = analyzed.exec_func_sink_ids[exec_func_idx];
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> ir, analyzed.ir->Clone());
+
+  absl::flat_hash_set<int64_t> other_sink_ids;
+  for (IRNode* sink : ir->FindNodesThatMatch(ResultSink())) {
+    if (!func_sink_ids.contains(sink->id()) && !analyzed.module_sink_ids.contains(sink->id())) {
+      other_sink_ids.insert(sink->id());
+      continue;
+    }
+    SetResultSinkName(sink, analyzed.sink_names.at(sink->id()));
+  }
+  PL_RETURN_IF_ERROR(ir->Prune(other_sink_ids));
+  // Only the sinks of this exec func have to be unique, as they would be in a compile of the exec
+  // func on its own.
+  UniqueSinkNameRule unique_sink_names_rule;
+  PL_RETURN_IF_ERROR(unique_sink_names_rule.Execute(ir.get()));
+
+  // The optimizer prunes the operators that only fed the other exec funcs.
+  PL_RETURN_IF_ERROR(Optimize(ir.get(), compiler_state));
+  PL_RETURN_IF_ERROR(VerifyGraphHasResultSink(ir.get()));
+  return ir;
+}
+
 StatusOr<shared::scriptspb::FuncArgsSpec> Compiler::GetMainFuncArgsSpec(
     const std::string& query, CompilerState* compiler_state) {
   Parser parser;
@@ -92,12 +188,9 @@ StatusOr<shared::scriptspb::FuncArgsSpec> Compiler::GetMainFuncArgsSpec(
   return ast_walker->GetMainFuncArgsSpec();
 }
 
-StatusOr<std::shared_ptr<IR>> Compiler::QueryToIR(const std::string& query,
+StatusOr<std::shared_ptr<IR>> Compiler::QueryToIR(const pypa::AstModulePtr& ast,
                                                   CompilerState* compiler_state,
                                                   const ExecFuncs& exec_funcs) {
-  Parser parser;
-  PL_ASSIGN_OR_RETURN(pypa::AstModulePtr ast, parser.Parse(query));
-
   std::shared_ptr<IR> ir = std::make_shared<IR>();
   bool func_based_exec = exec_funcs.size() > 0;
   absl::flat_hash_set<std::string> reserved_names;
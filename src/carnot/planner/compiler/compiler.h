@@ -23,6 +23,9 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
 #include "src/carnot/planner/compiler/ast_visitor.h"
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/ir/ir.h"
@@ -33,6 +36,20 @@ namespace carnot {
 namespace planner {
 namespace compiler {
 
+/**
+ * The IR of several exec funcs, built and analyzed together by Compiler::AnalyzeExecFuncs.
+ * Compiler::CompileExecFunc copies the plan of a single exec func out of it.
+ */
+struct AnalyzedExecFuncs {
+  std::shared_ptr<IR> ir;
+  // The result sinks written by the module itself, these are part of every exec func's plan.
+  absl::flat_hash_set<int64_t> module_sink_ids;
+  // The result sinks written by each exec func, in the order of the exec funcs.
+  std::vector<absl::flat_hash_set<int64_t>> exec_func_sink_ids;
+  // The names of the result sinks before analysis made them unique across all of the exec funcs.
+  absl::flat_hash_map<int64_t, std::string> sink_names;
+};
+
 /**
  * The compiler takes a query in the form of a string and compiles it into a logical plan.
  */
@@ -52,6 +69,18 @@ class Compiler {
                                             const ExecFuncs& exec_funcs);
   StatusOr<std::shared_ptr<IR>> CompileToIR(const std::string& query,
                                             CompilerState* compiler_state);
+  /**
+   * Compile an already parsed query into a logical plan. The AST is only read, so a single
+   * parsed query can be compiled with different exec funcs concurrently, each call with its own
+   * compiler state.
+   * @param ast the parsed query
+   * @param compiler_state compiler state
+   * @param exec_funcs list of funcs to execute.
+   * @return the IR of the logical plan.
+   */
+  StatusOr<std::shared_ptr<IR>> CompileToIR(const pypa::AstModulePtr& ast,
+                                            CompilerState* compiler_state,
+                                            const ExecFuncs& exec_funcs);
 
   /**
    * @brief Compiles the query to a Trace
@@ -69,12 +98,33 @@ class Compiler {
   StatusOr<px::shared::scriptspb::VisFuncsInfo> GetVisFuncsInfo(const std::string& query,
                                                                 CompilerState* compiler_state);
 
- private:
-  StatusOr<std::shared_ptr<IR>> QueryToIR(const std::string& query, CompilerState* compiler_state,
+  /**
+   * The phases of CompileToIR, which can be run separately to measure them. QueryToIR builds the
+   * IR from the parsed query, Analyze resolves it and Optimize rewrites it.
+   */
+  StatusOr<std::shared_ptr<IR>> QueryToIR(const pypa::AstModulePtr& ast,
+                                          CompilerState* compiler_state,
                                           const ExecFuncs& exec_funcs);
-
   Status Analyze(IR* ir, CompilerState* compiler_state);
   Status Optimize(IR* ir, CompilerState* compiler_state);
+
+  /**
+   * Builds and analyzes the IR of all of the exec funcs at once, so that the module and the
+   * operators the exec funcs share are only compiled once.
+   */
+  StatusOr<AnalyzedExecFuncs> AnalyzeExecFuncs(const pypa::AstModulePtr& ast,
+                                               CompilerState* compiler_state,
+                                               const ExecFuncs& exec_funcs);
+  /**
+   * Copies the operators of a single exec func out of the analyzed IR and optimizes them. The
+   * plan is the same as compiling the exec func on its own. The analyzed IR is only read, so the
+   * exec funcs can be compiled concurrently, each call with its own compiler state.
+   */
+  StatusOr<std::shared_ptr<IR>> CompileExecFunc(const AnalyzedExecFuncs& analyzed,
+                                                int64_t exec_func_idx,
+                                                CompilerState* compiler_state);
+
+ private:
   Status VerifyGraphHasResultSink(IR* ir);
 };
 
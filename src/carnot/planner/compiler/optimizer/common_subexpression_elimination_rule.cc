@@ -0,0 +1,340 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_join.h>
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planner/compiler/optimizer/common_subexpression_elimination_rule.h"
+#include "src/carnot/planner/ir/column_ir.h"
+#include "src/carnot/planner/ir/data_ir.h"
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/func_ir.h"
+#include "src/carnot/planner/ir/ir.h"
+#include "src/carnot/planner/ir/map_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+namespace {
+
+// Maps the columns available to an operator in the chain to the chain input column they pass
+// through unchanged. Columns computed inside the chain have no entry.
+using ColumnSources = absl::flat_hash_map<std::string, std::string>;
+
+struct Occurrence {
+  // The operator or function that holds the expression.
+  IRNode* holder;
+  FuncIR* func;
+  // The index of the operator in the chain.
+  size_t op_idx;
+};
+
+bool IsMapOrFilter(IRNode* node) { return Match(node, Map()) || Match(node, Filter()); }
+
+std::vector<ExpressionIR*> OperatorExpressions(OperatorIR* op) {
+  if (Match(op, Filter())) {
+    return {static_cast<FilterIR*>(op)->filter_expr()};
+  }
+  std::vector<ExpressionIR*> exprs;
+  for (const auto& col_expr : static_cast<MapIR*>(op)->col_exprs()) {
+    exprs.push_back(col_expr.node);
+  }
+  return exprs;
+}
+
+ColumnSources OutputColumnSources(OperatorIR* op, const ColumnSources& input_sources) {
+  if (Match(op, Filter())) {
+    return input_sources;
+  }
+  ColumnSources output_sources;
+  for (const auto& col_expr : static_cast<MapIR*>(op)->col_exprs()) {
+    if (!Match(col_expr.node, ColumnNode())) {
+      continue;
+    }
+    auto it = input_sources.find(static_cast<ColumnIR*>(col_expr.node)->col_name());
+    if (it != input_sources.end()) {
+      output_sources[col_expr.name] = it->second;
+    }
+  }
+  return output_sources;
+}
+
+// Nondeterministic calls can return different values for the same inputs, so they are never
+// shared. Neither are calls whose registry entry can't be found.
+bool IsDeterministic(FuncIR* func, RegistryInfo* registry_info) {
+  if (!func->HasRegistryArgTypes()) {
+    return false;
+  }
+  auto deterministic_or_s =
+      registry_info->IsUDFDeterministic(func->func_name(), func->registry_arg_types());
+  return deterministic_or_s.ok() && deterministic_or_s.ConsumeValueOrDie();
+}
+
+// Returns a key that is equal for expressions computing the same value from the chain input, or
+// std::nullopt if the expression reads a column computed inside the chain or calls a
+// nondeterministic function.
+std::optional<std::string> ExpressionKey(ExpressionIR* expr, const ColumnSources& sources,
+                                         RegistryInfo* registry_info) {
+  if (Match(expr, ColumnNode())) {
+    auto it = sources.find(static_cast<ColumnIR*>(expr)->col_name());
+    if (it == sources.end()) {
+      return std::nullopt;
+    }
+    return absl::StrCat("$", it->second);
+  }
+  if (Match(expr, DataNode())) {
+    planpb::ScalarValue value;
+    if (!static_cast<DataIR*>(expr)->ToProto(&value).ok()) {
+      return std::nullopt;
+    }
+    return value.ShortDebugString();
+  }
+  if (!Match(expr, Func())) {
+    return std::nullopt;
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  if (!IsDeterministic(func, registry_info)) {
+    return std::nullopt;
+  }
+  std::vector<std::string> arg_keys;
+  for (ExpressionIR* arg : func->all_args()) {
+    auto arg_key = ExpressionKey(arg, sources, registry_info);
+    if (!arg_key.has_value()) {
+      return std::nullopt;
+    }
+    arg_keys.push_back(arg_key.value());
+  }
+  return absl::Substitute("$0($1)", func->func_name(), absl::StrJoin(arg_keys, ","));
+}
+
+void CountFuncs(ExpressionIR* expr, const ColumnSources& sources, RegistryInfo* registry_info,
+                absl::flat_hash_map<std::string, int64_t>* counts) {
+  if (!Match(expr, Func())) {
+    return;
+  }
+  auto key = ExpressionKey(expr, sources, registry_info);
+  if (key.has_value()) {
+    ++(*counts)[key.value()];
+  }
+  for (ExpressionIR* arg : static_cast<FuncIR*>(expr)->all_args()) {
+    CountFuncs(arg, sources, registry_info, counts);
+  }
+}
+
+// Collects the outermost repeated function calls in the expression. Calls nested inside a
+// repeated call are computed along with it, so they aren't collected separately.
+void CollectRepeatedFuncs(IRNode* holder, ExpressionIR* expr, size_t op_idx,
+                          const ColumnSources& sources, RegistryInfo* registry_info,
+                          const absl::flat_hash_map<std::string, int64_t>& counts,
+                          std::vector<std::string>* keys,
+                          absl::flat_hash_map<std::string, std::vector<Occurrence>>* occurrences) {
+  if (!Match(expr, Func())) {
+    return;
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  auto key = ExpressionKey(func, sources, registry_info);
+  if (key.has_value() && counts.at(key.value()) > 1 && func->IsDataTypeEvaluated()) {
+    if (!occurrences->contains(key.value())) {
+      keys->push_back(key.value());
+    }
+    (*occurrences)[key.value()].push_back({holder, func, op_idx});
+    return;
+  }
+  for (ExpressionIR* arg : func->all_args()) {
+    CollectRepeatedFuncs(func, arg, op_idx, sources, registry_info, counts, keys, occurrences);
+  }
+}
+
+std::string UniqueColumnName(const FuncIR* func, absl::flat_hash_set<std::string>* used_names) {
+  std::string name;
+  int64_t idx = 0;
+  while (used_names->contains(name = absl::Substitute("_$0_$1", func->func_name(), idx++))) {
+    // Keep incrementing idx until we get a unique name.
+  }
+  used_names->insert(name);
+  return name;
+}
+
+StatusOr<ColumnIR*> MakeColumnRef(IRNode* node, const std::string& name,
+                                  types::DataType data_type, TypePtr type) {
+  PL_ASSIGN_OR_RETURN(ColumnIR * col, node->graph()->CreateNode<ColumnIR>(node->ast(), name,
+                                                                           /*parent_op_idx*/ 0));
+  col->ResolveColumnType(data_type);
+  if (type != nullptr) {
+    PL_RETURN_IF_ERROR(col->SetResolvedType(type));
+  }
+  return col;
+}
+
+Status ReplaceExpression(IRNode* holder, ExpressionIR* old_expr, ExpressionIR* new_expr) {
+  if (Match(holder, Filter())) {
+    return static_cast<FilterIR*>(holder)->SetFilterExpr(new_expr);
+  }
+  if (Match(holder, Map())) {
+    return static_cast<MapIR*>(holder)->UpdateColExpr(old_expr, new_expr);
+  }
+  if (Match(holder, Func())) {
+    return static_cast<FuncIR*>(holder)->UpdateArg(old_expr, new_expr);
+  }
+  return error::Internal("Unexpected parent expression type: $0", holder->type_string());
+}
+
+// Adds the column to the output of the operator, which must already have it in its input.
+Status PassColumnThrough(OperatorIR* op, const std::string& name, types::DataType data_type,
+                         TypePtr type) {
+  if (Match(op, Map())) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * col, MakeColumnRef(op, name, data_type, type));
+    PL_RETURN_IF_ERROR(static_cast<MapIR*>(op)->AddColExpr(ColumnExpression(name, col)));
+  }
+  auto relation = op->relation();
+  relation.AddColumn(data_type, name);
+  PL_RETURN_IF_ERROR(op->SetRelation(relation));
+  if (op->is_type_resolved() && type != nullptr) {
+    auto table_type = std::static_pointer_cast<TableType>(op->resolved_type()->Copy());
+    table_type->AddColumn(name, type);
+    PL_RETURN_IF_ERROR(op->SetResolvedType(table_type));
+  }
+  return Status::OK();
+}
+
+// Inserts a Map in front of the operator that passes its input through unchanged.
+StatusOr<MapIR*> InsertMapBefore(OperatorIR* op) {
+  DCHECK_EQ(1UL, op->parents().size());
+  OperatorIR* parent = op->parents()[0];
+  ColExpressionVector col_exprs;
+  for (const auto& col_name : parent->relation().col_names()) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * col, op->graph()->CreateNode<ColumnIR>(op->ast(), col_name,
+                                                                           /*parent_op_idx*/ 0));
+    col->ResolveColumnType(parent->relation());
+    col_exprs.emplace_back(col_name, col);
+  }
+  PL_ASSIGN_OR_RETURN(MapIR * map, op->graph()->CreateNode<MapIR>(op->ast(), parent, col_exprs,
+                                                                   /* keep_input_columns */ false));
+  PL_RETURN_IF_ERROR(op->ReplaceParent(parent, map));
+  return map;
+}
+
+}  // namespace
+
+StatusOr<bool> CommonSubexpressionEliminationRule::Apply(IRNode* ir_node) {
+  if (!IsMapOrFilter(ir_node)) {
+    return false;
+  }
+  auto head = static_cast<OperatorIR*>(ir_node);
+  DCHECK_EQ(1UL, head->parents().size());
+  OperatorIR* chain_parent = head->parents()[0];
+  // Only handle each chain once, starting from its first operator.
+  if (IsMapOrFilter(chain_parent) && chain_parent->Children().size() == 1) {
+    return false;
+  }
+  std::vector<OperatorIR*> chain{head};
+  while (chain.back()->Children().size() == 1 && IsMapOrFilter(chain.back()->Children()[0])) {
+    chain.push_back(chain.back()->Children()[0]);
+  }
+
+  // Count every function call in the chain by the value it computes.
+  ColumnSources sources;
+  for (const auto& col_name : chain_parent->relation().col_names()) {
+    sources[col_name] = col_name;
+  }
+  std::vector<ColumnSources> op_sources;
+  absl::flat_hash_map<std::string, int64_t> counts;
+  for (OperatorIR* op : chain) {
+    op_sources.push_back(sources);
+    for (ExpressionIR* expr : OperatorExpressions(op)) {
+      CountFuncs(expr, sources, compiler_state_->registry_info(), &counts);
+    }
+    sources = OutputColumnSources(op, sources);
+  }
+
+  // The keys are ordered by first use, so the chain operators before the first use of a key
+  // already pass along every earlier key that is still needed.
+  std::vector<std::string> keys;
+  absl::flat_hash_map<std::string, std::vector<Occurrence>> occurrences;
+  for (const auto& [op_idx, op] : Enumerate(chain)) {
+    for (ExpressionIR* expr : OperatorExpressions(op)) {
+      CollectRepeatedFuncs(op, expr, op_idx, op_sources[op_idx], compiler_state_->registry_info(),
+                           counts, &keys, &occurrences);
+    }
+  }
+  if (keys.empty()) {
+    return false;
+  }
+
+  absl::flat_hash_set<std::string> used_names;
+  for (const auto& col_name : chain_parent->relation().col_names()) {
+    used_names.insert(col_name);
+  }
+  for (OperatorIR* op : chain) {
+    for (const auto& col_name : op->relation().col_names()) {
+      used_names.insert(col_name);
+    }
+  }
+
+  // The Maps computing the repeated calls, keyed by the index of the operator they precede.
+  absl::flat_hash_map<size_t, MapIR*> hoisted_maps;
+  std::vector<MapIR*> new_maps;
+  for (const auto& key : keys) {
+    const auto& key_occurrences = occurrences[key];
+    // Other occurrences of this call may have been collected as part of a larger repeated call.
+    if (key_occurrences.size() < 2) {
+      continue;
+    }
+    const Occurrence& first = key_occurrences.front();
+    const Occurrence& last = key_occurrences.back();
+    if (!hoisted_maps.contains(first.op_idx)) {
+      PL_ASSIGN_OR_RETURN(hoisted_maps[first.op_idx], InsertMapBefore(chain[first.op_idx]));
+      new_maps.push_back(hoisted_maps[first.op_idx]);
+    }
+    MapIR* map = hoisted_maps[first.op_idx];
+    std::string name = UniqueColumnName(first.func, &used_names);
+    types::DataType data_type = first.func->EvaluatedDataType();
+    TypePtr type = first.func->resolved_type();
+
+    // The first occurrence reads the same input columns as the Map, so it is moved there as is.
+    PL_RETURN_IF_ERROR(map->AddColExpr(ColumnExpression(name, first.func)));
+    for (const Occurrence& occurrence : key_occurrences) {
+      PL_ASSIGN_OR_RETURN(ColumnIR * col, MakeColumnRef(occurrence.holder, name, data_type, type));
+      PL_RETURN_IF_ERROR(ReplaceExpression(occurrence.holder, occurrence.func, col));
+    }
+    for (size_t op_idx = first.op_idx; op_idx < last.op_idx; ++op_idx) {
+      PL_RETURN_IF_ERROR(PassColumnThrough(chain[op_idx], name, data_type, type));
+    }
+  }
+
+  for (MapIR* map : new_maps) {
+    PL_RETURN_IF_ERROR(map->SetRelationFromExprs());
+    if (map->parents()[0]->is_type_resolved()) {
+      PL_RETURN_IF_ERROR(ResolveOperatorType(map, compiler_state_));
+    }
+  }
+  return !new_maps.empty();
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+/**
+ * @brief Evaluates function calls that are repeated within a chain of consecutive Map and Filter
+ * operators only once, such as `px.upid_to_service_name(df.upid)` used in a filter and again in a
+ * map.
+ *
+ * A repeated call is moved into a new Map inserted right before the operator that first uses it.
+ * Every occurrence is replaced by a reference to the new column, which is passed along the chain
+ * up to its last use and dropped after that. Calls are compared on the chain input columns they
+ * read, so renaming a column in between doesn't hide a repeat. Calls to UDFs that the registry
+ * marks as nondeterministic are never shared.
+ *
+ * A Filter that reads a hoisted column can no longer be pushed above the new Map, so this rule
+ * runs in the PreSplitOptimizer, after the filters have been pushed down. The new Map forwards
+ * every column of its parent; the PreSplitOptimizer prunes the unused ones afterwards. Plans that
+ * are compiled without the distributed planner don't run this rule.
+ */
+class CommonSubexpressionEliminationRule : public Rule {
+ public:
+  explicit CommonSubexpressionEliminationRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ true, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+};
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
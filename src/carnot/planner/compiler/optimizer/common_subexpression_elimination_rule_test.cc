@@ -0,0 +1,176 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/optimizer/common_subexpression_elimination_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using table_store::schema::Relation;
+
+class CommonSubexpressionEliminationRuleTest : public RulesTest {
+ protected:
+  FuncIR* MakeServiceFunc(const std::string& upid_col, const Relation& relation,
+                          const std::string& func_name = "upid_to_service_name") {
+    auto func = MakeFunc(func_name, {MakeColumn(upid_col, 0, relation)}, types::DataType::STRING);
+    func->SetRegistryArgTypes({types::UINT128});
+    return func;
+  }
+};
+
+TEST_F(CommonSubexpressionEliminationRuleTest, filter_and_map) {
+  auto relation = MakeRelation();
+  auto src = MakeMemSource(relation);
+  auto filter =
+      MakeFilter(src, MakeEqualsFunc(MakeServiceFunc("count", relation), MakeString("svc")));
+  ASSERT_OK(filter->SetRelation(relation));
+  auto map = MakeMap(filter, {{"cpu0", MakeColumn("cpu0", 0, relation)},
+                              {"service", MakeServiceFunc("count", relation)}});
+  Relation map_relation({types::DataType::FLOAT64, types::DataType::STRING}, {"cpu0", "service"});
+  ASSERT_OK(map->SetRelation(map_relation));
+  MakeMemSink(map, "out");
+
+  CommonSubexpressionEliminationRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  // The service name is computed once, in a Map in front of the filter.
+  ASSERT_MATCH(filter->parents()[0], Map());
+  auto hoisted = static_cast<MapIR*>(filter->parents()[0]);
+  EXPECT_EQ(src, hoisted->parents()[0]);
+  ASSERT_EQ(5, hoisted->col_exprs().size());
+  const auto& service_expr = hoisted->col_exprs()[4];
+  EXPECT_EQ("_upid_to_service_name_0", service_expr.name);
+  EXPECT_MATCH(service_expr.node, Func());
+  EXPECT_EQ(types::DataType::STRING, hoisted->relation().GetColumnType(service_expr.name));
+
+  // The filter reads the new column and passes it on to the map, which doesn't output it.
+  ASSERT_MATCH(filter->filter_expr(), Func());
+  auto filter_func = static_cast<FuncIR*>(filter->filter_expr());
+  EXPECT_MATCH(filter_func->all_args()[0], ColumnNode(service_expr.name));
+  EXPECT_TRUE(filter->relation().HasColumn(service_expr.name));
+  EXPECT_MATCH(map->col_exprs()[1].node, ColumnNode(service_expr.name));
+  EXPECT_EQ(map_relation, map->relation());
+
+  // Running the rule again finds nothing left to share.
+  result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+}
+
+TEST_F(CommonSubexpressionEliminationRuleTest, renamed_column_across_maps) {
+  auto relation = MakeRelation();
+  auto src = MakeMemSource(relation);
+  auto map1 = MakeMap(src, {{"upid", MakeColumn("count", 0, relation)},
+                            {"service", MakeServiceFunc("count", relation)}});
+  Relation map1_relation({types::DataType::INT64, types::DataType::STRING}, {"upid", "service"});
+  ASSERT_OK(map1->SetRelation(map1_relation));
+  auto map2 = MakeMap(map1, {{"service", MakeColumn("service", 0, map1_relation)},
+                             {"other_service", MakeServiceFunc("upid", map1_relation)}});
+  Relation map2_relation({types::DataType::STRING, types::DataType::STRING},
+                         {"service", "other_service"});
+  ASSERT_OK(map2->SetRelation(map2_relation));
+  MakeMemSink(map2, "out");
+
+  CommonSubexpressionEliminationRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  // `upid` is `count` renamed, so both maps compute the same service name.
+  ASSERT_MATCH(map1->parents()[0], Map());
+  auto hoisted = static_cast<MapIR*>(map1->parents()[0]);
+  const auto& service_expr = hoisted->col_exprs().back();
+  EXPECT_MATCH(service_expr.node, Func());
+  EXPECT_MATCH(map1->col_exprs()[1].node, ColumnNode(service_expr.name));
+  EXPECT_MATCH(map2->col_exprs()[1].node, ColumnNode(service_expr.name));
+  // The first map passes the column along to the second one.
+  ASSERT_EQ(3, map1->col_exprs().size());
+  EXPECT_EQ(service_expr.name, map1->col_exprs()[2].name);
+  EXPECT_MATCH(map1->col_exprs()[2].node, ColumnNode(service_expr.name));
+  EXPECT_TRUE(map1->relation().HasColumn(service_expr.name));
+  EXPECT_EQ(map2_relation, map2->relation());
+}
+
+TEST_F(CommonSubexpressionEliminationRuleTest, computed_column_is_not_shared) {
+  auto relation = MakeRelation();
+  auto src = MakeMemSource(relation);
+  // `count` is overwritten by the first map, so the calls read different values.
+  auto map1 = MakeMap(src, {{"count", MakeAddFunc(MakeColumn("count", 0, relation), MakeInt(1))},
+                            {"service", MakeServiceFunc("count", relation)}});
+  Relation map1_relation({types::DataType::INT64, types::DataType::STRING}, {"count", "service"});
+  ASSERT_OK(map1->SetRelation(map1_relation));
+  auto map2 = MakeMap(map1, {{"service", MakeColumn("service", 0, map1_relation)},
+                             {"other_service", MakeServiceFunc("count", map1_relation)}});
+  ASSERT_OK(map2->SetRelation(Relation({types::DataType::STRING, types::DataType::STRING},
+                                       {"service", "other_service"})));
+  MakeMemSink(map2, "out");
+
+  CommonSubexpressionEliminationRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_EQ(src, map1->parents()[0]);
+}
+
+constexpr char kNondeterministicUDF[] = R"proto(
+  scalar_udfs {
+    name: "sampled_service_name"
+    exec_arg_types: UINT128
+    return_type: STRING
+    nondeterministic: true
+  }
+)proto";
+
+TEST_F(CommonSubexpressionEliminationRuleTest, nondeterministic_func_is_not_shared) {
+  auto info_pb = info_->info_pb();
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kNondeterministicUDF, &info_pb));
+  ASSERT_OK(info_->Init(info_pb));
+
+  auto relation = MakeRelation();
+  auto src = MakeMemSource(relation);
+  auto filter_func = MakeServiceFunc("count", relation, "sampled_service_name");
+  auto filter = MakeFilter(src, MakeEqualsFunc(filter_func, MakeString("svc")));
+  ASSERT_OK(filter->SetRelation(relation));
+  auto map_func = MakeServiceFunc("count", relation, "sampled_service_name");
+  auto map = MakeMap(filter, {{"service", map_func}});
+  ASSERT_OK(map->SetRelation(Relation({types::DataType::STRING}, {"service"})));
+  MakeMemSink(map, "out");
+
+  // Each call may return a different value, so both stay in place.
+  CommonSubexpressionEliminationRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_EQ(src, filter->parents()[0]);
+  EXPECT_EQ(map_func, map->col_exprs()[0].node);
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -26,6 +26,7 @@
 #include "src/carnot/planner/compiler/optimizer/merge_nodes_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unconnected_operators_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unused_columns_rule.h"
+#include "src/carnot/planner/compiler/optimizer/select_join_build_side_rule.h"
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/compiler_state/registry_info.h"
 #include "src/carnot/planner/ir/ir.h"
@@ -62,10 +63,16 @@ class Optimizer : public RuleExecutor<IR> {
     prune_unused_columns->AddRule<PruneUnusedColumnsRule>();
   }
 
+  void CreateSelectJoinBuildSideBatch() {
+    RuleBatch* join_build_side = CreateRuleBatch<TryUntilMax>("SelectJoinBuildSide", 1);
+    join_build_side->AddRule<SelectJoinBuildSideRule>(compiler_state_);
+  }
+
   Status Init() {
     CreatePruneUnconnectedOpsBatch();
     CreateMergeNodesBatch();
     CreatePruneUnusedColumnsBatch();
+    CreateSelectJoinBuildSideBatch();
     return Status::OK();
   }
 
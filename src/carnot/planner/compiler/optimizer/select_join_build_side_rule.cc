@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+
+#include "src/carnot/planner/compiler/optimizer/select_join_build_side_rule.h"
+#include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/join_ir.h"
+#include "src/carnot/planner/ir/limit_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+namespace {
+// Fraction of its input that a filter is assumed to keep.
+constexpr double kFilterSelectivity = 0.5;
+// Fraction of its input that a grouped aggregate is assumed to output. Aggregates over a group
+// key usually collapse their input by orders of magnitude.
+constexpr double kGroupedAggSelectivity = 0.1;
+}  // namespace
+
+std::optional<double> SelectJoinBuildSideRule::EstimateNumRows(OperatorIR* op) {
+  auto it = estimates_.find(op);
+  if (it != estimates_.end()) {
+    return it->second;
+  }
+  auto estimate = EstimateNumRowsImpl(op);
+  estimates_[op] = estimate;
+  return estimate;
+}
+
+std::optional<double> SelectJoinBuildSideRule::EstimateNumRowsImpl(OperatorIR* op) {
+  if (Match(op, MemorySource())) {
+    auto num_rows = compiler_state_->TableNumRows(static_cast<MemorySourceIR*>(op)->table_name());
+    if (!num_rows.has_value()) {
+      return std::nullopt;
+    }
+    return static_cast<double>(num_rows.value());
+  }
+  if (Match(op, EmptySource())) {
+    return 0;
+  }
+  if (op->parents().empty()) {
+    return std::nullopt;
+  }
+
+  if (Match(op, Union()) || Match(op, Join())) {
+    double total = 0;
+    double largest = 0;
+    for (OperatorIR* parent : op->parents()) {
+      auto parent_rows = EstimateNumRows(parent);
+      if (!parent_rows.has_value()) {
+        return std::nullopt;
+      }
+      total += parent_rows.value();
+      largest = std::max(largest, parent_rows.value());
+    }
+    // Assume joins mostly match each row of the larger side with a single row of the other.
+    return Match(op, Union()) ? total : largest;
+  }
+
+  DCHECK_EQ(1U, op->parents().size());
+  auto parent_rows = EstimateNumRows(op->parents()[0]);
+  if (Match(op, Limit())) {
+    // The limit caps the output even if the size of the input is unknown.
+    auto limit = static_cast<double>(static_cast<LimitIR*>(op)->limit_value());
+    return parent_rows.has_value() ? std::min(limit, parent_rows.value()) : limit;
+  }
+  if (!parent_rows.has_value()) {
+    return std::nullopt;
+  }
+  if (Match(op, Filter())) {
+    return parent_rows.value() * kFilterSelectivity;
+  }
+  if (Match(op, BlockingAgg())) {
+    if (static_cast<BlockingAggIR*>(op)->groups().empty()) {
+      return 1;
+    }
+    return parent_rows.value() * kGroupedAggSelectivity;
+  }
+  // Maps, drops and the remaining single parent operators output a row per input row.
+  return parent_rows;
+}
+
+StatusOr<bool> SelectJoinBuildSideRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Join())) {
+    return false;
+  }
+  JoinIR* join = static_cast<JoinIR*>(ir_node);
+  DCHECK_EQ(2U, join->parents().size());
+  auto left_rows = EstimateNumRows(join->parents()[0]);
+  auto right_rows = EstimateNumRows(join->parents()[1]);
+  if (!left_rows.has_value() || !right_rows.has_value()) {
+    return false;
+  }
+
+  int64_t build_parent_idx = right_rows.value() < left_rows.value() ? 1 : 0;
+  if (build_parent_idx == join->build_parent_idx()) {
+    return false;
+  }
+  join->set_build_parent_idx(build_parent_idx);
+  return true;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <optional>
+
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+/**
+ * @brief Chooses which parent of each join the hash table is built from. The executor buffers
+ * the whole build side in memory and streams the other side through it, so the build side should
+ * be the smaller input. Input sizes are estimated from the row counts of the tables in the
+ * CompilerState. Joins with an input of unknown size keep the default build side.
+ */
+class SelectJoinBuildSideRule : public Rule {
+ public:
+  explicit SelectJoinBuildSideRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ false, /*reverse_topological_execution*/ false) {}
+
+  /**
+   * @brief Estimates the number of rows output by the operator, or std::nullopt if there isn't
+   * enough information to make an estimate.
+   */
+  std::optional<double> EstimateNumRows(OperatorIR* op);
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+
+ private:
+  std::optional<double> EstimateNumRowsImpl(OperatorIR* op);
+
+  // Memoizes the estimates, since operators can feed several joins.
+  absl::flat_hash_map<OperatorIR*, std::optional<double>> estimates_;
+};
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
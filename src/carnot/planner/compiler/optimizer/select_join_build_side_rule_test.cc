@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/optimizer/select_join_build_side_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using SelectJoinBuildSideRuleTest = RulesTest;
+
+TEST_F(SelectJoinBuildSideRuleTest, build_from_smaller_parent) {
+  compiler_state_->set_table_num_rows({{"big", 1000000}, {"small", 100}});
+  auto relation = MakeRelation();
+  auto big = MakeMemSource("big", relation);
+  auto small = MakeMemSource("small", relation);
+  JoinIR* join = MakeJoin({big, small}, "inner", relation, relation, {"count"}, {"count"});
+  MakeMemSink(join, "out");
+  EXPECT_EQ(0, join->build_parent_idx());
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+  EXPECT_EQ(1, join->build_parent_idx());
+
+  planpb::Operator op;
+  ASSERT_OK(join->ToProto(&op));
+  EXPECT_EQ(1, op.join_op().build_parent_index());
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, unknown_size_keeps_default) {
+  compiler_state_->set_table_num_rows({{"big", 1000000}});
+  auto relation = MakeRelation();
+  auto big = MakeMemSource("big", relation);
+  auto unknown = MakeMemSource("unknown", relation);
+  JoinIR* join = MakeJoin({big, unknown}, "inner", relation, relation, {"count"}, {"count"});
+  MakeMemSink(join, "out");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_EQ(0, join->build_parent_idx());
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, estimates_through_operators) {
+  compiler_state_->set_table_num_rows({{"big", 1000000}, {"medium", 500000}});
+  auto relation = MakeRelation();
+  auto big = MakeMemSource("big", relation);
+  auto medium = MakeMemSource("medium", relation);
+  auto unknown = MakeMemSource("unknown", relation);
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto grouped_agg = MakeBlockingAgg(big, {MakeColumn("count", 0)},
+                                     {{"mean", MakeMeanFunc(MakeColumn("cpu0", 0))}});
+  EXPECT_DOUBLE_EQ(100000, rule.EstimateNumRows(grouped_agg).value());
+  auto agg = MakeBlockingAgg(big, {}, {{"mean", MakeMeanFunc(MakeColumn("cpu0", 0))}});
+  EXPECT_DOUBLE_EQ(1, rule.EstimateNumRows(agg).value());
+  EXPECT_DOUBLE_EQ(250000, rule.EstimateNumRows(MakeFilter(medium)).value());
+  EXPECT_DOUBLE_EQ(10, rule.EstimateNumRows(MakeLimit(big, 10)).value());
+  EXPECT_DOUBLE_EQ(10, rule.EstimateNumRows(MakeLimit(unknown, 10)).value());
+  EXPECT_FALSE(rule.EstimateNumRows(MakeFilter(unknown)).has_value());
+  EXPECT_DOUBLE_EQ(1500000, rule.EstimateNumRows(MakeUnion({big, medium})).value());
+
+  // The aggregate on the big table is smaller than the medium table, so build from it.
+  JoinIR* join = MakeJoin({grouped_agg, medium}, "inner", relation, relation, {"count"}, {"count"});
+  MakeMemSink(join, "out");
+  ASSERT_OK(rule.Execute(graph.get()));
+  EXPECT_EQ(0, join->build_parent_idx());
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -20,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -84,6 +85,8 @@ class IDRegistryKey {
 };
 
 using RelationMap = std::unordered_map<std::string, table_store::schema::Relation>;
+// Maps table name to the estimated number of rows held in that table.
+using TableNumRowsMap = std::unordered_map<std::string, int64_t>;
 class CompilerState : public NotCopyable {
  public:
   /**
@@ -140,6 +143,22 @@ class CompilerState : public NotCopyable {
   int64_t max_output_rows_per_table() { return max_output_rows_per_table_; }
   bool has_max_output_rows_per_table() { return max_output_rows_per_table_ > 0; }
 
+  /**
+   * @brief Sets the estimated row counts of the tables, used for cost-based decisions such as
+   * choosing which side of a join to build the hash table from.
+   */
+  void set_table_num_rows(const TableNumRowsMap& table_num_rows) {
+    table_num_rows_ = table_num_rows;
+  }
+  // Returns the estimated row count of the table, or std::nullopt if it isn't known.
+  std::optional<int64_t> TableNumRows(const std::string& table_name) const {
+    auto it = table_num_rows_.find(table_name);
+    if (it == table_num_rows_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
  private:
   std::unique_ptr<RelationMap> relation_map_;
   RegistryInfo* registry_info_;
@@ -148,6 +167,7 @@ class CompilerState : public NotCopyable {
   std::map<IDRegistryKey, int64_t> uda_to_id_map_;
 
   int64_t max_output_rows_per_table_ = 0;
+  TableNumRowsMap table_num_rows_;
   const std::string result_address_;
   const std::string result_ssl_targetname_;
 };
@@ -95,6 +95,7 @@ Status RegistryInfo::Init(const udfspb::UDFInfo& info) {
     auto key = RegistryKey(udf.name(), arg_types);
     udf_map_[key] = udf.return_type();
     udf_executor_map_[key] = udf.executor();
+    udf_deterministic_map_[key] = !udf.nondeterministic();
     num_init_args_map_[key] = udf.init_arg_types_size();
 
     // Add udf to funcs_.
@@ -117,10 +118,11 @@ Status RegistryInfo::Init(const udfspb::UDFInfo& info) {
 }
 
 StatusOr<UDFExecType> RegistryInfo::GetUDFExecType(std::string_view name) {
-  if (!funcs_.contains(name)) {
+  auto it = funcs_.find(name);
+  if (it == funcs_.end()) {
     return error::InvalidArgument("Could not find function '$0'.", name);
   }
-  return funcs_[name];
+  return it->second;
 }
 
 absl::flat_hash_set<std::string> RegistryInfo::func_names() const {
@@ -178,6 +180,15 @@ StatusOr<udfspb::UDFSourceExecutor> RegistryInfo::GetUDFSourceExecutor(
   return udf->second;
 }
 
+StatusOr<bool> RegistryInfo::IsUDFDeterministic(std::string name,
+                                                std::vector<types::DataType> exec_arg_types) {
+  auto udf = udf_deterministic_map_.find(RegistryKey(name, exec_arg_types));
+  if (udf == udf_deterministic_map_.end()) {
+    return FormatMissingUDFError(name, exec_arg_types);
+  }
+  return udf->second;
+}
+
 StatusOr<std::shared_ptr<ValueType>> RegistryInfo::ResolveUDFType(
     std::string name, const std::vector<std::shared_ptr<ValueType>>& arg_types) {
   std::vector<types::DataType> arg_data_types;
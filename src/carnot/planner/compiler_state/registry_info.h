@@ -129,6 +129,7 @@ class RegistryInfo {
                                            std::vector<types::DataType> arg_types);
   StatusOr<udfspb::UDFSourceExecutor> GetUDFSourceExecutor(std::string name,
                                                            std::vector<types::DataType> arg_types);
+  StatusOr<bool> IsUDFDeterministic(std::string name, std::vector<types::DataType> arg_types);
 
   StatusOr<bool> DoesUDASupportPartial(std::string name, std::vector<types::DataType> arg_types);
 
@@ -165,6 +166,7 @@ class RegistryInfo {
   std::map<RegistryKey, types::DataType> udf_map_;
   std::map<RegistryKey, types::DataType> uda_map_;
   std::map<RegistryKey, udfspb::UDFSourceExecutor> udf_executor_map_;
+  std::map<RegistryKey, bool> udf_deterministic_map_;
 
   std::map<RegistryKey, size_t> num_init_args_map_;
 
@@ -62,6 +62,7 @@ scalar_udfs {
   exec_arg_types: INT64
   return_type: INT64
   executor: UDF_KELVIN
+  nondeterministic: true
 }
 scalar_udfs {
   name: "init_arg_scalar"
@@ -160,6 +161,22 @@ TEST(RegistryInfo, udf_executor) {
       "scalar1", std::vector<types::DataType>({types::FLOAT64, types::FLOAT64})));
 }
 
+TEST(RegistryInfo, udf_deterministic) {
+  auto info = RegistryInfo();
+  udfspb::UDFInfo info_pb;
+  google::protobuf::TextFormat::MergeFromString(kExpectedUDFInfo, &info_pb);
+  EXPECT_OK(info.Init(info_pb));
+
+  EXPECT_TRUE(info.IsUDFDeterministic("add", std::vector<types::DataType>(
+                                                 {types::FLOAT64, types::FLOAT64}))
+                  .ConsumeValueOrDie());
+  EXPECT_FALSE(info.IsUDFDeterministic("scalar1", std::vector<types::DataType>(
+                                                      {types::BOOLEAN, types::INT64}))
+                   .ConsumeValueOrDie());
+  EXPECT_NOT_OK(info.IsUDFDeterministic(
+      "scalar1", std::vector<types::DataType>({types::FLOAT64, types::FLOAT64})));
+}
+
 TEST(RegistryInfo, init_args) {
   auto info = RegistryInfo();
   udfspb::UDFInfo info_pb;
@@ -59,6 +59,11 @@ StatusOr<std::unique_ptr<DistributedPlan>> Coordinator::Coordinate(const IR* log
   return CoordinateImpl(logical_plan);
 }
 
+StatusOr<std::unique_ptr<DistributedPlan>> Coordinator::CoordinateSplitPlan(
+    const BlockingSplitPlan& split_plan) {
+  return CoordinateSplitPlanImpl(split_plan);
+}
+
 Status CoordinatorImpl::InitImpl(CompilerState* compiler_state,
                                  const distributedpb::DistributedState& distributed_state) {
   compiler_state_ = compiler_state;
@@ -237,17 +242,21 @@ StatusOr<SchemaToAgentsMap> LoadSchemaMap(
 }
 
 StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const IR* logical_plan) {
-  // TODO(zasgar) set support_partial_agg to true to enable partial aggs.
   PL_ASSIGN_OR_RETURN(std::unique_ptr<Splitter> splitter,
-                      Splitter::Create(compiler_state_, /* support_partial_agg */ false));
+                      Splitter::Create(compiler_state_, /* support_partial_agg */ true));
   PL_ASSIGN_OR_RETURN(std::unique_ptr<BlockingSplitPlan> split_plan,
                       splitter->SplitKelvinAndAgents(logical_plan));
+  return CoordinateSplitPlanImpl(*split_plan);
+}
+
+StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateSplitPlanImpl(
+    const BlockingSplitPlan& split_plan) {
   auto distributed_plan = std::make_unique<DistributedPlan>();
   PL_ASSIGN_OR_RETURN(int64_t remote_node_id, distributed_plan->AddCarnot(GetRemoteProcessor()));
   // TODO(philkuz) Need to update the Blocking Split Plan to better represent what we expect.
   // TODO(philkuz) (PL-1469) Future support for grabbing data from multiple Kelvin nodes.
 
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> remote_plan_uptr, split_plan->original_plan->Clone());
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> remote_plan_uptr, split_plan.original_plan->Clone());
   CarnotInstance* remote_carnot = distributed_plan->Get(remote_node_id);
 
   IR* remote_plan = remote_plan_uptr.get();
@@ -265,7 +274,7 @@ StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const
                       LoadSchemaMap(*distributed_state_, distributed_plan->uuid_to_id_map()));
 
   PL_ASSIGN_OR_RETURN(auto agent_to_plan_map,
-                      GetUniquePEMPlans(split_plan->before_blocking.get(), distributed_plan.get(),
+                      GetUniquePEMPlans(split_plan.before_blocking.get(), distributed_plan.get(),
                                         source_node_ids, agent_schema_map));
 
   // Add the PEM plans to the distributed plan.
@@ -24,6 +24,7 @@
 
 #include <absl/container/flat_hash_map.h>
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
+#include "src/carnot/planner/distributed/splitter/splitter.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/pattern_match.h"
 
@@ -58,6 +59,14 @@ class Coordinator : public NotCopyable {
    */
   StatusOr<std::unique_ptr<DistributedPlan>> Coordinate(const IR* logical_plan);
 
+  /**
+   * @brief Same as Coordinate, but takes a plan that the Splitter has already split.
+   * @param split_plan: the plan split along blocking lines.
+   * @return StatusOr<std::unique_ptr<DistributedPlan>>
+   */
+  StatusOr<std::unique_ptr<DistributedPlan>> CoordinateSplitPlan(
+      const BlockingSplitPlan& split_plan);
+
   Status Init(CompilerState* compiler_state,
               const distributedpb::DistributedState& distributed_state);
 
@@ -74,6 +83,8 @@ class Coordinator : public NotCopyable {
    * @return StatusOr<CarnotGraph>
    */
   virtual StatusOr<std::unique_ptr<DistributedPlan>> CoordinateImpl(const IR* logical_plan) = 0;
+  virtual StatusOr<std::unique_ptr<DistributedPlan>> CoordinateSplitPlanImpl(
+      const BlockingSplitPlan& split_plan) = 0;
 
   virtual Status ProcessConfigImpl(const CarnotInfo& carnot_info) = 0;
 };
@@ -86,6 +97,8 @@ class Coordinator : public NotCopyable {
 class CoordinatorImpl : public Coordinator {
  protected:
   StatusOr<std::unique_ptr<DistributedPlan>> CoordinateImpl(const IR* logical_plan) override;
+  StatusOr<std::unique_ptr<DistributedPlan>> CoordinateSplitPlanImpl(
+      const BlockingSplitPlan& split_plan) override;
   Status InitImpl(CompilerState* compiler_state,
                   const distributedpb::DistributedState& distributed_state) override;
   Status ProcessConfigImpl(const CarnotInfo& carnot_info) override;
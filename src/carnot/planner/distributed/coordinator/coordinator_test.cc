@@ -26,6 +26,7 @@
 
 #include "src/carnot/planner/compiler/test_utils.h"
 #include "src/carnot/planner/distributed/coordinator/coordinator.h"
+#include "src/carnot/planner/distributed/distributed_planner.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/rules/rules.h"
 #include "src/carnot/planner/test_utils.h"
@@ -597,6 +598,120 @@ TEST_F(CoordinatorTest, prune_agent_on_pem_udtf) {
   EXPECT_EQ(1, kelvin_sources.size());
 }
 
+constexpr char kPartialAggQuery[] = R"pxl(
+import px
+
+df = px.DataFrame(table='http_events', start_time='-120s')
+df = df.groupby('req_method').agg(count=('remote_port', px.count),
+                                  mean=('remote_port', px.mean),
+                                  quantiles=('remote_port', px.quantiles))
+px.display(df, 't1')
+)pxl";
+
+TEST_F(CoordinatorTest, partial_agg) {
+  auto physical_plan = ThreeAgentOneKelvinCoordinateQuery(kPartialAggQuery);
+  ASSERT_EQ(physical_plan->dag().nodes().size(), 4UL);
+
+  absl::flat_hash_map<std::string, IR*> plan_by_qb_addr;
+  for (int64_t carnot_id : physical_plan->dag().nodes()) {
+    auto carnot = physical_plan->Get(carnot_id);
+    EXPECT_NE(carnot->plan(), nullptr) << carnot->QueryBrokerAddress();
+    plan_by_qb_addr[carnot->QueryBrokerAddress()] = carnot->plan();
+  }
+
+  // Each PEM aggregates its own data and sends the serialized UDA states to the Kelvin.
+  for (const auto& pem : {"pem1", "pem2", "pem3"}) {
+    SCOPED_TRACE(pem);
+    ASSERT_TRUE(plan_by_qb_addr.contains(pem));
+    auto partial_aggs = plan_by_qb_addr[pem]->FindNodesThatMatch(PartialAgg());
+    ASSERT_EQ(partial_aggs.size(), 1);
+    auto partial_agg = static_cast<BlockingAggIR*>(partial_aggs[0]);
+    ASSERT_EQ(partial_agg->Children().size(), 1);
+    EXPECT_MATCH(partial_agg->Children()[0], GRPCSink());
+    EXPECT_EQ(plan_by_qb_addr[pem]->FindNodesThatMatch(FullAgg()).size(), 0);
+  }
+
+  // The Kelvin only merges the partial aggregates.
+  auto kelvin_plan = plan_by_qb_addr["kelvin"];
+  auto finalize_aggs = kelvin_plan->FindNodesThatMatch(FinalizeAgg());
+  ASSERT_EQ(finalize_aggs.size(), 1);
+  auto finalize_agg = static_cast<BlockingAggIR*>(finalize_aggs[0]);
+  EXPECT_MATCH(finalize_agg->parents()[0], GRPCSourceGroup());
+  EXPECT_EQ(kelvin_plan->FindNodesThatMatch(FullAgg()).size(), 0);
+
+  planpb::Operator op;
+  ASSERT_OK(finalize_agg->ToProto(&op));
+  EXPECT_FALSE(op.agg_op().partial_agg());
+  EXPECT_TRUE(op.agg_op().finalize_results());
+  EXPECT_EQ(op.agg_op().values_size(), 3);
+
+  // Once stitched, every PEM sends its partial agg to a GRPC source of the Kelvin, which feeds the
+  // finalize agg.
+  compiler::Compiler compiler;
+  auto graph = compiler.CompileToIR(kPartialAggQuery, compiler_state_.get()).ConsumeValueOrDie();
+  auto distributed_planner = distributed::DistributedPlanner::Create().ConsumeValueOrDie();
+  auto stitched_plan = distributed_planner
+                           ->Plan(ThreeAgentOneKelvinStateWithMetadataInfo(),
+                                  compiler_state_.get(), graph.get())
+                           .ConsumeValueOrDie();
+  ASSERT_OK_AND_ASSIGN(auto plan_pb, stitched_plan->ToProto());
+
+  absl::flat_hash_map<std::string, std::vector<planpb::Operator>> ops_by_qb_addr;
+  for (const auto& [qb_addr, plan] : plan_pb.qb_address_to_plan()) {
+    for (const auto& fragment : plan.nodes()) {
+      for (const auto& node : fragment.nodes()) {
+        ops_by_qb_addr[qb_addr].push_back(node.op());
+      }
+    }
+  }
+  ASSERT_THAT(ops_by_qb_addr,
+              UnorderedElementsAre(Key("pem1"), Key("pem2"), Key("pem3"), Key("kelvin")));
+
+  absl::flat_hash_set<uint64_t> kelvin_grpc_source_ids;
+  for (const auto& [qb_addr, plan] : plan_pb.qb_address_to_plan()) {
+    if (qb_addr != "kelvin") {
+      continue;
+    }
+    for (const auto& fragment : plan.nodes()) {
+      for (const auto& node : fragment.nodes()) {
+        if (node.op().op_type() == planpb::GRPC_SOURCE_OPERATOR) {
+          kelvin_grpc_source_ids.insert(node.id());
+        }
+      }
+    }
+  }
+
+  for (const auto& pem : {"pem1", "pem2", "pem3"}) {
+    SCOPED_TRACE(pem);
+    int64_t num_partial_aggs = 0;
+    int64_t num_grpc_sinks = 0;
+    for (const auto& pem_op : ops_by_qb_addr[pem]) {
+      if (pem_op.op_type() == planpb::AGGREGATE_OPERATOR) {
+        EXPECT_TRUE(pem_op.agg_op().partial_agg());
+        EXPECT_FALSE(pem_op.agg_op().finalize_results());
+        ++num_partial_aggs;
+      }
+      if (pem_op.op_type() == planpb::GRPC_SINK_OPERATOR) {
+        EXPECT_TRUE(kelvin_grpc_source_ids.contains(pem_op.grpc_sink_op().grpc_source_id()));
+        ++num_grpc_sinks;
+      }
+    }
+    EXPECT_EQ(num_partial_aggs, 1);
+    EXPECT_EQ(num_grpc_sinks, 1);
+  }
+
+  int64_t num_finalize_aggs = 0;
+  for (const auto& kelvin_op : ops_by_qb_addr["kelvin"]) {
+    if (kelvin_op.op_type() == planpb::AGGREGATE_OPERATOR) {
+      EXPECT_FALSE(kelvin_op.agg_op().partial_agg());
+      EXPECT_TRUE(kelvin_op.agg_op().finalize_results());
+      EXPECT_EQ(kelvin_op.agg_op().values_size(), 3);
+      ++num_finalize_aggs;
+    }
+  }
+  EXPECT_EQ(num_finalize_aggs, 1);
+}
+
 constexpr char kExtraPEM[] = R"carnotinfo(
 query_broker_address: "pem5"
 agent_id {
@@ -126,46 +126,46 @@ class StringBloomFilterMatcher : public FilterExpressionMatcher {
       return true;
     }
 
+    return md_filter->ContainsAnyEntity(md_type_, entities_);
+  }
+
+  void ParseExpression(ExpressionIR* expr) override {
+    auto func = static_cast<FuncIR*>(expr);
+    int64_t val_idx = 0;
+    int64_t md_idx = 1;
+    if (Match(func->args()[1], String())) {
+      val_idx = 1;
+      md_idx = 0;
+    }
+    std::string val = static_cast<StringIR*>(func->args()[val_idx])->str();
+    md_type_ = static_cast<ExpressionIR*>(func->args()[md_idx])->annotations().metadata_type;
+
+    // The same values are checked against the filter of every agent, so they are hashed once here.
     // For cases like the following,
     // df.ctx['service'] == '["pl/svc1", "pl/svc2"]',
     // We would still like the expression to work.
     // However, the metadata filters will only store individual services,
     // not the JSON array. As a result, in the planner we will check for the
     // presence for either service in the Carnot instance when pruning the plan.
-
+    entities_.clear();
     rapidjson::Document doc;
-    doc.Parse(val_.c_str());
+    doc.Parse(val.c_str());
     if (!doc.IsArray()) {
-      return md_filter->ContainsEntity(md_type_, val_);
+      entities_.push_back(md::AgentMetadataFilter::HashEntity(md_type_, val));
+      return;
     }
-
     for (rapidjson::SizeType i = 0; i < doc.Size(); ++i) {
+      // Agents only match on the services before the first non-string element.
       if (!doc[i].IsString()) {
-        return false;
-      }
-      auto str = doc[i].GetString();
-      if (md_filter->ContainsEntity(md_type_, str)) {
-        return true;
+        break;
       }
+      entities_.push_back(md::AgentMetadataFilter::HashEntity(md_type_, doc[i].GetString()));
     }
-    return false;
-  }
-
-  void ParseExpression(ExpressionIR* expr) override {
-    auto func = static_cast<FuncIR*>(expr);
-    int64_t val_idx = 0;
-    int64_t md_idx = 1;
-    if (Match(func->args()[1], String())) {
-      val_idx = 1;
-      md_idx = 0;
-    }
-    val_ = static_cast<StringIR*>(func->args()[val_idx])->str();
-    md_type_ = static_cast<ExpressionIR*>(func->args()[md_idx])->annotations().metadata_type;
   }
 
  private:
-  std::string val_;
   MetadataType md_type_;
+  std::vector<md::AgentMetadataFilter::EntityHash> entities_;
 };
 
 MapRemovableOperatorsRule::MapRemovableOperatorsRule(
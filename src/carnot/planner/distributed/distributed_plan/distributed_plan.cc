@@ -18,32 +18,108 @@
 
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 
+#include <utility>
+#include <vector>
+
 namespace px {
 namespace carnot {
 namespace planner {
 namespace distributed {
 
+namespace {
+
+// The proto of a plan IR that is shared by every agent running it. Only the destinations of the
+// internal GRPCSinks depend on the agent, so the IR is serialized once and those are patched per
+// agent. This only saves the serialization: each agent still gets a full copy of the plan in
+// qb_address_to_plan, which is what the query broker fans out.
+struct PlanTemplate {
+  planpb::Plan plan;
+  // The index in the plan fragment and the IR node of each internal GRPCSink.
+  std::vector<std::pair<int, const GRPCSinkIR*>> grpc_sinks;
+  // The number of agents that have yet to receive the plan. The last one takes it over instead of
+  // copying it, so plans that are not shared are never copied.
+  int64_t remaining_uses = 0;
+};
+
+StatusOr<PlanTemplate> CreatePlanTemplate(const CarnotInstance* carnot) {
+  PlanTemplate plan_template;
+  PL_ASSIGN_OR_RETURN(plan_template.plan, carnot->PlanProto());
+  // IR::ToProto puts all operators into a single plan fragment.
+  DCHECK_EQ(1, plan_template.plan.nodes_size());
+  for (const auto& [node_idx, node_pb] : Enumerate(plan_template.plan.nodes(0).nodes())) {
+    if (node_pb.op().op_type() != planpb::GRPC_SINK_OPERATOR ||
+        !node_pb.op().grpc_sink_op().has_grpc_source_id()) {
+      continue;
+    }
+    auto sink = static_cast<const GRPCSinkIR*>(carnot->plan()->Get(node_pb.id()));
+    plan_template.grpc_sinks.emplace_back(node_idx, sink);
+  }
+  return plan_template;
+}
+
+planpb::GRPCSinkOperator* MutableGRPCSink(planpb::Plan* plan, int node_idx) {
+  return plan->mutable_nodes(0)->mutable_nodes(node_idx)->mutable_op()->mutable_grpc_sink_op();
+}
+
+StatusOr<int64_t> DestinationID(const GRPCSinkIR* sink, int64_t agent_id) {
+  const auto& destination_ids = sink->agent_id_to_destination_id();
+  auto it = destination_ids.find(agent_id);
+  if (it == destination_ids.end()) {
+    return error::Internal("No agent ID '$0' found in grpc sink '$1'", agent_id,
+                           sink->DebugString());
+  }
+  return it->second;
+}
+
+// Returns the template for the carnot's plan, creating it the first time the plan is seen.
+StatusOr<PlanTemplate*> GetPlanTemplate(const CarnotInstance* carnot,
+                                        absl::flat_hash_map<const IR*, PlanTemplate>* templates) {
+  auto it = templates->find(carnot->plan());
+  if (it == templates->end()) {
+    PL_ASSIGN_OR_RETURN(auto plan_template, CreatePlanTemplate(carnot));
+    it = templates->emplace(carnot->plan(), std::move(plan_template)).first;
+  }
+  return &it->second;
+}
+
+}  // namespace
+
 StatusOr<distributedpb::DistributedPlan> DistributedPlan::ToProto() const {
   distributedpb::DistributedPlan physical_plan_pb;
   auto physical_plan_dag = physical_plan_pb.mutable_dag();
   auto qb_address_to_plan_pb = physical_plan_pb.mutable_qb_address_to_plan();
   auto qb_address_to_dag_id_pb = physical_plan_pb.mutable_qb_address_to_dag_id();
 
-  for (int64_t i : dag_.TopologicalSort()) {
+  const std::vector<int64_t> carnot_ids = dag_.TopologicalSort();
+  absl::flat_hash_map<const IR*, PlanTemplate> templates;
+  for (int64_t i : carnot_ids) {
     CarnotInstance* carnot = Get(i);
     CHECK_EQ(carnot->id(), i) << absl::Substitute("Index in node ($1) and DAG ($0) don't agree.", i,
                                                   carnot->id());
     DCHECK(carnot->plan()) << absl::Substitute("$0 doesn't have a plan set.",
                                                carnot->DebugString());
-    PL_ASSIGN_OR_RETURN(auto plan_proto, carnot->PlanProto());
+    PL_ASSIGN_OR_RETURN(PlanTemplate * plan_template, GetPlanTemplate(carnot, &templates));
+    ++plan_template->remaining_uses;
+  }
+
+  for (int64_t i : carnot_ids) {
+    CarnotInstance* carnot = Get(i);
+    PlanTemplate& plan_template = templates.at(carnot->plan());
+    auto& plan_proto = (*qb_address_to_plan_pb)[carnot->QueryBrokerAddress()];
+    if (--plan_template.remaining_uses == 0) {
+      plan_proto = std::move(plan_template.plan);
+    } else {
+      plan_proto = plan_template.plan;
+    }
+    for (const auto& [node_idx, sink] : plan_template.grpc_sinks) {
+      PL_ASSIGN_OR_RETURN(int64_t destination_id, DestinationID(sink, carnot->id()));
+      MutableGRPCSink(&plan_proto, node_idx)->set_grpc_source_id(destination_id);
+    }
     for (int64_t parent_i : dag_.ParentsOf(i)) {
       *(plan_proto.add_incoming_agent_ids()) = Get(parent_i)->carnot_info().agent_id();
     }
-    (*qb_address_to_plan_pb)[carnot->QueryBrokerAddress()] = plan_proto;
+    plan_proto.mutable_plan_options()->CopyFrom(plan_options_);
     (*qb_address_to_dag_id_pb)[carnot->QueryBrokerAddress()] = i;
-
-    auto plan_opts = (*qb_address_to_plan_pb)[carnot->QueryBrokerAddress()].mutable_plan_options();
-    plan_opts->CopyFrom(plan_options_);
   }
   dag_.ToProto(physical_plan_dag);
   return physical_plan_pb;
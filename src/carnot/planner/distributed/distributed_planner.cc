@@ -72,11 +72,21 @@ Status StitchPlan(DistributedPlan* distributed_plan) {
 StatusOr<std::unique_ptr<DistributedPlan>> DistributedPlanner::Plan(
     const distributedpb::DistributedState& distributed_state, CompilerState* compiler_state,
     const IR* logical_plan) {
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<Splitter> splitter,
+                      Splitter::Create(compiler_state, /* support_partial_agg */ true));
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<BlockingSplitPlan> split_plan,
+                      splitter->SplitKelvinAndAgents(logical_plan));
+  return PlanSplit(distributed_state, compiler_state, *split_plan);
+}
+
+StatusOr<std::unique_ptr<DistributedPlan>> DistributedPlanner::PlanSplit(
+    const distributedpb::DistributedState& distributed_state, CompilerState* compiler_state,
+    const BlockingSplitPlan& split_plan) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<Coordinator> coordinator,
                       Coordinator::Create(compiler_state, distributed_state));
 
   PL_ASSIGN_OR_RETURN(std::unique_ptr<DistributedPlan> distributed_plan,
-                      coordinator->Coordinate(logical_plan));
+                      coordinator->CoordinateSplitPlan(split_plan));
 
   PL_RETURN_IF_ERROR(StitchPlan(distributed_plan.get()));
 
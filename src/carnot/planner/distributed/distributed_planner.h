@@ -26,6 +26,7 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/compiler_state/registry_info.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
+#include "src/carnot/planner/distributed/splitter/splitter.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/pattern_match.h"
 #include "src/carnot/planner/rules/rule_executor.h"
@@ -84,6 +85,20 @@ class DistributedPlanner : public NotCopyable, public Planner {
       const distributedpb::DistributedState& distributed_state, CompilerState* compiler_state,
       const IR* logical_plan) override;
 
+  /**
+   * @brief Takes in a logical plan that is already split into the Agent and Kelvin components and
+   * outputs the distributed plan. Plan() is the same as splitting with the Splitter and calling
+   * this.
+   *
+   * @param distributed_state: the distributed layout of the vizier instance.
+   * @param compiler_state: informastion passed to the compiler.
+   * @param split_plan: the logical plan split along blocking lines.
+   * @return StatusOr<std::unique_ptr<DistributedPlan>>
+   */
+  StatusOr<std::unique_ptr<DistributedPlan>> PlanSplit(
+      const distributedpb::DistributedState& distributed_state, CompilerState* compiler_state,
+      const BlockingSplitPlan& split_plan);
+
  private:
   DistributedPlanner() {}
 
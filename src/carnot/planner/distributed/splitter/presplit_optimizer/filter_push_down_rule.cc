@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <queue>
+#include <vector>
 
 #include "src/carnot/planner/distributed/splitter/executor_utils.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/filter_push_down_rule.h"
@@ -83,15 +84,58 @@ OperatorIR* FilterPushdownRule::HandleAggPushdown(BlockingAggIR* agg,
   return agg;
 }
 
-// Currently only supports single-parent, single-child operators.
-StatusOr<OperatorIR*> FilterPushdownRule::NextFilterLocation(
-    OperatorIR* current_node, bool filter_has_kelvin_only_udf,
-    ColumnNameMapping* column_name_mapping) {
-  if (current_node->parents().size() != 1) {
+OperatorIR* FilterPushdownRule::HandleJoinPushdown(JoinIR* join,
+                                                   ColumnNameMapping* column_name_mapping,
+                                                   int64_t* parent_idx) {
+  // The filter can't be placed in front of just one side of a self join.
+  if (join->parents()[0] == join->parents()[1]) {
+    return nullptr;
+  }
+  ColumnNameMapping reverse_column_name_mapping;
+  for (const auto& [old_name, cur_name] : *column_name_mapping) {
+    reverse_column_name_mapping[cur_name] = old_name;
+  }
+
+  // All of the filter columns must come from the same parent of the join.
+  int64_t filter_parent_idx = -1;
+  ColumnNameMapping parent_column_name_mapping = *column_name_mapping;
+  for (const auto& [idx, col_name] : Enumerate(join->column_names())) {
+    if (!reverse_column_name_mapping.contains(col_name)) {
+      continue;
+    }
+    ColumnIR* column = join->output_columns()[idx];
+    if (filter_parent_idx != -1 && filter_parent_idx != column->container_op_parent_idx()) {
+      return nullptr;
+    }
+    filter_parent_idx = column->container_op_parent_idx();
+    parent_column_name_mapping[reverse_column_name_mapping.at(col_name)] = column->col_name();
+  }
+  if (filter_parent_idx == -1) {
     return nullptr;
   }
 
-  OperatorIR* parent = current_node->parents()[0];
+  // Left joins keep the unmatched rows of the left parent, with nulls for the right parent's
+  // columns, so filtering the right parent first would keep rows the filter removes. Right joins
+  // have already been converted to left joins.
+  bool filter_parent_keeps_unmatched_rows =
+      join->join_type() == JoinIR::JoinType::kOuter ||
+      (join->join_type() == JoinIR::JoinType::kLeft && filter_parent_idx == 1);
+  if (filter_parent_keeps_unmatched_rows) {
+    return nullptr;
+  }
+
+  *column_name_mapping = parent_column_name_mapping;
+  *parent_idx = filter_parent_idx;
+  return join;
+}
+
+// Looks at the parent of current_node at parent_idx. If the filter can move above it, returns
+// that parent and sets parent_idx to the index of the parent the filter moves toward next.
+StatusOr<OperatorIR*> FilterPushdownRule::NextFilterLocation(
+    OperatorIR* current_node, int64_t* parent_idx, bool filter_has_kelvin_only_udf,
+    ColumnNameMapping* column_name_mapping) {
+  DCHECK_LT(*parent_idx, static_cast<int64_t>(current_node->parents().size()));
+  OperatorIR* parent = current_node->parents()[*parent_idx];
   if (parent->Children().size() > 1) {
     return nullptr;
   }
@@ -106,16 +150,22 @@ StatusOr<OperatorIR*> FilterPushdownRule::NextFilterLocation(
   if (parent_has_pem_only_udf && filter_has_kelvin_only_udf) {
     return nullptr;
   }
-  if (Match(parent, Filter()) || Match(parent, Limit())) {
-    return parent;
+  if (Match(parent, Join())) {
+    return HandleJoinPushdown(static_cast<JoinIR*>(parent), column_name_mapping, parent_idx);
   }
-  if (Match(parent, BlockingAgg())) {
-    return HandleAggPushdown(static_cast<BlockingAggIR*>(parent), column_name_mapping);
+
+  OperatorIR* next_location = nullptr;
+  if (Match(parent, Filter()) || Match(parent, Limit())) {
+    next_location = parent;
+  } else if (Match(parent, BlockingAgg())) {
+    next_location = HandleAggPushdown(static_cast<BlockingAggIR*>(parent), column_name_mapping);
+  } else if (Match(parent, Map())) {
+    next_location = HandleMapPushdown(static_cast<MapIR*>(parent), column_name_mapping);
   }
-  if (Match(parent, Map())) {
-    return HandleMapPushdown(static_cast<MapIR*>(parent), column_name_mapping);
+  if (next_location != nullptr) {
+    *parent_idx = 0;
   }
-  return nullptr;
+  return next_location;
 }
 
 Status FilterPushdownRule::UpdateFilter(FilterIR* filter,
@@ -129,6 +179,22 @@ Status FilterPushdownRule::UpdateFilter(FilterIR* filter,
   return filter->SetFilterExpr(new_expr);
 }
 
+// Replaces the filter with a copy in front of each parent of the union, which then continues to
+// be pushed up its own branch.
+Status FilterPushdownRule::PushIntoUnion(FilterIR* filter, UnionIR* union_op) {
+  auto graph = filter->graph();
+  // Copy the parents since they are replaced in the loop.
+  std::vector<OperatorIR*> union_parents = union_op->parents();
+  for (OperatorIR* union_parent : union_parents) {
+    PL_ASSIGN_OR_RETURN(FilterIR * new_filter, graph->CopyNode(filter));
+    PL_RETURN_IF_ERROR(new_filter->AddParent(union_parent));
+    PL_RETURN_IF_ERROR(union_op->ReplaceParent(union_parent, new_filter));
+    PL_RETURN_IF_ERROR(new_filter->SetRelation(union_parent->relation()));
+    PL_RETURN_IF_ERROR(Apply(new_filter).status());
+  }
+  return graph->DeleteOrphansInSubtree(filter->id());
+}
+
 StatusOr<bool> FilterPushdownRule::Apply(IRNode* ir_node) {
   if (!Match(ir_node, Filter())) {
     return false;
@@ -151,17 +217,24 @@ StatusOr<bool> FilterPushdownRule::Apply(IRNode* ir_node) {
 
   // Iterate up from the current node, stopping when we reach the earliest allowable
   // new location for the filter node.
+  // The index of the parent of current_node that the filter is placed in front of.
+  int64_t parent_idx = 0;
   while (true) {
     PL_ASSIGN_OR_RETURN(OperatorIR * next_parent,
-                        NextFilterLocation(current_node, kelvin_only_filter, &column_name_mapping));
+                        NextFilterLocation(current_node, &parent_idx, kelvin_only_filter,
+                                           &column_name_mapping));
     if (next_parent == nullptr) {
       break;
     }
     current_node = next_parent;
   }
+  // A union that only feeds the filter gets a copy of the filter in each of its branches.
+  OperatorIR* new_filter_parent = current_node->parents()[parent_idx];
+  bool push_into_union =
+      Match(new_filter_parent, Union()) && new_filter_parent->Children().size() == 1;
   // If the current_node is filter, that means we could not find a better filter location and will
   // not change.
-  if (current_node == filter) {
+  if (current_node == filter && !push_into_union) {
     return false;
   }
 
@@ -176,8 +249,10 @@ StatusOr<bool> FilterPushdownRule::Apply(IRNode* ir_node) {
   }
   PL_RETURN_IF_ERROR(filter->RemoveParent(filter_parent));
 
-  DCHECK_EQ(1, current_node->parents().size());
-  auto new_filter_parent = current_node->parents()[0];
+  if (push_into_union) {
+    PL_RETURN_IF_ERROR(PushIntoUnion(filter, static_cast<UnionIR*>(new_filter_parent)));
+    return true;
+  }
   PL_RETURN_IF_ERROR(filter->AddParent(new_filter_parent));
   PL_RETURN_IF_ERROR(current_node->ReplaceParent(new_filter_parent, filter));
   PL_RETURN_IF_ERROR(filter->SetRelation(new_filter_parent->relation()));
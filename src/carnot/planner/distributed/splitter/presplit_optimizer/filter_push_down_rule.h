@@ -19,7 +19,10 @@
 #pragma once
 
 #include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/join_ir.h"
 #include "src/carnot/planner/ir/map_ir.h"
+#include "src/carnot/planner/ir/union_ir.h"
 #include "src/carnot/planner/rules/rules.h"
 
 namespace px {
@@ -32,6 +35,9 @@ namespace distributed {
  * It must run after OperatorRelationRule so that it has full context on all of the column
  * names that exist in the IR.
  *
+ * Filters move past Maps and Limits, past BlockingAggs when they only read group columns, into
+ * the parent of a Join that all of their columns come from, and into every branch of a Union.
+ *
  */
 class FilterPushdownRule : public Rule {
  public:
@@ -45,9 +51,13 @@ class FilterPushdownRule : public Rule {
   using ColumnNameMapping = absl::flat_hash_map<std::string, std::string>;
   OperatorIR* HandleAggPushdown(BlockingAggIR* map, ColumnNameMapping* column_name_mapping);
   OperatorIR* HandleMapPushdown(MapIR* map, ColumnNameMapping* column_name_mapping);
-  StatusOr<OperatorIR*> NextFilterLocation(OperatorIR* current_node, bool kelvin_only_filter,
+  OperatorIR* HandleJoinPushdown(JoinIR* join, ColumnNameMapping* column_name_mapping,
+                                 int64_t* parent_idx);
+  StatusOr<OperatorIR*> NextFilterLocation(OperatorIR* current_node, int64_t* parent_idx,
+                                           bool kelvin_only_filter,
                                            ColumnNameMapping* column_name_mapping);
   Status UpdateFilter(FilterIR* expr, const ColumnNameMapping& column_name_mapping);
+  Status PushIntoUnion(FilterIR* filter, UnionIR* union_op);
 };
 
 }  // namespace distributed
@@ -449,6 +449,127 @@ TEST_F(FilterPushDownTest, kelvin_only_filter) {
   EXPECT_THAT(map2->parents()[0]->parents(), ElementsAre(map1));
 }
 
+TEST_F(FilterPushDownTest, join_one_side) {
+  Relation left_relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  Relation right_relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "def"});
+  MemorySourceIR* left = MakeMemSource(left_relation);
+  MemorySourceIR* right = MakeMemSource(right_relation);
+  JoinIR* join = MakeJoin({left, right}, "inner", left_relation, right_relation, {"abc"}, {"abc"});
+  ASSERT_OK(join->SetOutputColumns(
+      {"abc", "xyz", "def_right"},
+      {MakeColumn("abc", 0, left_relation), MakeColumn("xyz", 0, left_relation),
+       MakeColumn("def", 1, right_relation)}));
+  auto col = MakeColumn("def_right", 0);
+  col->ResolveColumnType(types::DataType::INT64);
+  auto eq_func = MakeEqualsFunc(col, MakeInt(2));
+  eq_func->SetRegistryArgTypes({types::DataType::INT64, types::DataType::INT64});
+  EXPECT_OK(eq_func->SplitInitArgs(0));
+  FilterIR* filter = MakeFilter(join, eq_func);
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  EXPECT_THAT(sink->parents(), ElementsAre(join));
+  EXPECT_THAT(join->parents(), ElementsAre(left, filter));
+  EXPECT_THAT(filter->parents(), ElementsAre(right));
+  EXPECT_EQ(right_relation, filter->relation());
+  EXPECT_MATCH(filter->filter_expr(), Equals(ColumnNode("def"), Int(2)));
+}
+
+TEST_F(FilterPushDownTest, left_join_right_side_no_push) {
+  Relation left_relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  Relation right_relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "def"});
+  MemorySourceIR* left = MakeMemSource(left_relation);
+  MemorySourceIR* right = MakeMemSource(right_relation);
+  JoinIR* join = MakeJoin({left, right}, "left", left_relation, right_relation, {"abc"}, {"abc"});
+  ASSERT_OK(join->SetOutputColumns(
+      {"abc", "xyz", "def"},
+      {MakeColumn("abc", 0, left_relation), MakeColumn("xyz", 0, left_relation),
+       MakeColumn("def", 1, right_relation)}));
+  // The left join keeps the left rows that don't match, so the right parent can't be filtered
+  // before the join.
+  auto col = MakeColumn("def", 0);
+  col->ResolveColumnType(types::DataType::INT64);
+  auto eq_func = MakeEqualsFunc(col, MakeInt(2));
+  eq_func->SetRegistryArgTypes({types::DataType::INT64, types::DataType::INT64});
+  EXPECT_OK(eq_func->SplitInitArgs(0));
+  FilterIR* filter = MakeFilter(join, eq_func);
+  MakeMemSink(filter, "foo", {});
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_THAT(join->parents(), ElementsAre(left, right));
+}
+
+TEST_F(FilterPushDownTest, join_both_sides_no_push) {
+  Relation left_relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  Relation right_relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "def"});
+  MemorySourceIR* left = MakeMemSource(left_relation);
+  MemorySourceIR* right = MakeMemSource(right_relation);
+  JoinIR* join = MakeJoin({left, right}, "inner", left_relation, right_relation, {"abc"}, {"abc"});
+  ASSERT_OK(join->SetOutputColumns(
+      {"abc", "xyz", "def"},
+      {MakeColumn("abc", 0, left_relation), MakeColumn("xyz", 0, left_relation),
+       MakeColumn("def", 1, right_relation)}));
+  auto col1 = MakeColumn("xyz", 0);
+  col1->ResolveColumnType(types::DataType::INT64);
+  auto col2 = MakeColumn("def", 0);
+  col2->ResolveColumnType(types::DataType::INT64);
+  auto eq_func = MakeEqualsFunc(col1, col2);
+  eq_func->SetRegistryArgTypes({types::DataType::INT64, types::DataType::INT64});
+  EXPECT_OK(eq_func->SplitInitArgs(0));
+  FilterIR* filter = MakeFilter(join, eq_func);
+  MakeMemSink(filter, "foo", {});
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_THAT(join->parents(), ElementsAre(left, right));
+}
+
+TEST_F(FilterPushDownTest, union_branches) {
+  Relation relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  MemorySourceIR* src1 = MakeMemSource(relation);
+  MemorySourceIR* src2 = MakeMemSource(relation);
+  MapIR* map = MakeMap(src2, {{"abc", MakeColumn("abc", 0)}, {"xyz", MakeColumn("xyz", 0)}}, false);
+  ASSERT_OK(map->SetRelation(relation));
+  UnionIR* union_op = MakeUnion({src1, map});
+  auto col = MakeColumn("abc", 0);
+  col->ResolveColumnType(types::DataType::INT64);
+  auto eq_func = MakeEqualsFunc(col, MakeInt(2));
+  eq_func->SetRegistryArgTypes({types::DataType::INT64, types::DataType::INT64});
+  EXPECT_OK(eq_func->SplitInitArgs(0));
+  FilterIR* filter = MakeFilter(union_op, eq_func);
+  int64_t filter_id = filter->id();
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  // Each branch gets its own copy of the filter, pushed as far up the branch as possible.
+  EXPECT_FALSE(graph->HasNode(filter_id));
+  EXPECT_THAT(sink->parents(), ElementsAre(union_op));
+  ASSERT_EQ(2, union_op->parents().size());
+  ASSERT_MATCH(union_op->parents()[0], Filter());
+  auto filter1 = static_cast<FilterIR*>(union_op->parents()[0]);
+  EXPECT_THAT(filter1->parents(), ElementsAre(src1));
+  EXPECT_MATCH(filter1->filter_expr(), Equals(ColumnNode("abc"), Int(2)));
+
+  EXPECT_EQ(map, union_op->parents()[1]);
+  ASSERT_MATCH(map->parents()[0], Filter());
+  auto filter2 = static_cast<FilterIR*>(map->parents()[0]);
+  EXPECT_THAT(filter2->parents(), ElementsAre(src2));
+  EXPECT_MATCH(filter2->filter_expr(), Equals(ColumnNode("abc"), Int(2)));
+}
+
 }  // namespace distributed
 }  // namespace planner
 }  // namespace carnot
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/memory_source_predicate_push_down_rule.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+namespace {
+
+using ColumnPredicatePb = planpb::MemorySourceOperator::ColumnPredicate;
+
+// Splits a tree of logical ands into the expressions that are and-ed together.
+void SplitConjuncts(ExpressionIR* expr, std::vector<ExpressionIR*>* conjuncts) {
+  if (Match(expr, LogicalAnd())) {
+    for (ExpressionIR* arg : static_cast<FuncIR*>(expr)->all_args()) {
+      SplitConjuncts(arg, conjuncts);
+    }
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+// Removes the pushed conjuncts from a tree of logical ands. Returns the expression made of the
+// remaining conjuncts, or nullptr if every conjunct was pushed.
+StatusOr<ExpressionIR*> RemovePushedConjuncts(ExpressionIR* expr,
+                                              const absl::flat_hash_set<ExpressionIR*>& pushed) {
+  if (!Match(expr, LogicalAnd())) {
+    return pushed.contains(expr) ? nullptr : expr;
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  DCHECK_EQ(2UL, func->all_args().size());
+  ExpressionIR* lhs = func->all_args()[0];
+  ExpressionIR* rhs = func->all_args()[1];
+  PL_ASSIGN_OR_RETURN(ExpressionIR * new_lhs, RemovePushedConjuncts(lhs, pushed));
+  PL_ASSIGN_OR_RETURN(ExpressionIR * new_rhs, RemovePushedConjuncts(rhs, pushed));
+  if (new_lhs == nullptr) {
+    return new_rhs;
+  }
+  if (new_rhs == nullptr) {
+    return new_lhs;
+  }
+  if (new_lhs != lhs) {
+    PL_RETURN_IF_ERROR(func->UpdateArg(lhs, new_lhs));
+  }
+  if (new_rhs != rhs) {
+    PL_RETURN_IF_ERROR(func->UpdateArg(rhs, new_rhs));
+  }
+  return func;
+}
+
+// Returns the predicate op for a comparison opcode of the form `column op constant`. Returns
+// false if the opcode isn't a comparison.
+bool ComparisonOp(FuncIR::Opcode opcode, ColumnPredicatePb::Op* op) {
+  switch (opcode) {
+    case FuncIR::Opcode::eq:
+      *op = ColumnPredicatePb::EQUAL;
+      return true;
+    case FuncIR::Opcode::neq:
+      *op = ColumnPredicatePb::NOT_EQUAL;
+      return true;
+    case FuncIR::Opcode::lt:
+      *op = ColumnPredicatePb::LESS_THAN;
+      return true;
+    case FuncIR::Opcode::lteq:
+      *op = ColumnPredicatePb::LESS_THAN_EQUAL;
+      return true;
+    case FuncIR::Opcode::gt:
+      *op = ColumnPredicatePb::GREATER_THAN;
+      return true;
+    case FuncIR::Opcode::gteq:
+      *op = ColumnPredicatePb::GREATER_THAN_EQUAL;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the op that gives the same result when the operands are swapped.
+ColumnPredicatePb::Op SwapOperands(ColumnPredicatePb::Op op) {
+  switch (op) {
+    case ColumnPredicatePb::LESS_THAN:
+      return ColumnPredicatePb::GREATER_THAN;
+    case ColumnPredicatePb::LESS_THAN_EQUAL:
+      return ColumnPredicatePb::GREATER_THAN_EQUAL;
+    case ColumnPredicatePb::GREATER_THAN:
+      return ColumnPredicatePb::LESS_THAN;
+    case ColumnPredicatePb::GREATER_THAN_EQUAL:
+      return ColumnPredicatePb::LESS_THAN_EQUAL;
+    default:
+      return op;
+  }
+}
+
+// Converts the constant into the type of the column it is compared to, matching the implicit
+// conversions done by the comparison UDFs. Returns false if there is no such conversion.
+bool CastToColumnType(types::DataType column_type, planpb::ScalarValue* value) {
+  if (value->data_type() == column_type) {
+    return true;
+  }
+  if (value->data_type() != types::INT64) {
+    return false;
+  }
+  int64_t int_value = value->int64_value();
+  switch (column_type) {
+    case types::TIME64NS:
+      value->set_time64_ns_value(int_value);
+      break;
+    case types::FLOAT64:
+      value->set_float64_value(static_cast<double>(int_value));
+      break;
+    default:
+      return false;
+  }
+  value->set_data_type(column_type);
+  return true;
+}
+
+}  // namespace
+
+StatusOr<bool> MemorySourcePredicatePushdownRule::ToSourcePredicate(
+    MemorySourceIR* src, ExpressionIR* expr, MemorySourceIR::ColumnPredicate* predicate) {
+  if (!Match(expr, Func())) {
+    return false;
+  }
+  FuncIR* func = static_cast<FuncIR*>(expr);
+  if (func->all_args().size() != 2) {
+    return false;
+  }
+  ExpressionIR* lhs = func->all_args()[0];
+  ExpressionIR* rhs = func->all_args()[1];
+  bool column_first = Match(lhs, ColumnNode()) && Match(rhs, DataNode());
+  bool column_last = Match(lhs, DataNode()) && Match(rhs, ColumnNode());
+  if (!column_first && !column_last) {
+    return false;
+  }
+  if (!ComparisonOp(func->opcode(), &predicate->op)) {
+    return false;
+  }
+  if (column_last) {
+    predicate->op = SwapOperands(predicate->op);
+  }
+
+  ColumnIR* column = static_cast<ColumnIR*>(column_first ? lhs : rhs);
+  DataIR* constant = static_cast<DataIR*>(column_first ? rhs : lhs);
+  if (!src->relation().HasColumn(column->col_name())) {
+    return false;
+  }
+  predicate->column_name = column->col_name();
+  PL_RETURN_IF_ERROR(constant->ToProto(&predicate->value));
+  return CastToColumnType(src->relation().GetColumnType(column->col_name()), &predicate->value);
+}
+
+StatusOr<bool> MemorySourcePredicatePushdownRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Filter())) {
+    return false;
+  }
+  FilterIR* filter = static_cast<FilterIR*>(ir_node);
+  if (filter->parents().size() != 1 || !Match(filter->parents()[0], MemorySource())) {
+    return false;
+  }
+  MemorySourceIR* src = static_cast<MemorySourceIR*>(filter->parents()[0]);
+  // Other children of the source must still see the rows the filter drops.
+  if (src->Children().size() != 1 || !(filter->relation() == src->relation())) {
+    return false;
+  }
+
+  std::vector<ExpressionIR*> conjuncts;
+  SplitConjuncts(filter->filter_expr(), &conjuncts);
+  std::vector<MemorySourceIR::ColumnPredicate> predicates;
+  absl::flat_hash_set<ExpressionIR*> pushed_conjuncts;
+  for (ExpressionIR* conjunct : conjuncts) {
+    MemorySourceIR::ColumnPredicate predicate;
+    PL_ASSIGN_OR_RETURN(bool converted, ToSourcePredicate(src, conjunct, &predicate));
+    if (converted) {
+      predicates.push_back(predicate);
+      pushed_conjuncts.insert(conjunct);
+    }
+  }
+  if (predicates.empty()) {
+    return false;
+  }
+  for (const auto& predicate : predicates) {
+    src->AddPredicate(predicate);
+  }
+  // The filter is still needed for the conjuncts the source can't evaluate, but it no longer
+  // needs to evaluate the ones the source does.
+  if (predicates.size() < conjuncts.size()) {
+    PL_ASSIGN_OR_RETURN(ExpressionIR * remaining,
+                        RemovePushedConjuncts(filter->filter_expr(), pushed_conjuncts));
+    if (remaining != filter->filter_expr()) {
+      PL_RETURN_IF_ERROR(filter->SetFilterExpr(remaining));
+    }
+    return true;
+  }
+
+  for (OperatorIR* child : filter->Children()) {
+    PL_RETURN_IF_ERROR(child->ReplaceParent(filter, src));
+  }
+  PL_RETURN_IF_ERROR(filter->RemoveParent(src));
+  PL_RETURN_IF_ERROR(filter->graph()->DeleteOrphansInSubtree(filter->id()));
+  return true;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
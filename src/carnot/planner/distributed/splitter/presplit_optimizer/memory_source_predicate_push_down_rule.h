@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief This rule copies the simple comparisons of a filter that sits directly on top of a
+ * MemorySource into the MemorySource itself, so that they are evaluated while the table is
+ * scanned. A comparison is simple if it compares a column with a constant of the same type.
+ * The pushed conjuncts are removed from the filter, and if none are left, so is the filter.
+ *
+ * It should run after FilterPushdownRule, which moves filters as close to the sources as
+ * possible.
+ */
+class MemorySourcePredicatePushdownRule : public Rule {
+ public:
+  explicit MemorySourcePredicatePushdownRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ true, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode*) override;
+
+ private:
+  // Returns whether the expression was converted, in which case it is written to predicate.
+  StatusOr<bool> ToSourcePredicate(MemorySourceIR* src, ExpressionIR* expr,
+                                   MemorySourceIR::ColumnPredicate* predicate);
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/memory_source_predicate_push_down_rule.h"
+#include "src/carnot/planner/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using ::testing::ElementsAre;
+using ColumnPredicatePb = planpb::MemorySourceOperator::ColumnPredicate;
+
+class MemorySourcePredicatePushdownTest : public testutils::DistributedRulesTest {
+ protected:
+  FuncIR* MakeComparison(const std::string& op, ExpressionIR* left, ExpressionIR* right) {
+    return graph
+        ->CreateNode<FuncIR>(ast, FuncIR::op_map.find(op)->second,
+                             std::vector<ExpressionIR*>({left, right}))
+        .ConsumeValueOrDie();
+  }
+
+  Relation relation_{{types::DataType::TIME64NS, types::DataType::FLOAT64, types::DataType::STRING},
+                     {"time_", "cpu", "service"}};
+};
+
+TEST_F(MemorySourcePredicatePushdownTest, push_all_conjuncts) {
+  MemorySourceIR* src = MakeMemSource(relation_);
+  auto time_gteq = MakeComparison(">=", MakeColumn("time_", 0), MakeInt(10));
+  // Constant on the left, which flips the comparison.
+  auto cpu_gt = MakeComparison("<", MakeFloat(0.5), MakeColumn("cpu", 0));
+  auto service_eq = MakeComparison("==", MakeColumn("service", 0), MakeString("foo"));
+  FilterIR* filter = MakeFilter(src, MakeAndFunc(MakeAndFunc(time_gteq, cpu_gt), service_eq));
+  ASSERT_OK(filter->SetRelation(relation_));
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+  auto filter_id = filter->id();
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  EXPECT_FALSE(graph->HasNode(filter_id));
+  EXPECT_THAT(sink->parents(), ElementsAre(src));
+
+  planpb::Operator op;
+  ASSERT_OK(src->ToProto(&op));
+  const auto& predicates = op.mem_source_op().predicates();
+  ASSERT_EQ(3, predicates.size());
+  EXPECT_EQ(0, predicates[0].column_idx());
+  EXPECT_EQ(ColumnPredicatePb::GREATER_THAN_EQUAL, predicates[0].op());
+  EXPECT_EQ(types::TIME64NS, predicates[0].value().data_type());
+  EXPECT_EQ(10, predicates[0].value().time64_ns_value());
+  EXPECT_EQ(1, predicates[1].column_idx());
+  EXPECT_EQ(ColumnPredicatePb::GREATER_THAN, predicates[1].op());
+  EXPECT_EQ(0.5, predicates[1].value().float64_value());
+  EXPECT_EQ(2, predicates[2].column_idx());
+  EXPECT_EQ(ColumnPredicatePb::EQUAL, predicates[2].op());
+  EXPECT_EQ("foo", predicates[2].value().string_value());
+}
+
+TEST_F(MemorySourcePredicatePushdownTest, keep_filter_for_unsupported_conjuncts) {
+  MemorySourceIR* src = MakeMemSource(relation_);
+  auto cpu_gt = MakeComparison(">", MakeColumn("cpu", 0), MakeFloat(0.5));
+  // Comparisons between two columns can't be evaluated by the source.
+  auto col_eq = MakeComparison("==", MakeColumn("cpu", 0), MakeColumn("time_", 0));
+  FilterIR* filter = MakeFilter(src, MakeAndFunc(cpu_gt, col_eq));
+  ASSERT_OK(filter->SetRelation(relation_));
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  EXPECT_THAT(sink->parents(), ElementsAre(filter));
+  EXPECT_THAT(filter->parents(), ElementsAre(src));
+  ASSERT_EQ(1, src->predicates().size());
+  EXPECT_EQ("cpu", src->predicates()[0].column_name);
+  EXPECT_EQ(ColumnPredicatePb::GREATER_THAN, src->predicates()[0].op);
+  // The filter only keeps the conjunct the source can't evaluate.
+  EXPECT_EQ(col_eq, filter->filter_expr());
+}
+
+TEST_F(MemorySourcePredicatePushdownTest, remove_pushed_conjuncts) {
+  MemorySourceIR* src = MakeMemSource(relation_);
+  auto cpu_gt = MakeComparison(">", MakeColumn("cpu", 0), MakeFloat(0.5));
+  auto col_eq = MakeComparison("==", MakeColumn("cpu", 0), MakeColumn("time_", 0));
+  auto service_eq = MakeComparison("==", MakeColumn("service", 0), MakeString("foo"));
+  auto col_neq = MakeComparison("!=", MakeColumn("service", 0), MakeColumn("service", 0));
+  FilterIR* filter = MakeFilter(
+      src, MakeAndFunc(MakeAndFunc(cpu_gt, col_eq), MakeAndFunc(service_eq, col_neq)));
+  ASSERT_OK(filter->SetRelation(relation_));
+  MakeMemSink(filter, "foo", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  ASSERT_EQ(2, src->predicates().size());
+
+  // The remaining conjuncts are still and-ed together.
+  ASSERT_MATCH(filter->filter_expr(), LogicalAnd());
+  auto remaining = static_cast<FuncIR*>(filter->filter_expr());
+  EXPECT_THAT(remaining->all_args(), ElementsAre(col_eq, col_neq));
+  EXPECT_FALSE(graph->HasNode(cpu_gt->id()));
+  EXPECT_FALSE(graph->HasNode(service_eq->id()));
+
+  // Nothing is left to push on another pass.
+  result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_EQ(2, src->predicates().size());
+}
+
+TEST_F(MemorySourcePredicatePushdownTest, source_with_other_children) {
+  MemorySourceIR* src = MakeMemSource(relation_);
+  FilterIR* filter = MakeFilter(src, MakeComparison(">", MakeColumn("cpu", 0), MakeFloat(0.5)));
+  ASSERT_OK(filter->SetRelation(relation_));
+  MakeMemSink(filter, "foo", {});
+  // The unfiltered rows are still needed by this sink.
+  MakeMemSink(src, "bar", {});
+
+  MemorySourcePredicatePushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_EQ(0, src->predicates().size());
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -19,9 +19,12 @@
 #pragma once
 #include <memory>
 
+#include "src/carnot/planner/compiler/optimizer/common_subexpression_elimination_rule.h"
+#include "src/carnot/planner/compiler/optimizer/prune_unused_columns_rule.h"
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/filter_push_down_rule.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/limit_push_down_rule.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/memory_source_predicate_push_down_rule.h"
 #include "src/carnot/planner/rules/rule_executor.h"
 
 namespace px {
@@ -59,9 +62,34 @@ class PreSplitOptimizer : public RuleExecutor<IR> {
     filter_pushdown->AddRule<FilterPushdownRule>(compiler_state_);
   }
 
+  void CreateMemorySourcePredicatePushdownBatch() {
+    // Runs after filter pushdown so that filters have already been moved next to the sources.
+    // A single pass pushes everything, since pushed conjuncts are removed from the filters.
+    RuleBatch* predicate_pushdown =
+        CreateRuleBatch<TryUntilMax>("MemorySourcePredicatePushdown", 1);
+    predicate_pushdown->AddRule<MemorySourcePredicatePushdownRule>(compiler_state_);
+  }
+
+  void CreateCommonSubexpressionEliminationBatch() {
+    // Runs after filter pushdown, because a filter that reads a column computed by a hoisted Map
+    // can't be pushed above that Map anymore.
+    RuleBatch* cse_batch = CreateRuleBatch<TryUntilMax>("CommonSubexpressionElimination", 1);
+    cse_batch->AddRule<compiler::CommonSubexpressionEliminationRule>(compiler_state_);
+  }
+
+  void CreatePruneUnusedColumnsBatch() {
+    // The Maps inserted by common subexpression elimination forward every column of their
+    // parent, so the columns are pruned again once it has run.
+    RuleBatch* prune_unused_columns = CreateRuleBatch<FailOnMax>("PruneUnusedColumns", 2);
+    prune_unused_columns->AddRule<compiler::PruneUnusedColumnsRule>();
+  }
+
   Status Init() {
     CreateLimitPushdownBatch();
     CreateFilterPushdownBatch();
+    CreateMemorySourcePredicatePushdownBatch();
+    CreateCommonSubexpressionEliminationBatch();
+    CreatePruneUnusedColumnsBatch();
     return Status::OK();
   }
 
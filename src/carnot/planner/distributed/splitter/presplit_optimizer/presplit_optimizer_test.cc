@@ -71,14 +71,66 @@ TEST_F(PreSplitOptimizerTest, filter_pushdown) {
   EXPECT_OK(eq_func->SplitInitArgs(0));
   FilterIR* filter = MakeFilter(map, eq_func);
   MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+  auto filter_id = filter->id();
 
   auto optimizer = PreSplitOptimizer::Create(compiler_state_.get()).ConsumeValueOrDie();
   ASSERT_OK(optimizer->Execute(graph.get()));
 
+  // The filter is first pushed above the map, and then into the source.
   EXPECT_THAT(sink->parents(), ElementsAre(map));
-  EXPECT_THAT(map->parents(), ElementsAre(filter));
-  EXPECT_THAT(filter->parents(), ElementsAre(src));
-  EXPECT_MATCH(filter->filter_expr(), Equals(ColumnNode("abc"), Int(2)));
+  EXPECT_THAT(map->parents(), ElementsAre(src));
+  EXPECT_FALSE(graph->HasNode(filter_id));
+  ASSERT_EQ(1, src->predicates().size());
+  EXPECT_EQ("abc", src->predicates()[0].column_name);
+  EXPECT_EQ(planpb::MemorySourceOperator::ColumnPredicate::EQUAL, src->predicates()[0].op);
+  EXPECT_EQ(2, src->predicates()[0].value.int64_value());
+}
+
+// The repeated service name lookups are shared only after the filter has been pushed, so the
+// Map computing them doesn't keep the filter in place.
+TEST_F(PreSplitOptimizerTest, filter_pushdown_before_common_subexpression_elimination) {
+  Relation relation({types::DataType::UINT128, types::DataType::INT64}, {"upid", "abc"});
+  MemorySourceIR* src = MakeMemSource(relation);
+  MapIR* map1 = MakeMap(src, {{"upid", MakeColumn("upid", 0, relation)},
+                              {"abc", MakeColumn("abc", 0, relation)}});
+  ASSERT_OK(map1->SetRelation(relation));
+
+  auto make_service_func = [&]() {
+    auto func = MakeFunc("upid_to_service_name", {MakeColumn("upid", 0, relation)},
+                         types::DataType::STRING);
+    func->SetRegistryArgTypes({types::DataType::UINT128});
+    return func;
+  };
+  auto eq_func = MakeEqualsFunc(make_service_func(), MakeString("svc"));
+  eq_func->SetOutputDataType(types::DataType::BOOLEAN);
+  eq_func->SetRegistryArgTypes({types::DataType::STRING, types::DataType::STRING});
+  EXPECT_OK(eq_func->SplitInitArgs(0));
+  FilterIR* filter = MakeFilter(map1, eq_func);
+  ASSERT_OK(filter->SetRelation(relation));
+
+  MapIR* map2 = MakeMap(filter, {{"service", make_service_func()}});
+  ASSERT_OK(map2->SetRelation(Relation({types::DataType::STRING}, {"service"})));
+  MemorySinkIR* sink = MakeMemSink(map2, "foo", {});
+
+  auto optimizer = PreSplitOptimizer::Create(compiler_state_.get()).ConsumeValueOrDie();
+  ASSERT_OK(optimizer->Execute(graph.get()));
+
+  // The filter is pushed above the first map.
+  EXPECT_THAT(sink->parents(), ElementsAre(map2));
+  EXPECT_THAT(map2->parents(), ElementsAre(map1));
+  EXPECT_THAT(map1->parents(), ElementsAre(filter));
+
+  // The service name is then computed once, in a new Map in front of the filter.
+  ASSERT_MATCH(filter->parents()[0], Map());
+  auto hoisted = static_cast<MapIR*>(filter->parents()[0]);
+  EXPECT_THAT(hoisted->parents(), ElementsAre(src));
+  ASSERT_MATCH(filter->filter_expr(), Func());
+  EXPECT_MATCH(static_cast<FuncIR*>(filter->filter_expr())->all_args()[0], ColumnNode());
+  EXPECT_MATCH(map2->col_exprs()[0].node, ColumnNode());
+
+  // The new Map starts out forwarding every input column, but only the service name is used.
+  EXPECT_THAT(hoisted->relation().col_names(), ElementsAre("_upid_to_service_name_0"));
+  EXPECT_THAT(map1->relation().col_names(), ElementsAre("_upid_to_service_name_0"));
 }
 
 }  // namespace distributed
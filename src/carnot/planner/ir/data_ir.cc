@@ -43,6 +43,13 @@ Status DataIR::ToProto(planpb::ScalarValue* value_pb) const {
 
 uint64_t DataIR::HashValue() const { return HashValueImpl(); }
 
+Status DataIR::CopyFromNode(const IRNode* node,
+                            absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) {
+  PL_RETURN_IF_ERROR(ExpressionIR::CopyFromNode(node, copied_nodes_map));
+  time_dependence_ = static_cast<const DataIR*>(node)->time_dependence_;
+  return Status::OK();
+}
+
 StatusOr<DataIR*> DataIR::FromProto(IR* ir, std::string_view name,
                                     const planpb::ScalarValue& value) {
   switch (value.data_type()) {
@@ -79,6 +79,21 @@ class DataIR : public ExpressionIR {
   static StatusOr<DataIR*> ZeroValueForType(IR* ir, IRNodeType type);
   static StatusOr<DataIR*> ZeroValueForType(IR* ir, types::DataType type);
 
+  /**
+   * @brief How the value depends on the compile time. Literals created from the compile time
+   * (px.now(), durations such as "-5m") are relative: their value is the compile time plus a
+   * constant. Values computed from relative literals in any other way are opaque.
+   */
+  enum class TimeDependence { kNone, kRelative, kOpaque };
+  TimeDependence time_dependence() const { return time_dependence_; }
+  void set_time_dependence(TimeDependence time_dependence) { time_dependence_ = time_dependence; }
+
+  /**
+   * @brief Override of CopyFromNode that keeps the time dependence of the data.
+   */
+  Status CopyFromNode(const IRNode* node,
+                      absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) override;
+
  protected:
   DataIR(int64_t id, IRNodeType type, const ExpressionIR::Annotations& annotations)
       : ExpressionIR(id, type, annotations), evaluated_data_type_(DataType(type)) {}
@@ -86,6 +101,7 @@ class DataIR : public ExpressionIR {
 
  private:
   types::DataType evaluated_data_type_;
+  TimeDependence time_dependence_ = TimeDependence::kNone;
 };
 
 }  // namespace planner
@@ -134,7 +134,7 @@ class GRPCSinkIR : public OperatorIR {
 
   Status ResolveType(CompilerState* compiler_state);
 
-  const absl::flat_hash_map<int64_t, int64_t>& agent_id_to_destination_id() {
+  const absl::flat_hash_map<int64_t, int64_t>& agent_id_to_destination_id() const {
     return agent_id_to_destination_id_;
   }
 
@@ -90,6 +90,13 @@ class JoinIR : public OperatorIR {
                           const std::vector<ColumnIR*>& columns);
   bool specified_as_right() const { return specified_as_right_; }
 
+  // The parent the join builds its hash table from. The other parent is streamed through it.
+  int64_t build_parent_idx() const { return build_parent_idx_; }
+  void set_build_parent_idx(int64_t build_parent_idx) {
+    DCHECK(build_parent_idx == 0 || build_parent_idx == 1);
+    build_parent_idx_ = build_parent_idx;
+  }
+
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override;
 
   const std::tuple<std::shared_ptr<TableType>, std::shared_ptr<TableType>> left_right_table_types()
@@ -155,6 +162,8 @@ class JoinIR : public OperatorIR {
   std::vector<ColumnIR*> right_on_columns_;
   // The suffixes to add to the left columns and to the right columns.
   std::vector<std::string> suffix_strs_;
+  // The parent the join builds its hash table from.
+  int64_t build_parent_idx_ = 0;
 
   // Whether this join was originally specified as a right join.
   // Used because we transform left joins into right joins but need to do some back transform.
@@ -58,6 +58,17 @@ Status MemorySourceIR::ToProto(planpb::Operator* op) const {
   }
 
   pb->set_streaming(streaming());
+
+  for (const auto& predicate : predicates_) {
+    if (!relation().HasColumn(predicate.column_name)) {
+      return CreateIRNodeError("Predicate column '$0' is not an output of the MemorySource",
+                               predicate.column_name);
+    }
+    auto predicate_pb = pb->add_predicates();
+    predicate_pb->set_column_idx(relation().GetColumnIndex(predicate.column_name));
+    predicate_pb->set_op(predicate.op);
+    *predicate_pb->mutable_value() = predicate.value;
+  }
   return Status::OK();
 }
 
@@ -132,6 +143,7 @@ Status MemorySourceIR::CopyFromNodeImpl(
   column_index_map_ = source_ir->column_index_map_;
   has_time_expressions_ = source_ir->has_time_expressions_;
   streaming_ = source_ir->streaming_;
+  predicates_ = source_ir->predicates_;
 
   if (has_time_expressions_) {
     PL_ASSIGN_OR_RETURN(ExpressionIR * new_start_expr,
@@ -111,6 +111,18 @@ class MemorySourceIR : public OperatorIR {
     return tablet_value_;
   }
 
+  /**
+   * @brief A comparison between one of the source's output columns and a constant, evaluated
+   * by the source while it scans the table. Predicates are conjunctive.
+   */
+  struct ColumnPredicate {
+    std::string column_name;
+    planpb::MemorySourceOperator::ColumnPredicate::Op op;
+    planpb::ScalarValue value;
+  };
+  void AddPredicate(const ColumnPredicate& predicate) { predicates_.push_back(predicate); }
+  const std::vector<ColumnPredicate>& predicates() const { return predicates_; }
+
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override {
     return std::vector<absl::flat_hash_set<std::string>>{};
   }
@@ -146,6 +158,8 @@ class MemorySourceIR : public OperatorIR {
 
   types::TabletID tablet_value_;
   bool has_tablet_value_ = false;
+
+  std::vector<ColumnPredicate> predicates_;
 };
 
 }  // namespace planner
@@ -18,8 +18,15 @@
 
 #include "src/carnot/planner/logical_planner.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include "src/carnot/planner/parser/parser.h"
 #include "src/shared/scriptspb/scripts.pb.h"
 
 namespace px {
@@ -28,6 +35,9 @@ namespace planner {
 
 using table_store::schemapb::Schema;
 
+// The maximum number of threads that plan the exec funcs of a single query.
+constexpr int64_t kMaxExecFuncPlanningThreads = 8;
+
 StatusOr<std::unique_ptr<RelationMap>> MakeRelationMapFromSchema(const Schema& schema_pb) {
   auto rel_map = std::make_unique<RelationMap>();
   for (auto& relation_pair : schema_pb.relation_map()) {
@@ -52,14 +62,30 @@ StatusOr<std::unique_ptr<RelationMap>> MakeRelationMapFromDistributedState(
 
 StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
     const distributedpb::LogicalPlannerState& logical_state, RegistryInfo* registry_info,
-    int64_t max_output_rows_per_table) {
+    int64_t max_output_rows_per_table, int64_t time_now) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<RelationMap> rel_map,
                       MakeRelationMapFromDistributedState(logical_state.distributed_state()));
-  // Create a CompilerState obj using the relation map and grabbing the current time.
+  // Create a CompilerState obj using the relation map and the compile time.
 
-  return std::make_unique<planner::CompilerState>(
-      std::move(rel_map), registry_info, px::CurrentTimeNS(), max_output_rows_per_table,
+  auto compiler_state = std::make_unique<planner::CompilerState>(
+      std::move(rel_map), registry_info, time_now, max_output_rows_per_table,
       logical_state.result_address(), logical_state.result_ssl_targetname());
+
+  TableNumRowsMap table_num_rows;
+  for (const auto& schema_info : logical_state.distributed_state().schema_info()) {
+    if (schema_info.num_rows() > 0) {
+      table_num_rows[schema_info.name()] = schema_info.num_rows();
+    }
+  }
+  compiler_state->set_table_num_rows(table_num_rows);
+  return compiler_state;
+}
+
+StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
+    const distributedpb::LogicalPlannerState& logical_state, RegistryInfo* registry_info,
+    int64_t max_output_rows_per_table) {
+  return CreateCompilerState(logical_state, registry_info, max_output_rows_per_table,
+                             px::CurrentTimeNS());
 }
 
 StatusOr<std::unique_ptr<LogicalPlanner>> LogicalPlanner::Create(const udfspb::UDFInfo& udf_info) {
@@ -74,23 +100,158 @@ Status LogicalPlanner::Init(const udfspb::UDFInfo& udf_info) {
   PL_RETURN_IF_ERROR(registry_info_->Init(udf_info));
 
   PL_ASSIGN_OR_RETURN(distributed_planner_, distributed::DistributedPlanner::Create());
+  // Cached plans were compiled against the previous registry.
+  plan_cache_.Clear();
   return Status::OK();
 }
 
 StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::Plan(
     const distributedpb::LogicalPlannerState& logical_state,
     const plannerpb::QueryRequest& query_request) {
-  // Compile into the IR.
+  return PlanAt(logical_state, query_request, px::CurrentTimeNS());
+}
+
+StatusOr<distributedpb::DistributedPlan> LogicalPlanner::PlanToProto(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request) {
+  int64_t time_now = px::CurrentTimeNS();
+  std::string cache_key = PlanCache::Key(logical_state, query_request);
+  auto cached_plan = plan_cache_.Lookup(cache_key, time_now);
+  if (cached_plan.has_value()) {
+    return std::move(cached_plan.value());
+  }
+
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> distributed_plan,
+                      PlanAt(logical_state, query_request, time_now));
+  distributed_plan->SetPlanOptions(logical_state.plan_options());
+  PL_ASSIGN_OR_RETURN(auto plan_pb, distributed_plan->ToProto());
+  std::vector<PlanCache::RelativeTime> relative_times;
+  if (PlanCache::FindRelativeTimes(*distributed_plan, &relative_times)) {
+    plan_cache_.Insert(cache_key, plan_pb, time_now, relative_times);
+  }
+  return plan_pb;
+}
+
+Status LogicalPlanner::PlanExecFuncs(const distributedpb::LogicalPlannerState& logical_state,
+                                     const plannerpb::QueryRequest& query_request,
+                                     const ExecFuncPlanCallback& callback) {
+  int64_t num_exec_funcs = query_request.exec_funcs_size();
+  if (num_exec_funcs == 0) {
+    return error::InvalidArgument("Query must have exec funcs to plan them separately.");
+  }
+  Parser parser;
+  PL_ASSIGN_OR_RETURN(pypa::AstModulePtr ast, parser.Parse(query_request.query_str()));
+  // Every exec func is compiled at the same time, so that the plans cover the same time range.
+  int64_t time_now = px::CurrentTimeNS();
+  compiler::ExecFuncs exec_funcs(query_request.exec_funcs().begin(),
+                                 query_request.exec_funcs().end());
+
+  // The module and the operators that the exec funcs share are compiled and analyzed once, then
+  // each exec func is copied out of the analyzed IR to be optimized and planned on its own.
   auto ms = logical_state.plan_options().max_output_rows_per_table();
-  VLOG(1) << "Max output rows: " << ms;
   PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+                      CreateCompilerState(logical_state, registry_info_.get(), ms, time_now));
+  auto analyzed_or_s = compiler_.AnalyzeExecFuncs(ast, compiler_state.get(), exec_funcs);
+  if (!analyzed_or_s.ok()) {
+    VLOG(1) << "Compiling the exec funcs separately: " << analyzed_or_s.status().msg();
+  }
+
+  // Each exec func gets its own IR and compiler state, the analyzed IR, the parsed script, the
+  // registry and the planners are only read.
+  std::atomic<int64_t> next_exec_func_idx{0};
+  std::mutex callback_lock;
+  auto plan_exec_funcs = [&]() {
+    for (int64_t i = next_exec_func_idx++; i < num_exec_funcs; i = next_exec_func_idx++) {
+      // An error in one exec func fails the shared compile, so when it fails every exec func is
+      // compiled from scratch to keep the error to the exec funcs that cause it.
+      auto plan_pb = analyzed_or_s.ok()
+                         ? PlanExecFuncToProtoAt(logical_state, analyzed_or_s.ValueOrDie(), i,
+                                                 time_now)
+                         : PlanToProtoAt(logical_state, ast, {exec_funcs[i]}, time_now);
+      std::lock_guard<std::mutex> lock(callback_lock);
+      callback(i, std::move(plan_pb));
+    }
+  };
 
+  int64_t num_threads =
+      std::min({num_exec_funcs, static_cast<int64_t>(std::thread::hardware_concurrency()),
+                kMaxExecFuncPlanningThreads});
+  std::vector<std::thread> workers;
+  // The calling thread plans exec funcs as well.
+  for (int64_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back(plan_exec_funcs);
+  }
+  plan_exec_funcs();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return Status::OK();
+}
+
+StatusOr<std::vector<distributedpb::DistributedPlan>> LogicalPlanner::PlanExecFuncsToProto(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request) {
+  std::vector<StatusOr<distributedpb::DistributedPlan>> plans(query_request.exec_funcs_size(),
+                                                              error::Internal("Not planned."));
+  PL_RETURN_IF_ERROR(PlanExecFuncs(
+      logical_state, query_request,
+      [&plans](int64_t exec_func_idx, StatusOr<distributedpb::DistributedPlan> plan) {
+        plans[exec_func_idx] = std::move(plan);
+      }));
+
+  std::vector<distributedpb::DistributedPlan> plan_pbs;
+  for (auto& plan : plans) {
+    PL_ASSIGN_OR_RETURN(auto plan_pb, std::move(plan));
+    plan_pbs.push_back(std::move(plan_pb));
+  }
+  return plan_pbs;
+}
+
+StatusOr<distributedpb::DistributedPlan> LogicalPlanner::PlanToProtoAt(
+    const distributedpb::LogicalPlannerState& logical_state, const pypa::AstModulePtr& ast,
+    const compiler::ExecFuncs& exec_funcs, int64_t time_now) {
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> distributed_plan,
+                      PlanAt(logical_state, ast, exec_funcs, time_now));
+  distributed_plan->SetPlanOptions(logical_state.plan_options());
+  return distributed_plan->ToProto();
+}
+
+StatusOr<distributedpb::DistributedPlan> LogicalPlanner::PlanExecFuncToProtoAt(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const compiler::AnalyzedExecFuncs& analyzed, int64_t exec_func_idx, int64_t time_now) {
+  auto ms = logical_state.plan_options().max_output_rows_per_table();
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
+                      CreateCompilerState(logical_state, registry_info_.get(), ms, time_now));
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> single_node_plan,
+                      compiler_.CompileExecFunc(analyzed, exec_func_idx, compiler_state.get()));
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> distributed_plan,
+                      distributed_planner_->Plan(logical_state.distributed_state(),
+                                                 compiler_state.get(), single_node_plan.get()));
+  distributed_plan->SetPlanOptions(logical_state.plan_options());
+  return distributed_plan->ToProto();
+}
+
+StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::PlanAt(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request, int64_t time_now) {
+  Parser parser;
+  PL_ASSIGN_OR_RETURN(pypa::AstModulePtr ast, parser.Parse(query_request.query_str()));
   std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
                                                    query_request.exec_funcs().end());
-  PL_ASSIGN_OR_RETURN(
-      std::shared_ptr<IR> single_node_plan,
-      compiler_.CompileToIR(query_request.query_str(), compiler_state.get(), exec_funcs));
+  return PlanAt(logical_state, ast, exec_funcs, time_now);
+}
+
+StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::PlanAt(
+    const distributedpb::LogicalPlannerState& logical_state, const pypa::AstModulePtr& ast,
+    const compiler::ExecFuncs& exec_funcs, int64_t time_now) {
+  // Compile into the IR.
+  auto ms = logical_state.plan_options().max_output_rows_per_table();
+  VLOG(1) << "Max output rows: " << ms;
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
+                      CreateCompilerState(logical_state, registry_info_.get(), ms, time_now));
+
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> single_node_plan,
+                      compiler_.CompileToIR(ast, compiler_state.get(), exec_funcs));
   // Create the distributed plan.
   return distributed_planner_->Plan(logical_state.distributed_state(), compiler_state.get(),
                                     single_node_plan.get());
@@ -17,6 +17,7 @@
  */
 
 #pragma once
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/plan_cache.h"
 #include "src/carnot/planner/plannerpb/func_args.pb.h"
 #include "src/carnot/planner/probes/probes.h"
 #include "src/shared/scriptspb/scripts.pb.h"
@@ -33,6 +35,14 @@ namespace px {
 namespace carnot {
 namespace planner {
 
+/**
+ * @brief Creates the compiler state for compiling a query against the logical state at the given
+ * compile time.
+ */
+StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
+    const distributedpb::LogicalPlannerState& logical_state, RegistryInfo* registry_info,
+    int64_t max_output_rows_per_table, int64_t time_now);
+
 /**
  * @brief The logical planner takes in queries and a Logical Planner State and
  *
@@ -58,6 +68,55 @@ class LogicalPlanner : public NotCopyable {
       const distributedpb::LogicalPlannerState& logical_state,
       const plannerpb::QueryRequest& query);
 
+  /**
+   * @brief Plans the query and returns the distributed plan proto with the plan options of
+   * the logical state applied. Repeated requests are served from the plan cache, only rebinding
+   * the times that are relative to the compile time.
+   *
+   * @param logical_state: the distributed layout of the vizier instance.
+   * @param query: QueryRequest
+   * @return distributedpb::DistributedPlan or error if one occurs during compilation.
+   */
+  StatusOr<distributedpb::DistributedPlan> PlanToProto(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const plannerpb::QueryRequest& query);
+
+  /**
+   * @brief Called with the plan of each exec func planned by PlanExecFuncs. Calls are never made
+   * concurrently, but they arrive in the order the plans finish rather than the order of the exec
+   * funcs in the query.
+   */
+  using ExecFuncPlanCallback =
+      std::function<void(int64_t exec_func_idx, StatusOr<distributedpb::DistributedPlan> plan)>;
+
+  /**
+   * @brief Plans every exec func of the query into its own distributed plan, compiling the exec
+   * funcs in parallel. The query is parsed, compiled and analyzed once for all of the exec funcs,
+   * then each exec func is optimized and planned on its own. Each plan is handed to the callback as soon as it is ready, so that the widgets
+   * planned first can start executing while the rest are still being planned.
+   *
+   * The per exec func plans don't go through the plan cache and don't share operators with each
+   * other.
+   *
+   * @param logical_state: the distributed layout of the vizier instance.
+   * @param query: QueryRequest with at least one exec func.
+   * @param callback: called once per exec func with its plan or the error planning it.
+   * @return error if the query doesn't parse or has no exec funcs.
+   */
+  Status PlanExecFuncs(const distributedpb::LogicalPlannerState& logical_state,
+                       const plannerpb::QueryRequest& query, const ExecFuncPlanCallback& callback);
+
+  /**
+   * @brief Plans every exec func of the query into its own distributed plan, see PlanExecFuncs.
+   *
+   * @return the plans in the order of the exec funcs in the query, or the first error.
+   */
+  StatusOr<std::vector<distributedpb::DistributedPlan>> PlanExecFuncsToProto(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const plannerpb::QueryRequest& query);
+
+  const PlanCache& plan_cache() const { return plan_cache_; }
+
   StatusOr<std::unique_ptr<compiler::MutationsIR>> CompileTrace(
       const distributedpb::LogicalPlannerState& logical_state,
       const plannerpb::CompileMutationsRequest& mutations_req);
@@ -87,9 +146,23 @@ class LogicalPlanner : public NotCopyable {
   LogicalPlanner() {}
 
  private:
+  StatusOr<std::unique_ptr<distributed::DistributedPlan>> PlanAt(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const plannerpb::QueryRequest& query, int64_t time_now);
+  StatusOr<std::unique_ptr<distributed::DistributedPlan>> PlanAt(
+      const distributedpb::LogicalPlannerState& logical_state, const pypa::AstModulePtr& ast,
+      const compiler::ExecFuncs& exec_funcs, int64_t time_now);
+  StatusOr<distributedpb::DistributedPlan> PlanToProtoAt(
+      const distributedpb::LogicalPlannerState& logical_state, const pypa::AstModulePtr& ast,
+      const compiler::ExecFuncs& exec_funcs, int64_t time_now);
+  StatusOr<distributedpb::DistributedPlan> PlanExecFuncToProtoAt(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const compiler::AnalyzedExecFuncs& analyzed, int64_t exec_func_idx, int64_t time_now);
+
   compiler::Compiler compiler_;
   std::unique_ptr<distributed::Planner> distributed_planner_;
   std::unique_ptr<planner::RegistryInfo> registry_info_;
+  PlanCache plan_cache_;
 };
 
 }  // namespace planner
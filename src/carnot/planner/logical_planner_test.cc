@@ -95,6 +95,112 @@ TEST_F(LogicalPlannerTest, max_output_rows) {
   EXPECT_OK(plan->ToProto());
 }
 
+int64_t MemorySourceStartTime(const distributedpb::DistributedPlan& plan_pb) {
+  for (const auto& [address, agent_plan] : plan_pb.qb_address_to_plan()) {
+    for (const auto& fragment : agent_plan.nodes()) {
+      for (const auto& node : fragment.nodes()) {
+        if (node.op().op_type() == planpb::MEMORY_SOURCE_OPERATOR) {
+          return node.op().mem_source_op().start_time().value();
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+TEST_F(LogicalPlannerTest, plan_cache_rebinds_relative_times) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto request = MakeQueryRequest(kSimpleQueryDefaultLimit);
+
+  auto start_ns = CurrentTimeNS();
+  auto first_pb = planner->PlanToProto(state, request).ConsumeValueOrDie();
+  EXPECT_EQ(1, planner->plan_cache().size());
+  EXPECT_EQ(0, planner->plan_cache().num_hits());
+  EXPECT_EQ(1, planner->plan_cache().num_misses());
+
+  auto second_pb = planner->PlanToProto(state, request).ConsumeValueOrDie();
+  auto end_ns = CurrentTimeNS();
+  EXPECT_EQ(1, planner->plan_cache().size());
+  EXPECT_EQ(1, planner->plan_cache().num_hits());
+  EXPECT_EQ(1, planner->plan_cache().num_misses());
+
+  // The -120s start time is rebound to the time of the second request.
+  auto first_start_time = MemorySourceStartTime(first_pb);
+  auto second_start_time = MemorySourceStartTime(second_pb);
+  EXPECT_LE(start_ns - 120 * 1000 * 1000 * 1000LL, first_start_time);
+  EXPECT_LE(first_start_time, second_start_time);
+  EXPECT_LE(second_start_time, end_ns - 120 * 1000 * 1000 * 1000LL);
+
+  // Apart from the times, the cached plan matches the plan from a full compile.
+  auto fresh_plan = planner->Plan(state, request).ConsumeValueOrDie();
+  fresh_plan->SetPlanOptions(state.plan_options());
+  auto fresh_pb = fresh_plan->ToProto().ConsumeValueOrDie();
+  auto cached_pb = planner->PlanToProto(state, request).ConsumeValueOrDie();
+  EXPECT_EQ(2, planner->plan_cache().num_hits());
+  EXPECT_EQ(fresh_pb.qb_address_to_plan_size(), cached_pb.qb_address_to_plan_size());
+  EXPECT_THAT(cached_pb.dag(), EqualsProto(fresh_pb.dag().DebugString()));
+}
+
+constexpr char kNowArithmeticQuery[] = R"pxl(
+import px
+t1 = px.DataFrame(table='http_events', select=['time_'], start_time=px.now() - px.minutes(2),
+                  end_time=px.now() - (px.now() - px.now()))
+px.display(t1)
+)pxl";
+
+TEST_F(LogicalPlannerTest, plan_cache_rebinds_now_arithmetic) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto request = MakeQueryRequest(kNowArithmeticQuery);
+
+  ASSERT_OK(planner->PlanToProto(state, request));
+  EXPECT_EQ(1, planner->plan_cache().size());
+  ASSERT_OK(planner->PlanToProto(state, request));
+  EXPECT_EQ(1, planner->plan_cache().num_hits());
+  EXPECT_EQ(1, planner->plan_cache().num_misses());
+}
+
+constexpr char kAbsoluteStartTimeQuery[] = R"pxl(
+import px
+t1 = px.DataFrame(table='http_events', select=['time_'], start_time='2020-01-01 00:00:00 +0000',
+                  end_time='-1s')
+px.display(t1)
+)pxl";
+
+TEST_F(LogicalPlannerTest, plan_cache_keeps_absolute_times) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto request = MakeQueryRequest(kAbsoluteStartTimeQuery);
+
+  auto first_pb = planner->PlanToProto(state, request).ConsumeValueOrDie();
+  auto second_pb = planner->PlanToProto(state, request).ConsumeValueOrDie();
+  EXPECT_EQ(1, planner->plan_cache().num_hits());
+  // 2020-01-01 00:00:00 UTC.
+  EXPECT_EQ(1577836800LL * 1000 * 1000 * 1000, MemorySourceStartTime(first_pb));
+  EXPECT_EQ(1577836800LL * 1000 * 1000 * 1000, MemorySourceStartTime(second_pb));
+}
+
+constexpr char kNowQuery[] = R"pxl(
+import px
+t1 = px.DataFrame(table='http_events', select=['time_'])
+t1.now = px.now()
+px.display(t1)
+)pxl";
+
+TEST_F(LogicalPlannerTest, plan_cache_skips_time_dependent_plans) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto request = MakeQueryRequest(kNowQuery);
+
+  ASSERT_OK(planner->PlanToProto(state, request));
+  EXPECT_EQ(0, planner->plan_cache().size());
+  ASSERT_OK(planner->PlanToProto(state, request));
+  EXPECT_EQ(0, planner->plan_cache().size());
+  EXPECT_EQ(0, planner->plan_cache().num_hits());
+  EXPECT_EQ(2, planner->plan_cache().num_misses());
+}
+
 constexpr char kCompileTimeQuery[] = R"pxl(
 import px
 
@@ -442,6 +548,108 @@ TEST_F(LogicalPlannerTest, PlanWithExecFuncs) {
   EXPECT_OK(plan->ToProto());
 }
 
+constexpr char kPlanMultipleExecFuncs[] = R"pxl(
+import px
+def f(a: int):
+  return px.DataFrame('http_events', start_time='-2m')
+
+def g():
+  df = px.DataFrame('http_events', start_time='-2m')
+  return df.groupby('upid').agg(count=('resp_status', px.count))
+)pxl";
+
+TEST_F(LogicalPlannerTest, PlanExecFuncsSeparately) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  plannerpb::QueryRequest req;
+  req.set_query_str(kPlanMultipleExecFuncs);
+  auto f = req.add_exec_funcs();
+  f->set_func_name("f");
+  f->set_output_table_prefix("f_out");
+  auto a = f->add_arg_values();
+  a->set_name("a");
+  a->set_value("1");
+  auto g = req.add_exec_funcs();
+  g->set_func_name("g");
+  g->set_output_table_prefix("g_out");
+
+  auto plans_or_s = planner->PlanExecFuncsToProto(
+      testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema), req);
+  ASSERT_OK(plans_or_s);
+  auto plans = plans_or_s.ConsumeValueOrDie();
+  ASSERT_EQ(2, plans.size());
+  // Each plan only writes the result of its own exec func.
+  EXPECT_THAT(plans[0].DebugString(), ::testing::HasSubstr("\"f_out\""));
+  EXPECT_THAT(plans[0].DebugString(), ::testing::Not(::testing::HasSubstr("\"g_out\"")));
+  EXPECT_THAT(plans[1].DebugString(), ::testing::HasSubstr("\"g_out\""));
+  EXPECT_THAT(plans[1].DebugString(), ::testing::Not(::testing::HasSubstr("\"f_out\"")));
+}
+
+constexpr char kExecFuncsWithDebugTables[] = R"pxl(
+import px
+def f():
+  df = px.DataFrame('http_events', start_time='-2m')
+  px.debug(df, 'events')
+  return df
+
+def g():
+  df = px.DataFrame('http_events', start_time='-2m')
+  px.debug(df, 'events')
+  return df.groupby('upid').agg(count=('resp_status', px.count))
+)pxl";
+
+TEST_F(LogicalPlannerTest, PlanExecFuncsKeepsOwnSinkNames) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  plannerpb::QueryRequest req;
+  req.set_query_str(kExecFuncsWithDebugTables);
+  auto f = req.add_exec_funcs();
+  f->set_func_name("f");
+  f->set_output_table_prefix("f_out");
+  auto g = req.add_exec_funcs();
+  g->set_func_name("g");
+  g->set_output_table_prefix("g_out");
+
+  auto plans_or_s = planner->PlanExecFuncsToProto(
+      testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema), req);
+  ASSERT_OK(plans_or_s);
+  auto plans = plans_or_s.ConsumeValueOrDie();
+  ASSERT_EQ(2, plans.size());
+  // The debug tables are named as if each exec func was compiled on its own.
+  for (const auto& plan : plans) {
+    EXPECT_THAT(plan.DebugString(), ::testing::HasSubstr("\"_events\""));
+    EXPECT_THAT(plan.DebugString(), ::testing::Not(::testing::HasSubstr("_events_1")));
+  }
+}
+
+TEST_F(LogicalPlannerTest, PlanExecFuncsReportsEachError) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  plannerpb::QueryRequest req;
+  req.set_query_str(kPlanMultipleExecFuncs);
+  auto g = req.add_exec_funcs();
+  g->set_func_name("g");
+  g->set_output_table_prefix("g_out");
+  auto missing = req.add_exec_funcs();
+  missing->set_func_name("dne");
+  missing->set_output_table_prefix("dne_out");
+
+  std::vector<bool> plan_ok(2, false);
+  int64_t num_calls = 0;
+  ASSERT_OK(planner->PlanExecFuncs(
+      testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema), req,
+      [&](int64_t exec_func_idx, StatusOr<distributedpb::DistributedPlan> plan) {
+        plan_ok[exec_func_idx] = plan.ok();
+        ++num_calls;
+      }));
+  EXPECT_EQ(2, num_calls);
+  EXPECT_TRUE(plan_ok[0]);
+  EXPECT_FALSE(plan_ok[1]);
+
+  EXPECT_NOT_OK(planner->PlanExecFuncsToProto(
+      testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema), req));
+  req.clear_exec_funcs();
+  EXPECT_NOT_OK(planner->PlanExecFuncsToProto(
+      testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema), req));
+}
+
 constexpr char kSingleProbePxl[] = R"pxl(
 import pxtrace
 import px
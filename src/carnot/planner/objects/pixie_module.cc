@@ -345,6 +345,7 @@ StatusOr<QLObjectPtr> CompileTimeFuncHandler::NowEval(CompilerState* compiler_st
   // TODO(philkuz) switch to use TimeIR.
   PL_ASSIGN_OR_RETURN(IntIR * time_now,
                       graph->CreateNode<IntIR>(ast, compiler_state->time_now().val));
+  time_now->set_time_dependence(DataIR::TimeDependence::kRelative);
   return ExprObject::Create(time_now, visitor);
 }
 
@@ -358,6 +359,9 @@ StatusOr<QLObjectPtr> CompileTimeFuncHandler::TimeEval(IR* graph, std::chrono::n
   // TODO(philkuz) cast as durationnanos.
   PL_ASSIGN_OR_RETURN(IntIR * duration_nanos,
                       graph->CreateNode<IntIR>(ast, unit->val() * scale_ns.count()));
+  if (unit->time_dependence() != DataIR::TimeDependence::kNone) {
+    duration_nanos->set_time_dependence(DataIR::TimeDependence::kOpaque);
+  }
   return ExprObject::Create(duration_nanos, visitor);
 }
 
@@ -398,6 +402,11 @@ StatusOr<QLObjectPtr> CompileTimeFuncHandler::UPIDConstructor(IR* graph, const p
   auto upid = md::UPID(asid_ir->val(), pid_ir->val(), ts_ns_ir->val());
   PL_ASSIGN_OR_RETURN(UInt128IR * uint128_ir, graph->CreateNode<UInt128IR>(ast, upid.value()));
   uint128_ir->SetTypeCast(ValueType::Create(uint128_ir->EvaluatedDataType(), types::ST_UPID));
+  for (const IntIR* arg : {asid_ir, pid_ir, ts_ns_ir}) {
+    if (arg->time_dependence() != DataIR::TimeDependence::kNone) {
+      uint128_ir->set_time_dependence(DataIR::TimeDependence::kOpaque);
+    }
+  }
 
   return ExprObject::Create(uint128_ir, visitor);
 }
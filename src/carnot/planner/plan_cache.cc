@@ -0,0 +1,326 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/plan_cache.h"
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_cat.h>
+#include <farmhash.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "src/carnot/planner/ir/data_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+#include "src/carnot/planner/ir/pattern_match.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+namespace {
+
+// Normalizes a script so that requests that only differ in trailing whitespace, which editors and
+// clients tend to add or drop, share a cache entry. Whitespace inside the script is left alone
+// since it can be significant in PxL (indentation, multi-line strings).
+std::string_view NormalizeScript(std::string_view script) {
+  return absl::StripTrailingAsciiWhitespace(script);
+}
+
+// Row counts in the schema change with every write to a table, but the planner only uses them as
+// rough estimates. Round them down to a power of two so that the plan is only recomputed once a
+// table's size changes significantly.
+int64_t BucketNumRows(int64_t num_rows) {
+  if (num_rows <= 0) {
+    return 0;
+  }
+  int64_t bucket = 1;
+  while (bucket <= num_rows / 2) {
+    bucket *= 2;
+  }
+  return bucket;
+}
+
+// Builds a digest of a planning request out of fixed size hashes of its parts. Each part is hashed
+// where it is, so the request is never copied or serialized as a whole. This matters for the
+// metadata bloom filters of the agents, which make up most of the planner state.
+class RequestDigest {
+ public:
+  void Add(std::string_view bytes) { Add(::util::Hash64(bytes.data(), bytes.size())); }
+  void Add(uint64_t value) { digest_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+  void Add(const google::protobuf::Message& msg) {
+    scratch_.clear();
+    {
+      google::protobuf::io::StringOutputStream stream(&scratch_);
+      google::protobuf::io::CodedOutputStream coded(&stream);
+      coded.SetSerializationDeterministic(true);
+      msg.SerializeToCodedStream(&coded);
+    }
+    Add(std::string_view(scratch_));
+  }
+  template <typename TContainer>
+  void AddAll(const TContainer& values) {
+    Add(static_cast<uint64_t>(values.size()));
+    for (const auto& value : values) {
+      Add(value);
+    }
+  }
+
+  const std::string& digest() const { return digest_; }
+
+ private:
+  std::string digest_;
+  std::string scratch_;
+};
+
+// Adds every field of the planner state to the digest. Fields added to the state have to be added
+// here as well, otherwise requests that differ in them share a plan.
+void AddPlannerState(const distributedpb::LogicalPlannerState& logical_state,
+                     RequestDigest* digest) {
+  const auto& distributed_state = logical_state.distributed_state();
+  digest->Add(static_cast<uint64_t>(distributed_state.carnot_info_size()));
+  for (const auto& carnot_info : distributed_state.carnot_info()) {
+    digest->Add(carnot_info.query_broker_address());
+    digest->Add(carnot_info.agent_id());
+    digest->Add(static_cast<uint64_t>(carnot_info.has_grpc_server()) |
+                static_cast<uint64_t>(carnot_info.has_data_store()) << 1 |
+                static_cast<uint64_t>(carnot_info.processes_data()) << 2 |
+                static_cast<uint64_t>(carnot_info.accepts_remote_sources()) << 3 |
+                static_cast<uint64_t>(carnot_info.has_metadata_info()) << 4);
+    digest->Add(carnot_info.grpc_address());
+    digest->AddAll(carnot_info.table_info());
+    digest->Add(static_cast<uint64_t>(carnot_info.asid()));
+    digest->Add(carnot_info.ssl_targetname());
+    const auto& metadata_info = carnot_info.metadata_info();
+    digest->Add(static_cast<uint64_t>(metadata_info.metadata_fields_size()));
+    for (int metadata_field : metadata_info.metadata_fields()) {
+      digest->Add(static_cast<uint64_t>(metadata_field));
+    }
+    digest->Add(metadata_info.xxhash64_bloom_filter().data());
+    digest->Add(static_cast<uint64_t>(metadata_info.xxhash64_bloom_filter().num_hashes()));
+  }
+  digest->Add(static_cast<uint64_t>(distributed_state.schema_info_size()));
+  for (const auto& schema_info : distributed_state.schema_info()) {
+    digest->Add(schema_info.name());
+    digest->Add(schema_info.relation());
+    digest->AddAll(schema_info.agent_list());
+    digest->Add(static_cast<uint64_t>(BucketNumRows(schema_info.num_rows())));
+  }
+  digest->Add(logical_state.plan_options());
+  digest->Add(logical_state.result_address());
+  digest->Add(logical_state.result_ssl_targetname());
+}
+
+// Adds the time of the memory source to relative_times if it's relative to the compile time.
+// Returns false if the time depends on the compile time in any other way.
+bool AddRelativeTime(const std::string& qb_address, const MemorySourceIR* mem_src,
+                     bool is_stop_time, std::vector<PlanCache::RelativeTime>* relative_times) {
+  const ExpressionIR* expr = is_stop_time ? mem_src->end_time_expr() : mem_src->start_time_expr();
+  if (!expr->IsData()) {
+    return true;
+  }
+  auto time_dependence = static_cast<const DataIR*>(expr)->time_dependence();
+  if (time_dependence == DataIR::TimeDependence::kNone) {
+    return true;
+  }
+  // The time is only known to be relative if it was set from the expression, rather than merged
+  // with the time of another source.
+  int64_t time_ns = is_stop_time ? mem_src->time_stop_ns() : mem_src->time_start_ns();
+  if (time_dependence != DataIR::TimeDependence::kRelative || !Match(expr, Int()) ||
+      static_cast<const IntIR*>(expr)->val() != time_ns) {
+    return false;
+  }
+  relative_times->push_back({qb_address, mem_src->id(), is_stop_time});
+  return true;
+}
+
+planpb::MemorySourceOperator* MutableMemSource(distributedpb::DistributedPlan* plan,
+                                               const std::string& qb_address, int fragment_idx,
+                                               int node_idx) {
+  auto& agent_plan = (*plan->mutable_qb_address_to_plan())[qb_address];
+  return agent_plan.mutable_nodes(fragment_idx)
+      ->mutable_nodes(node_idx)
+      ->mutable_op()
+      ->mutable_mem_source_op();
+}
+
+}  // namespace
+
+std::string PlanCache::Key(const distributedpb::LogicalPlannerState& logical_state,
+                           const plannerpb::QueryRequest& query_request) {
+  RequestDigest digest;
+  digest.Add(NormalizeScript(query_request.query_str()));
+  digest.AddAll(query_request.exec_funcs());
+  AddPlannerState(logical_state, &digest);
+
+  // Two differently seeded hashes make a 128-bit fingerprint, so collisions aren't a concern.
+  const std::string& bytes = digest.digest();
+  return absl::StrCat(
+      absl::Hex(::util::Hash64WithSeed(bytes.data(), bytes.size(), 0), absl::kZeroPad16),
+      absl::Hex(::util::Hash64WithSeed(bytes.data(), bytes.size(), 0x9ae16a3b2f90404fULL),
+                absl::kZeroPad16));
+}
+
+bool PlanCache::FindRelativeTimes(const distributed::DistributedPlan& plan,
+                                  std::vector<RelativeTime>* relative_times) {
+  for (int64_t carnot_id : plan.dag().nodes()) {
+    const distributed::CarnotInstance* carnot = plan.Get(carnot_id);
+    const IR* agent_plan = carnot->plan();
+    for (int64_t node_id : agent_plan->dag().nodes()) {
+      IRNode* node = agent_plan->Get(node_id);
+      if (Match(node, MemorySource())) {
+        auto mem_src = static_cast<const MemorySourceIR*>(node);
+        if (!mem_src->IsTimeSet() || !mem_src->HasTimeExpressions()) {
+          continue;
+        }
+        if (!AddRelativeTime(carnot->QueryBrokerAddress(), mem_src, /* is_stop_time */ false,
+                             relative_times) ||
+            !AddRelativeTime(carnot->QueryBrokerAddress(), mem_src, /* is_stop_time */ true,
+                             relative_times)) {
+          return false;
+        }
+        continue;
+      }
+      if (!Match(node, DataNode()) ||
+          static_cast<DataIR*>(node)->time_dependence() == DataIR::TimeDependence::kNone) {
+        continue;
+      }
+      // Only memory source times can be rebound. Literals without parents are left over from
+      // evaluating expressions at compile time and aren't part of the plan.
+      for (int64_t parent_id : agent_plan->dag().ParentsOf(node_id)) {
+        if (!Match(agent_plan->Get(parent_id), MemorySource())) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+std::optional<distributedpb::DistributedPlan> PlanCache::Lookup(const std::string& key,
+                                                                int64_t time_now) {
+  absl::MutexLock lock(&lock_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++num_misses_;
+    return std::nullopt;
+  }
+  ++num_hits_;
+  Entry& entry = it->second;
+  entry.last_used = ++use_counter_;
+  distributedpb::DistributedPlan plan = entry.plan;
+  ShiftTimes(entry.relative_times, time_now - entry.time_now, &plan);
+  return plan;
+}
+
+bool PlanCache::Insert(const std::string& key, const distributedpb::DistributedPlan& plan,
+                       int64_t time_now, const std::vector<RelativeTime>& relative_times) {
+  Entry entry;
+  for (const auto& relative_time : relative_times) {
+    auto agent_plan_it = plan.qb_address_to_plan().find(relative_time.qb_address);
+    if (agent_plan_it == plan.qb_address_to_plan().end()) {
+      return false;
+    }
+    bool found = false;
+    const auto& agent_plan = agent_plan_it->second;
+    for (int fragment_idx = 0; !found && fragment_idx < agent_plan.nodes_size(); ++fragment_idx) {
+      const auto& fragment = agent_plan.nodes(fragment_idx);
+      for (int node_idx = 0; !found && node_idx < fragment.nodes_size(); ++node_idx) {
+        const auto& node = fragment.nodes(node_idx);
+        if (node.id() != relative_time.node_id ||
+            node.op().op_type() != planpb::MEMORY_SOURCE_OPERATOR) {
+          continue;
+        }
+        entry.relative_times.push_back(
+            {relative_time.qb_address, fragment_idx, node_idx, relative_time.is_stop_time});
+        found = true;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  entry.plan = plan;
+  entry.time_now = time_now;
+
+  absl::MutexLock lock(&lock_);
+  if (!entries_.contains(key)) {
+    EvictIfFull();
+  }
+  entry.last_used = ++use_counter_;
+  entries_[key] = std::move(entry);
+  return true;
+}
+
+void PlanCache::Clear() {
+  absl::MutexLock lock(&lock_);
+  entries_.clear();
+}
+
+size_t PlanCache::size() const {
+  absl::MutexLock lock(&lock_);
+  return entries_.size();
+}
+
+int64_t PlanCache::num_hits() const {
+  absl::MutexLock lock(&lock_);
+  return num_hits_;
+}
+
+int64_t PlanCache::num_misses() const {
+  absl::MutexLock lock(&lock_);
+  return num_misses_;
+}
+
+void PlanCache::EvictIfFull() {
+  if (entries_.size() < max_entries_) {
+    return;
+  }
+  auto lru = entries_.end();
+  uint64_t lru_last_used = std::numeric_limits<uint64_t>::max();
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->second.last_used < lru_last_used) {
+      lru_last_used = it->second.last_used;
+      lru = it;
+    }
+  }
+  if (lru != entries_.end()) {
+    entries_.erase(lru);
+  }
+}
+
+void PlanCache::ShiftTimes(const std::vector<TimeSlot>& slots, int64_t shift,
+                           distributedpb::DistributedPlan* plan) {
+  if (shift == 0) {
+    return;
+  }
+  for (const auto& slot : slots) {
+    auto mem_src = MutableMemSource(plan, slot.qb_address, slot.fragment_idx, slot.node_idx);
+    auto time = slot.is_stop_time ? mem_src->mutable_stop_time() : mem_src->mutable_start_time();
+    time->set_value(time->value() + shift);
+  }
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+
+#include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/carnot/planner/plannerpb/func_args.pb.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * @brief PlanCache keeps the distributed plans of recently planned scripts so that repeated
+ * requests, such as dashboards refreshing the same script, can skip compilation.
+ *
+ * Entries are keyed by a fingerprint of the normalized script, its arguments and a digest of the
+ * LogicalPlannerState (schemas, agents and plan options). The registry isn't part of the key:
+ * a cache belongs to a single LogicalPlanner, which clears it whenever the registry is replaced.
+ *
+ * The only input to compilation that changes between refreshes is the compile time, which
+ * relative start/stop times ("-5m") are resolved against. The compiler marks the literals derived
+ * from the compile time, so the memory source times that move with it are found from the IR and
+ * rebound on every hit. Plans that depend on the compile time in any other way (e.g. px.now() in
+ * an expression) aren't cached.
+ */
+class PlanCache : public NotCopyable {
+ public:
+  static constexpr size_t kDefaultMaxEntries = 64;
+
+  // A memory source start or stop time that is relative to the compile time.
+  struct RelativeTime {
+    std::string qb_address;
+    int64_t node_id;
+    bool is_stop_time;
+  };
+
+  explicit PlanCache(size_t max_entries = kDefaultMaxEntries) : max_entries_(max_entries) {}
+
+  /**
+   * @brief Computes the cache key of a planning request.
+   */
+  static std::string Key(const distributedpb::LogicalPlannerState& logical_state,
+                         const plannerpb::QueryRequest& query_request);
+
+  /**
+   * @brief Finds the memory source times of the plan that are relative to the compile time.
+   *
+   * @return false if the plan depends on the compile time in a way that can't be rebound.
+   */
+  static bool FindRelativeTimes(const distributed::DistributedPlan& plan,
+                                std::vector<RelativeTime>* relative_times);
+
+  /**
+   * @brief Returns the cached plan for key, with its relative times rebound to time_now, or
+   * std::nullopt if there is no cached plan.
+   */
+  std::optional<distributedpb::DistributedPlan> Lookup(const std::string& key, int64_t time_now);
+
+  /**
+   * @brief Inserts the plan for key, planned at time_now. The relative_times of the plan are
+   * rebound on every hit.
+   *
+   * @return true if the plan was cached, false if a relative time isn't part of the plan.
+   */
+  bool Insert(const std::string& key, const distributedpb::DistributedPlan& plan, int64_t time_now,
+              const std::vector<RelativeTime>& relative_times);
+
+  void Clear();
+  size_t size() const;
+  int64_t num_hits() const;
+  int64_t num_misses() const;
+
+ private:
+  // The location of a relative time in the plan proto.
+  struct TimeSlot {
+    std::string qb_address;
+    int fragment_idx;
+    int node_idx;
+    bool is_stop_time;
+  };
+
+  struct Entry {
+    distributedpb::DistributedPlan plan;
+    int64_t time_now = 0;
+    std::vector<TimeSlot> relative_times;
+    uint64_t last_used = 0;
+  };
+
+  static void ShiftTimes(const std::vector<TimeSlot>& slots, int64_t shift,
+                         distributedpb::DistributedPlan* plan);
+  void EvictIfFull() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const size_t max_entries_;
+  mutable absl::Mutex lock_;
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(lock_);
+  uint64_t use_counter_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t num_hits_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t num_misses_ ABSL_GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
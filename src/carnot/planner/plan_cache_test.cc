@@ -0,0 +1,167 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planner/plan_cache.h"
+#include "src/common/testing/protobuf.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+using px::testing::proto::EqualsProto;
+
+constexpr char kPlanTmpl[] = R"proto(
+qb_address_to_plan {
+  key: "pem"
+  value {
+    nodes {
+      id: 1
+      nodes {
+        id: 1
+        op {
+          op_type: MEMORY_SOURCE_OPERATOR
+          mem_source_op {
+            name: "http_events"
+            start_time { value: $0 }
+            stop_time { value: $1 }
+          }
+        }
+      }
+      nodes {
+        id: 2
+        op {
+          op_type: MAP_OPERATOR
+          map_op {
+            expressions { constant { data_type: INT64 int64_value: $2 } }
+          }
+        }
+      }
+    }
+  }
+}
+qb_address_to_dag_id {
+  key: "pem"
+  value: 0
+}
+)proto";
+
+distributedpb::DistributedPlan MakePlan(int64_t start_time, int64_t stop_time,
+                                        int64_t map_constant) {
+  distributedpb::DistributedPlan plan;
+  CHECK(google::protobuf::TextFormat::ParseFromString(
+      absl::Substitute(kPlanTmpl, start_time, stop_time, map_constant), &plan));
+  return plan;
+}
+
+TEST(PlanCacheTest, key_depends_on_script_args_and_state) {
+  distributedpb::LogicalPlannerState state;
+  plannerpb::QueryRequest req;
+  req.set_query_str("import px\npx.display(px.DataFrame('http_events'))");
+  auto key = PlanCache::Key(state, req);
+
+  // Trailing whitespace doesn't change the plan.
+  plannerpb::QueryRequest trailing_whitespace = req;
+  trailing_whitespace.set_query_str(req.query_str() + "\n  \n");
+  EXPECT_EQ(key, PlanCache::Key(state, trailing_whitespace));
+
+  plannerpb::QueryRequest other_script = req;
+  other_script.set_query_str("import px\npx.display(px.DataFrame('conn_stats'))");
+  EXPECT_NE(key, PlanCache::Key(state, other_script));
+
+  plannerpb::QueryRequest with_args = req;
+  auto exec_func = with_args.add_exec_funcs();
+  exec_func->set_func_name("main");
+  exec_func->set_output_table_prefix("out");
+  EXPECT_NE(key, PlanCache::Key(state, with_args));
+
+  distributedpb::LogicalPlannerState other_state;
+  other_state.mutable_plan_options()->set_max_output_rows_per_table(100);
+  EXPECT_NE(key, PlanCache::Key(other_state, req));
+}
+
+TEST(PlanCacheTest, key_buckets_table_num_rows) {
+  plannerpb::QueryRequest req;
+  req.set_query_str("import px\npx.display(px.DataFrame('http_events'))");
+  auto key_with_num_rows = [&req](int64_t num_rows) {
+    distributedpb::LogicalPlannerState state;
+    auto schema_info = state.mutable_distributed_state()->add_schema_info();
+    schema_info->set_name("http_events");
+    schema_info->set_num_rows(num_rows);
+    return PlanCache::Key(state, req);
+  };
+
+  // Small changes in a table's size keep the cached plan, large ones don't.
+  EXPECT_EQ(key_with_num_rows(1100), key_with_num_rows(1500));
+  EXPECT_NE(key_with_num_rows(1100), key_with_num_rows(2100));
+  EXPECT_NE(key_with_num_rows(0), key_with_num_rows(1));
+}
+
+TEST(PlanCacheTest, rebinds_relative_times) {
+  PlanCache cache;
+  // The start time is relative to the compile time, the stop time is absolute.
+  std::vector<PlanCache::RelativeTime> relative_times{{"pem", 1, /* is_stop_time */ false}};
+  EXPECT_TRUE(cache.Insert("key", MakePlan(100 - 10, 500, 7), 100, relative_times));
+  EXPECT_FALSE(cache.Lookup("other_key", 1000).has_value());
+
+  auto plan = cache.Lookup("key", 1000);
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_THAT(plan.value(), EqualsProto(MakePlan(1000 - 10, 500, 7).DebugString()));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(1, cache.num_hits());
+  EXPECT_EQ(1, cache.num_misses());
+}
+
+TEST(PlanCacheTest, relative_time_must_be_a_memory_source) {
+  PlanCache cache;
+  // Node 2 is the map, which has no times to rebind.
+  EXPECT_FALSE(cache.Insert("key", MakePlan(90, 500, 7), 100, {{"pem", 2, false}}));
+  EXPECT_FALSE(cache.Insert("key", MakePlan(90, 500, 7), 100, {{"kelvin", 1, false}}));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST(PlanCacheTest, evicts_least_recently_used) {
+  PlanCache cache(/* max_entries */ 2);
+  auto plan = MakePlan(90, 500, 7);
+  EXPECT_TRUE(cache.Insert("a", plan, 100, {}));
+  EXPECT_TRUE(cache.Insert("b", plan, 100, {}));
+  // Touch "a" so that "b" is the least recently used entry.
+  EXPECT_TRUE(cache.Lookup("a", 100).has_value());
+  EXPECT_TRUE(cache.Insert("c", plan, 100, {}));
+
+  EXPECT_EQ(2, cache.size());
+  EXPECT_TRUE(cache.Lookup("a", 100).has_value());
+  EXPECT_FALSE(cache.Lookup("b", 100).has_value());
+  EXPECT_TRUE(cache.Lookup("c", 100).has_value());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.size());
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/util/json_util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/match.h>
+#include <absl/strings/str_format.h>
+
+#ifdef TCMALLOC
+#include <gperftools/malloc_hook.h>
+#endif
+
+#include "src/api/proto/vispb/vis.pb.h"
+#include "src/carnot/planner/compiler/compiler.h"
+#include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/distributed/splitter/splitter.h"
+#include "src/carnot/planner/logical_planner.h"
+#include "src/carnot/planner/parser/parser.h"
+#include "src/carnot/planner/test_utils.h"
+#include "src/carnot/udf_exporter/udf_exporter.h"
+#include "src/common/base/base.h"
+#include "src/common/base/file.h"
+#include "src/common/testing/test_environment.h"
+
+DEFINE_int32(num_pems, 500, "The number of PEMs in the cluster that the scripts are planned for.");
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace pxl_scripts_benchmark {
+
+// Plans every script under src/pxl_scripts with the exec funcs of its vis spec, the same way the
+// UI runs them (see src/e2e_test/vizier/planner/all_scripts_test.go), and reports the time and
+// the allocations of each planning phase.
+constexpr std::string_view kPxlScriptsDir = "src/pxl_scripts";
+// The schemas of all of the Stirling tables, dumped by //src/e2e_test/vizier/planner/dump_schemas.
+constexpr std::string_view kSchemasPath =
+    "src/e2e_test/vizier/planner/dump_schemas/all_schemas.bin";
+
+// Every allocation in the process, counted through the tcmalloc hooks.
+std::atomic<int64_t> num_allocs{0};
+std::atomic<int64_t> num_alloc_bytes{0};
+
+#ifdef TCMALLOC
+void CountAllocation(const void* /* ptr */, size_t size) {
+  num_allocs.fetch_add(1, std::memory_order_relaxed);
+  num_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+#endif
+
+struct PhaseStats {
+  std::string name;
+  int64_t time_ns = 0;
+  int64_t allocs = 0;
+  int64_t alloc_bytes = 0;
+};
+
+/**
+ * @brief Adds the time and the allocations made during its lifetime to the stats of a phase.
+ */
+class ScopedPhase : public NotCopyable {
+ public:
+  explicit ScopedPhase(PhaseStats* stats)
+      : stats_(stats),
+        start_allocs_(num_allocs.load(std::memory_order_relaxed)),
+        start_alloc_bytes_(num_alloc_bytes.load(std::memory_order_relaxed)),
+        start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedPhase() {
+    auto end = std::chrono::steady_clock::now();
+    stats_->time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+    stats_->allocs += num_allocs.load(std::memory_order_relaxed) - start_allocs_;
+    stats_->alloc_bytes += num_alloc_bytes.load(std::memory_order_relaxed) - start_alloc_bytes_;
+  }
+
+ private:
+  PhaseStats* stats_;
+  int64_t start_allocs_;
+  int64_t start_alloc_bytes_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+struct Script {
+  std::string name;
+  plannerpb::QueryRequest query_request;
+};
+
+// The value the UI passes for a vis variable that the user hasn't set.
+std::string DefaultArgValue(const vispb::Vis::Variable& variable) {
+  if (variable.has_default_value() && !variable.default_value().value().empty()) {
+    return variable.default_value().value();
+  }
+  if (variable.valid_values_size() > 0) {
+    return variable.valid_values(0);
+  }
+  switch (variable.type()) {
+    case vispb::PX_BOOLEAN:
+      return "True";
+    case vispb::PX_INT64:
+      return "1";
+    case vispb::PX_FLOAT64:
+      return "1.0";
+    case vispb::PX_SERVICE:
+    case vispb::PX_POD:
+    case vispb::PX_CONTAINER:
+    case vispb::PX_NAMESPACE:
+    case vispb::PX_NODE:
+      return "pl";
+    case vispb::PX_LIST:
+      return "[]";
+    case vispb::PX_STRING_LIST:
+      return "[\"\"]";
+    default:
+      return "";
+  }
+}
+
+void AddExecFunc(const vispb::Widget::Func& func,
+                 const absl::flat_hash_map<std::string, const vispb::Vis::Variable*>& variables,
+                 plannerpb::QueryRequest* query_request) {
+  auto exec_func = query_request->add_exec_funcs();
+  exec_func->set_func_name(func.name());
+  exec_func->set_output_table_prefix(func.name());
+  for (const auto& arg : func.args()) {
+    auto arg_value = exec_func->add_arg_values();
+    arg_value->set_name(arg.name());
+    if (arg.variable().empty()) {
+      arg_value->set_value(arg.value());
+      continue;
+    }
+    auto variable = variables.find(arg.variable());
+    if (variable != variables.end()) {
+      arg_value->set_value(DefaultArgValue(*variable->second));
+    }
+  }
+}
+
+Status AddVisExecFuncs(const std::filesystem::path& vis_path,
+                       plannerpb::QueryRequest* query_request) {
+  PL_ASSIGN_OR_RETURN(std::string vis_json, ReadFileToString(vis_path.string()));
+  vispb::Vis vis;
+  google::protobuf::util::JsonParseOptions options;
+  options.ignore_unknown_fields = true;
+  auto status = google::protobuf::util::JsonStringToMessage(vis_json, &vis, options);
+  if (!status.ok()) {
+    return error::InvalidArgument("Failed to parse $0: $1", vis_path.string(), status.ToString());
+  }
+
+  absl::flat_hash_map<std::string, const vispb::Vis::Variable*> variables;
+  for (const auto& variable : vis.variables()) {
+    variables[variable.name()] = &variable;
+  }
+  for (const auto& global_func : vis.global_funcs()) {
+    AddExecFunc(global_func.func(), variables, query_request);
+  }
+  for (const auto& widget : vis.widgets()) {
+    if (widget.has_func()) {
+      AddExecFunc(widget.func(), variables, query_request);
+    }
+  }
+  return Status::OK();
+}
+
+StatusOr<std::vector<Script>> LoadScripts() {
+  std::filesystem::path scripts_dir = px::testing::TestFilePath(kPxlScriptsDir);
+  std::vector<Script> scripts;
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(scripts_dir)) {
+    const std::filesystem::path& pxl_path = entry.path();
+    if (pxl_path.extension() != ".pxl") {
+      continue;
+    }
+    Script script;
+    script.name = std::filesystem::relative(pxl_path, scripts_dir).replace_extension().string();
+    PL_ASSIGN_OR_RETURN(std::string query_str, ReadFileToString(pxl_path.string()));
+    // Scripts that deploy tracepoints are compiled into mutations rather than plans.
+    if (absl::StrContains(query_str, "pxtrace")) {
+      continue;
+    }
+    script.query_request.set_query_str(query_str);
+
+    auto vis_path = pxl_path.parent_path() / "vis.json";
+    if (std::filesystem::exists(vis_path)) {
+      PL_RETURN_IF_ERROR(AddVisExecFuncs(vis_path, &script.query_request));
+    }
+    scripts.push_back(std::move(script));
+  }
+  std::sort(scripts.begin(), scripts.end(),
+            [](const Script& a, const Script& b) { return a.name < b.name; });
+  return scripts;
+}
+
+// A cluster of num_pems PEMs and one Kelvin, where every PEM has every table.
+StatusOr<distributedpb::LogicalPlannerState> MakeLargeClusterState(int64_t num_pems) {
+  PL_ASSIGN_OR_RETURN(
+      std::string schemas_str,
+      ReadFileToString(px::testing::BazelBinTestFilePath(kSchemasPath).string(),
+                       std::ios_base::in | std::ios_base::binary));
+  table_store::schemapb::Schema schema;
+  if (!schema.ParseFromString(schemas_str)) {
+    return error::InvalidArgument("Failed to parse the schemas in $0", kSchemasPath);
+  }
+
+  std::vector<std::string> carnot_infos;
+  for (int64_t i = 0; i < num_pems; ++i) {
+    carnot_infos.push_back(testutils::MakePEMCarnotInfo(
+        absl::StrFormat("pem%d", i), absl::StrFormat("00000001-0000-0000-0000-%012d", i),
+        /* asid */ i, /* table_info */ {}));
+  }
+  carnot_infos.push_back(testutils::MakeKelvinCarnotInfo(
+      "kelvin", "00000002-0000-0000-0000-000000000001", "1111", /* asid */ num_pems));
+  return testutils::LoadLogicalPlannerStatePB(testutils::MakeDistributedState(carnot_infos),
+                                              schema);
+}
+
+// NOLINTNEXTLINE : runtime/references.
+void BM_PlanScript(benchmark::State& state, const plannerpb::QueryRequest& query_request,
+                   const distributedpb::LogicalPlannerState& logical_state,
+                   RegistryInfo* registry_info) {
+  // Parse includes walking the AST into the IR.
+  PhaseStats parse{"parse"};
+  PhaseStats analyze{"analyze"};
+  PhaseStats optimize{"optimize"};
+  PhaseStats split{"split"};
+  PhaseStats coordinate{"coordinate"};
+  compiler::ExecFuncs exec_funcs(query_request.exec_funcs().begin(),
+                                 query_request.exec_funcs().end());
+  compiler::Compiler compiler;
+  auto distributed_planner = distributed::DistributedPlanner::Create().ConsumeValueOrDie();
+
+  for (auto _ : state) {
+    auto compiler_state =
+        CreateCompilerState(logical_state, registry_info,
+                            logical_state.plan_options().max_output_rows_per_table(),
+                            px::CurrentTimeNS())
+            .ConsumeValueOrDie();
+    std::shared_ptr<IR> ir;
+    {
+      ScopedPhase phase(&parse);
+      Parser parser;
+      auto ast = parser.Parse(query_request.query_str()).ConsumeValueOrDie();
+      ir = compiler.QueryToIR(ast, compiler_state.get(), exec_funcs).ConsumeValueOrDie();
+    }
+    {
+      ScopedPhase phase(&analyze);
+      PL_CHECK_OK(compiler.Analyze(ir.get(), compiler_state.get()));
+    }
+    {
+      ScopedPhase phase(&optimize);
+      PL_CHECK_OK(compiler.Optimize(ir.get(), compiler_state.get()));
+    }
+    std::unique_ptr<distributed::BlockingSplitPlan> split_plan;
+    {
+      ScopedPhase phase(&split);
+      auto splitter = distributed::Splitter::Create(compiler_state.get(),
+                                                    /* support_partial_agg */ true)
+                          .ConsumeValueOrDie();
+      split_plan = splitter->SplitKelvinAndAgents(ir.get()).ConsumeValueOrDie();
+    }
+    {
+      ScopedPhase phase(&coordinate);
+      auto distributed_plan = distributed_planner
+                                  ->PlanSplit(logical_state.distributed_state(),
+                                              compiler_state.get(), *split_plan)
+                                  .ConsumeValueOrDie();
+      benchmark::DoNotOptimize(distributed_plan);
+    }
+  }
+
+  for (const PhaseStats* phase : {&parse, &analyze, &optimize, &split, &coordinate}) {
+    state.counters[phase->name + "_us"] =
+        benchmark::Counter(phase->time_ns / 1000.0, benchmark::Counter::kAvgIterations);
+#ifdef TCMALLOC
+    state.counters[phase->name + "_allocs"] =
+        benchmark::Counter(phase->allocs, benchmark::Counter::kAvgIterations);
+    state.counters[phase->name + "_alloc_bytes"] =
+        benchmark::Counter(phase->alloc_bytes, benchmark::Counter::kAvgIterations,
+                           benchmark::Counter::OneK::kIs1024);
+#endif
+  }
+}
+
+}  // namespace pxl_scripts_benchmark
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
+
+int main(int argc, char** argv) {
+  using px::carnot::planner::pxl_scripts_benchmark::BM_PlanScript;
+  using px::carnot::planner::pxl_scripts_benchmark::LoadScripts;
+  using px::carnot::planner::pxl_scripts_benchmark::MakeLargeClusterState;
+
+  benchmark::Initialize(&argc, argv);
+  px::EnvironmentGuard env_guard(&argc, argv);
+#ifdef TCMALLOC
+  CHECK(MallocHook::AddNewHook(&px::carnot::planner::pxl_scripts_benchmark::CountAllocation));
+#endif
+
+  PL_ASSIGN_OR_EXIT(auto registry_info, px::carnot::udfexporter::ExportUDFInfo());
+  PL_ASSIGN_OR_EXIT(auto planner, px::carnot::planner::LogicalPlanner::Create(
+                                      registry_info->info_pb()));
+  PL_ASSIGN_OR_EXIT(auto logical_state, MakeLargeClusterState(FLAGS_num_pems));
+  PL_ASSIGN_OR_EXIT(auto scripts, LoadScripts());
+
+  for (const auto& script : scripts) {
+    // Only benchmark the scripts that plan, a broken script shouldn't hide the others.
+    auto plan_or_s = planner->Plan(logical_state, script.query_request);
+    if (!plan_or_s.ok()) {
+      LOG(WARNING) << absl::Substitute("Skipping $0: $1", script.name, plan_or_s.msg());
+      continue;
+    }
+    benchmark::RegisterBenchmark(script.name.c_str(), BM_PlanScript, script.query_request,
+                                 logical_state, registry_info.get())
+        ->Unit(benchmark::kMillisecond);
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
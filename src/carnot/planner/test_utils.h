@@ -1867,7 +1867,7 @@ class DistributedRulesTest : public OperatorTests {
   std::unique_ptr<distributed::BlockingSplitPlan> SplitPlan(IR* logical_plan) {
     std::unique_ptr<distributed::Splitter> splitter =
         distributed::Splitter::Create(compiler_state_.get(),
-                                      /* support_partial_agg */ false)
+                                      /* support_partial_agg */ true)
             .ConsumeValueOrDie();
     return splitter->SplitKelvinAndAgents(logical_plan).ConsumeValueOrDie();
   }
@@ -21,6 +21,8 @@
 #include <memory>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/carnot/exec/ml/model_pool.h"
 #include "src/shared/metadata/metadata_state.h"
 #include "src/shared/types/types.h"
@@ -41,9 +43,61 @@ class FunctionContext {
   const px::md::AgentMetadataState* metadata_state() const { return metadata_state_.get(); }
   exec::ml::ModelPool* model_pool() { return model_pool_; }
 
+  /**
+   * The metadata objects that a UPID resolves to. Each of them may be null.
+   */
+  struct UPIDMetadata {
+    const md::PIDInfo* pid_info = nullptr;
+    const md::ContainerInfo* container_info = nullptr;
+    const md::PodInfo* pod_info = nullptr;
+  };
+
+  /**
+   * Resolves a UPID to its process, container and pod in metadata_state().
+   *
+   * Each UPID is only looked up once per metadata_state() generation. The result is shared by all
+   * functions that execute with this context, such as the pod, service and namespace columns that
+   * a single map computes from the same UPID column.
+   */
+  UPIDMetadata ResolveUPID(const md::UPID& upid) {
+    uint64_t generation = metadata_state_ == nullptr ? 0 : metadata_state_->generation();
+    if (generation != resolved_generation_) {
+      resolved_upids_.clear();
+      resolved_generation_ = generation;
+    }
+
+    auto it = resolved_upids_.find(upid);
+    if (it != resolved_upids_.end()) {
+      return it->second;
+    }
+
+    UPIDMetadata resolved;
+    if (metadata_state_ != nullptr) {
+      resolved.pid_info = metadata_state_->GetPIDByUPID(upid);
+      if (resolved.pid_info != nullptr) {
+        const auto& k8s_state = metadata_state_->k8s_metadata_state();
+        resolved.container_info = k8s_state.ContainerInfoByID(resolved.pid_info->cid());
+        if (resolved.container_info != nullptr) {
+          resolved.pod_info = k8s_state.PodInfoByID(resolved.container_info->pod_id());
+        }
+      }
+    }
+
+    // Bound the memory used by long-running queries over many short-lived processes.
+    if (resolved_upids_.size() >= kMaxResolvedUPIDs) {
+      resolved_upids_.clear();
+    }
+    resolved_upids_.emplace(upid, resolved);
+    return resolved;
+  }
+
  private:
+  static constexpr size_t kMaxResolvedUPIDs = 16384;
+
   std::shared_ptr<const px::md::AgentMetadataState> metadata_state_;
   exec::ml::ModelPool* model_pool_;
+  absl::flat_hash_map<md::UPID, UPIDMetadata> resolved_upids_;
+  uint64_t resolved_generation_ = 0;
 };
 
 /**
@@ -70,6 +70,7 @@ void Registry::ToProto(const ScalarUDFDefinition& def, udfspb::ScalarUDFSpec* sp
   spec->set_return_type(def.exec_return_type());
   spec->set_name(def.name());
   spec->set_executor(def.executor());
+  spec->set_nondeterministic(!def.deterministic());
 }
 
 void Registry::ToProto(const UDADefinition& def, udfspb::UDASpec* spec) {
@@ -291,6 +291,27 @@ TEST(Registry, ToProto) {
   EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(expected_udf_info, udf_info));
 }
 
+class NondeterministicUDF : public ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value b1) { return b1.val + counter_++; }
+  static constexpr bool Deterministic() { return false; }
+
+ private:
+  int64_t counter_ = 0;
+};
+
+TEST(Registry, ToProtoNondeterministic) {
+  auto registry = Registry("test registry");
+  registry.RegisterOrDie<ScalarUDF1>("scalar1");
+  registry.RegisterOrDie<NondeterministicUDF>("nondeterministic");
+
+  auto udf_info = registry.ToProto();
+  ASSERT_EQ(2, udf_info.scalar_udfs_size());
+  for (const auto& spec : udf_info.scalar_udfs()) {
+    EXPECT_EQ(spec.name() == "nondeterministic", spec.nondeterministic());
+  }
+}
+
 class BasicUDTFTwoCol : public UDTF<BasicUDTFTwoCol> {
  public:
   static constexpr auto Executor() { return udfspb::UDTFSourceExecutor::UDTF_ALL_AGENTS; }
@@ -167,6 +167,16 @@ struct has_udf_executor_fn<T, std::void_t<decltype(&T::Executor)>> : std::true_t
       "If an executor function exists, it must have the form: UDFSourceExecutor Executor()");
 };
 
+// SFINAE test for Deterministic fn.
+template <typename T, typename = void>
+struct has_udf_deterministic_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_deterministic_fn<T, std::void_t<decltype(&T::Deterministic)>> : std::true_type {
+  static_assert(std::is_same_v<decltype(&T::Deterministic), bool (*)()>,
+                "If a deterministic function exists, it must have the form: bool Deterministic()");
+};
+
 template <typename T, typename = void>
 struct check_executor_fn {};
 
@@ -228,6 +238,18 @@ class ScalarUDFTraits {
    */
   static constexpr bool HasExecutor() { return has_udf_executor_fn<T>::value; }
 
+  /**
+   * Returns true if the UDF always returns the same output for the same inputs. UDFs are
+   * deterministic unless they define a Deterministic() func that returns false.
+   */
+  static constexpr bool IsDeterministic() {
+    if constexpr (has_udf_deterministic_fn<T>::value) {
+      return T::Deterministic();
+    } else {
+      return true;
+    }
+  }
+
   template <typename Q = T, std::enable_if_t<ScalarUDFTraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
@@ -111,6 +111,7 @@ class ScalarUDFDefinition : public UDFDefinition {
     } else {
       executor_ = udfspb::UDFSourceExecutor::UDF_ALL;
     }
+    deterministic_ = ScalarUDFTraits<TUDF>::IsDeterministic();
 
     return Status::OK();
   }
@@ -144,6 +145,7 @@ class ScalarUDFDefinition : public UDFDefinition {
   const std::vector<types::DataType>& exec_arguments() const { return exec_arguments_; }
   const std::vector<types::DataType>& init_arguments() const { return init_arguments_; }
   udfspb::UDFSourceExecutor executor() const { return executor_; }
+  bool deterministic() const { return deterministic_; }
 
   const std::vector<types::DataType>& RegistryArgTypes() override { return registry_arguments_; }
   size_t Arity() const { return exec_arguments_.size(); }
@@ -155,6 +157,7 @@ class ScalarUDFDefinition : public UDFDefinition {
   std::vector<types::DataType> registry_arguments_;
   types::DataType exec_return_type_;
   udfspb::UDFSourceExecutor executor_;
+  bool deterministic_;
   std::function<std::unique_ptr<ScalarUDF>()> make_fn_;
   std::function<Status(ScalarUDF*, FunctionContext* ctx,
                        const std::vector<const types::ColumnWrapper*>& inputs,
@@ -209,6 +212,8 @@ class UDADefinition : public UDFDefinition {
     finalize_value_fn = UDAWrapper<T>::FinalizeValue;
 
     supports_partial_ = UDAWrapper<T>::SupportsPartial;
+    serialize_fn_ = UDAWrapper<T>::Serialize;
+    deserialize_fn_ = UDAWrapper<T>::Deserialize;
     return Status::OK();
   }
 
@@ -245,6 +250,12 @@ class UDADefinition : public UDFDefinition {
   Status FinalizeArrow(UDA* uda, FunctionContext* ctx, arrow::ArrayBuilder* output) {
     return finalize_arrow_fn_(uda, ctx, output);
   }
+  Status Serialize(UDA* uda, FunctionContext* ctx, types::StringValue* output) {
+    return serialize_fn_(uda, ctx, output);
+  }
+  Status Deserialize(UDA* uda, FunctionContext* ctx, const types::StringValue& data) {
+    return deserialize_fn_(uda, ctx, data);
+  }
 
  private:
   std::vector<types::DataType> init_arguments_;
@@ -267,6 +278,9 @@ class UDADefinition : public UDFDefinition {
   std::function<Status(UDA* uda, FunctionContext* ctx, types::BaseValueType* output)>
       finalize_value_fn;
   std::function<Status(UDA* uda1, UDA* uda2, FunctionContext* ctx)> merge_fn_;
+  std::function<Status(UDA* uda, FunctionContext* ctx, types::StringValue* output)> serialize_fn_;
+  std::function<Status(UDA* uda, FunctionContext* ctx, const types::StringValue& data)>
+      deserialize_fn_;
   std::function<Status(UDA* uda, FunctionContext* ctx,
                        const std::vector<std::shared_ptr<types::BaseValueType>>& inputs)>
       init_wrapper_fn_;
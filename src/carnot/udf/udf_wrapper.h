@@ -435,6 +435,37 @@ struct UDAWrapper {
     *casted_output = casted_uda->Finalize(ctx);
     return Status::OK();
   }
+
+  /**
+   * Serialize the partial aggregate state of the UDA.
+   * Returns an error if the UDA does not support partial aggregation.
+   */
+  static Status Serialize(UDA* uda, FunctionContext* ctx, types::StringValue* output) {
+    DCHECK(output != nullptr);
+    if constexpr (SupportsPartial) {
+      *output = static_cast<TUDA*>(uda)->Serialize(ctx);
+      return Status::OK();
+    }
+    PL_UNUSED(uda);
+    PL_UNUSED(ctx);
+    return error::Unimplemented("UDA '$0' does not support partial aggregation",
+                                typeid(TUDA).name());
+  }
+
+  /**
+   * Load the partial aggregate state produced by Serialize into the UDA, replacing its current
+   * state. Returns an error if the UDA does not support partial aggregation.
+   */
+  static Status Deserialize(UDA* uda, FunctionContext* ctx, const types::StringValue& data) {
+    if constexpr (SupportsPartial) {
+      return static_cast<TUDA*>(uda)->Deserialize(ctx, data);
+    }
+    PL_UNUSED(uda);
+    PL_UNUSED(ctx);
+    PL_UNUSED(data);
+    return error::Unimplemented("UDA '$0' does not support partial aggregation",
+                                typeid(TUDA).name());
+  }
 };
 
 /**
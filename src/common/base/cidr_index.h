@@ -0,0 +1,297 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <absl/numeric/int128.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "src/common/base/inet_utils.h"
+#include "src/common/base/logging.h"
+
+namespace px {
+
+/**
+ * CIDRIndex maps CIDR blocks to values, and finds the value of the longest block that contains an
+ * address. Single addresses can be added as /32 (IPv4) or /128 (IPv6) blocks.
+ *
+ * Blocks are kept in a path-compressed binary trie (a PATRICIA trie), so a lookup visits at most
+ * one node per distinct prefix length on the path to the address, rather than testing every block.
+ * IPv4 blocks and addresses are stored as IPv4-mapped IPv6, which matches the semantics of
+ * CIDRContainsIPAddr() for mixed address families.
+ *
+ * The index is not synchronized. Concurrent readers are safe, but modifications must not overlap
+ * with any other access; callers that publish an index to readers should modify a copy instead.
+ */
+template <typename TValue>
+class CIDRIndex {
+ public:
+  /**
+   * Adds a block to the index. If the same block was already added, its value is replaced.
+   * Bits of the block address beyond its prefix length are ignored.
+   */
+  void Insert(const CIDRBlock& block, TValue value) {
+    auto [key, len] = ToKey(block);
+    DCHECK_LE(len, kMaxLen);
+
+    int32_t parent = kNull;
+    int dir = 0;
+    int32_t cur = root_;
+    while (true) {
+      if (cur == kNull) {
+        SetChild(parent, dir, NewNode(key, len, std::move(value)));
+        return;
+      }
+
+      const Node& node = nodes_[cur];
+      int common = std::min({CommonPrefixLen(node.prefix, key), node.len, len});
+
+      if (common == node.len) {
+        if (len == node.len) {
+          if (node.value == kNull) {
+            nodes_[cur].value = NewValue(std::move(value));
+          } else {
+            values_[node.value] = std::move(value);
+          }
+          return;
+        }
+        // The node is a prefix of the new block; keep walking down.
+        parent = cur;
+        dir = Bit(key, node.len);
+        cur = node.child[dir];
+        continue;
+      }
+
+      // The new block diverges from the node, or is a prefix of it.
+      int node_dir = Bit(node.prefix, common);
+      if (common == len) {
+        int32_t new_node = NewNode(key, len, std::move(value));
+        nodes_[new_node].child[node_dir] = cur;
+        SetChild(parent, dir, new_node);
+        return;
+      }
+
+      int32_t branch = NewNode(Mask(key, common), common);
+      int32_t leaf = NewNode(key, len, std::move(value));
+      nodes_[branch].child[node_dir] = cur;
+      nodes_[branch].child[1 - node_dir] = leaf;
+      SetChild(parent, dir, branch);
+      return;
+    }
+  }
+
+  /**
+   * Removes a block from the index. Returns false if the block was not in the index.
+   * Bits of the block address beyond its prefix length are ignored.
+   */
+  bool Erase(const CIDRBlock& block) {
+    auto [key, len] = ToKey(block);
+
+    int32_t grandparent = kNull;
+    int grandparent_dir = 0;
+    int32_t parent = kNull;
+    int parent_dir = 0;
+    int32_t cur = root_;
+    while (cur != kNull) {
+      const Node& node = nodes_[cur];
+      if (node.len > len || Mask(key, node.len) != node.prefix) {
+        return false;
+      }
+      if (node.len == len) {
+        break;
+      }
+      grandparent = parent;
+      grandparent_dir = parent_dir;
+      parent = cur;
+      parent_dir = Bit(key, node.len);
+      cur = node.child[parent_dir];
+    }
+    if (cur == kNull || nodes_[cur].value == kNull) {
+      return false;
+    }
+
+    FreeValue(nodes_[cur].value);
+    nodes_[cur].value = kNull;
+
+    // Nodes without a value are only kept while they branch, so that every node on a lookup path
+    // either holds a block or splits the path.
+    Node& node = nodes_[cur];
+    if (node.child[0] != kNull && node.child[1] != kNull) {
+      return true;
+    }
+    SetChild(parent, parent_dir, node.child[0] != kNull ? node.child[0] : node.child[1]);
+    bool was_leaf = node.child[0] == kNull && node.child[1] == kNull;
+    FreeNode(cur);
+
+    // Removing a leaf can leave its parent as a branch with a single child.
+    if (was_leaf && parent != kNull && nodes_[parent].value == kNull) {
+      SetChild(grandparent, grandparent_dir, nodes_[parent].child[1 - parent_dir]);
+      FreeNode(parent);
+    }
+    return true;
+  }
+
+  /**
+   * Returns the value of the longest block that contains addr, or nullptr if there is none.
+   * The pointer is valid until the index is next modified.
+   */
+  const TValue* LongestPrefixMatch(const InetAddr& addr) const {
+    if (addr.family != InetAddrFamily::kIPv4 && addr.family != InetAddrFamily::kIPv6) {
+      return nullptr;
+    }
+    absl::uint128 key = ToKey(addr);
+
+    const TValue* match = nullptr;
+    int32_t cur = root_;
+    while (cur != kNull) {
+      const Node& node = nodes_[cur];
+      if (Mask(key, node.len) != node.prefix) {
+        break;
+      }
+      if (node.value != kNull) {
+        match = &values_[node.value];
+      }
+      if (node.len == kMaxLen) {
+        break;
+      }
+      cur = node.child[Bit(key, node.len)];
+    }
+    return match;
+  }
+
+  /**
+   * Returns the number of blocks in the index.
+   */
+  size_t size() const { return values_.size() - free_values_.size(); }
+  bool empty() const { return size() == 0; }
+
+ private:
+  static constexpr int kMaxLen = 128;
+  static constexpr int kIPv4MappedLen = 96;
+  static constexpr int32_t kNull = -1;
+
+  struct Node {
+    // The key bits of this node, with all bits past len cleared.
+    absl::uint128 prefix;
+    int len;
+    // Index into values_, or kNull for nodes that only branch.
+    int32_t value = kNull;
+    int32_t child[2] = {kNull, kNull};
+  };
+
+  static absl::uint128 ToKey(const InetAddr& addr) {
+    const InetAddr addr6 = addr.family == InetAddrFamily::kIPv4 ? MapIPv4ToIPv6(addr) : addr;
+    const uint8_t* bytes = std::get<struct in6_addr>(addr6.addr).s6_addr;
+    uint64_t high = 0;
+    uint64_t low = 0;
+    for (int i = 0; i < 8; ++i) {
+      high = (high << 8) | bytes[i];
+      low = (low << 8) | bytes[i + 8];
+    }
+    return absl::MakeUint128(high, low);
+  }
+
+  static std::pair<absl::uint128, int> ToKey(const CIDRBlock& block) {
+    int len = static_cast<int>(block.prefix_length);
+    if (block.ip_addr.family == InetAddrFamily::kIPv4) {
+      len += kIPv4MappedLen;
+    }
+    len = std::min(len, kMaxLen);
+    return {Mask(ToKey(block.ip_addr), len), len};
+  }
+
+  static absl::uint128 Mask(absl::uint128 key, int len) {
+    if (len == 0) {
+      return 0;
+    }
+    return key & (~absl::uint128(0) << (kMaxLen - len));
+  }
+
+  static int Bit(absl::uint128 key, int pos) {
+    return static_cast<int>((key >> (kMaxLen - 1 - pos)) & 1);
+  }
+
+  static int CommonPrefixLen(absl::uint128 a, absl::uint128 b) {
+    absl::uint128 diff = a ^ b;
+    if (absl::Uint128High64(diff) != 0) {
+      return __builtin_clzll(absl::Uint128High64(diff));
+    }
+    if (absl::Uint128Low64(diff) != 0) {
+      return 64 + __builtin_clzll(absl::Uint128Low64(diff));
+    }
+    return kMaxLen;
+  }
+
+  int32_t NewValue(TValue value) {
+    if (!free_values_.empty()) {
+      int32_t idx = free_values_.back();
+      free_values_.pop_back();
+      values_[idx] = std::move(value);
+      return idx;
+    }
+    values_.push_back(std::move(value));
+    return static_cast<int32_t>(values_.size() - 1);
+  }
+
+  void FreeValue(int32_t idx) {
+    values_[idx] = TValue{};
+    free_values_.push_back(idx);
+  }
+
+  int32_t NewNode(absl::uint128 prefix, int len) {
+    if (!free_nodes_.empty()) {
+      int32_t idx = free_nodes_.back();
+      free_nodes_.pop_back();
+      nodes_[idx] = Node{prefix, len};
+      return idx;
+    }
+    nodes_.push_back(Node{prefix, len});
+    return static_cast<int32_t>(nodes_.size() - 1);
+  }
+
+  void FreeNode(int32_t idx) { free_nodes_.push_back(idx); }
+
+  int32_t NewNode(absl::uint128 prefix, int len, TValue value) {
+    int32_t node = NewNode(prefix, len);
+    nodes_[node].value = NewValue(std::move(value));
+    return node;
+  }
+
+  void SetChild(int32_t parent, int dir, int32_t child) {
+    if (parent == kNull) {
+      root_ = child;
+    } else {
+      nodes_[parent].child[dir] = child;
+    }
+  }
+
+  // Nodes refer to each other by index, which keeps them in one allocation. Slots of erased nodes
+  // and values are reused by later inserts.
+  std::vector<Node> nodes_;
+  std::vector<TValue> values_;
+  std::vector<int32_t> free_nodes_;
+  std::vector<int32_t> free_values_;
+  int32_t root_ = kNull;
+};
+
+}  // namespace px
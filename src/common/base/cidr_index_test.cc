@@ -0,0 +1,241 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/cidr_index.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+
+namespace {
+
+CIDRBlock Block(std::string_view str) {
+  CIDRBlock block;
+  PL_CHECK_OK(ParseCIDRBlock(str, &block));
+  return block;
+}
+
+InetAddr Addr(std::string_view str) {
+  InetAddr addr;
+  PL_CHECK_OK(ParseIPAddress(str, &addr));
+  return addr;
+}
+
+std::string Lookup(const CIDRIndex<std::string>& index, std::string_view addr) {
+  const std::string* value = index.LongestPrefixMatch(Addr(addr));
+  return value == nullptr ? "" : *value;
+}
+
+}  // namespace
+
+TEST(CIDRIndexTest, Empty) {
+  CIDRIndex<std::string> index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(Lookup(index, "10.0.0.1"), "");
+  EXPECT_EQ(Lookup(index, "::1"), "");
+}
+
+TEST(CIDRIndexTest, LongestPrefixMatchIPv4) {
+  CIDRIndex<std::string> index;
+  index.Insert(Block("10.0.0.0/8"), "cluster");
+  index.Insert(Block("10.1.0.0/16"), "pods");
+  index.Insert(Block("10.1.2.3/32"), "pod");
+  index.Insert(Block("10.2.0.0/16"), "services");
+  // Host bits past the prefix are ignored.
+  index.Insert(Block("192.168.1.77/24"), "lan");
+  EXPECT_EQ(index.size(), 5);
+
+  EXPECT_EQ(Lookup(index, "10.1.2.3"), "pod");
+  EXPECT_EQ(Lookup(index, "10.1.2.4"), "pods");
+  EXPECT_EQ(Lookup(index, "10.2.9.9"), "services");
+  EXPECT_EQ(Lookup(index, "10.3.0.1"), "cluster");
+  EXPECT_EQ(Lookup(index, "192.168.1.1"), "lan");
+  EXPECT_EQ(Lookup(index, "192.168.2.1"), "");
+  EXPECT_EQ(Lookup(index, "11.0.0.1"), "");
+}
+
+TEST(CIDRIndexTest, InsertOrderDoesNotMatter) {
+  CIDRIndex<std::string> index;
+  index.Insert(Block("10.1.2.3/32"), "pod");
+  index.Insert(Block("10.2.0.0/16"), "services");
+  index.Insert(Block("10.1.0.0/16"), "pods");
+  index.Insert(Block("10.0.0.0/8"), "cluster");
+
+  EXPECT_EQ(Lookup(index, "10.1.2.3"), "pod");
+  EXPECT_EQ(Lookup(index, "10.1.2.4"), "pods");
+  EXPECT_EQ(Lookup(index, "10.2.9.9"), "services");
+  EXPECT_EQ(Lookup(index, "10.3.0.1"), "cluster");
+}
+
+TEST(CIDRIndexTest, ReplaceValue) {
+  CIDRIndex<std::string> index;
+  index.Insert(Block("10.1.0.0/16"), "old");
+  index.Insert(Block("10.1.0.0/16"), "new");
+  EXPECT_EQ(index.size(), 1);
+  EXPECT_EQ(Lookup(index, "10.1.0.1"), "new");
+}
+
+TEST(CIDRIndexTest, DefaultRoute) {
+  CIDRIndex<std::string> index;
+  index.Insert(Block("::/0"), "any");
+  index.Insert(Block("10.1.0.0/16"), "pods");
+  EXPECT_EQ(Lookup(index, "10.1.0.1"), "pods");
+  EXPECT_EQ(Lookup(index, "8.8.8.8"), "any");
+  EXPECT_EQ(Lookup(index, "2001:db8::1"), "any");
+}
+
+TEST(CIDRIndexTest, IPv6AndMixedFamilies) {
+  CIDRIndex<std::string> index;
+  index.Insert(Block("2001:db8::/32"), "net");
+  index.Insert(Block("2001:db8:1::/48"), "pods");
+  index.Insert(Block("2001:db8:1::5/128"), "pod");
+  index.Insert(Block("10.1.0.0/16"), "pods4");
+
+  EXPECT_EQ(Lookup(index, "2001:db8:1::5"), "pod");
+  EXPECT_EQ(Lookup(index, "2001:db8:1::6"), "pods");
+  EXPECT_EQ(Lookup(index, "2001:db8:2::1"), "net");
+  EXPECT_EQ(Lookup(index, "2001:db9::1"), "");
+
+  // IPv4-mapped IPv6 addresses match IPv4 blocks, as in CIDRContainsIPAddr().
+  EXPECT_EQ(Lookup(index, "::ffff:10.1.0.1"), "pods4");
+  EXPECT_EQ(Lookup(index, "::ffff:10.2.0.1"), "");
+}
+
+TEST(CIDRIndexTest, Erase) {
+  CIDRIndex<std::string> index;
+  index.Insert(Block("10.0.0.0/8"), "cluster");
+  index.Insert(Block("10.1.0.0/16"), "pods");
+  index.Insert(Block("10.1.2.3/32"), "pod");
+  index.Insert(Block("10.1.2.4/32"), "pod2");
+
+  EXPECT_FALSE(index.Erase(Block("10.2.0.0/16")));
+  EXPECT_FALSE(index.Erase(Block("10.1.2.0/24")));
+  EXPECT_EQ(index.size(), 4);
+
+  EXPECT_TRUE(index.Erase(Block("10.1.2.3/32")));
+  EXPECT_FALSE(index.Erase(Block("10.1.2.3/32")));
+  EXPECT_EQ(index.size(), 3);
+  EXPECT_EQ(Lookup(index, "10.1.2.3"), "pods");
+  EXPECT_EQ(Lookup(index, "10.1.2.4"), "pod2");
+
+  // Erasing a block that others are nested in keeps the nested blocks.
+  EXPECT_TRUE(index.Erase(Block("10.1.0.0/16")));
+  EXPECT_EQ(Lookup(index, "10.1.2.3"), "cluster");
+  EXPECT_EQ(Lookup(index, "10.1.2.4"), "pod2");
+
+  // Erased slots are reused.
+  index.Insert(Block("10.1.2.3/32"), "new_pod");
+  EXPECT_EQ(Lookup(index, "10.1.2.3"), "new_pod");
+  EXPECT_EQ(index.size(), 3);
+
+  EXPECT_TRUE(index.Erase(Block("10.0.0.0/8")));
+  EXPECT_TRUE(index.Erase(Block("10.1.2.3/32")));
+  EXPECT_TRUE(index.Erase(Block("10.1.2.4/32")));
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(Lookup(index, "10.1.2.4"), "");
+}
+
+// Checks the index against a linear scan with CIDRContainsIPAddr().
+TEST(CIDRIndexTest, MatchesLinearScan) {
+  std::mt19937 rng(37);
+  auto random_addr = [&rng]() {
+    // Draw from a small address space so that blocks overlap.
+    return absl::Substitute("10.$0.$1.$2", rng() % 4, rng() % 4, rng() % 256);
+  };
+
+  std::vector<CIDRBlock> blocks;
+  CIDRIndex<int> index;
+  for (int i = 0; i < 200; ++i) {
+    int prefix_length = 8 + rng() % 25;
+    CIDRBlock block = Block(absl::Substitute("$0/$1", random_addr(), prefix_length));
+    blocks.push_back(block);
+    index.Insert(block, i);
+  }
+
+  for (int i = 0; i < 2000; ++i) {
+    InetAddr addr = Addr(random_addr());
+
+    int expected_len = -1;
+    for (const auto& block : blocks) {
+      if (CIDRContainsIPAddr(block, addr)) {
+        expected_len = std::max(expected_len, static_cast<int>(block.prefix_length));
+      }
+    }
+
+    const int* value = index.LongestPrefixMatch(addr);
+    if (expected_len == -1) {
+      EXPECT_EQ(value, nullptr) << addr.AddrStr();
+    } else {
+      ASSERT_NE(value, nullptr) << addr.AddrStr();
+      EXPECT_EQ(static_cast<int>(blocks[*value].prefix_length), expected_len) << addr.AddrStr();
+      EXPECT_TRUE(CIDRContainsIPAddr(blocks[*value], addr)) << addr.AddrStr();
+    }
+  }
+}
+
+// Checks the index against a linear scan while blocks are inserted and erased.
+TEST(CIDRIndexTest, MatchesLinearScanWithErase) {
+  std::mt19937 rng(41);
+  auto random_addr = [&rng]() {
+    return absl::Substitute("10.$0.$1.$2", rng() % 4, rng() % 4, rng() % 256);
+  };
+
+  // The blocks currently in the index, by their (masked) string form.
+  absl::flat_hash_map<std::string, CIDRBlock> blocks;
+  CIDRIndex<std::string> index;
+  for (int i = 0; i < 2000; ++i) {
+    // Octet-aligned blocks with the host bits cleared, so that the string form is unique.
+    int num_octets = 1 + rng() % 4;
+    std::vector<int> octets = {10, static_cast<int>(rng() % 4), static_cast<int>(rng() % 4),
+                               static_cast<int>(rng() % 256)};
+    std::fill(octets.begin() + num_octets, octets.end(), 0);
+    std::string key = absl::Substitute("$0.$1.$2.$3/$4", octets[0], octets[1], octets[2],
+                                       octets[3], 8 * num_octets);
+    CIDRBlock block = Block(key);
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(index.Erase(block), blocks.erase(key) == 1) << key;
+    } else {
+      index.Insert(block, key);
+      blocks[key] = block;
+    }
+    ASSERT_EQ(index.size(), blocks.size());
+
+    InetAddr addr = Addr(random_addr());
+    int expected_len = -1;
+    for (const auto& [_, b] : blocks) {
+      if (CIDRContainsIPAddr(b, addr)) {
+        expected_len = std::max(expected_len, static_cast<int>(b.prefix_length));
+      }
+    }
+    const std::string* value = index.LongestPrefixMatch(addr);
+    if (expected_len == -1) {
+      EXPECT_EQ(value, nullptr) << addr.AddrStr();
+    } else {
+      ASSERT_NE(value, nullptr) << addr.AddrStr();
+      EXPECT_EQ(static_cast<int>(blocks[*value].prefix_length), expected_len) << addr.AddrStr();
+    }
+  }
+}
+
+}  // namespace px
@@ -16,8 +16,14 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
 #include <fstream>
-#include <limits>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -95,6 +101,164 @@ constexpr int kProcStatStartTimeField = 21;
 constexpr int kProcStatVSizeField = 22;
 constexpr int kProcStatRSSField = 23;
 
+/*************************************************
+ * Allocation-free reading of small /proc files
+ *************************************************/
+
+namespace {
+
+// Large enough for /proc/<pid>/stat, /proc/<pid>/io and /proc/meminfo.
+// /proc/stat can be longer on hosts with many CPUs, but only its first line is needed.
+constexpr size_t kProcFileBufSize = 8192;
+
+// Formats <proc_base_path>/<pid>/<file> into buf.
+template <size_t N>
+const char* ProcPIDFilePath(char (&buf)[N], std::string_view proc_base_path, pid_t pid,
+                            const char* file) {
+  std::snprintf(buf, N, "%.*s/%d/%s", static_cast<int>(proc_base_path.size()),
+                proc_base_path.data(), pid, file);
+  return buf;
+}
+
+// Formats <proc_base_path>/<file> into buf.
+template <size_t N>
+const char* ProcFilePath(char (&buf)[N], std::string_view proc_base_path, const char* file) {
+  std::snprintf(buf, N, "%.*s/%s", static_cast<int>(proc_base_path.size()),
+                proc_base_path.data(), file);
+  return buf;
+}
+
+// Reads the file at path into buf with open() and pread(), and returns the contents.
+// Unlike std::ifstream, this does not allocate, and it reports read failures (e.g. when the PID
+// dies between the open and the read) through return codes instead of exceptions.
+// If the file does not fit into buf, the contents are truncated to the last complete line.
+StatusOr<std::string_view> ReadProcFile(const char* path, char* buf, size_t buf_size) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open file $0", path);
+  }
+
+  size_t size = 0;
+  while (size < buf_size) {
+    ssize_t n = pread(fd, buf + size, buf_size - size, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      close(fd);
+      return error::Internal("Failed to read file $0", path);
+    }
+    if (n == 0) {
+      break;
+    }
+    size += n;
+  }
+  close(fd);
+
+  std::string_view contents(buf, size);
+  if (size == buf_size) {
+    size_t last_newline = contents.rfind('\n');
+    contents = contents.substr(0, last_newline == std::string_view::npos ? 0 : last_newline + 1);
+  }
+  return contents;
+}
+
+// Walks the whitespace-separated fields of a buffer in place, one line at a time.
+class FieldScanner {
+ public:
+  explicit FieldScanner(std::string_view buf) : buf_(buf) {}
+
+  // Returns the next field on the current line, or an empty view if the line has no more fields.
+  std::string_view NextField() {
+    while (pos_ < buf_.size() && IsFieldSeparator(buf_[pos_])) {
+      ++pos_;
+    }
+    size_t start = pos_;
+    while (pos_ < buf_.size() && !IsFieldSeparator(buf_[pos_]) && buf_[pos_] != '\n') {
+      ++pos_;
+    }
+    return buf_.substr(start, pos_ - start);
+  }
+
+  // Moves to the start of the next line. Returns false if there is none.
+  bool NextLine() {
+    size_t newline = buf_.find('\n', pos_);
+    if (newline == std::string_view::npos) {
+      pos_ = buf_.size();
+      return false;
+    }
+    pos_ = newline + 1;
+    return pos_ < buf_.size();
+  }
+
+  // Stores up to fields.size() of the remaining fields on the current line into fields.
+  // Returns the number of remaining fields, which may exceed fields.size().
+  size_t SplitLine(absl::Span<std::string_view> fields) {
+    size_t num_fields = 0;
+    for (std::string_view field = NextField(); !field.empty(); field = NextField()) {
+      if (num_fields < fields.size()) {
+        fields[num_fields] = field;
+      }
+      ++num_fields;
+    }
+    return num_fields;
+  }
+
+ private:
+  static bool IsFieldSeparator(char c) { return c == ' ' || c == '\t'; }
+
+  std::string_view buf_;
+  size_t pos_ = 0;
+};
+
+using ProcPIDStatFields = std::array<std::string_view, kProcStatNumFields>;
+
+// Splits the contents of /proc/<pid>/stat into fields, and returns the number of fields found.
+// The process name is kept with its surrounding parentheses. It is delimited by the last ')' on
+// the line rather than by whitespace, because the name itself may contain spaces.
+size_t SplitProcPIDStat(std::string_view contents, ProcPIDStatFields* fields) {
+  size_t name_begin = contents.find('(');
+  size_t name_end = contents.rfind(')');
+  if (name_begin == std::string_view::npos || name_end == std::string_view::npos ||
+      name_end < name_begin) {
+    return 0;
+  }
+
+  FieldScanner pid_scanner(contents.substr(0, name_begin));
+  (*fields)[kProcStatPIDField] = pid_scanner.NextField();
+  (*fields)[kProcStatProcessNameField] = contents.substr(name_begin, name_end - name_begin + 1);
+
+  constexpr size_t kNumLeadingFields = kProcStatProcessNameField + 1;
+  FieldScanner scanner(contents.substr(name_end + 1));
+  return kNumLeadingFields +
+         scanner.SplitLine(absl::MakeSpan(*fields).subspan(kNumLeadingFields));
+}
+
+StatusOr<int64_t> ParsePIDStartTimeTicks(const char* fpath) {
+  char buf[kProcFileBufSize];
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadProcFile(fpath, buf, sizeof(buf)));
+  if (contents.empty()) {
+    return error::Internal("Could not get line from file $0", fpath);
+  }
+
+  ProcPIDStatFields split;
+  size_t num_fields = SplitProcPIDStat(contents, &split);
+  // We check less than in case more fields are added later.
+  if (num_fields < kProcStatNumFields) {
+    return error::Internal("Unexpected number of columns in file $0 [columns = $1].", fpath,
+                           num_fields);
+  }
+
+  int64_t start_time_ticks;
+  if (!absl::SimpleAtoi(split[kProcStatStartTimeField], &start_time_ticks)) {
+    return error::Internal("Time value does not parse in file $0", fpath);
+  }
+
+  return start_time_ticks;
+}
+
+}  // namespace
+
 std::filesystem::path ProcParser::ProcPidPath(pid_t pid) const {
   return std::filesystem::path(proc_base_path_) / std::to_string(pid);
 }
@@ -107,7 +271,7 @@ ProcParser::ProcParser(const system::Config& cfg) {
 }
 
 Status ProcParser::ParseNetworkStatAccumulateIFaceData(
-    const std::vector<std::string_view>& dev_stat_record, NetworkStats* out) {
+    absl::Span<const std::string_view> dev_stat_record, NetworkStats* out) {
   DCHECK(out != nullptr);
 
   int64_t val;
@@ -170,24 +334,28 @@ Status ProcParser::ParseProcPIDNetDev(int32_t pid, NetworkStats* out) const {
    */
   DCHECK(out != nullptr);
 
-  std::string fpath = absl::Substitute("$0/$1/net/dev", proc_base_path_, pid);
-  std::ifstream ifs;
-  ifs.open(fpath);
-  if (!ifs) {
-    return error::Internal("Failed to open file $0", fpath);
-  }
+  // The file grows with the number of interfaces, so it is not read into a fixed-size buffer.
+  char fpath[PATH_MAX];
+  ProcPIDFilePath(fpath, proc_base_path_, pid, "net/dev");
+  PL_ASSIGN_OR_RETURN(std::string content, px::ReadFileToString(fpath));
+  FieldScanner scanner(content);
 
   // Ignore the first two lines since they are just headers;
   const int kHeaderLines = 2;
   for (int i = 0; i < kHeaderLines; ++i) {
-    ifs.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    if (!scanner.NextLine()) {
+      return Status::OK();
+    }
   }
 
-  std::string line;
-  while (std::getline(ifs, line)) {
-    std::vector<std::string_view> split = absl::StrSplit(line, " ", absl::SkipWhitespace());
+  std::array<std::string_view, kProcNetDevNumFields> split;
+  do {
+    size_t num_fields = scanner.SplitLine(absl::MakeSpan(split));
+    if (num_fields == 0) {
+      continue;
+    }
     // We check less than in case more fields are added later.
-    if (split.size() < kProcNetDevNumFields) {
+    if (num_fields < kProcNetDevNumFields) {
       return error::Internal("failed to parse net dev file, incorrect number of fields");
     }
 
@@ -201,7 +369,7 @@ Status ProcParser::ParseProcPIDNetDev(int32_t pid, NetworkStats* out) const {
       // Empty out the stats so we don't leave intermediate results.
       return s;
     }
-  }
+  } while (scanner.NextLine());
 
   return Status::OK();
 }
@@ -216,27 +384,24 @@ Status ProcParser::ParseProcPIDStat(int32_t pid, ProcessStats* out) const {
    * 140730842488200 140730842492896 0
    */
   DCHECK(out != nullptr);
-  std::string fpath = absl::Substitute("$0/$1/stat", proc_base_path_, pid);
+  char fpath[PATH_MAX];
+  ProcPIDFilePath(fpath, proc_base_path_, pid, "stat");
 
-  std::ifstream ifs;
-  ifs.open(fpath);
-  if (!ifs) {
-    return error::Internal("Failed to open file $0", fpath);
-  }
+  char buf[kProcFileBufSize];
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadProcFile(fpath, buf, sizeof(buf)));
 
-  std::string line;
   bool ok = true;
-  if (std::getline(ifs, line)) {
-    std::vector<std::string_view> split = absl::StrSplit(line, " ", absl::SkipWhitespace());
+  if (!contents.empty()) {
+    ProcPIDStatFields split;
     // We check less than in case more fields are added later.
-    if (split.size() < kProcStatNumFields) {
+    if (SplitProcPIDStat(contents, &split) < kProcStatNumFields) {
       return error::Unknown("Incorrect number of fields in stat file: $0", fpath);
     }
     ok &= absl::SimpleAtoi(split[kProcStatPIDField], &out->pid);
     // The name is surrounded by () we remove it here.
     const std::string_view& name_field = split[kProcStatProcessNameField];
     if (name_field.length() > 2) {
-      out->process_name = std::string(name_field.substr(1, name_field.size() - 2));
+      out->process_name.assign(name_field.substr(1, name_field.size() - 2));
     } else {
       ok = false;
     }
@@ -251,7 +416,7 @@ Status ProcParser::ParseProcPIDStat(int32_t pid, ProcessStats* out) const {
 
     ok &= absl::SimpleAtoi(split[kProcStatNumThreadsField], &out->num_threads);
     ok &= absl::SimpleAtoi(split[kProcStatVSizeField], &out->vsize_bytes);
-    ok &= absl::SimpleAtoi(std::string(split[kProcStatRSSField]), &out->rss_bytes);
+    ok &= absl::SimpleAtoi(split[kProcStatRSSField], &out->rss_bytes);
 
     // RSS is in pages.
     out->rss_bytes *= bytes_per_page_;
@@ -280,7 +445,8 @@ Status ProcParser::ParseProcPIDStatIO(int32_t pid, ProcessStats* out) const {
    *   cancelled_write_bytes: 192512
    */
   DCHECK(out != nullptr);
-  std::string fpath = absl::Substitute("$0/$1/io", proc_base_path_, pid);
+  char fpath[PATH_MAX];
+  ProcPIDFilePath(fpath, proc_base_path_, pid, "io");
 
   // Just to be safe when using offsetof, make sure object is standard layout.
   static_assert(std::is_standard_layout<ProcessStats>::value);
@@ -304,20 +470,20 @@ Status ProcParser::ParseProcStat(SystemStats* out) const {
    * ...
    */
   CHECK(out != nullptr);
-  std::string fpath = absl::Substitute("$0/stat", proc_base_path_);
-  std::ifstream ifs;
-  ifs.open(fpath);
-  if (!ifs) {
-    return error::Internal("Failed to open file $0", fpath);
-  }
+  char fpath[PATH_MAX];
+  ProcFilePath(fpath, proc_base_path_, "stat");
+
+  char buf[kProcFileBufSize];
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadProcFile(fpath, buf, sizeof(buf)));
 
-  std::string line;
+  FieldScanner scanner(contents);
+  std::array<std::string_view, kProcStatCPUNumFields> split;
   bool ok = true;
-  while (std::getline(ifs, line)) {
-    std::vector<std::string_view> split = absl::StrSplit(line, " ", absl::SkipWhitespace());
+  do {
+    size_t num_fields = scanner.SplitLine(absl::MakeSpan(split));
 
-    if (!split.empty() && split[0] == "cpu") {
-      if (split.size() < kProcStatCPUNumFields) {
+    if (num_fields > 0 && split[0] == "cpu") {
+      if (num_fields < kProcStatCPUNumFields) {
         return error::Unknown("Incorrect number of fields in proc/stat CPU");
       }
 
@@ -330,7 +496,7 @@ Status ProcParser::ParseProcStat(SystemStats* out) const {
       // We only need cpu. We can exit here.
       return Status::OK();
     }
-  }
+  } while (scanner.NextLine());
 
   // If we get here, we failed to extract system information.
   return error::NotFound("Could not extract system information");
@@ -345,7 +511,8 @@ Status ProcParser::ParseProcMemInfo(SystemStats* out) const {
    * ...
    */
   CHECK(out != nullptr);
-  std::string fpath = absl::Substitute("$0/meminfo", proc_base_path_);
+  char fpath[PATH_MAX];
+  ProcFilePath(fpath, proc_base_path_, "meminfo");
 
   // Just to be safe when using offsetof, make sure object is standard layout.
   static_assert(std::is_standard_layout<SystemStats>::value);
@@ -370,26 +537,23 @@ Status ProcParser::ParseProcMemInfo(SystemStats* out) const {
 }
 
 Status ProcParser::ParseFromKeyValueFile(
-    const std::string& fpath,
-    const absl::flat_hash_map<std::string_view, size_t>& field_name_to_value_map, uint8_t* out_base,
-    int64_t field_value_multiplier) {
-  std::ifstream ifs;
-  ifs.open(fpath);
-  if (!ifs) {
-    return error::Internal("Failed to open file $0", fpath);
-  }
+    const char* fpath, const absl::flat_hash_map<std::string_view, size_t>& field_name_to_value_map,
+    uint8_t* out_base, int64_t field_value_multiplier) {
+  char buf[kProcFileBufSize];
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadProcFile(fpath, buf, sizeof(buf)));
 
-  std::string line;
+  FieldScanner scanner(contents);
+  std::array<std::string_view, 3> split;
   size_t read_count = 0;
-  while (std::getline(ifs, line)) {
-    std::vector<std::string_view> split = absl::StrSplit(line, " ", absl::SkipWhitespace());
+  do {
+    size_t num_fields = scanner.SplitLine(absl::MakeSpan(split));
     // This is a key value pair with a unit (that is always KB when present).
     // If the number is 0 then the units are missing so we either have 2 or 3
     // for the width of the field.
-    const int kMemInfoMinFields = 2;
-    const int kMemInfoMaxFields = 3;
+    const size_t kMemInfoMinFields = 2;
+    const size_t kMemInfoMaxFields = 3;
 
-    if (split.size() >= kMemInfoMinFields && split.size() <= kMemInfoMaxFields) {
+    if (num_fields >= kMemInfoMinFields && num_fields <= kMemInfoMaxFields) {
       const auto& key = split[0];
       const auto& val = split[1];
 
@@ -410,11 +574,12 @@ Status ProcParser::ParseFromKeyValueFile(
 
       // Check to see if we have read all the fields, if so we can skip the
       // rest. We assume no duplicates.
+      ++read_count;
       if (read_count == field_name_to_value_map.size()) {
         break;
       }
     }
-  }
+  } while (scanner.NextLine());
 
   return Status::OK();
 }
@@ -451,9 +616,8 @@ StatusOr<std::string> ProcParser::GetExePath(int32_t pid) const {
 }
 
 StatusOr<int64_t> ProcParser::GetPIDStartTimeTicks(int32_t pid) const {
-  const std::filesystem::path proc_pid_path =
-      std::filesystem::path(proc_base_path_) / std::to_string(pid);
-  return ::px::system::GetPIDStartTimeTicks(proc_pid_path);
+  char fpath[PATH_MAX];
+  return ParsePIDStartTimeTicks(ProcPIDFilePath(fpath, proc_base_path_, pid, "stat"));
 }
 
 Status ProcParser::ReadProcPIDFDLink(int32_t pid, int32_t fd, std::string* out) const {
@@ -533,66 +697,18 @@ Status ProcParser::ReadNSPid(pid_t pid, std::vector<std::string>* ns_pids) const
 
 StatusOr<int64_t> GetPIDStartTimeTicks(const std::filesystem::path& proc_pid_path) {
   const std::filesystem::path proc_pid_stat_path = proc_pid_path / "stat";
-  const std::string fpath = proc_pid_stat_path.string();
-
-  std::string line;
-
-  // It's usually a big no-no to ifdef based on compilation mode,
-  // but this is a workaround for an ASAN bug that causes crashes and flakiness
-  // in our tests. See //src/common/system/proc_parser_bug_test.cc for details.
-  //
-  // The workaround implementation uses a C functions that don't throw exceptions.
-  // Why not just use the workaround version all the time?
-  // Because it has a hard-coded constant which makes it less robust.
-#if defined(PL_CONFIG_ASAN)
-  std::FILE* fp = std::fopen(fpath.c_str(), "r");
-  if (fp == nullptr) {
-    return error::Internal("Could not open file $0", fpath);
-  }
-
-  // A few quick runs show that /proc/<pid>/stat is <200 characters on my machine,
-  // but a lot of those numbers are 0. If they were non-zero, the string could be much
-  // longer. Hopefully a 4KB block keeps us safe. This is for ASAN only anyways.
-  constexpr int kMaxSupportedProcPIDStatLength = 4096;
-  line.resize(kMaxSupportedProcPIDStatLength);
-  if (std::fgets(line.data(), line.size(), fp) == nullptr) {
-    return error::Internal("Could not get line from file $0", fpath);
-  }
-#else
-  std::ifstream ifs;
-  ifs.open(fpath);
-  if (!ifs) {
-    return error::Internal("Could not open file $0", fpath);
-  }
-
-  if (!std::getline(ifs, line)) {
-    return error::Internal("Could not get line from file $0", fpath);
-  }
-#endif
-
-  std::vector<std::string_view> split = absl::StrSplit(line, " ", absl::SkipWhitespace());
-  // We check less than in case more fields are added later.
-  if (split.size() < kProcStatNumFields) {
-    return error::Internal("Unexpected number of columns in file $0 [columns = $1].", fpath,
-                           split.size());
-  }
-
-  int64_t start_time_ticks;
-  if (!absl::SimpleAtoi(split[kProcStatStartTimeField], &start_time_ticks)) {
-    return error::Internal("Time value does not parse in file $0", fpath);
-  }
-
-  return start_time_ticks;
+  return ParsePIDStartTimeTicks(proc_pid_stat_path.c_str());
 }
 
 namespace {
 
-Status ParseMountInfo(std::string_view str, ProcParser::MountInfo* mount_info) {
-  std::vector<std::string_view> fields =
-      absl::StrSplit(str, absl::ByAnyChar(kFieldSeparators), absl::SkipWhitespace());
-  if (fields.size() < 10) {
+using MountInfoFields = std::array<std::string_view, 5>;
+
+Status ParseMountInfo(const MountInfoFields& fields, size_t num_fields,
+                      ProcParser::MountInfo* mount_info) {
+  if (num_fields < 10) {
     return error::InvalidArgument("Mountinfo record should have at least 10 fields, got: $0",
-                                  fields.size());
+                                  num_fields);
   }
   mount_info->dev = fields[2];
   mount_info->root = fields[3];
@@ -607,11 +723,16 @@ Status ProcParser::ReadMountInfos(pid_t pid,
                                   std::vector<ProcParser::MountInfo>* mount_infos) const {
   const std::filesystem::path proc_pid_mount_info_path = ProcPidPath(pid) / "mountinfo";
   PL_ASSIGN_OR_RETURN(std::string content, px::ReadFileToString(proc_pid_mount_info_path));
-  std::vector<std::string_view> lines = absl::StrSplit(content, "\n", absl::SkipWhitespace());
-  for (const auto line : lines) {
+  FieldScanner scanner(content);
+  MountInfoFields fields;
+  do {
+    size_t num_fields = scanner.SplitLine(absl::MakeSpan(fields));
+    if (num_fields == 0) {
+      continue;
+    }
     ProcParser::MountInfo& mount_info = mount_infos->emplace_back();
-    PL_RETURN_IF_ERROR(ParseMountInfo(line, &mount_info));
-  }
+    PL_RETURN_IF_ERROR(ParseMountInfo(fields, num_fields, &mount_info));
+  } while (scanner.NextLine());
   return Status::OK();
 }
 
@@ -27,6 +27,7 @@
 
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
+#include <absl/types/span.h>
 #include "src/common/base/base.h"
 #include "src/common/system/system.h"
 
@@ -263,10 +264,10 @@ class ProcParser {
 
  private:
   static Status ParseNetworkStatAccumulateIFaceData(
-      const std::vector<std::string_view>& dev_stat_record, NetworkStats* out);
+      absl::Span<const std::string_view> dev_stat_record, NetworkStats* out);
 
   static Status ParseFromKeyValueFile(
-      const std::string& fpath,
+      const char* fpath,
       const absl::flat_hash_map<std::string_view, size_t>& field_name_to_value_map,
       uint8_t* out_base, int64_t field_value_multiplier);
 
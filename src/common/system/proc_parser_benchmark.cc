@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_split.h>
+
+#include "src/common/base/base.h"
+#include "src/common/system/config_mock.h"
+#include "src/common/system/proc_parser.h"
+#include "src/common/testing/test_environment.h"
+
+using ::px::system::MockConfig;
+using ::px::system::ProcParser;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+// Parses the proc fixtures used by proc_parser_test. PID 123 has all per-process files.
+constexpr std::string_view kProcPath = "src/common/system/testdata/proc";
+constexpr int32_t kPID = 123;
+
+std::unique_ptr<ProcParser> MakeProcParser() {
+  static const std::filesystem::path proc_path = px::testing::TestFilePath(kProcPath);
+  NiceMock<MockConfig> sysconfig;
+  ON_CALL(sysconfig, HasConfig()).WillByDefault(Return(true));
+  ON_CALL(sysconfig, PageSize()).WillByDefault(Return(4096));
+  ON_CALL(sysconfig, KernelTicksPerSecond()).WillByDefault(Return(100));
+  ON_CALL(sysconfig, proc_path()).WillByDefault(ReturnRef(proc_path));
+  return std::make_unique<ProcParser>(sysconfig);
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ParseProcPIDStat(benchmark::State& state) {
+  std::unique_ptr<ProcParser> parser = MakeProcParser();
+  ProcParser::ProcessStats stats;
+  for (auto _ : state) {
+    PL_CHECK_OK(parser->ParseProcPIDStat(kPID, &stats));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+// The getline + StrSplit implementation that ParseProcPIDStat used to have, as a baseline.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ParseProcPIDStatIfstreamBaseline(benchmark::State& state) {
+  const std::string fpath =
+      (px::testing::TestFilePath(kProcPath) / std::to_string(kPID) / "stat").string();
+  ProcParser::ProcessStats stats;
+  for (auto _ : state) {
+    std::ifstream ifs(fpath);
+    std::string line;
+    CHECK(std::getline(ifs, line));
+    std::vector<std::string_view> split = absl::StrSplit(line, " ", absl::SkipWhitespace());
+    CHECK_GE(split.size(), 52U);
+    stats.process_name = std::string(split[1].substr(1, split[1].size() - 2));
+    CHECK(absl::SimpleAtoi(split[9], &stats.minor_faults));
+    CHECK(absl::SimpleAtoi(split[11], &stats.major_faults));
+    CHECK(absl::SimpleAtoi(split[13], &stats.utime_ns));
+    CHECK(absl::SimpleAtoi(split[14], &stats.ktime_ns));
+    CHECK(absl::SimpleAtoi(split[19], &stats.num_threads));
+    CHECK(absl::SimpleAtoi(split[22], &stats.vsize_bytes));
+    CHECK(absl::SimpleAtoi(split[23], &stats.rss_bytes));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ParseProcPIDStatIO(benchmark::State& state) {
+  std::unique_ptr<ProcParser> parser = MakeProcParser();
+  ProcParser::ProcessStats stats;
+  for (auto _ : state) {
+    PL_CHECK_OK(parser->ParseProcPIDStatIO(kPID, &stats));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_GetPIDStartTimeTicks(benchmark::State& state) {
+  std::unique_ptr<ProcParser> parser = MakeProcParser();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parser->GetPIDStartTimeTicks(kPID).ConsumeValueOrDie());
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ParseProcStat(benchmark::State& state) {
+  std::unique_ptr<ProcParser> parser = MakeProcParser();
+  ProcParser::SystemStats stats;
+  for (auto _ : state) {
+    PL_CHECK_OK(parser->ParseProcStat(&stats));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ParseProcMemInfo(benchmark::State& state) {
+  std::unique_ptr<ProcParser> parser = MakeProcParser();
+  ProcParser::SystemStats stats;
+  for (auto _ : state) {
+    PL_CHECK_OK(parser->ParseProcMemInfo(&stats));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ReadMountInfos(benchmark::State& state) {
+  std::unique_ptr<ProcParser> parser = MakeProcParser();
+  std::vector<ProcParser::MountInfo> mount_infos;
+  for (auto _ : state) {
+    mount_infos.clear();
+    PL_CHECK_OK(parser->ReadMountInfos(kPID, &mount_infos));
+    benchmark::DoNotOptimize(mount_infos);
+  }
+}
+
+BENCHMARK(BM_ParseProcPIDStat);
+BENCHMARK(BM_ParseProcPIDStatIfstreamBaseline);
+BENCHMARK(BM_ParseProcPIDStatIO);
+BENCHMARK(BM_GetPIDStartTimeTicks);
+BENCHMARK(BM_ParseProcStat);
+BENCHMARK(BM_ParseProcMemInfo);
+BENCHMARK(BM_ReadMountInfos);
@@ -25,8 +25,10 @@
 #include <memory>
 #include <sstream>
 
+#include "src/common/base/file.h"
 #include "src/common/fs/fs_wrapper.h"
 #include "src/common/system/config_mock.h"
+#include "src/common/testing/temp_dir.h"
 #include "src/common/testing/test_environment.h"
 #include "src/common/testing/testing.h"
 
@@ -113,6 +115,41 @@ TEST_F(ProcParserTest, ParsePidStat) {
   EXPECT_EQ(2577 * bytes_per_page_, stats.rss_bytes);
 }
 
+// The process name is delimited by parentheses, and may itself contain spaces and parentheses.
+TEST_F(ProcParserTest, ParsePidStatNameWithSpaces) {
+  testing::TempDir proc_dir;
+  std::string stat = "4602 (my (weird) proc) S";
+  for (int i = 3; i < 52; ++i) {
+    absl::StrAppend(&stat, " ", i);
+  }
+  std::filesystem::create_directories(proc_dir.path() / "4602");
+  ASSERT_OK(WriteFileFromString(proc_dir.path() / "4602/stat", stat));
+
+  system::MockConfig sysconfig;
+  std::filesystem::path proc_path = proc_dir.path();
+  EXPECT_CALL(sysconfig, HasConfig()).WillRepeatedly(Return(true));
+  EXPECT_CALL(sysconfig, PageSize()).WillRepeatedly(Return(4096));
+  EXPECT_CALL(sysconfig, KernelTicksPerSecond()).WillRepeatedly(Return(10000000));
+  EXPECT_CALL(sysconfig, proc_path()).WillRepeatedly(ReturnRef(proc_path));
+  ProcParser parser(sysconfig);
+
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(parser.ParseProcPIDStat(4602, &stats));
+  EXPECT_EQ(4602, stats.pid);
+  EXPECT_EQ("my (weird) proc", stats.process_name);
+  EXPECT_EQ(9, stats.minor_faults);
+  EXPECT_EQ(19, stats.num_threads);
+  EXPECT_EQ(23 * 4096, stats.rss_bytes);
+  ASSERT_OK_AND_EQ(parser.GetPIDStartTimeTicks(4602), 21);
+}
+
+TEST_F(ProcParserTest, ParsePidStatMissingPID) {
+  ProcParser::ProcessStats stats;
+  EXPECT_NOT_OK(parser_->ParseProcPIDStat(999999, &stats));
+  EXPECT_NOT_OK(parser_->ParseProcPIDStatIO(999999, &stats));
+  EXPECT_NOT_OK(parser_->GetPIDStartTimeTicks(999999));
+}
+
 TEST_F(ProcParserTest, ParseStat) {
   ProcParser::SystemStats stats;
   PL_CHECK_OK(parser_->ParseProcStat(&stats));
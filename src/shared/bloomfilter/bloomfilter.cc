@@ -17,8 +17,10 @@
  */
 
 #include <math.h>
+#include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "src/common/base/base.h"
 #include "src/shared/bloomfilter/bloomfilter.h"
@@ -77,44 +79,85 @@ XXHash64BloomFilterPB XXHash64BloomFilter::ToProto() {
   return output;
 }
 
-void XXHash64BloomFilter::SetBit(int bit_number) {
-  int byte_index = bit_number >> 3;
+void XXHash64BloomFilter::SetBit(uint64_t bit_number) {
+  uint64_t byte_index = bit_number >> 3;
   int mask = 1 << (bit_number % 8);
   buffer_[byte_index] = buffer_[byte_index] | mask;
 }
 
-bool XXHash64BloomFilter::HasBitSet(int bit_number) const {
-  int byte_index = bit_number >> 3;
+bool XXHash64BloomFilter::HasBitSet(uint64_t bit_number) const {
+  uint64_t byte_index = bit_number >> 3;
   int mask = 1 << (bit_number % 8);
   return buffer_[byte_index] & mask;
 }
 
-void XXHash64BloomFilter::Insert(std::string_view item) {
-  uint64_t a = XXH64(item.data(), item.size(), seed_);
+// The i-th bit of an item is (a + i * b) mod num_bits, with the sum wrapping at 64 bits. The loops
+// below compute the sum incrementally. The bit positions must not change, since filters are
+// serialized by agents and read by the planner.
+
+XXHash64BloomFilter::ItemHash XXHash64BloomFilter::Hash(std::string_view item) {
+  uint64_t a = XXH64(item.data(), item.size(), kSeed);
   uint64_t b = XXH64(item.data(), item.size(), a);
+  return {a, b};
+}
 
-  for (auto i = 0; i < num_hashes_; ++i) {
-    // Use int128 because the combination of uint64s below (the underyling type of XXH64) could
-    // overflow.
-    absl::uint128 x = a + i * b;
-    int bit_number = static_cast<int>(x % (buffer_.size() << 3));
-    SetBit(bit_number);
+void XXHash64BloomFilter::Insert(std::string_view item) {
+  ItemHash hash = Hash(item);
+  uint64_t x = hash.a;
+  for (auto i = 0; i < num_hashes_; ++i, x += hash.b) {
+    SetBit(x % num_bits());
   }
 }
 
-bool XXHash64BloomFilter::Contains(std::string_view item) const {
-  uint64_t a = XXH64(item.data(), item.size(), seed_);
-  uint64_t b = XXH64(item.data(), item.size(), a);
+bool XXHash64BloomFilter::Contains(std::string_view item) const { return Contains(Hash(item)); }
 
-  for (auto i = 0; i < num_hashes_; ++i) {
-    absl::uint128 x = a + i * b;
-    int bit_number = static_cast<int>(x % (buffer_.size() << 3));
-    if (!HasBitSet(bit_number)) {
+bool XXHash64BloomFilter::Contains(const ItemHash& hash) const {
+  uint64_t x = hash.a;
+  for (auto i = 0; i < num_hashes_; ++i, x += hash.b) {
+    if (!HasBitSet(x % num_bits())) {
       return false;
     }
   }
   return true;
 }
 
+void XXHash64BloomFilter::PrefetchBits(const ItemHash& hash) const {
+  // About half of the bits are set in a full filter, so most absent items are rejected by their
+  // first two bits. Fetching the rest would cost more divisions than it saves.
+  uint64_t x = hash.a;
+  for (auto i = 0; i < std::min(num_hashes_, kNumPrefetchedBits); ++i, x += hash.b) {
+    __builtin_prefetch(&buffer_[(x % num_bits()) >> 3]);
+  }
+}
+
+std::vector<bool> XXHash64BloomFilter::ContainsMany(absl::Span<const ItemHash> hashes) const {
+  std::vector<bool> results(hashes.size());
+  for (size_t begin = 0; begin < hashes.size(); begin += kBatchSize) {
+    size_t end = std::min(begin + kBatchSize, hashes.size());
+    for (size_t i = begin; i < end; ++i) {
+      PrefetchBits(hashes[i]);
+    }
+    for (size_t i = begin; i < end; ++i) {
+      results[i] = Contains(hashes[i]);
+    }
+  }
+  return results;
+}
+
+bool XXHash64BloomFilter::ContainsAny(absl::Span<const ItemHash> hashes) const {
+  for (size_t begin = 0; begin < hashes.size(); begin += kBatchSize) {
+    size_t end = std::min(begin + kBatchSize, hashes.size());
+    for (size_t i = begin; i < end; ++i) {
+      PrefetchBits(hashes[i]);
+    }
+    for (size_t i = begin; i < end; ++i) {
+      if (Contains(hashes[i])) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 }  // namespace bloomfilter
 }  // namespace px
@@ -23,6 +23,8 @@
 #include <string>
 #include <vector>
 
+#include <absl/types/span.h>
+
 #include "src/common/base/base.h"
 #include "src/shared/bloomfilterpb/bloomfilter.pb.h"
 
@@ -55,6 +57,30 @@ class XXHash64BloomFilter {
   bool Contains(std::string_view item) const;
   bool Contains(const std::string& item) const { return Contains(std::string_view(item)); }
 
+  /**
+   * ItemHash holds the hashes of an item that all of its bit positions are derived from. All
+   * filters hash items the same way, so an item can be hashed once and checked in many filters.
+   */
+  struct ItemHash {
+    uint64_t a;
+    uint64_t b;
+  };
+  static ItemHash Hash(std::string_view item);
+  bool Contains(const ItemHash& hash) const;
+
+  /**
+   * ContainsMany checks a batch of items, and returns whether each of them may be present.
+   * The first bits of several items are fetched before any of them is tested, so that their cache
+   * misses overlap instead of being taken one after the other.
+   */
+  std::vector<bool> ContainsMany(absl::Span<const ItemHash> hashes) const;
+
+  /**
+   * ContainsAny returns whether any of the items may be present. Like ContainsMany, but stops at
+   * the first batch with a match.
+   */
+  bool ContainsAny(absl::Span<const ItemHash> hashes) const;
+
   /**
    * Get the buffer size in bytes of the bloom filter.
    */
@@ -73,12 +99,19 @@ class XXHash64BloomFilter {
       : num_hashes_(num_hashes), buffer_(buffer) {}
 
  private:
-  void SetBit(int bit_number);
-  bool HasBitSet(int bit_number) const;
+  // Number of items whose bits are fetched together in ContainsMany and ContainsAny.
+  static constexpr size_t kBatchSize = 8;
+  // Number of bits of each item that are prefetched in a batch.
+  static constexpr int kNumPrefetchedBits = 2;
+  static constexpr uint64_t kSeed = 3091990;
+
+  void SetBit(uint64_t bit_number);
+  bool HasBitSet(uint64_t bit_number) const;
+  void PrefetchBits(const ItemHash& hash) const;
+  uint64_t num_bits() const { return buffer_.size() << 3; }
 
   const int num_hashes_;
   std::vector<uint8_t> buffer_;
-  const uint64_t seed_ = 3091990;
 };
 
 }  // namespace bloomfilter
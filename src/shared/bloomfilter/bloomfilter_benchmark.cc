@@ -20,6 +20,8 @@
 
 #include <absl/container/flat_hash_map.h>
 #include <map>
+#include <memory>
+#include <string>
 #include <random>
 #include <unordered_map>
 #include <vector>
@@ -37,15 +39,22 @@ class BloomFilterBenchmark : public benchmark::Fixture {
     auto strlen = state.range(2);
     insert_bf_ = XXHash64BloomFilter::Create(num_items * 2, error_rate).ConsumeValueOrDie();
     lookup_bf_ = XXHash64BloomFilter::Create(num_items * 2, error_rate).ConsumeValueOrDie();
+    // The fixture is reused across the runs of a benchmark.
+    random_strs_.clear();
+    lookup_hashes_.clear();
     random_strs_.reserve(num_items);
     for (auto i = 0; i < num_items; ++i) {
       random_strs_.push_back(datagen::RandomString(strlen));
       lookup_bf_->Insert(random_strs_[i]);
+      // Half of the looked up items are absent, which is the common case when pruning agents.
+      lookup_hashes_.push_back(XXHash64BloomFilter::Hash(
+          i % 2 == 0 ? random_strs_[i] : datagen::RandomString(strlen)));
     }
   }
 
  protected:
   std::vector<std::string> random_strs_;
+  std::vector<XXHash64BloomFilter::ItemHash> lookup_hashes_;
   std::unique_ptr<XXHash64BloomFilter> insert_bf_;
   std::unique_ptr<XXHash64BloomFilter> lookup_bf_;
 };
@@ -74,10 +83,68 @@ BENCHMARK_DEFINE_F(BloomFilterBenchmark, LookupTest)(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations() * random_strs_.size());
 }
 
+// NOLINTNEXTLINE : runtime/references.
+BENCHMARK_DEFINE_F(BloomFilterBenchmark, LookupHashedTest)(benchmark::State& state) {
+  bool result = false;
+  for (auto _ : state) {
+    for (const auto& hash : lookup_hashes_) {
+      result = lookup_bf_->Contains(hash);
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * lookup_hashes_.size());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+BENCHMARK_DEFINE_F(BloomFilterBenchmark, LookupManyTest)(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<bool> results = lookup_bf_->ContainsMany(lookup_hashes_);
+    benchmark::DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.iterations() * lookup_hashes_.size());
+}
+
+// Planning checks one value against the filter of each agent. Compares hashing the value for each
+// agent against hashing it once.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_LookupAcrossFilters(benchmark::State& state) {
+  auto num_filters = state.range(0);
+  bool hash_once = state.range(1);
+  std::vector<std::unique_ptr<XXHash64BloomFilter>> filters;
+  for (auto i = 0; i < num_filters; ++i) {
+    filters.push_back(XXHash64BloomFilter::Create(10000, 0.01).ConsumeValueOrDie());
+    for (auto j = 0; j < 1000; ++j) {
+      filters.back()->Insert(datagen::RandomString(32));
+    }
+  }
+  std::string value = "POD_NAME=pl/" + datagen::RandomString(32);
+
+  for (auto _ : state) {
+    int matches = 0;
+    if (hash_once) {
+      auto hash = XXHash64BloomFilter::Hash(value);
+      for (const auto& filter : filters) {
+        matches += filter->ContainsAny({&hash, 1});
+      }
+    } else {
+      for (const auto& filter : filters) {
+        matches += filter->Contains(value);
+      }
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  state.SetItemsProcessed(state.iterations() * num_filters);
+}
+
 BENCHMARK_REGISTER_F(BloomFilterBenchmark, InsertTest)
     ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
 BENCHMARK_REGISTER_F(BloomFilterBenchmark, LookupTest)
     ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 256}});
+BENCHMARK_REGISTER_F(BloomFilterBenchmark, LookupHashedTest)
+    ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 8}});
+BENCHMARK_REGISTER_F(BloomFilterBenchmark, LookupManyTest)
+    ->Ranges({{1 << 10, 1 << 20}, {10, 100000}, {8, 8}});
+BENCHMARK(BM_LookupAcrossFilters)->Ranges({{100, 5000}, {0, 1}});
 
 }  // namespace bloomfilter
 }  // namespace px
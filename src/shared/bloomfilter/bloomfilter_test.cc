@@ -18,6 +18,11 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+
 #include "src/shared/bloomfilter/bloomfilter.h"
 
 namespace px {
@@ -87,6 +92,36 @@ TEST(XXHash64BloomFilter, test_error_rate) {
   }
 }
 
+TEST(XXHash64BloomFilter, test_bit_positions) {
+  // Filters are serialized by agents and read by the planner, so the bits that an item maps to
+  // must not change.
+  auto bf = XXHash64BloomFilter::Create(10, 0.1).ConsumeValueOrDie();
+  bf->Insert(std::string_view("foo"));
+  bf->Insert(std::string_view("bar"));
+  EXPECT_EQ(bf->ToProto().data(), std::string("\x00\x84\x82\x80\x10\x00", 6));
+}
+
+TEST(XXHash64BloomFilter, test_contains_many) {
+  auto bf = XXHash64BloomFilter::Create(1000, 0.01).ConsumeValueOrDie();
+  std::vector<XXHash64BloomFilter::ItemHash> hashes;
+  std::vector<bool> expected;
+  for (int i = 0; i < 100; ++i) {
+    std::string item = absl::StrCat("item", i);
+    if (i % 3 == 0) {
+      bf->Insert(item);
+    }
+    hashes.push_back(XXHash64BloomFilter::Hash(item));
+    expected.push_back(bf->Contains(item));
+  }
+
+  EXPECT_EQ(bf->ContainsMany(hashes), expected);
+  EXPECT_TRUE(bf->ContainsAny(hashes));
+  EXPECT_TRUE(bf->ContainsAny(absl::MakeConstSpan(hashes).subspan(99)));
+  EXPECT_EQ(bf->ContainsAny(absl::MakeConstSpan(hashes).subspan(1, 2)), expected[1] || expected[2]);
+  EXPECT_FALSE(bf->ContainsAny({}));
+  EXPECT_TRUE(bf->ContainsMany({}).empty());
+}
+
 TEST(XXHash64BloomFilter, test_create_from_proto) {
   std::vector<std::string> matches{"foo", "bar", "abc"};
   std::vector<std::string> non_matches{"123", "456", "789"};
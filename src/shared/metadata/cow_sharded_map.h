@@ -0,0 +1,224 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace px {
+namespace md {
+
+/**
+ * CowShardedMap is a hash map that can be copied in O(1) and then modified in O(changed entries).
+ *
+ * Entries are spread over a fixed number of shards, each of which is a flat_hash_map held by a
+ * shared_ptr. Copying the map only copies the shard pointers. A write first copies the shard it
+ * lands in, if that shard is still shared with another copy of the map, so copies never observe
+ * each other's writes.
+ *
+ * This lets the metadata state be snapshotted on every update without deep copies: readers keep
+ * the old snapshot, and the writer only pays for the shards it touches.
+ *
+ * Like flat_hash_map, this is not thread-safe. Different copies may be used from different threads.
+ */
+template <typename K, typename V, typename Hash = typename absl::flat_hash_map<K, V>::hasher,
+          typename Eq = typename absl::flat_hash_map<K, V>::key_equal>
+class CowShardedMap {
+  using Shard = absl::flat_hash_map<K, V, Hash, Eq>;
+
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = typename Shard::value_type;
+  using size_type = size_t;
+
+  static constexpr size_t kNumShardBits = 6;
+  static constexpr size_t kNumShards = 1 << kNumShardBits;
+
+  /**
+   * Iterates over all entries, shard by shard. The iterator only holds a raw pointer to its
+   * shard, so iterating does not make the shards look shared and writes made during iteration
+   * do not copy them. Writes through FindMutable() are safe during iteration: if the current shard
+   * is shared it is copied and the iterator continues over the (unchanged) original, which the
+   * other copy of the map keeps alive; otherwise the value is changed in place. Set() and erase()
+   * on an unshared shard invalidate iterators, as they do for flat_hash_map.
+   */
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Shard::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return *iter_; }
+    pointer operator->() const { return &*iter_; }
+
+    const_iterator& operator++() {
+      ++iter_;
+      SkipEmptyShards();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return shard_idx_ == other.shard_idx_ && (shard_ == nullptr || iter_ == other.iter_);
+    }
+    bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class CowShardedMap;
+
+    const_iterator(const CowShardedMap* map, size_t shard_idx) : map_(map), shard_idx_(shard_idx) {
+      if (shard_idx_ < kNumShards) {
+        shard_ = map_->shards_[shard_idx_].get();
+        iter_ = shard_->begin();
+        SkipEmptyShards();
+      }
+    }
+
+    // Advances to the first entry of the next non-empty shard, or to end().
+    void SkipEmptyShards() {
+      while (iter_ == shard_->end()) {
+        ++shard_idx_;
+        if (shard_idx_ == kNumShards) {
+          shard_ = nullptr;
+          return;
+        }
+        shard_ = map_->shards_[shard_idx_].get();
+        iter_ = shard_->begin();
+      }
+    }
+
+    const CowShardedMap* map_ = nullptr;
+    size_t shard_idx_ = kNumShards;
+    const Shard* shard_ = nullptr;
+    typename Shard::const_iterator iter_;
+  };
+  using iterator = const_iterator;
+
+  CowShardedMap() {
+    for (auto& shard : shards_) {
+      shard = std::make_shared<Shard>();
+    }
+  }
+
+  // Copies share all shards with the original.
+  CowShardedMap(const CowShardedMap&) = default;
+  CowShardedMap& operator=(const CowShardedMap&) = default;
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, kNumShards); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * Returns a pointer to the value for key, or nullptr if there is none.
+   */
+  template <typename Q>
+  const V* Find(const Q& key) const {
+    const Shard& shard = *shards_[ShardIndex(key)];
+    auto it = shard.find(key);
+    return it == shard.end() ? nullptr : &it->second;
+  }
+
+  template <typename Q>
+  bool contains(const Q& key) const {
+    return Find(key) != nullptr;
+  }
+
+  /**
+   * Returns a mutable pointer to the value for key, or nullptr if there is none.
+   * Copies the key's shard if it is shared, even if the caller then leaves the value unchanged.
+   */
+  template <typename Q>
+  V* FindMutable(const Q& key) {
+    size_t idx = ShardIndex(key);
+    if (!shards_[idx]->contains(key)) {
+      return nullptr;
+    }
+    Shard* shard = MutableShard(idx);
+    return &shard->find(key)->second;
+  }
+
+  /**
+   * Sets the value for key. The shard is only copied if this changes the map.
+   */
+  void Set(K key, V value) {
+    size_t idx = ShardIndex(key);
+    auto it = shards_[idx]->find(key);
+    if (it != shards_[idx]->end() && it->second == value) {
+      return;
+    }
+    Shard* shard = MutableShard(idx);
+    auto [new_it, inserted] = shard->try_emplace(std::move(key), std::move(value));
+    if (inserted) {
+      ++size_;
+    } else {
+      new_it->second = std::move(value);
+    }
+  }
+
+  /**
+   * Removes key from the map. Returns the number of removed entries.
+   */
+  template <typename Q>
+  size_t erase(const Q& key) {
+    size_t idx = ShardIndex(key);
+    if (!shards_[idx]->contains(key)) {
+      return 0;
+    }
+    MutableShard(idx)->erase(key);
+    --size_;
+    return 1;
+  }
+
+ private:
+  template <typename Q>
+  static size_t ShardIndex(const Q& key) {
+    // The low bits of the hash are used by the shards themselves to place entries,
+    // so the shard is picked from the high bits.
+    return static_cast<uint64_t>(Hash{}(key)) >> (64 - kNumShardBits);
+  }
+
+  Shard* MutableShard(size_t idx) {
+    std::shared_ptr<Shard>& shard = shards_[idx];
+    if (shard.use_count() > 1) {
+      shard = std::make_shared<Shard>(*shard);
+    }
+    return shard.get();
+  }
+
+  std::array<std::shared_ptr<Shard>, kNumShards> shards_;
+  size_t size_ = 0;
+};
+
+}  // namespace md
+}  // namespace px
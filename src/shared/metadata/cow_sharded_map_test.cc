@@ -0,0 +1,132 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/shared/metadata/cow_sharded_map.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace px {
+namespace md {
+
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+using StringMap = CowShardedMap<std::string, std::string>;
+
+TEST(CowShardedMapTest, SetFindErase) {
+  StringMap map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find("a"));
+
+  map.Set("a", "1");
+  map.Set("b", "2");
+  map.Set("a", "3");
+  EXPECT_EQ(2, map.size());
+  ASSERT_NE(nullptr, map.Find("a"));
+  EXPECT_EQ("3", *map.Find("a"));
+  EXPECT_TRUE(map.contains(std::string_view("b")));
+
+  *map.FindMutable("b") = "4";
+  EXPECT_EQ(nullptr, map.FindMutable("c"));
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("a", "3"), Pair("b", "4")));
+
+  EXPECT_EQ(1, map.erase("a"));
+  EXPECT_EQ(0, map.erase("a"));
+  EXPECT_EQ(1, map.size());
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("b", "4")));
+}
+
+TEST(CowShardedMapTest, CopiesAreIndependent) {
+  StringMap map;
+  for (int i = 0; i < 1000; ++i) {
+    map.Set(std::to_string(i), std::to_string(i));
+  }
+
+  StringMap copy = map;
+  copy.Set("0", "zero");
+  copy.Set("new", "entry");
+  copy.erase("1");
+  *map.FindMutable("2") = "two";
+
+  EXPECT_EQ(1000, map.size());
+  EXPECT_EQ("0", *map.Find("0"));
+  EXPECT_EQ(nullptr, map.Find("new"));
+  EXPECT_EQ("1", *map.Find("1"));
+  EXPECT_EQ("two", *map.Find("2"));
+
+  EXPECT_EQ(1000, copy.size());
+  EXPECT_EQ("zero", *copy.Find("0"));
+  EXPECT_EQ("entry", *copy.Find("new"));
+  EXPECT_EQ(nullptr, copy.Find("1"));
+  EXPECT_EQ("2", *copy.Find("2"));
+
+  // Entries in shards that neither side modified are not copied.
+  EXPECT_EQ(map.Find("500"), copy.Find("500"));
+
+  size_t count = 0;
+  for (const auto& [k, v] : copy) {
+    EXPECT_EQ(v, *copy.Find(k));
+    ++count;
+  }
+  EXPECT_EQ(copy.size(), count);
+}
+
+TEST(CowShardedMapTest, IterateWhileModifying) {
+  StringMap map;
+  for (int i = 0; i < 100; ++i) {
+    map.Set(std::to_string(i), "");
+  }
+  StringMap snapshot = map;
+
+  // The iterator keeps seeing the entries as they were when it reached their shard.
+  size_t count = 0;
+  for (const auto& [k, v] : map) {
+    EXPECT_THAT(v, IsEmpty());
+    *map.FindMutable(k) = "modified";
+    ++count;
+  }
+  EXPECT_EQ(100, count);
+
+  for (const auto& [k, v] : map) {
+    EXPECT_EQ("modified", v);
+  }
+  for (const auto& [k, v] : snapshot) {
+    EXPECT_THAT(v, IsEmpty());
+  }
+}
+
+TEST(CowShardedMapTest, IteratingDoesNotCopyUnsharedShards) {
+  StringMap map;
+  for (int i = 0; i < 100; ++i) {
+    map.Set(std::to_string(i), "");
+  }
+
+  // Nothing else shares the shards, so writes during iteration happen in place.
+  for (const auto& [k, v] : map) {
+    const std::string* value = map.Find(k);
+    EXPECT_EQ(value, map.FindMutable(k));
+    EXPECT_EQ(value, &v);
+  }
+}
+
+}  // namespace md
+}  // namespace px
@@ -62,6 +62,19 @@ bool AgentMetadataFilter::ContainsEntity(MetadataType key, std::string_view valu
   return Contains(ToEntityKeyPair(key, value));
 }
 
+AgentMetadataFilter::EntityHash AgentMetadataFilter::HashEntity(MetadataType key,
+                                                               std::string_view value) {
+  return XXHash64BloomFilter::Hash(ToEntityKeyPair(key, value));
+}
+
+bool AgentMetadataFilter::ContainsAnyEntity(MetadataType key,
+                                            absl::Span<const EntityHash> entities) const {
+  if (!metadata_types_.contains(key)) {
+    return false;
+  }
+  return ContainsAny(entities);
+}
+
 MetadataInfo AgentMetadataFilter::ToProto() {
   auto output = ToProtoImpl();
   for (const auto& type : metadata_types_) {
@@ -76,6 +89,10 @@ bool AgentMetadataFilterImpl::Contains(std::string_view val) const {
   return bloomfilter_->Contains(val);
 }
 
+bool AgentMetadataFilterImpl::ContainsAny(absl::Span<const EntityHash> entities) const {
+  return bloomfilter_->ContainsAny(entities);
+}
+
 MetadataInfo AgentMetadataFilterImpl::ToProtoImpl() const {
   MetadataInfo output;
   *(output.mutable_xxhash64_bloom_filter()) = bloomfilter_->ToProto();
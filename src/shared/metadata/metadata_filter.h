@@ -24,6 +24,7 @@
 #include <vector>
 
 #include <absl/container/flat_hash_set.h>
+#include <absl/types/span.h>
 
 #include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
 #include "src/common/base/base.h"
@@ -79,6 +80,19 @@ class AgentMetadataFilter {
    */
   bool ContainsEntity(MetadataType key, std::string_view value) const;
 
+  /**
+   * A key/value pair hashed for lookups. The planner checks the same entities against the filters
+   * of every agent, so it hashes them once with HashEntity rather than once per filter.
+   */
+  using EntityHash = XXHash64BloomFilter::ItemHash;
+  static EntityHash HashEntity(MetadataType key, std::string_view value);
+
+  /**
+   * Check whether the filter contains any of the hashed key/value pairs. All of them must have
+   * been hashed with the given key.
+   */
+  bool ContainsAnyEntity(MetadataType key, absl::Span<const EntityHash> entities) const;
+
   /**
    * Get the registered metadata keys that are stored in this filter.
    */
@@ -89,6 +103,7 @@ class AgentMetadataFilter {
  protected:
   virtual void Insert(std::string_view value) = 0;
   virtual bool Contains(std::string_view value) const = 0;
+  virtual bool ContainsAny(absl::Span<const EntityHash> entities) const = 0;
 
   /**
    * Creates an proto, excluding the metadata_fields field which is taken care of by the
@@ -117,6 +132,7 @@ class AgentMetadataFilterImpl : public AgentMetadataFilter {
  protected:
   void Insert(std::string_view entity) override;
   bool Contains(std::string_view entity) const override;
+  bool ContainsAny(absl::Span<const EntityHash> entities) const override;
   MetadataInfo ToProtoImpl() const override;
 
  private:
@@ -43,6 +43,30 @@ TEST(AgentMetadataFilter, test_basic) {
   EXPECT_NOT_OK(filter->InsertEntity(MetadataType::SERVICE_NAME, "abc"));
 }
 
+TEST(AgentMetadataFilter, test_contains_any) {
+  auto filter =
+      AgentMetadataFilter::Create(100, 0.01, {MetadataType::POD_NAME, MetadataType::CONTAINER_ID})
+          .ConsumeValueOrDie();
+  EXPECT_OK(filter->InsertEntity(MetadataType::POD_NAME, "foo"));
+
+  std::vector<AgentMetadataFilter::EntityHash> pods = {
+      AgentMetadataFilter::HashEntity(MetadataType::POD_NAME, "bar"),
+      AgentMetadataFilter::HashEntity(MetadataType::POD_NAME, "foo"),
+  };
+  EXPECT_TRUE(filter->ContainsAnyEntity(MetadataType::POD_NAME, pods));
+  EXPECT_FALSE(
+      filter->ContainsAnyEntity(MetadataType::POD_NAME, absl::MakeConstSpan(pods).subspan(0, 1)));
+  EXPECT_FALSE(filter->ContainsAnyEntity(MetadataType::POD_NAME, {}));
+
+  // Entities are hashed together with their type.
+  std::vector<AgentMetadataFilter::EntityHash> containers = {
+      AgentMetadataFilter::HashEntity(MetadataType::CONTAINER_ID, "foo"),
+  };
+  EXPECT_FALSE(filter->ContainsAnyEntity(MetadataType::CONTAINER_ID, containers));
+  // Types that are not in the filter never match.
+  EXPECT_FALSE(filter->ContainsAnyEntity(MetadataType::SERVICE_NAME, pods));
+}
+
 TEST(AgentMetadataFilter, test_proto) {
   auto filter =
       AgentMetadataFilter::Create(100, 0.01, {MetadataType::POD_NAME, MetadataType::CONTAINER_ID})
@@ -19,8 +19,10 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <absl/container/flat_hash_set.h>
+#include <absl/strings/match.h>
 
 #include "src/shared/metadata/metadata_state.h"
 
@@ -29,17 +31,38 @@ namespace md {
 
 const K8sMetadataObject* K8sMetadataState::K8sMetadataObjectByID(UIDView id,
                                                                  K8sObjectType type) const {
-  auto it = k8s_objects_by_id_.find(id);
+  const K8sMetadataObjectSPtr* obj = k8s_objects_by_id_.Find(id);
 
-  if (it == k8s_objects_by_id_.end()) {
+  if (obj == nullptr) {
     return nullptr;
   }
 
-  if (it->second->type() != type) {
+  if ((*obj)->type() != type) {
     return nullptr;
   }
 
-  return it->second.get();
+  return obj->get();
+}
+
+namespace {
+
+// Returns the object held by ptr for modification, first replacing it with a copy if
+// it is also held by another (cloned) state.
+template <typename T>
+T* MakeUnique(std::shared_ptr<T>* ptr) {
+  if (ptr->use_count() > 1) {
+    *ptr = (*ptr)->Clone();
+  }
+  return ptr->get();
+}
+
+constexpr std::string_view kIPv4MappedPrefix = "::ffff:";
+
+}  // namespace
+
+K8sMetadataObject* K8sMetadataState::MutableK8sMetadataObjectByID(UIDView id) {
+  K8sMetadataObjectSPtr* obj = k8s_objects_by_id_.FindMutable(id);
+  return obj == nullptr ? nullptr : MakeUnique(obj);
 }
 
 const PodInfo* K8sMetadataState::PodInfoByID(UIDView pod_id) const {
@@ -58,38 +81,54 @@ const NamespaceInfo* K8sMetadataState::NamespaceInfoByID(UIDView ns_id) const {
 }
 
 const ContainerInfo* K8sMetadataState::ContainerInfoByID(CIDView id) const {
-  auto it = containers_by_id_.find(id);
-
-  if (it == containers_by_id_.end()) {
-    return nullptr;
-  }
+  const ContainerInfoSPtr* container = containers_by_id_.Find(id);
+  return container == nullptr ? nullptr : container->get();
+}
 
-  return it->second.get();
+ContainerInfo* K8sMetadataState::MutableContainerInfoByID(CIDView id) {
+  ++generation_;
+  ContainerInfoSPtr* container = containers_by_id_.FindMutable(id);
+  return container == nullptr ? nullptr : MakeUnique(container);
 }
 
 UID K8sMetadataState::PodIDByName(K8sNameIdentView pod_name) const {
-  auto it = pods_by_name_.find(pod_name);
-  return (it == pods_by_name_.end()) ? "" : it->second;
+  const UID* uid = pods_by_name_.Find(pod_name);
+  return (uid == nullptr) ? "" : *uid;
 }
 
 UID K8sMetadataState::PodIDByIP(std::string_view pod_ip) const {
-  auto it = pods_by_ip_.find(pod_ip);
-  return (it == pods_by_ip_.end()) ? "" : it->second;
+  const UID* uid = pods_by_ip_.Find(pod_ip);
+  if (uid == nullptr && absl::StartsWithIgnoreCase(pod_ip, kIPv4MappedPrefix)) {
+    // Dual-stack sockets report IPv4 peers as IPv4-mapped IPv6 addresses.
+    uid = pods_by_ip_.Find(pod_ip.substr(kIPv4MappedPrefix.size()));
+  }
+  return (uid == nullptr) ? "" : *uid;
+}
+
+void K8sMetadataState::RebuildClusterCIDRIndex() {
+  auto cluster_cidr_index = std::make_shared<CIDRIndex<CIDRBlock>>();
+  for (const auto& cidr : pod_cidrs_) {
+    cluster_cidr_index->Insert(cidr, cidr);
+  }
+  if (service_cidr_.has_value()) {
+    cluster_cidr_index->Insert(service_cidr_.value(), service_cidr_.value());
+  }
+  cluster_cidr_index_ = std::move(cluster_cidr_index);
 }
 
 CID K8sMetadataState::ContainerIDByName(std::string_view container_name) const {
-  auto it = containers_by_name_.find(container_name);
-  return (it == containers_by_name_.end()) ? "" : it->second;
+  const CID* cid = containers_by_name_.Find(container_name);
+  return (cid == nullptr) ? "" : *cid;
 }
 
 UID K8sMetadataState::ServiceIDByName(K8sNameIdentView service_name) const {
-  auto it = services_by_name_.find(service_name);
-  return (it == services_by_name_.end()) ? "" : it->second;
+  const UID* uid = services_by_name_.Find(service_name);
+  return (uid == nullptr) ? "" : *uid;
 }
 
 UID K8sMetadataState::NamespaceIDByName(K8sNameIdentView namespace_name) const {
-  auto it = namespaces_by_name_.find(namespace_name);
-  return (it == namespaces_by_name_.end()) ? "" : it->second;
+  const UID* uid = namespaces_by_name_.Find(namespace_name);
+  return (uid == nullptr) ? "" : *uid;
 }
 
 std::unique_ptr<K8sMetadataState> K8sMetadataState::Clone() const {
@@ -98,21 +137,15 @@ std::unique_ptr<K8sMetadataState> K8sMetadataState::Clone() const {
   other->pod_cidrs_ = pod_cidrs_;
   other->service_cidr_ = service_cidr_;
 
-  other->k8s_objects_by_id_.reserve(k8s_objects_by_id_.size());
-  for (const auto& [k, v] : k8s_objects_by_id_) {
-    other->k8s_objects_by_id_[k] = v->Clone();
-  }
-
-  other->containers_by_id_.reserve(containers_by_id_.size());
-  for (const auto& [k, v] : containers_by_id_) {
-    other->containers_by_id_[k] = v->Clone();
-  }
-
+  // These only copy shard pointers. Shards and objects are copied when they are next modified.
+  other->k8s_objects_by_id_ = k8s_objects_by_id_;
+  other->containers_by_id_ = containers_by_id_;
   other->pods_by_name_ = pods_by_name_;
   other->services_by_name_ = services_by_name_;
   other->namespaces_by_name_ = namespaces_by_name_;
   other->containers_by_name_ = containers_by_name_;
   other->pods_by_ip_ = pods_by_ip_;
+  other->cluster_cidr_index_ = cluster_cidr_index_;
 
   return other;
 }
@@ -146,17 +179,19 @@ std::string K8sMetadataState::DebugString(int indent_level) const {
 }
 
 Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
+  ++generation_;
   const UID& object_uid = update.uid();
   const std::string& name = update.name();
   const std::string& ns = update.namespace_();
 
-  auto it = k8s_objects_by_id_.find(object_uid);
-  if (it == k8s_objects_by_id_.end()) {
-    auto pod = std::make_unique<PodInfo>(update);
+  K8sMetadataObject* obj = MutableK8sMetadataObjectByID(object_uid);
+  if (obj == nullptr) {
+    auto pod = std::make_shared<PodInfo>(update);
     VLOG(1) << "Adding Pod: " << pod->DebugString();
-    it = k8s_objects_by_id_.try_emplace(object_uid, std::move(pod)).first;
+    obj = pod.get();
+    k8s_objects_by_id_.Set(object_uid, std::move(pod));
   }
-  auto pod_info = static_cast<PodInfo*>(it->second.get());
+  auto pod_info = static_cast<PodInfo*>(obj);
 
   // We always just add to the container set even if the container is stopped.
   // We expect all cleanup to happen periodically to allow stale objects to be queried for some
@@ -165,7 +200,8 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   // state might be periodically inconsistent.
 
   for (const auto& cid : update.container_ids()) {
-    if (containers_by_id_.find(cid) == containers_by_id_.end()) {
+    const ContainerInfo* container_info = ContainerInfoByID(cid);
+    if (container_info == nullptr) {
       // We should be resilient to the case where we happened to miss a pod update
       // in the stream of events. If we did miss a pod update, just skip adding the
       // pod to this particular service to avoid dangling references.
@@ -174,7 +210,10 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
     }
 
     pod_info->AddContainer(cid);
-    containers_by_id_[cid]->set_pod_id(object_uid);
+    // Avoid copying the container if it is already attached to this pod.
+    if (container_info->pod_id() != object_uid) {
+      MutableContainerInfoByID(cid)->set_pod_id(object_uid);
+    }
   }
 
   pod_info->set_start_time_ns(update.start_timestamp_ns());
@@ -187,61 +226,72 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   pod_info->set_phase_message(update.message());
   pod_info->set_phase_reason(update.reason());
 
-  pods_by_name_[{ns, name}] = object_uid;
+  pods_by_name_.Set({ns, name}, object_uid);
   if (update.host_ip() !=
       update.pod_ip()) {  // Filter out daemonset which don't have their own, unique podIP.
-    pods_by_ip_[update.pod_ip()] = object_uid;
+    const UID* ip_owner = pods_by_ip_.Find(update.pod_ip());
+    if (ip_owner == nullptr || *ip_owner != object_uid) {
+      pods_by_ip_.Set(update.pod_ip(), object_uid);
+    }
   }
 
   return Status::OK();
 }
 
 Status K8sMetadataState::HandleContainerUpdate(const ContainerUpdate& update) {
+  ++generation_;
   const CID& cid = update.cid();
 
-  auto it = containers_by_id_.find(cid);
-  if (it == containers_by_id_.end()) {
-    auto container = std::make_unique<ContainerInfo>(update);
+  ContainerInfo* container_info = MutableContainerInfoByID(cid);
+  if (container_info == nullptr) {
+    auto container = std::make_shared<ContainerInfo>(update);
     VLOG(1) << "Adding Container: " << container->DebugString();
-    it = containers_by_id_.try_emplace(cid, std::move(container)).first;
+    container_info = container.get();
+    containers_by_id_.Set(cid, std::move(container));
   }
   VLOG(1) << "container update: " << update.name();
 
-  auto* container_info = it->second.get();
   container_info->set_stop_time_ns(update.stop_timestamp_ns());
   container_info->set_state(ConvertToContainerState(update.container_state()));
   container_info->set_state_message(update.message());
   container_info->set_state_reason(update.reason());
 
-  containers_by_name_[update.name()] = cid;
+  containers_by_name_.Set(update.name(), cid);
 
   return Status::OK();
 }
 
 Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
+  ++generation_;
   const UID& service_uid = update.uid();
   const std::string& name = update.name();
   const std::string& ns = update.namespace_();
 
-  auto it = k8s_objects_by_id_.find(service_uid);
-  if (it == k8s_objects_by_id_.end()) {
-    auto service = std::make_unique<ServiceInfo>(service_uid, ns, name);
+  K8sMetadataObject* obj = MutableK8sMetadataObjectByID(service_uid);
+  if (obj == nullptr) {
+    auto service = std::make_shared<ServiceInfo>(service_uid, ns, name);
     VLOG(1) << "Adding Service: " << service->DebugString();
-    it = k8s_objects_by_id_.try_emplace(service_uid, std::move(service)).first;
+    obj = service.get();
+    k8s_objects_by_id_.Set(service_uid, std::move(service));
   }
-  auto service_info = static_cast<ServiceInfo*>(it->second.get());
+  auto service_info = static_cast<ServiceInfo*>(obj);
 
   for (const auto& uid : update.pod_ids()) {
-    if (k8s_objects_by_id_.find(uid) == k8s_objects_by_id_.end()) {
+    const K8sMetadataObjectSPtr* pod_obj = k8s_objects_by_id_.Find(uid);
+    if (pod_obj == nullptr) {
       // We should be resilient to the case where we happened to miss a pod update
       // in the stream of events. If we did miss a pod update, just skip adding the
       // pod to this particular service to avoid dangling references.
       LOG(INFO) << absl::Substitute("Didn't find pod UID $0 for service $1/$2", uid, ns, name);
       continue;
     }
-    ECHECK(k8s_objects_by_id_[uid]->type() == K8sObjectType::kPod);
+    ECHECK((*pod_obj)->type() == K8sObjectType::kPod);
+    // Avoid copying the pod if it already references this service.
+    if (static_cast<const PodInfo*>(pod_obj->get())->services().contains(service_uid)) {
+      continue;
+    }
     // We add the service uid to the pod. Lifetime of service still handled by the service object.
-    PodInfo* pod_info = static_cast<PodInfo*>(k8s_objects_by_id_[uid].get());
+    PodInfo* pod_info = static_cast<PodInfo*>(MutableK8sMetadataObjectByID(uid));
     pod_info->AddService(service_uid);
   }
   service_info->set_start_time_ns(update.start_timestamp_ns());
@@ -249,29 +299,31 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
 
   VLOG(1) << "service update: " << update.name();
 
-  services_by_name_[{ns, name}] = service_uid;
+  services_by_name_.Set({ns, name}, service_uid);
   return Status::OK();
 }
 
 Status K8sMetadataState::HandleNamespaceUpdate(const NamespaceUpdate& update) {
+  ++generation_;
   const UID& namespace_uid = update.uid();
   const std::string& name = update.name();
   const std::string& ns = update.name();
 
-  auto it = k8s_objects_by_id_.find(namespace_uid);
-  if (it == k8s_objects_by_id_.end()) {
-    auto ns_obj = std::make_unique<NamespaceInfo>(namespace_uid, ns, name);
+  K8sMetadataObject* obj = MutableK8sMetadataObjectByID(namespace_uid);
+  if (obj == nullptr) {
+    auto ns_obj = std::make_shared<NamespaceInfo>(namespace_uid, ns, name);
     VLOG(1) << "Adding Namespace: " << ns_obj->DebugString();
-    it = k8s_objects_by_id_.try_emplace(namespace_uid, std::move(ns_obj)).first;
+    obj = ns_obj.get();
+    k8s_objects_by_id_.Set(namespace_uid, std::move(ns_obj));
   }
-  auto ns_info = static_cast<NamespaceInfo*>(it->second.get());
+  auto ns_info = static_cast<NamespaceInfo*>(obj);
 
   ns_info->set_start_time_ns(update.start_timestamp_ns());
   ns_info->set_stop_time_ns(update.stop_timestamp_ns());
 
   VLOG(1) << "namespace update: " << update.name();
 
-  namespaces_by_name_[{ns, name}] = namespace_uid;
+  namespaces_by_name_.Set({ns, name}, namespace_uid);
   return Status::OK();
 }
 
@@ -287,45 +339,49 @@ bool IsExpired(const T& obj, int64_t retention_time, int64_t now) {
 }
 
 Status K8sMetadataState::CleanupExpiredMetadata(int64_t retention_time_ns) {
+  ++generation_;
   int64_t now = CurrentTimeNS();
 
-  for (auto iter = k8s_objects_by_id_.begin(); iter != k8s_objects_by_id_.end();) {
-    const auto& k8s_object = iter->second;
-
+  // Expired objects are collected first, so that only the shards that hold them are modified.
+  std::vector<UID> expired_object_ids;
+  for (const auto& [id, k8s_object] : k8s_objects_by_id_) {
     if (!IsExpired(*k8s_object, retention_time_ns, now)) {
-      ++iter;
       continue;
     }
 
     switch (k8s_object->type()) {
       case K8sObjectType::kPod:
-        pods_by_name_.erase({k8s_object->ns(), k8s_object->name()});
+        pods_by_name_.erase(K8sNameIdentView(k8s_object->ns(), k8s_object->name()));
         pods_by_ip_.erase(static_cast<PodInfo*>(k8s_object.get())->pod_ip());
         break;
       case K8sObjectType::kNamespace:
-        namespaces_by_name_.erase({k8s_object->ns(), k8s_object->name()});
+        namespaces_by_name_.erase(K8sNameIdentView(k8s_object->ns(), k8s_object->name()));
         break;
       case K8sObjectType::kService:
-        services_by_name_.erase({k8s_object->ns(), k8s_object->name()});
+        services_by_name_.erase(K8sNameIdentView(k8s_object->ns(), k8s_object->name()));
         break;
       default:
         LOG(DFATAL) << absl::Substitute("Unexpected object type: $0",
                                         static_cast<int>(k8s_object->type()));
     }
 
-    k8s_objects_by_id_.erase(iter++);
+    expired_object_ids.push_back(id);
+  }
+  for (const auto& id : expired_object_ids) {
+    k8s_objects_by_id_.erase(id);
   }
 
-  for (auto iter = containers_by_id_.begin(); iter != containers_by_id_.end();) {
-    const auto& cinfo = iter->second;
-
+  std::vector<CID> expired_container_ids;
+  for (const auto& [cid, cinfo] : containers_by_id_) {
     if (!IsExpired(*cinfo, retention_time_ns, now)) {
-      ++iter;
       continue;
     }
 
     containers_by_name_.erase(cinfo->name());
-    containers_by_id_.erase(iter++);
+    expired_container_ids.push_back(cid);
+  }
+  for (const auto& cid : expired_container_ids) {
+    containers_by_id_.erase(cid);
   }
 
   return Status::OK();
@@ -27,7 +27,9 @@
 #include <absl/container/flat_hash_set.h>
 
 #include "src/common/base/base.h"
+#include "src/common/base/cidr_index.h"
 #include "src/shared/k8s/metadatapb/metadata.pb.h"
+#include "src/shared/metadata/cow_sharded_map.h"
 #include "src/shared/metadata/k8s_objects.h"
 #include "src/shared/metadata/pids.h"
 #include "src/shared/upid/upid.h"
@@ -36,12 +38,18 @@ namespace px {
 namespace md {
 
 using K8sMetadataObjectUPtr = std::unique_ptr<K8sMetadataObject>;
+using K8sMetadataObjectSPtr = std::shared_ptr<K8sMetadataObject>;
 using ContainerInfoUPtr = std::unique_ptr<ContainerInfo>;
+using ContainerInfoSPtr = std::shared_ptr<ContainerInfo>;
 using PIDInfoUPtr = std::unique_ptr<PIDInfo>;
 using AgentID = sole::uuid;
 
 /**
  * This class contains all kubernetes relate metadata.
+ *
+ * All maps are copy-on-write, and the objects in them are shared between clones until one of the
+ * clones modifies them. This makes Clone() cheap, and each update afterwards costs time and memory
+ * in proportion to the objects it changes rather than to the size of the cluster.
  */
 class K8sMetadataState : NotCopyable {
  public:
@@ -91,26 +99,46 @@ class K8sMetadataState : NotCopyable {
     };
   };
   using K8sEntityByNameMap =
-      absl::flat_hash_map<K8sNameIdent, UID, K8sIdentHashEq::Hash, K8sIdentHashEq::Eq>;
+      CowShardedMap<K8sNameIdent, UID, K8sIdentHashEq::Hash, K8sIdentHashEq::Eq>;
 
   using PodsByNameMap = K8sEntityByNameMap;
   using ServicesByNameMap = K8sEntityByNameMap;
   using NamespacesByNameMap = K8sEntityByNameMap;
-  using ContainersByNameMap = absl::flat_hash_map<std::string, CID>;
-  using PodsByPodIpMap = absl::flat_hash_map<std::string, UID>;
+  using ContainersByNameMap = CowShardedMap<std::string, CID>;
+  using PodsByPodIpMap = CowShardedMap<std::string, UID>;
+  using K8sObjectsByIDMap = CowShardedMap<UID, K8sMetadataObjectSPtr>;
+  using ContainersByIDMap = CowShardedMap<CID, ContainerInfoSPtr>;
 
   void set_service_cidr(CIDRBlock cidr) {
-    if (!service_cidr_.has_value() || service_cidr_.value() != cidr) {
+    bool changed = !service_cidr_.has_value() || service_cidr_.value() != cidr;
+    if (changed) {
       LOG(INFO) << absl::Substitute("Service CIDR updated to $0", ToString(cidr));
     }
     service_cidr_ = cidr;
+    if (changed) {
+      RebuildClusterCIDRIndex();
+    }
+    ++generation_;
   }
   const std::optional<CIDRBlock>& service_cidr() const { return service_cidr_; }
 
-  void set_pod_cidrs(std::vector<CIDRBlock> cidrs) { pod_cidrs_ = std::move(cidrs); }
+  void set_pod_cidrs(std::vector<CIDRBlock> cidrs) {
+    bool changed = pod_cidrs_ != cidrs;
+    pod_cidrs_ = std::move(cidrs);
+    if (changed) {
+      RebuildClusterCIDRIndex();
+    }
+    ++generation_;
+  }
 
   const std::vector<CIDRBlock>& pod_cidrs() const { return pod_cidrs_; }
 
+  /**
+   * Index over the pod and service CIDRs, mapping each block to itself. Used to test whether an
+   * address is inside the cluster without scanning the CIDRs.
+   */
+  const CIDRIndex<CIDRBlock>& cluster_cidr_index() const { return *cluster_cidr_index_; }
+
   const PodsByNameMap& pods_by_name() const { return pods_by_name_; }
 
   /**
@@ -142,6 +170,14 @@ class K8sMetadataState : NotCopyable {
    */
   const ContainerInfo* ContainerInfoByID(CIDView id) const;
 
+  /**
+   * MutableContainerInfoByID returns the container info by ID for modification.
+   * If the container is shared with a clone of this state, it is copied first.
+   * @param id The ID of the container.
+   * @return ContainerInfo or nullptr if not found.
+   */
+  ContainerInfo* MutableContainerInfoByID(CIDView id);
+
   /**
    * ContainerIDByName returns the ContainerID for the container of the given name.
    * @param container_name the container name
@@ -188,11 +224,24 @@ class K8sMetadataState : NotCopyable {
 
   Status CleanupExpiredMetadata(int64_t retention_time_ns);
 
-  absl::flat_hash_map<CID, ContainerInfoUPtr>& containers_by_id() { return containers_by_id_; }
+  const ContainersByIDMap& containers_by_id() const { return containers_by_id_; }
   std::string DebugString(int indent_level = 0) const;
 
+  /**
+   * A counter that is incremented whenever this state is modified. Readers that cache lookups
+   * against a state can use it to detect in-place modifications.
+   */
+  uint64_t generation() const { return generation_; }
+
  private:
   const K8sMetadataObject* K8sMetadataObjectByID(UIDView id, K8sObjectType type) const;
+  // Returns the object for modification, copying it first if it is shared with a clone.
+  K8sMetadataObject* MutableK8sMetadataObjectByID(UIDView id);
+
+  uint64_t generation_ = 0;
+
+  // Rebuilds the cluster CIDR index from scratch. CIDRs rarely change, so this is not incremental.
+  void RebuildClusterCIDRIndex();
 
   // The CIDR block used for services inside the cluster.
   std::optional<CIDRBlock> service_cidr_;
@@ -201,10 +250,10 @@ class K8sMetadataState : NotCopyable {
   std::vector<CIDRBlock> pod_cidrs_;
 
   // This stores K8s native objects (services, pods, etc).
-  absl::flat_hash_map<UID, K8sMetadataObjectUPtr> k8s_objects_by_id_;
+  K8sObjectsByIDMap k8s_objects_by_id_;
 
   // This stores container objects, complementing k8s_objects_by_id_.
-  absl::flat_hash_map<CID, ContainerInfoUPtr> containers_by_id_;
+  ContainersByIDMap containers_by_id_;
 
   /**
    * Mapping of pods by name.
@@ -230,6 +279,10 @@ class K8sMetadataState : NotCopyable {
    * Mapping of Pods by host ip.
    */
   PodsByPodIpMap pods_by_ip_;
+
+  // See cluster_cidr_index(). Immutable, so clones share it.
+  std::shared_ptr<const CIDRIndex<CIDRBlock>> cluster_cidr_index_ =
+      std::make_shared<CIDRIndex<CIDRBlock>>();
 };
 
 class AgentMetadataState : NotCopyable {
@@ -264,6 +317,12 @@ class AgentMetadataState : NotCopyable {
 
   std::shared_ptr<AgentMetadataState> CloneToShared() const;
 
+  /**
+   * A counter that changes whenever the PIDs or the k8s state of this object are modified.
+   * States published to readers are not modified, so this only changes while a state is built.
+   */
+  uint64_t generation() const { return pids_generation_ + k8s_metadata_state_->generation(); }
+
   PIDInfo* GetPIDByUPID(UPID upid) const {
     auto it = pids_by_upid_.find(upid);
     if (it != pids_by_upid_.end()) {
@@ -278,6 +337,7 @@ class AgentMetadataState : NotCopyable {
 
     pids_by_upid_[upid] = std::move(pid_info);
     upids_.insert(upid);
+    ++pids_generation_;
   }
 
   void MarkUPIDAsStopped(UPID upid, int64_t ts) {
@@ -285,6 +345,7 @@ class AgentMetadataState : NotCopyable {
     if (pid_info != nullptr) {
       pid_info->set_stop_time_ns(ts);
       upids_.erase(upid);
+      ++pids_generation_;
     } else {
       DCHECK(!upids_.contains(upid));
     }
@@ -310,6 +371,9 @@ class AgentMetadataState : NotCopyable {
    */
   uint64_t epoch_id_ = 0;
 
+  // Incremented whenever pids_by_upid_ or upids_ are modified. See generation().
+  uint64_t pids_generation_ = 0;
+
   std::string hostname_;
   std::string pod_name_;
   uint32_t asid_;
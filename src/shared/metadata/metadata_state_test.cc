@@ -113,6 +113,100 @@ TEST(K8sMetadataStateTest, CloneCopiedCIDR) {
   EXPECT_EQ(service_cidr.prefix_length, state_copy->service_cidr()->prefix_length);
 }
 
+TEST(K8sMetadataStateTest, CloneIsCopyOnWrite) {
+  K8sMetadataState state;
+
+  K8sMetadataState::ContainerUpdate container_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kContainer0UpdatePbTxt, &container_update));
+  K8sMetadataState::PodUpdate pod_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod0UpdatePbTxt, &pod_update));
+  K8sMetadataState::NamespaceUpdate ns_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kRunningNamespaceUpdatePbTxt, &ns_update));
+
+  ASSERT_OK(state.HandleContainerUpdate(container_update));
+  ASSERT_OK(state.HandlePodUpdate(pod_update));
+  ASSERT_OK(state.HandleNamespaceUpdate(ns_update));
+
+  auto state_copy = state.Clone();
+
+  // Until modified, objects are shared between the clones.
+  EXPECT_EQ(state.PodInfoByID("pod0_uid"), state_copy->PodInfoByID("pod0_uid"));
+  EXPECT_EQ(state.ContainerInfoByID("container0_uid"),
+            state_copy->ContainerInfoByID("container0_uid"));
+
+  pod_update.set_phase(px::shared::k8s::metadatapb::FAILED);
+  pod_update.set_pod_ip("1.1.1.1");
+  ASSERT_OK(state_copy->HandlePodUpdate(pod_update));
+
+  // The updated pod is copied, and the original state does not see the update.
+  ASSERT_NE(state.PodInfoByID("pod0_uid"), state_copy->PodInfoByID("pod0_uid"));
+  EXPECT_EQ(PodPhase::kRunning, state.PodInfoByID("pod0_uid")->phase());
+  EXPECT_EQ(PodPhase::kFailed, state_copy->PodInfoByID("pod0_uid")->phase());
+  EXPECT_EQ("", state.PodIDByIP("1.1.1.1"));
+  EXPECT_EQ("pod0_uid", state_copy->PodIDByIP("1.1.1.1"));
+
+  // Untouched objects remain shared.
+  EXPECT_EQ(state.ContainerInfoByID("container0_uid"),
+            state_copy->ContainerInfoByID("container0_uid"));
+  EXPECT_EQ(state.NamespaceInfoByID("ns0_uid"), state_copy->NamespaceInfoByID("ns0_uid"));
+
+  state_copy->MutableContainerInfoByID("container0_uid")->set_stop_time_ns(200);
+  EXPECT_EQ(102, state.ContainerInfoByID("container0_uid")->stop_time_ns());
+  EXPECT_EQ(200, state_copy->ContainerInfoByID("container0_uid")->stop_time_ns());
+}
+
+TEST(K8sMetadataStateTest, PodIDByIP) {
+  K8sMetadataState state;
+
+  K8sMetadataState::PodUpdate pod_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod0UpdatePbTxt, &pod_update));
+  ASSERT_OK(state.HandlePodUpdate(pod_update));
+
+  EXPECT_EQ("pod0_uid", state.PodIDByIP("1.2.3.4"));
+  // IPv4-mapped spellings of the pod IP, as reported by dual-stack sockets, resolve too.
+  EXPECT_EQ("pod0_uid", state.PodIDByIP("::ffff:1.2.3.4"));
+  EXPECT_EQ("pod0_uid", state.PodIDByIP("::FFFF:1.2.3.4"));
+  EXPECT_EQ("", state.PodIDByIP("1.2.3.5"));
+  EXPECT_EQ("", state.PodIDByIP("not an ip"));
+}
+
+TEST(K8sMetadataStateTest, ClusterCIDRIndex) {
+  K8sMetadataState state;
+
+  CIDRBlock pod_cidr;
+  ASSERT_OK(ParseCIDRBlock("1.2.0.0/16", &pod_cidr));
+  state.set_pod_cidrs({pod_cidr});
+  CIDRBlock service_cidr;
+  ASSERT_OK(ParseCIDRBlock("10.64.0.0/16", &service_cidr));
+  state.set_service_cidr(service_cidr);
+
+  auto lookup = [](const K8sMetadataState& state, std::string_view ip) {
+    InetAddr addr;
+    PL_CHECK_OK(ParseIPAddress(ip, &addr));
+    return state.cluster_cidr_index().LongestPrefixMatch(addr);
+  };
+
+  const CIDRBlock* cluster_cidr = lookup(state, "1.2.3.4");
+  ASSERT_NE(cluster_cidr, nullptr);
+  EXPECT_EQ(pod_cidr, *cluster_cidr);
+  cluster_cidr = lookup(state, "10.64.1.1");
+  ASSERT_NE(cluster_cidr, nullptr);
+  EXPECT_EQ(service_cidr, *cluster_cidr);
+  EXPECT_EQ(nullptr, lookup(state, "8.8.8.8"));
+
+  // The index is immutable and shared by clones, so a CIDR change in a clone leaves the original
+  // state unchanged.
+  auto state_copy = state.Clone();
+  EXPECT_EQ(&state.cluster_cidr_index(), &state_copy->cluster_cidr_index());
+  CIDRBlock new_pod_cidr;
+  ASSERT_OK(ParseCIDRBlock("8.8.0.0/16", &new_pod_cidr));
+  state_copy->set_pod_cidrs({pod_cidr, new_pod_cidr});
+  EXPECT_EQ(nullptr, lookup(state, "8.8.8.8"));
+  cluster_cidr = lookup(*state_copy, "8.8.8.8");
+  ASSERT_NE(cluster_cidr, nullptr);
+  EXPECT_EQ(new_pod_cidr, *cluster_cidr);
+}
+
 TEST(K8sMetadataStateTest, HandleContainerUpdate) {
   K8sMetadataState state;
 
@@ -284,6 +378,7 @@ TEST(K8sMetadataStateTest, CleanupExpiredMetadata) {
   {
     const PodInfo* pod_info = state.PodInfoByID("pod0_uid");
     ASSERT_NE(pod_info, nullptr);
+    EXPECT_EQ("pod0_uid", state.PodIDByIP("1.2.3.4"));
 
     const ServiceInfo* service_info = state.ServiceInfoByID("service0_uid");
     ASSERT_NE(service_info, nullptr);
@@ -301,6 +396,7 @@ TEST(K8sMetadataStateTest, CleanupExpiredMetadata) {
   {
     const PodInfo* pod_info = state.PodInfoByID("pod0_uid");
     ASSERT_EQ(pod_info, nullptr);
+    EXPECT_EQ("", state.PodIDByIP("1.2.3.4"));
 
     const ServiceInfo* service_info = state.ServiceInfoByID("service0_uid");
     ASSERT_EQ(service_info, nullptr);
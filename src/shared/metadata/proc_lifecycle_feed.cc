@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/shared/metadata/proc_lifecycle_feed.h"
+
+#include <string>
+#include <utility>
+
+#include <absl/strings/ascii.h>
+
+#include "src/common/base/file.h"
+#include "src/common/system/proc_parser.h"
+
+namespace px {
+namespace md {
+
+std::optional<uint32_t> ProcScanLifecycleFeed::ReadLastPID() const {
+  StatusOr<std::string> contents = ReadFileToString(proc_path_ / "sys/kernel/ns_last_pid");
+  uint32_t last_pid = 0;
+  if (!contents.ok() ||
+      !absl::SimpleAtoi(absl::StripAsciiWhitespace(contents.ValueOrDie()), &last_pid)) {
+    return std::nullopt;
+  }
+  return last_pid;
+}
+
+ProcLifecycleDelta ProcScanLifecycleFeed::Poll() {
+  ProcLifecycleDelta delta;
+
+  std::error_code ec;
+  std::filesystem::directory_iterator proc_dir(proc_path_, ec);
+  if (ec) {
+    LOG(ERROR) << absl::Substitute("Failed to list $0: $1", proc_path_.string(), ec.message());
+    return delta;
+  }
+
+  ++poll_count_;
+  const bool verify = verify_period_ > 0 && poll_count_ % verify_period_ == 0;
+
+  // The PIDs allocated since the previous poll are the ones in (prev_last_pid, last_pid], where
+  // the range wraps around when the allocation did.
+  std::optional<uint32_t> prev_last_pid = last_pid_;
+  last_pid_ = ReadLastPID();
+  auto maybe_reused = [&](uint32_t pid) {
+    if (!prev_last_pid.has_value() || !last_pid_.has_value()) {
+      return false;
+    }
+    const uint32_t from = prev_last_pid.value();
+    const uint32_t to = last_pid_.value();
+    return from <= to ? (pid > from && pid <= to) : (pid > from || pid <= to);
+  };
+
+  absl::flat_hash_map<uint32_t, int64_t> prev_start_times = std::move(start_times_);
+  start_times_.clear();
+  start_times_.reserve(prev_start_times.size());
+
+  for (const auto& p : proc_dir) {
+    uint32_t pid = 0;
+    if (!absl::SimpleAtoi(p.path().filename().string(), &pid)) {
+      continue;
+    }
+
+    auto iter = prev_start_times.find(pid);
+    if (iter != prev_start_times.end() && !verify && !maybe_reused(pid)) {
+      // Known PID that wasn't allocated again since the previous poll: the same process.
+      start_times_.insert(prev_start_times.extract(iter));
+      continue;
+    }
+
+    StatusOr<int64_t> start_time = system::GetPIDStartTimeTicks(p.path());
+    if (!start_time.ok()) {
+      // Likely already dead. If it was known, it is reported as an exit below.
+      continue;
+    }
+
+    if (iter != prev_start_times.end() && iter->second == start_time.ValueOrDie()) {
+      start_times_.insert(prev_start_times.extract(iter));
+      continue;
+    }
+
+    // A new process; if the PID was recycled, the previous process is reported as an exit below.
+    start_times_.emplace(pid, start_time.ValueOrDie());
+    delta.execs.emplace(asid_, pid, start_time.ValueOrDie());
+  }
+
+  for (const auto& [pid, start_time] : prev_start_times) {
+    delta.exits.emplace(asid_, pid, start_time);
+  }
+
+  return delta;
+}
+
+}  // namespace md
+}  // namespace px
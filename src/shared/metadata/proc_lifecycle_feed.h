@@ -0,0 +1,105 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include "src/shared/upid/upid.h"
+
+namespace px {
+namespace md {
+
+/**
+ * The processes that started (exec) and terminated (exit) between two polls of a
+ * ProcLifecycleFeed.
+ */
+struct ProcLifecycleDelta {
+  absl::flat_hash_set<UPID> execs;
+  absl::flat_hash_set<UPID> exits;
+};
+
+/**
+ * A source of process lifecycle events. Consumers apply the deltas to their own view of the
+ * running processes (see stirling::ProcTracker), instead of each rebuilding the full set of UPIDs
+ * on every cycle.
+ */
+class ProcLifecycleFeed {
+ public:
+  virtual ~ProcLifecycleFeed() = default;
+
+  /**
+   * Returns the processes that started and terminated since the previous call.
+   * The first call reports all running processes as execs.
+   */
+  virtual ProcLifecycleDelta Poll() = 0;
+};
+
+/**
+ * A ProcLifecycleFeed that scans the proc filesystem. It does not require BPF.
+ *
+ * The scan is incremental: only PIDs that were not seen on the previous poll have their start
+ * time read, so a steady-state poll costs a directory listing rather than a file read per
+ * process. A PID that exits and is reused between two polls is still listed, so the reuse is
+ * caught through the kernel's PID allocation: PIDs are handed out in increasing order, wrapping
+ * around at pid_max, so only the PIDs between the last PID allocated at the previous poll and
+ * the last one allocated now (sys/kernel/ns_last_pid) can have been reused, and those have their
+ * start time re-read on every poll. ns_last_pid is that of the reader's PID namespace, so it only
+ * applies to the proc filesystem of that namespace, e.g. the host's with hostPID. Where the last
+ * allocated PID can't be read, every verify_period-th poll re-reads the start times of all
+ * processes instead.
+ */
+class ProcScanLifecycleFeed : public ProcLifecycleFeed {
+ public:
+  static constexpr int kDefaultVerifyPeriod = 10;
+
+  /**
+   * @param proc_path Path to the proc filesystem.
+   * @param asid The ASID of the UPIDs that are reported.
+   * @param verify_period Re-read all start times every verify_period polls; 0 to never do so.
+   */
+  ProcScanLifecycleFeed(std::filesystem::path proc_path, uint32_t asid,
+                        int verify_period = kDefaultVerifyPeriod)
+      : proc_path_(std::move(proc_path)), asid_(asid), verify_period_(verify_period) {}
+
+  ProcLifecycleDelta Poll() override;
+
+ private:
+  // Returns the last PID allocated by the kernel, if the proc filesystem exposes it.
+  std::optional<uint32_t> ReadLastPID() const;
+
+  const std::filesystem::path proc_path_;
+  const uint32_t asid_;
+  const int verify_period_;
+
+  int poll_count_ = 0;
+
+  // The last PID allocated by the kernel as of the last poll.
+  std::optional<uint32_t> last_pid_;
+
+  // The start time of each PID seen on the last poll.
+  absl::flat_hash_map<uint32_t, int64_t> start_times_;
+};
+
+}  // namespace md
+}  // namespace px
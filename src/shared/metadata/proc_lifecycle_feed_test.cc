@@ -0,0 +1,161 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/shared/metadata/proc_lifecycle_feed.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/common/base/file.h"
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace md {
+
+using ::px::testing::TempDir;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+class ProcScanLifecycleFeedTest : public ::testing::Test {
+ protected:
+  // Creates <proc>/<pid>/stat, with the given start time.
+  void StartProcess(uint32_t pid, int64_t start_time) {
+    // The start time is the 22nd field of /proc/<pid>/stat; the file has 52 fields.
+    std::string stat = absl::StrCat(pid, " (test) S");
+    for (int i = 3; i < 52; ++i) {
+      absl::StrAppend(&stat, " ", i == 21 ? start_time : 0);
+    }
+    const std::filesystem::path pid_path = proc_dir_.path() / std::to_string(pid);
+    std::filesystem::create_directories(pid_path);
+    ASSERT_OK(WriteFileFromString(pid_path / "stat", stat));
+  }
+
+  void StopProcess(uint32_t pid) {
+    std::filesystem::remove_all(proc_dir_.path() / std::to_string(pid));
+  }
+
+  // Sets the last PID allocated by the kernel, <proc>/sys/kernel/ns_last_pid.
+  void SetLastPID(uint32_t pid) {
+    const std::filesystem::path kernel_path = proc_dir_.path() / "sys/kernel";
+    std::filesystem::create_directories(kernel_path);
+    ASSERT_OK(WriteFileFromString(kernel_path / "ns_last_pid", absl::StrCat(pid, "\n")));
+  }
+
+  TempDir proc_dir_;
+};
+
+TEST_F(ProcScanLifecycleFeedTest, ExecsAndExits) {
+  constexpr uint32_t kASID = 3;
+  ProcScanLifecycleFeed feed(proc_dir_.path(), kASID, /* verify_period */ 0);
+
+  StartProcess(1, 100);
+  StartProcess(2, 200);
+  std::filesystem::create_directories(proc_dir_.path() / "self");
+
+  ProcLifecycleDelta delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 1, 100), UPID(kASID, 2, 200)));
+  EXPECT_THAT(delta.exits, IsEmpty());
+
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, IsEmpty());
+  EXPECT_THAT(delta.exits, IsEmpty());
+
+  StopProcess(1);
+  StartProcess(3, 300);
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 3, 300)));
+  EXPECT_THAT(delta.exits, UnorderedElementsAre(UPID(kASID, 1, 100)));
+}
+
+TEST_F(ProcScanLifecycleFeedTest, RecycledPID) {
+  constexpr uint32_t kASID = 0;
+  ProcScanLifecycleFeed feed(proc_dir_.path(), kASID, /* verify_period */ 2);
+
+  StartProcess(1, 100);
+  ProcLifecycleDelta delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 1, 100)));
+
+  // PID 1 is reused by a new process between two polls.
+  StopProcess(1);
+  StartProcess(1, 150);
+
+  // The second poll verifies start times, so the reuse is noticed.
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 1, 150)));
+  EXPECT_THAT(delta.exits, UnorderedElementsAre(UPID(kASID, 1, 100)));
+
+  // The third poll does not read start times, so a reuse is not noticed until the next
+  // verifying poll.
+  StopProcess(1);
+  StartProcess(1, 175);
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, IsEmpty());
+  EXPECT_THAT(delta.exits, IsEmpty());
+
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 1, 175)));
+  EXPECT_THAT(delta.exits, UnorderedElementsAre(UPID(kASID, 1, 150)));
+}
+
+TEST_F(ProcScanLifecycleFeedTest, RecycledPIDByLastPID) {
+  constexpr uint32_t kASID = 0;
+  ProcScanLifecycleFeed feed(proc_dir_.path(), kASID, /* verify_period */ 0);
+
+  SetLastPID(20);
+  StartProcess(10, 100);
+  StartProcess(20, 200);
+  ProcLifecycleDelta delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 10, 100), UPID(kASID, 20, 200)));
+
+  // PID 10 is reused after the PIDs wrapped around: the allocations since the previous poll were
+  // 21 and up, then 1 to 10.
+  StopProcess(10);
+  StartProcess(10, 150);
+  SetLastPID(10);
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 10, 150)));
+  EXPECT_THAT(delta.exits, UnorderedElementsAre(UPID(kASID, 10, 100)));
+
+  // Only the PIDs in the allocated range, 11 to 15, have their start times read, so the change
+  // to PID 20 isn't seen.
+  StopProcess(20);
+  StartProcess(20, 250);
+  SetLastPID(15);
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, IsEmpty());
+  EXPECT_THAT(delta.exits, IsEmpty());
+
+  // PID 20 is reused within the allocated range 16 to 30.
+  SetLastPID(30);
+  delta = feed.Poll();
+  EXPECT_THAT(delta.execs, UnorderedElementsAre(UPID(kASID, 20, 250)));
+  EXPECT_THAT(delta.exits, UnorderedElementsAre(UPID(kASID, 20, 200)));
+}
+
+TEST_F(ProcScanLifecycleFeedTest, MissingProcPath) {
+  ProcScanLifecycleFeed feed(proc_dir_.path() / "missing", /* asid */ 0);
+  ProcLifecycleDelta delta = feed.Poll();
+  EXPECT_THAT(delta.execs, IsEmpty());
+  EXPECT_THAT(delta.exits, IsEmpty());
+}
+
+}  // namespace md
+}  // namespace px
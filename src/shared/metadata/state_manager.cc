@@ -67,7 +67,7 @@ Status AgentMetadataStateManagerImpl::PerformMetadataStateUpdate() {
    *   3. For each container pull the pid information. Diff this with the existing pids and update.
    *   4. Send diff of pids to the outgoing update Q.
    *   5. Set current update time and increment the epoch.
-   *   6. Update pod/service CIDR information if it has changed.
+   *   6. Update pod/service CIDR information if it has changed, and index pod IPs and CIDRs.
    *   7. Replace the current agent_metdata_state_ ptr.
    */
   uint64_t epoch_id = 0;
@@ -90,8 +90,9 @@ Status AgentMetadataStateManagerImpl::PerformMetadataStateUpdate() {
 
   if (collects_data_) {
     // Update PID information.
-    PL_RETURN_IF_ERROR(
-        ProcessPIDUpdates(ts, proc_parser_, shadow_state.get(), md_reader_.get(), &pid_updates_));
+    ProcLifecycleDelta proc_delta = proc_feed_->Poll();
+    PL_RETURN_IF_ERROR(ProcessPIDUpdates(ts, proc_parser_, shadow_state.get(), md_reader_.get(),
+                                         proc_delta.exits, &pid_updates_));
   }
 
   // Update the pod/service CIDRs if they have been updated.
@@ -168,9 +169,30 @@ StatusOr<UPID> InitUPID(const system::ProcParser& proc_parser, uint32_t asid, ui
 
 }  // namespace
 
+namespace {
+
+// Returns whether the PIDs read from a container's cgroups differ from its tracked UPIDs, or any of
+// the tracked UPIDs exited.
+bool PIDsChanged(const absl::flat_hash_set<UPID>& upids,
+                 const absl::flat_hash_set<uint32_t>& cgroups_pids,
+                 const absl::flat_hash_set<UPID>& exited_upids) {
+  if (upids.size() != cgroups_pids.size()) {
+    return true;
+  }
+  for (const auto& upid : upids) {
+    if (!cgroups_pids.contains(upid.pid()) || exited_upids.contains(upid)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 void ProcessContainerPIDUpdates(
     CIDView cid, int64_t ts, const system::ProcParser& proc_parser, AgentMetadataState* md,
     absl::flat_hash_set<UPID>* upids, absl::flat_hash_set<uint32_t>* cgroups_pids,
+    const absl::flat_hash_set<UPID>& exited_upids,
     moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates) {
   // Iterate through old list of UPIDs, looking for PIDs which have been deleted.
   auto upids_iter = upids->begin();
@@ -178,8 +200,9 @@ void ProcessContainerPIDUpdates(
     const auto& prev_upid = *upids_iter;
 
     auto cgroups_pids_iter = cgroups_pids->find(prev_upid.pid());
-    if (cgroups_pids_iter == cgroups_pids->end()) {
-      // Deleted PID.
+    if (cgroups_pids_iter == cgroups_pids->end() || exited_upids.contains(prev_upid)) {
+      // Deleted PID. If the PID was reused, it stays in cgroups_pids and is added back as a new
+      // UPID below.
       md->MarkUPIDAsStopped(prev_upid, ts);
 
       // Push deletion events to the queue.
@@ -219,10 +242,14 @@ void ProcessContainerPIDUpdates(
 
 Status ProcessPIDUpdates(
     int64_t ts, const system::ProcParser& proc_parser, AgentMetadataState* md,
-    CGroupMetadataReader* md_reader,
+    CGroupMetadataReader* md_reader, const absl::flat_hash_set<UPID>& exited_upids,
     moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates) {
-  const auto& k8s_md_state = md->k8s_metadata_state();
+  auto* k8s_md_state = md->k8s_metadata_state();
 
+  // Containers are read from the (shared) map, and only copied via MutableContainerInfoByID()
+  // when their state actually changes. The iterator does not hold a reference to the shards,
+  // so only containers in shards shared with an earlier snapshot get copied, and the iteration
+  // continues over the snapshot's unchanged shard.
   for (const auto& [cid, cinfo] : k8s_md_state->containers_by_id()) {
     if (cinfo->stop_time_ns() != 0) {
       // Ignore dead containers.
@@ -249,7 +276,7 @@ Status ProcessPIDUpdates(
     if (pod_info->stop_time_ns() != 0) {
       VLOG(1) << absl::Substitute("Found a running container in a deleted pod [cid=$0, pod_id=$1]",
                                   cid, pod_id);
-      cinfo->set_stop_time_ns(pod_info->stop_time_ns());
+      k8s_md_state->MutableContainerInfoByID(cid)->set_stop_time_ns(pod_info->stop_time_ns());
       continue;
     }
 
@@ -267,17 +294,23 @@ Status ProcessPIDUpdates(
       // NOTE: Currently, MDS sends pods that do no belong to this Agent, so this is actually
       // required to avoid repeatedly printing out the warning message above.
       if (error::IsNotFound(s)) {
-        cinfo->set_stop_time_ns(ts);
-        for (const auto& upid : cinfo->active_upids()) {
+        ContainerInfo* mutable_cinfo = k8s_md_state->MutableContainerInfoByID(cid);
+        mutable_cinfo->set_stop_time_ns(ts);
+        for (const auto& upid : mutable_cinfo->active_upids()) {
           md->MarkUPIDAsStopped(upid, ts);
         }
-        cinfo->mutable_active_upids()->clear();
+        mutable_cinfo->mutable_active_upids()->clear();
       }
       continue;
     }
 
-    ProcessContainerPIDUpdates(cid, ts, proc_parser, md, cinfo->mutable_active_upids(),
-                               &cgroups_active_pids, pid_updates);
+    if (!PIDsChanged(cinfo->active_upids(), cgroups_active_pids, exited_upids)) {
+      continue;
+    }
+
+    ProcessContainerPIDUpdates(cid, ts, proc_parser, md,
+                               k8s_md_state->MutableContainerInfoByID(cid)->mutable_active_upids(),
+                               &cgroups_active_pids, exited_upids, pid_updates);
   }
 
   return Status::OK();
@@ -37,6 +37,7 @@
 #include "src/shared/metadata/metadata_filter.h"
 #include "src/shared/metadata/metadata_state.h"
 #include "src/shared/metadata/pids.h"
+#include "src/shared/metadata/proc_lifecycle_feed.h"
 #include "src/shared/metadatapb/metadata.pb.h"
 #include "src/shared/upid/upid.h"
 
@@ -124,6 +125,7 @@ class AgentMetadataStateManagerImpl : public AgentMetadataStateManager {
         collects_data_(collects_data),
         metadata_filter_(metadata_filter) {
     md_reader_ = std::make_unique<CGroupMetadataReader>(config);
+    proc_feed_ = std::make_unique<ProcScanLifecycleFeed>(config.proc_path(), asid);
     agent_metadata_state_ =
         std::make_shared<AgentMetadataState>(hostname, asid, agent_id, pod_name);
   }
@@ -160,6 +162,9 @@ class AgentMetadataStateManagerImpl : public AgentMetadataStateManager {
   system::ProcParser proc_parser_;
 
   std::unique_ptr<CGroupMetadataReader> md_reader_;
+  // Tracks the processes of the host, to catch PIDs that are reused while they stay in the same
+  // container. Stirling reads the processes from this state rather than scanning them itself.
+  std::unique_ptr<ProcLifecycleFeed> proc_feed_;
   // The metadata state stored here is immutable so that we can easily share a read only
   // copy across threads. The pointer is atomically updated in PerformMetadataStateUpdate(),
   // which is responsible for applying the queued updates.
@@ -192,10 +197,12 @@ Status ApplyK8sUpdates(
 void RemoveDeadPods(int64_t ts, AgentMetadataState* md, CGroupMetadataReader* md_reader);
 
 /**
- * Processes PID updates.
+ * Processes PID updates. The exited UPIDs, e.g. from a ProcLifecycleFeed, are stopped even if
+ * their PID has been reused by a process in the same container.
  */
 Status ProcessPIDUpdates(
     int64_t ts, const system::ProcParser& proc_parser, AgentMetadataState*, CGroupMetadataReader*,
+    const absl::flat_hash_set<UPID>& exited_upids,
     moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates);
 
 /**
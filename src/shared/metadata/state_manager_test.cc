@@ -258,7 +258,8 @@ TEST_F(AgentMetadataStateTest, pid_created) {
   EXPECT_CALL(sysconfig, KernelTicksPerSecond()).WillRepeatedly(Return(10000000));
   EXPECT_CALL(sysconfig, proc_path()).WillRepeatedly(ReturnRef(proc_path));
   system::ProcParser proc_parser(sysconfig);
-  EXPECT_OK(ProcessPIDUpdates(1000, proc_parser, &metadata_state_, &md_reader, &events));
+  EXPECT_OK(ProcessPIDUpdates(1000, proc_parser, &metadata_state_, &md_reader,
+                              /* exited_upids */ {}, &events));
 
   std::unique_ptr<PIDStatusEvent> event;
   std::vector<PIDStartedEvent> pids_started;
@@ -278,6 +279,54 @@ TEST_F(AgentMetadataStateTest, pid_created) {
   EXPECT_THAT(pids_started, UnorderedElementsAre(PIDStartedEvent{pid1}, PIDStartedEvent{pid2}));
 }
 
+TEST_F(AgentMetadataStateTest, pid_reused) {
+  moodycamel::BlockingConcurrentQueue<std::unique_ptr<ResourceUpdate>> updates;
+  GenerateTestUpdateEvents(&updates);
+
+  EXPECT_OK(ApplyK8sUpdates(2000 /*ts*/, &metadata_state_, &md_filter_, &updates));
+
+  moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>> events;
+  FakePIDData md_reader;
+
+  std::filesystem::path proc_path = testing::TestFilePath("src/shared/metadata/testdata/proc");
+
+  system::MockConfig sysconfig;
+  EXPECT_CALL(sysconfig, ClockRealTimeOffset()).WillRepeatedly(Return(128));
+  EXPECT_CALL(sysconfig, HasConfig()).WillRepeatedly(Return(true));
+  EXPECT_CALL(sysconfig, PageSize()).WillRepeatedly(Return(4096));
+  EXPECT_CALL(sysconfig, KernelTicksPerSecond()).WillRepeatedly(Return(10000000));
+  EXPECT_CALL(sysconfig, proc_path()).WillRepeatedly(ReturnRef(proc_path));
+  system::ProcParser proc_parser(sysconfig);
+  EXPECT_OK(ProcessPIDUpdates(1000, proc_parser, &metadata_state_, &md_reader,
+                              /* exited_upids */ {}, &events));
+
+  std::unique_ptr<PIDStatusEvent> event;
+  while (events.try_dequeue(event)) {
+    // Drop the events of the initial PIDs.
+  }
+
+  // The cgroups still list PID 100, but its process exited and the PID was reused.
+  const UPID upid1(kASID, 100 /*pid*/, 1000 /*ts*/);
+  EXPECT_OK(ProcessPIDUpdates(3000, proc_parser, &metadata_state_, &md_reader,
+                              /* exited_upids */ {upid1}, &events));
+
+  std::vector<UPID> pids_started;
+  std::vector<UPID> pids_terminated;
+  while (events.try_dequeue(event)) {
+    if (event->type == PIDStatusEventType::kStarted) {
+      pids_started.push_back(static_cast<PIDStartedEvent*>(event.get())->pid_info.upid());
+    } else {
+      pids_terminated.push_back(static_cast<PIDTerminatedEvent*>(event.get())->upid);
+    }
+  }
+  EXPECT_THAT(pids_terminated, ElementsAre(upid1));
+  // The test proc filesystem has the same start time, a reused PID would have a later one.
+  EXPECT_THAT(pids_started, ElementsAre(upid1));
+  K8sMetadataState* state = metadata_state_.k8s_metadata_state();
+  EXPECT_THAT(state->ContainerInfoByID("container_id1")->active_upids(),
+              UnorderedElementsAre(upid1, UPID(kASID, 200 /*pid*/, 2000 /*ts*/)));
+}
+
 TEST_F(AgentMetadataStateTest, insert_into_filter) {
   moodycamel::BlockingConcurrentQueue<std::unique_ptr<ResourceUpdate>> updates;
   GenerateTestUpdateEvents(&updates);
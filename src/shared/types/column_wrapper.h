@@ -22,8 +22,11 @@
 #include <arrow/buffer.h>
 #include <arrow/builder.h>
 
+#include <limits>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -66,6 +69,10 @@ class ColumnWrapper {
   virtual void ShrinkToFit() = 0;
   virtual std::shared_ptr<arrow::Array> ConvertToArrow(arrow::MemoryPool* mem_pool) = 0;
 
+  // Whether this is a StringArenaColumnWrapper, which stores its STRING values contiguously
+  // instead of in a std::vector<StringValue>.
+  virtual bool IsStringArena() const { return false; }
+
   template <class TValueType>
   void Append(TValueType val);
 
@@ -182,6 +189,142 @@ inline int64_t ColumnWrapperTmpl<StringValue>::Bytes() const {
   return bytes;
 }
 
+/**
+ * A STRING column that stores all its values in one contiguous byte buffer plus an offsets buffer,
+ * which is the same layout as an arrow::StringArray. Appending a value is a memcpy into the arena
+ * rather than a separate heap allocation per value, and ConvertToArrow() hands the buffers to
+ * arrow without copying them.
+ *
+ * Once converted to arrow, the column is sealed: further reads are served from the arrow array,
+ * and appending is no longer allowed.
+ *
+ * The column is read-only through the generic ColumnWrapper interface: there is no StringValue
+ * array to hand out, so UnsafeRawData() and the mutable Get<StringValue>() CHECK-fail. Read the
+ * values through View() or a const ColumnWrapper instead.
+ */
+class StringArenaColumnWrapper : public ColumnWrapper {
+ public:
+  StringArenaColumnWrapper() { Init(); }
+  ~StringArenaColumnWrapper() override = default;
+
+  BaseValueType* UnsafeRawData() override {
+    LOG(FATAL) << "Arena-backed STRING columns have no StringValue array.";
+    return nullptr;
+  }
+  const BaseValueType* UnsafeRawData() const override {
+    LOG(FATAL) << "Arena-backed STRING columns have no StringValue array.";
+    return nullptr;
+  }
+  DataType data_type() const override { return DataType::STRING; }
+  bool IsStringArena() const override { return true; }
+
+  size_t Size() const override { return size_; }
+  bool Empty() const override { return size_ == 0; }
+  int64_t Bytes() const override { return bytes_; }
+
+  /**
+   * Appends val, followed by suffix, as a single value.
+   */
+  void Append(std::string_view val, std::string_view suffix = {}) {
+    DCHECK(array_ == nullptr) << "Cannot append to a column that was already converted to arrow.";
+    const int64_t len = val.size() + suffix.size();
+    CHECK_LE(bytes_ + len, std::numeric_limits<int32_t>::max());
+    PL_CHECK_OK(data_->Append(val.data(), val.size()));
+    PL_CHECK_OK(data_->Append(suffix.data(), suffix.size()));
+    bytes_ += len;
+    const int32_t end = static_cast<int32_t>(bytes_);
+    PL_CHECK_OK(offsets_->Append(&end, sizeof(end)));
+    ++size_;
+  }
+
+  std::string_view View(size_t idx) const {
+    DCHECK_LT(idx, size_);
+    if (array_ != nullptr) {
+      int32_t length = 0;
+      const uint8_t* data = array_->GetValue(idx, &length);
+      return {reinterpret_cast<const char*>(data), static_cast<size_t>(length)};
+    }
+    const int32_t* offsets = reinterpret_cast<const int32_t*>(offsets_->data());
+    return {reinterpret_cast<const char*>(data_->data()) + offsets[idx],
+            static_cast<size_t>(offsets[idx + 1] - offsets[idx])};
+  }
+
+  // Returns a copy of the value; the arena has no StringValue to return a reference to.
+  StringValue operator[](size_t idx) const { return StringValue(View(idx)); }
+
+  // Reserves space for the offsets of size values; value bytes are grown on demand.
+  void Reserve(size_t size) override {
+    if (array_ == nullptr) {
+      PL_CHECK_OK(offsets_->Reserve(size * sizeof(int32_t)));
+    }
+  }
+
+  void Clear() override { Init(); }
+
+  void ShrinkToFit() override {}
+
+  // The arena's buffers are handed over as-is, so they remain owned by the pool they were
+  // allocated from rather than mem_pool.
+  std::shared_ptr<arrow::Array> ConvertToArrow(arrow::MemoryPool* /* mem_pool */) override {
+    if (array_ == nullptr) {
+      std::shared_ptr<arrow::Buffer> offsets;
+      std::shared_ptr<arrow::Buffer> data;
+      // Don't shrink to fit, since that could reallocate (i.e. copy) the buffers.
+      PL_CHECK_OK(offsets_->Finish(&offsets, /*shrink_to_fit*/ false));
+      PL_CHECK_OK(data_->Finish(&data, /*shrink_to_fit*/ false));
+      array_ = std::make_shared<arrow::StringArray>(size_, offsets, data);
+    }
+    return array_;
+  }
+
+  SharedColumnWrapper CopyIndexes(const std::vector<size_t>& indexes) const override {
+    DCHECK_LE(indexes.size(), size_);
+    auto copy = std::make_shared<StringArenaColumnWrapper>();
+    copy->Reserve(indexes.size());
+    for (size_t idx : indexes) {
+      copy->Append(View(idx));
+    }
+    return copy;
+  }
+
+  // Moving every index in order (the common case when draining a table) hands over the arena
+  // itself; otherwise the selected values are copied into a new arena.
+  SharedColumnWrapper MoveIndexes(const std::vector<size_t>& indexes) override {
+    DCHECK_LE(indexes.size(), size_);
+    bool identity = indexes.size() == size_;
+    for (size_t i = 0; identity && i < indexes.size(); ++i) {
+      identity = indexes[i] == i;
+    }
+    if (!identity) {
+      return CopyIndexes(indexes);
+    }
+    auto col = std::make_shared<StringArenaColumnWrapper>();
+    std::swap(col->data_, data_);
+    std::swap(col->offsets_, offsets_);
+    std::swap(col->array_, array_);
+    std::swap(col->size_, size_);
+    std::swap(col->bytes_, bytes_);
+    return col;
+  }
+
+ private:
+  void Init() {
+    data_ = std::make_unique<arrow::BufferBuilder>();
+    offsets_ = std::make_unique<arrow::BufferBuilder>();
+    const int32_t start = 0;
+    PL_CHECK_OK(offsets_->Append(&start, sizeof(start)));
+    array_.reset();
+    size_ = 0;
+    bytes_ = 0;
+  }
+
+  std::unique_ptr<arrow::BufferBuilder> data_;
+  std::unique_ptr<arrow::BufferBuilder> offsets_;
+  std::shared_ptr<arrow::StringArray> array_;
+  size_t size_ = 0;
+  int64_t bytes_ = 0;
+};
+
 // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
 using BoolValueColumnWrapper = ColumnWrapperTmpl<BoolValue>;
 using Int64ValueColumnWrapper = ColumnWrapperTmpl<Int64Value>;
@@ -293,36 +436,64 @@ inline void ColumnWrapper::Append(TValueType val) {
   CHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type)
       << "Expect " << ToString(data_type()) << " got "
       << ToString(ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    if (IsStringArena()) {
+      static_cast<StringArenaColumnWrapper*>(this)->Append(val);
+      return;
+    }
+  }
   static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(val);
 }
 
 template <class TValueType>
 inline TValueType& ColumnWrapper::Get(size_t idx) {
   CHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    CHECK(!IsStringArena()) << "Arena-backed STRING columns are read-only; use a const Get().";
+  }
   return static_cast<ColumnWrapperTmpl<TValueType>*>(this)->operator[](idx);
 }
 
 template <class TValueType>
 inline TValueType ColumnWrapper::Get(size_t idx) const {
   CHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    if (IsStringArena()) {
+      return static_cast<const StringArenaColumnWrapper*>(this)->operator[](idx);
+    }
+  }
   return static_cast<const ColumnWrapperTmpl<TValueType>*>(this)->operator[](idx);
 }
 
 template <class TValueType>
 inline void ColumnWrapper::AppendNoTypeCheck(TValueType val) {
   DCHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    if (IsStringArena()) {
+      static_cast<StringArenaColumnWrapper*>(this)->Append(val);
+      return;
+    }
+  }
   static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(val);
 }
 
 template <class TValueType>
 inline TValueType& ColumnWrapper::GetNoTypeCheck(size_t idx) {
   DCHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    CHECK(!IsStringArena()) << "Arena-backed STRING columns are read-only; use a const Get().";
+  }
   return static_cast<ColumnWrapperTmpl<TValueType>*>(this)->operator[](idx);
 }
 
 template <class TValueType>
 inline TValueType ColumnWrapper::GetNoTypeCheck(size_t idx) const {
   DCHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    if (IsStringArena()) {
+      return static_cast<const StringArenaColumnWrapper*>(this)->operator[](idx);
+    }
+  }
   return static_cast<ColumnWrapperTmpl<TValueType>*>(this)->operator[](idx);
 }
 
@@ -331,6 +502,14 @@ inline void ColumnWrapper::AppendFromVector(const std::vector<TValueType>& val)
   CHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type)
       << "Expect " << ToString(data_type()) << " got "
       << ToString(ValueTypeTraits<TValueType>::data_type);
+  if constexpr (std::is_same_v<TValueType, StringValue>) {
+    if (IsStringArena()) {
+      for (const auto& v : val) {
+        static_cast<StringArenaColumnWrapper*>(this)->Append(v);
+      }
+      return;
+    }
+  }
   static_cast<ColumnWrapperTmpl<TValueType>*>(this)->AppendFromVector(val);
 }
 
@@ -24,6 +24,9 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/types.h"
@@ -283,5 +286,95 @@ TEST(ColumnWrapperTest, MoveIndexes) {
   }
 }
 
+TEST(StringArenaColumnWrapperTest, AppendAndGet) {
+  auto col = std::make_shared<StringArenaColumnWrapper>();
+  SharedColumnWrapper wrapper = col;
+  wrapper->Append<StringValue>("abc");
+  col->Append("", "");
+  col->Append("hello", " world");
+  wrapper->AppendFromVector(std::vector<StringValue>{"x", "yz"});
+
+  EXPECT_EQ(wrapper->data_type(), DataType::STRING);
+  EXPECT_TRUE(wrapper->IsStringArena());
+  ASSERT_EQ(wrapper->Size(), 5);
+  EXPECT_EQ(wrapper->Bytes(), 3 + 11 + 1 + 2);
+  EXPECT_EQ(col->View(0), "abc");
+  EXPECT_EQ(col->View(1), "");
+  EXPECT_EQ(col->View(2), "hello world");
+  EXPECT_EQ((*col)[3], "x");
+  EXPECT_EQ(std::as_const(*wrapper).Get<StringValue>(4), "yz");
+}
+
+TEST(StringArenaColumnWrapperTest, InterleavedAppendAndGet) {
+  auto col = std::make_shared<StringArenaColumnWrapper>();
+  SharedColumnWrapper wrapper = col;
+  for (int i = 0; i < 100; ++i) {
+    col->Append(std::to_string(i));
+    EXPECT_EQ(std::as_const(*wrapper).Get<StringValue>(i), std::to_string(i));
+  }
+}
+
+TEST(StringArenaColumnWrapperDeathTest, MutableAccess) {
+  SharedColumnWrapper wrapper = std::make_shared<StringArenaColumnWrapper>();
+  wrapper->Append<StringValue>("abc");
+  EXPECT_DEATH(wrapper->Get<StringValue>(0), "read-only");
+  EXPECT_DEATH(wrapper->GetNoTypeCheck<StringValue>(0), "read-only");
+  EXPECT_DEATH(wrapper->UnsafeRawData(), "no StringValue array");
+}
+
+TEST(StringArenaColumnWrapperTest, ConvertToArrowAdoptsBuffers) {
+  auto col = std::make_shared<StringArenaColumnWrapper>();
+  col->Append("abc");
+  col->Append("def");
+  col->Append("hello");
+
+  arrow::StringBuilder builder;
+  PL_CHECK_OK(builder.Append("abc"));
+  PL_CHECK_OK(builder.Append("def"));
+  PL_CHECK_OK(builder.Append("hello"));
+  std::shared_ptr<arrow::Array> expected_arr;
+  PL_CHECK_OK(builder.Finish(&expected_arr));
+
+  const char* arena_data = col->View(0).data();
+  auto arr = col->ConvertToArrow(arrow::default_memory_pool());
+  EXPECT_TRUE(arr->Equals(expected_arr));
+
+  // The arrow array points at the arena bytes, rather than a copy of them.
+  int32_t length = 0;
+  auto* str_arr = static_cast<arrow::StringArray*>(arr.get());
+  EXPECT_EQ(reinterpret_cast<const char*>(str_arr->GetValue(0, &length)), arena_data);
+
+  // The column is sealed after conversion: the same array is returned and reads are served from it.
+  EXPECT_EQ(arr, col->ConvertToArrow(arrow::default_memory_pool()));
+  EXPECT_EQ(col->View(1), "def");
+  EXPECT_EQ(col->Bytes(), 11);
+}
+
+TEST(StringArenaColumnWrapperTest, CopyAndMoveIndexes) {
+  auto col = std::make_shared<StringArenaColumnWrapper>();
+  for (const char* s : {"a", "bb", "ccc", "dddd"}) {
+    col->Append(s);
+  }
+
+  auto copy = col->CopyIndexes({3, 1, 1});
+  ASSERT_EQ(copy->Size(), 3);
+  EXPECT_TRUE(copy->IsStringArena());
+  EXPECT_EQ(std::as_const(*copy).Get<StringValue>(0), "dddd");
+  EXPECT_EQ(std::as_const(*copy).Get<StringValue>(1), "bb");
+  EXPECT_EQ(std::as_const(*copy).Get<StringValue>(2), "bb");
+
+  auto subset = col->MoveIndexes({2, 0});
+  ASSERT_EQ(subset->Size(), 2);
+  EXPECT_EQ(std::as_const(*subset).Get<StringValue>(0), "ccc");
+  EXPECT_EQ(std::as_const(*subset).Get<StringValue>(1), "a");
+
+  // Moving all indexes in order hands over the arena and leaves the source empty.
+  auto moved = col->MoveIndexes({0, 1, 2, 3});
+  ASSERT_EQ(moved->Size(), 4);
+  EXPECT_EQ(std::as_const(*moved).Get<StringValue>(3), "dddd");
+  EXPECT_EQ(moved->Bytes(), 10);
+  EXPECT_EQ(col->Size(), 0);
+}
+
 }  // namespace types
 }  // namespace px
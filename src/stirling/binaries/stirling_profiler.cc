@@ -19,6 +19,7 @@
 #include <csignal>
 #include <iostream>
 #include <thread>
+#include <utility>
 
 #include "src/common/base/base.h"
 #include "src/shared/upid/upid.h"
@@ -76,7 +77,10 @@ Status StirlingWrapperCallback(uint64_t table_id, TabletID /* tablet_id */,
   auto iter = g_table_info_map.find(table_id);
   CHECK(iter != g_table_info_map.end());
   const InfoClass& table_info = iter->second;
-  CHECK_EQ(table_info.schema().name(), "stack_traces.beta");
+  if (table_info.schema().name() != "stack_traces.beta") {
+    // E.g. the stack frames table, which is only populated when stack frames are interned.
+    return Status::OK();
+  }
 
   auto& upid_col = (*record_batch)[px::stirling::kStackTraceUPIDIdx];
   auto& stack_trace_str_col = (*record_batch)[px::stirling::kStackTraceStackTraceStrIdx];
@@ -87,7 +91,7 @@ Status StirlingWrapperCallback(uint64_t table_id, TabletID /* tablet_id */,
     UPID upid(upid_col->Get<px::types::UInt128Value>(i).val);
 
     if (g_args.pid == upid.pid()) {
-      std::cout << stack_trace_str_col->Get<px::types::StringValue>(i);
+      std::cout << std::as_const(*stack_trace_str_col).Get<px::types::StringValue>(i);
       std::cout << " ";
       std::cout << count_col->Get<px::types::Int64Value>(i).val;
       std::cout << "\n";
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "src/common/base/base.h"
+#include "src/common/base/cidr_index.h"
 #include "src/shared/metadata/metadata_state.h"
 #include "src/shared/types/types.h"
 #include "src/shared/upid/upid.h"
@@ -67,11 +68,11 @@ class ConnectorContext {
   virtual const md::K8sMetadataState& GetK8SMetadata() = 0;
 
   /**
-   * Return a list of cluster CIDRs. Any IPs within any of these CIDRs is considered
+   * Return an index over the cluster CIDRs. Any IPs within any of these CIDRs is considered
    * part of the traceable domain. Primarily used to determine when to apply client vs server side
-   * tracing.
+   * tracing. The index is valid for the lifetime of the context.
    */
-  virtual std::vector<CIDRBlock> GetClusterCIDRs() = 0;
+  virtual const CIDRIndex<CIDRBlock>& GetClusterCIDRIndex() = 0;
 };
 
 /**
@@ -103,7 +104,9 @@ class AgentContext : public ConnectorContext {
     return agent_metadata_state_->k8s_metadata_state();
   }
 
-  std::vector<CIDRBlock> GetClusterCIDRs() override;
+  const CIDRIndex<CIDRBlock>& GetClusterCIDRIndex() override {
+    return agent_metadata_state_->k8s_metadata_state().cluster_cidr_index();
+  }
 
  private:
   std::shared_ptr<const md::AgentMetadataState> agent_metadata_state_;
@@ -114,10 +117,14 @@ class AgentContext : public ConnectorContext {
  */
 class StandaloneContext : public ConnectorContext {
  public:
-  StandaloneContext() {
-    // The context consists of all PIDs, but no pods/containers.
-    upids_ = ListUPIDs(system::Config::GetInstance().proc_path(), 0);
+  // The context consists of all PIDs, but no pods/containers.
+  StandaloneContext()
+      : StandaloneContext(ListUPIDs(system::Config::GetInstance().proc_path(), 0)) {}
 
+  /**
+   * A context with the given set of processes, e.g. as tracked from a ProcLifecycleFeed.
+   */
+  explicit StandaloneContext(absl::flat_hash_set<md::UPID> upids) : upids_(std::move(upids)) {
     // Cannot be empty, otherwise stirling will wait indefinitely. Since StandaloneContext is used
     // for local environment, set it such that localhost (127.0.0.1) will be treated as outside of
     // cluster, and --treat_loopback_as_in_cluster in conn_tracker.cc will take effect.
@@ -139,12 +146,12 @@ class StandaloneContext : public ConnectorContext {
     return kEmpty;
   }
 
-  std::vector<CIDRBlock> GetClusterCIDRs() override { return cidrs_; }
+  const CIDRIndex<CIDRBlock>& GetClusterCIDRIndex() override { return cidrs_; }
 
   Status SetClusterCIDR(std::string_view cidr_str);
 
  private:
-  std::vector<CIDRBlock> cidrs_;
+  CIDRIndex<CIDRBlock> cidrs_;
   absl::flat_hash_set<md::UPID> upids_;
 };
 
@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,7 +34,8 @@ namespace stirling {
 using types::ColumnWrapper;
 using types::DataType;
 
-DataTable::DataTable(uint64_t id, const DataTableSchema& schema) : id_(id), table_schema_(schema) {}
+DataTable::DataTable(uint64_t id, const DataTableSchema& schema, bool string_arena)
+    : id_(id), table_schema_(schema), string_arena_(string_arena) {}
 
 void DataTable::InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr) {
   DCHECK(record_batch_ptr != nullptr);
@@ -42,6 +44,13 @@ void DataTable::InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr) {
   for (const auto& element : table_schema_.elements()) {
     px::types::DataType type = element.type();
 
+    if (string_arena_ && type == DataType::STRING) {
+      auto col = std::make_shared<types::StringArenaColumnWrapper>();
+      col->Reserve(kTargetCapacity);
+      record_batch_ptr->push_back(col);
+      continue;
+    }
+
 #define TYPE_CASE(_dt_)                           \
   auto col = types::ColumnWrapper::Make(_dt_, 0); \
   col->Reserve(kTargetCapacity);                  \
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -51,7 +52,9 @@ struct Tablet {
 class DataTable : public NotCopyable {
  public:
   // Global unique ID identifies the table store to which this DataTable's data should be pushed.
-  DataTable(uint64_t id, const DataTableSchema& schema);
+  // If string_arena is true, STRING columns are buffered in types::StringArenaColumnWrapper
+  // instead of one heap-allocated StringValue per record.
+  DataTable(uint64_t id, const DataTableSchema& schema, bool string_arena = false);
   virtual ~DataTable() = default;
 
   /**
@@ -122,6 +125,27 @@ class DataTable : public NotCopyable {
 
   static constexpr char kTruncatedMsg[] = "... [TRUNCATED]";
 
+  // Appends a string value to a column, truncating it if it is larger than TMaxStringBytes.
+  // Arena-backed columns copy the (truncated) bytes straight into the arena.
+  template <const size_t TMaxStringBytes>
+  static void AppendString(types::ColumnWrapper* col, types::StringValue val) {
+    if (col->IsStringArena()) {
+      auto* arena = static_cast<types::StringArenaColumnWrapper*>(col);
+      if (val.size() > TMaxStringBytes) {
+        arena->Append(std::string_view(val).substr(0, TMaxStringBytes), kTruncatedMsg);
+      } else {
+        arena->Append(val);
+      }
+      return;
+    }
+
+    if (val.size() > TMaxStringBytes) {
+      val.resize(TMaxStringBytes);
+      val.append(kTruncatedMsg);
+    }
+    col->Append(std::move(val));
+  }
+
   // RecordBuilder is used to build records into the DataTable.
   // It is to be preferred when the schema is known at compile-time, as it is more optimized.
   // If the schema is not known at compile-time, see DynamicRecordBuilder.
@@ -158,13 +182,10 @@ class DataTable : public NotCopyable {
       if constexpr (std::is_same_v<typename types::DataTypeTraits<
                                        schema->elements()[TIndex].type()>::value_type,
                                    types::StringValue>) {
-        if (val.size() > TMaxStringBytes) {
-          val.resize(TMaxStringBytes);
-          val.append(kTruncatedMsg);
-        }
+        AppendString<TMaxStringBytes>(tablet_.records[TIndex].get(), std::move(val));
+      } else {
+        tablet_.records[TIndex]->Append(std::move(val));
       }
-
-      tablet_.records[TIndex]->Append(std::move(val));
       DCHECK(!signature_[TIndex]) << absl::Substitute(
           "Attempt to Append() to column $0 (name=$1) multiple times", TIndex,
           schema->ColName(TIndex));
@@ -223,14 +244,11 @@ class DataTable : public NotCopyable {
     template <typename TValueType, const size_t TMaxStringBytes = 1024>
     inline void Append(size_t col_index, TValueType val) {
       if constexpr (std::is_same_v<TValueType, types::StringValue>) {
-        if (val.size() > TMaxStringBytes) {
-          val.resize(TMaxStringBytes);
-          val.append(kTruncatedMsg);
-        }
+        AppendString<TMaxStringBytes>(tablet_.records[col_index].get(), std::move(val));
+      } else {
+        tablet_.records[col_index]->Append(std::move(val));
       }
 
-      tablet_.records[col_index]->Append(std::move(val));
-
       DCHECK(!signature_[col_index])
           << absl::Substitute("Attempt to Append() to column $0 (name=$1) multiple times",
                               col_index, schema_.ColName(col_index));
@@ -276,6 +294,9 @@ class DataTable : public NotCopyable {
   // Table schema: a DataElement to describe each column.
   const DataTableSchema& table_schema_;
 
+  // Whether STRING columns are arena-backed.
+  const bool string_arena_;
+
   // Key is tablet id, value is tablet records.
   absl::flat_hash_map<types::TabletID, Tablet> tablets_;
 
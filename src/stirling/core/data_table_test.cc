@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 #include <random>
 #include <string>
+#include <utility>
 
 #include "src/stirling/core/data_table.h"
 #include "src/stirling/source_connectors/seq_gen/sequence_generator.h"
@@ -26,7 +27,8 @@
 namespace px {
 namespace stirling {
 
-class DataTableTest : public ::testing::Test {
+// The test parameter selects whether STRING columns are arena-backed.
+class DataTableTest : public ::testing::TestWithParam<bool> {
  protected:
   // The test uses a pre-defined schema.
   static constexpr DataElement kElements[] = {
@@ -40,12 +42,13 @@ class DataTableTest : public ::testing::Test {
   static constexpr auto kSchema =
       DataTableSchema("test_table", "This is the table description", kElements);
 
-  DataTableTest() : data_table_(std::make_unique<DataTable>(/*id*/ 0, kSchema)) {}
+  DataTableTest()
+      : data_table_(std::make_unique<DataTable>(/*id*/ 0, kSchema, /*string_arena*/ GetParam())) {}
 
   std::unique_ptr<DataTable> data_table_;
 };
 
-TEST_F(DataTableTest, ResultIsSorted) {
+TEST_P(DataTableTest, ResultIsSorted) {
   std::vector<int> time_vals = {0, 10, 40, 20, 30, 50, 90, 70, 60, 80};
   std::vector<int> x_vals = {0, 1, 4, 2, 3, 5, 9, 7, 6, 8};
   std::vector<std::string> s_vals = {"a", "b", "e", "c", "d", "f", "j", "h", "g", "i"};
@@ -65,14 +68,14 @@ TEST_F(DataTableTest, ResultIsSorted) {
   for (size_t i = 0; i < time_vals.size(); ++i) {
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(i), 10 * static_cast<int>(i));
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(i), static_cast<int>(i));
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(i), std::string(1, 'a' + i));
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(i), std::string(1, 'a' + i));
   }
 }
 
 // No time passed to RecordBuilder, so all timestamps should be zero.
 // That means there should never be any expired or carry-over records.
 // Also, nothing should be sorted in any way.
-TEST_F(DataTableTest, FixedTimeMode) {
+TEST_P(DataTableTest, FixedTimeMode) {
   std::vector<int> time_vals = {0, 10, 40, 20, 30, 50, 90, 70, 60, 80};
   std::vector<int> x_vals = {0, 1, 4, 2, 3, 5, 9, 7, 6, 8};
   std::vector<std::string> s_vals = {"a", "b", "e", "c", "d", "f", "j", "h", "g", "i"};
@@ -92,11 +95,11 @@ TEST_F(DataTableTest, FixedTimeMode) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), time_vals[i]);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), x_vals[i]);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), s_vals[i]);
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), s_vals[i]);
   }
 }
 
-TEST_F(DataTableTest, FixedTimeModeV2) {
+TEST_P(DataTableTest, FixedTimeModeV2) {
   std::vector<int> time_vals = {0, 10, 40, 20, 30, 50, 90, 70, 60, 80};
   std::vector<int> x_vals = {0, 1, 4, 2, 3, 5, 9, 7, 6, 8};
   std::vector<std::string> s_vals = {"a", "b", "e", "c", "d", "f", "j", "h", "g", "i"};
@@ -118,11 +121,11 @@ TEST_F(DataTableTest, FixedTimeModeV2) {
   for (size_t i = 0; i < time_vals.size(); ++i) {
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(i), time_vals[i]);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(i), x_vals[i]);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(i), s_vals[i]);
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(i), s_vals[i]);
   }
 }
 
-TEST_F(DataTableTest, Expiry) {
+TEST_P(DataTableTest, Expiry) {
   std::vector<int> time_vals = {0, 10, 40, 20, 30, 50, 90, 70, 60, 80};
   std::vector<int> x_vals = {0, 1, 4, 2, 3, 5, 9, 7, 6, 8};
   std::vector<std::string> s_vals = {"a", "b", "e", "c", "d", "f", "j", "h", "g", "i"};
@@ -145,19 +148,19 @@ TEST_F(DataTableTest, Expiry) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 0);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), 0);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "a");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), "a");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(1), 10);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 1);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "b");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "b");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(2), 20);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(2), 2);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(2), "c");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(2), "c");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(3), 40);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(3), 4);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(3), "e");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(3), "e");
   }
 
   // Process the next three entries. Time 30 should be expired.
@@ -179,11 +182,11 @@ TEST_F(DataTableTest, Expiry) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 50);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), 5);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "f");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), "f");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(1), 90);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 9);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "j");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "j");
   }
 
   // Process the next three entries. Time 30 should be expired.
@@ -203,7 +206,7 @@ TEST_F(DataTableTest, Expiry) {
 
 // This test has scrambled entries, but ConsumeRecords is called with end times
 // that should cause carryover. This test also causes no expirations for simplicity.
-TEST_F(DataTableTest, Carryover) {
+TEST_P(DataTableTest, Carryover) {
   std::vector<int> time_vals = {0, 10, 40, 20, 30, 50, 90, 70, 60, 80};
   std::vector<int> x_vals = {0, 1, 4, 2, 3, 5, 9, 7, 6, 8};
   std::vector<std::string> s_vals = {"a", "b", "e", "c", "d", "f", "j", "h", "g", "i"};
@@ -227,15 +230,15 @@ TEST_F(DataTableTest, Carryover) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 0);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), 0);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "a");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), "a");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(1), 10);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 1);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "b");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "b");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(2), 20);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(2), 2);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(2), "c");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(2), "c");
   }
 
   // Process the next three entries. Time 30 should be expired.
@@ -258,11 +261,11 @@ TEST_F(DataTableTest, Carryover) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 30);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), 3);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "d");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), "d");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(1), 40);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 4);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "e");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "e");
   }
 
   // Process the next three entries. Time 30 should be expired.
@@ -284,15 +287,15 @@ TEST_F(DataTableTest, Carryover) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 50);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), 5);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "f");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), "f");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(1), 60);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 6);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "g");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "g");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(2), 70);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(2), 7);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(2), "h");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(2), "h");
   }
 
   {
@@ -306,14 +309,42 @@ TEST_F(DataTableTest, Carryover) {
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 80);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(0), 8);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "i");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0), "i");
 
     EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(1), 90);
     EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 9);
-    EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "j");
+    EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "j");
   }
 }
 
+TEST_P(DataTableTest, StringTruncation) {
+  const std::string long_str(2000, 'x');
+
+  {
+    DataTable::RecordBuilder<&kSchema> r(data_table_.get(), 0);
+    r.Append<r.ColIndex("time_")>(0);
+    r.Append<r.ColIndex("x")>(0);
+    r.Append<r.ColIndex("s"), /*TMaxStringBytes*/ 8>(long_str);
+  }
+  {
+    DataTable::DynamicRecordBuilder r(data_table_.get(), 1);
+    r.Append(0, types::Time64NSValue(1));
+    r.Append(1, types::Int64Value(1));
+    r.Append<types::StringValue, /*TMaxStringBytes*/ 8>(2, "short");
+  }
+
+  std::vector<TaggedRecordBatch> tablets = data_table_->ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  types::ColumnWrapperRecordBatch& rb = tablets[0].records;
+  ASSERT_EQ(rb[2]->Size(), 2);
+  EXPECT_EQ(rb[2]->IsStringArena(), GetParam());
+  EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(0),
+            absl::StrCat(long_str.substr(0, 8), DataTable::kTruncatedMsg));
+  EXPECT_EQ(std::as_const(*rb[2]).Get<types::StringValue>(1), "short");
+}
+
+INSTANTIATE_TEST_SUITE_P(StringArena, DataTableTest, ::testing::Bool());
+
 class DataTableStressTest : public ::testing::Test {
  private:
   std::default_random_engine rng_;
@@ -24,6 +24,11 @@
 #include "src/stirling/core/info_class_manager.h"
 #include "src/stirling/core/source_connector.h"
 
+DEFINE_bool(stirling_string_arena_columns, true,
+            "If true, buffer STRING columns of Stirling tables in contiguous arenas that are "
+            "handed to the table store without copying. The columns are read-only; consumers "
+            "of the pushed record batches must read them through a const ColumnWrapper.");
+
 namespace px {
 namespace stirling {
 
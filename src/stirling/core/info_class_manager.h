@@ -33,6 +33,8 @@
 #include "src/stirling/core/types.h"
 #include "src/stirling/proto/stirling.pb.h"
 
+DECLARE_bool(stirling_string_arena_columns);
+
 namespace px {
 namespace stirling {
 
@@ -64,7 +66,9 @@ class InfoClassManager final : public NotCopyable {
    * the publish proto.
    */
   explicit InfoClassManager(const DataTableSchema& schema)
-      : id_(global_id_++), schema_(schema), data_table_(new DataTable(id_, schema_)) {}
+      : id_(global_id_++),
+        schema_(schema),
+        data_table_(new DataTable(id_, schema_, FLAGS_stirling_string_arena_columns)) {}
 
   /**
    * @brief Source connector connected to this Info Class.
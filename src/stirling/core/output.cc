@@ -79,7 +79,8 @@ std::string ToString(const stirlingpb::TableSchema& schema,
         absl::StrAppend(&out, val);
       } break;
       case DataType::STRING: {
-        const auto& val = col->Get<StringValue>(index);
+        // Read through a const column, so arena-backed columns are not materialized.
+        const auto val = std::as_const(*col).Get<StringValue>(index);
         absl::StrAppend(&out, val);
       } break;
       case DataType::UINT128: {
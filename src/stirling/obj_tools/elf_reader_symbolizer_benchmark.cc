@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <absl/container/btree_map.h>
+
+#include "src/common/base/base.h"
+#include "src/common/fs/fs_wrapper.h"
+#include "src/common/testing/test_environment.h"
+#include "src/stirling/obj_tools/elf_tools.h"
+
+using px::stirling::obj_tools::ElfReader;
+using px::stirling::obj_tools::SymbolMatchType;
+using px::testing::BazelBinTestFilePath;
+
+// NOTE: This benchmark only works with `-c opt`, but that's how we want it to run anyways.
+constexpr std::string_view kGoBinary =
+    "src/stirling/testing/demo_apps/go_grpc_tls_pl/server/linux_amd64/server";
+
+// Returns the binaries to benchmark: a Go binary, and this benchmark itself, which links LLVM
+// and therefore has a large number of C++ symbols.
+std::string BinaryPath(int64_t index) {
+  if (index == 0) {
+    return BazelBinTestFilePath(kGoBinary).string();
+  }
+  return px::fs::ReadSymlink("/proc/self/exe").ConsumeValueOrDie().string();
+}
+
+// Returns random addresses that fall inside the function symbols of the binary.
+std::vector<uintptr_t> SampleAddrs(ElfReader* elf_reader, size_t num_addrs) {
+  std::vector<ElfReader::SymbolInfo> symbols =
+      elf_reader->ListFuncSymbols("", SymbolMatchType::kSubstr).ConsumeValueOrDie();
+  CHECK(!symbols.empty());
+
+  std::mt19937_64 rng(37);
+  std::uniform_int_distribution<size_t> symbol_dist(0, symbols.size() - 1);
+  std::vector<uintptr_t> addrs;
+  addrs.reserve(num_addrs);
+  for (size_t i = 0; i < num_addrs; ++i) {
+    const ElfReader::SymbolInfo& symbol = symbols[symbol_dist(rng)];
+    addrs.push_back(symbol.address + (symbol.size > 0 ? rng() % symbol.size : 0));
+  }
+  return addrs;
+}
+
+constexpr size_t kNumAddrs = 4096;
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_GetSymbolizer(benchmark::State& state) {
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<ElfReader> elf_reader,
+                    ElfReader::Create(BinaryPath(state.range(0))));
+
+  size_t num_symbols = 0;
+  for (auto _ : state) {
+    PL_ASSIGN_OR_EXIT(std::unique_ptr<ElfReader::Symbolizer> symbolizer,
+                      elf_reader->GetSymbolizer());
+    num_symbols = symbolizer->NumSymbols();
+    benchmark::DoNotOptimize(symbolizer);
+  }
+  state.counters["symbols"] = num_symbols;
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_Lookup(benchmark::State& state) {
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<ElfReader> elf_reader,
+                    ElfReader::Create(BinaryPath(state.range(0))));
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<ElfReader::Symbolizer> symbolizer,
+                    elf_reader->GetSymbolizer());
+  const std::vector<uintptr_t> addrs = SampleAddrs(elf_reader.get(), kNumAddrs);
+
+  for (auto _ : state) {
+    for (const uintptr_t addr : addrs) {
+      benchmark::DoNotOptimize(symbolizer->Lookup(addr));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+
+// The previous btree_map based index, kept as a baseline for BM_Lookup.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_LookupBTreeBaseline(benchmark::State& state) {
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<ElfReader> elf_reader,
+                    ElfReader::Create(BinaryPath(state.range(0))));
+  const std::vector<uintptr_t> addrs = SampleAddrs(elf_reader.get(), kNumAddrs);
+
+  struct SymbolAddrInfo {
+    size_t size;
+    std::string name;
+  };
+  absl::btree_map<uintptr_t, SymbolAddrInfo> symbols;
+  for (auto& symbol :
+       elf_reader->ListFuncSymbols("", SymbolMatchType::kSubstr).ConsumeValueOrDie()) {
+    symbols.emplace(symbol.address, SymbolAddrInfo{symbol.size, std::move(symbol.name)});
+  }
+
+  for (auto _ : state) {
+    for (const uintptr_t addr : addrs) {
+      auto iter = symbols.upper_bound(addr);
+      std::string_view name;
+      if (iter != symbols.begin()) {
+        --iter;
+        if (addr < iter->first + iter->second.size) {
+          name = iter->second.name;
+        }
+      }
+      benchmark::DoNotOptimize(name);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * addrs.size());
+}
+
+BENCHMARK(BM_GetSymbolizer)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Lookup)->DenseRange(0, 1);
+BENCHMARK(BM_LookupBTreeBaseline)->DenseRange(0, 1);
@@ -24,6 +24,8 @@
 #include <llvm/Support/TargetSelect.h>
 
 #include <absl/container/flat_hash_set.h>
+#include <algorithm>
+#include <limits>
 #include <set>
 #include <utility>
 
@@ -47,7 +49,6 @@ struct LowercaseHex {
 }  // namespace
 
 Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir) {
-  std::string build_id;
   std::string debug_link;
   bool found_symtab = false;
 
@@ -80,8 +81,8 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
       int32_t desc_pos = 3 * sizeof(int32_t) + name_size;
       std::string_view desc = std::string_view(psec->get_data() + desc_pos, desc_size);
 
-      build_id = BytesToString<LowercaseHex>(desc);
-      VLOG(1) << absl::Substitute("Found build-id: $0", build_id);
+      build_id_ = BytesToString<LowercaseHex>(desc);
+      VLOG(1) << absl::Substitute("Found build-id: $0", build_id_);
     }
 
     // Method 2: .gnu_debuglink.
@@ -109,10 +110,10 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
   }
 
   // Try using build-id first.
-  if (!build_id.empty()) {
+  if (!build_id_.empty()) {
     std::filesystem::path symbols_file;
     std::string loc =
-        absl::Substitute(".build-id/$0/$1.debug", build_id.substr(0, 2), build_id.substr(2));
+        absl::Substitute(".build-id/$0/$1.debug", build_id_.substr(0, 2), build_id_.substr(2));
     symbols_file = debug_file_dir / loc;
     VLOG(1) << absl::Substitute("Checking for debug symbols at $0", symbols_file.string());
     if (fs::Exists(symbols_file).ok()) {
@@ -367,34 +368,83 @@ StatusOr<std::unique_ptr<ElfReader::Symbolizer>> ElfReader::GetSymbolizer() {
       symbolizer->AddEntry(addr, size, llvm::demangle(name));
     }
   }
+  symbolizer->Finalize();
 
   return symbolizer;
 }
 
-void ElfReader::Symbolizer::AddEntry(size_t addr, size_t size, std::string name) {
-  symbols_.emplace(addr, SymbolAddrInfo{size, std::move(name)});
+void ElfReader::Symbolizer::AddEntry(uintptr_t addr, size_t size, std::string_view name) {
+  DCHECK(!finalized_);
+  staged_entries_.push_back(StagedEntry{addr, size, static_cast<uint32_t>(names_.size()),
+                                        static_cast<uint32_t>(name.size())});
+  names_.append(name);
 }
 
-std::string_view ElfReader::Symbolizer::Lookup(size_t addr) const {
+void ElfReader::Symbolizer::Finalize() {
+  DCHECK(!finalized_);
+  finalized_ = true;
+
+  // Stable, so that the first entry added for an address wins, as documented in AddEntry().
+  std::stable_sort(staged_entries_.begin(), staged_entries_.end(),
+                   [](const StagedEntry& a, const StagedEntry& b) { return a.addr < b.addr; });
+
+  std::string staged_names = std::move(names_);
+  names_.clear();
+  names_.reserve(staged_names.size());
+  addrs_.reserve(staged_entries_.size());
+  sizes_.reserve(staged_entries_.size());
+  name_offsets_.reserve(staged_entries_.size() + 1);
+
+  for (const StagedEntry& entry : staged_entries_) {
+    if (!addrs_.empty() && addrs_.back() == entry.addr) {
+      continue;
+    }
+    addrs_.push_back(entry.addr);
+    // Function sizes fit in 32 bits; clamp rather than wrap just in case.
+    sizes_.push_back(static_cast<uint32_t>(
+        std::min<size_t>(entry.size, std::numeric_limits<uint32_t>::max())));
+    name_offsets_.push_back(static_cast<uint32_t>(names_.size()));
+    names_.append(staged_names, entry.name_pos, entry.name_len);
+  }
+  name_offsets_.push_back(static_cast<uint32_t>(names_.size()));
+
+  // Release the staging memory.
+  std::vector<StagedEntry>().swap(staged_entries_);
+  addrs_.shrink_to_fit();
+  sizes_.shrink_to_fit();
+  name_offsets_.shrink_to_fit();
+  names_.shrink_to_fit();
+}
+
+std::string_view ElfReader::Symbolizer::Lookup(uintptr_t runtime_addr, uintptr_t load_bias) const {
+  DCHECK(finalized_);
   static std::string symbol_str;
 
-  // Find the first symbol for which the address_range_start > addr.
-  auto iter = symbols_.upper_bound(addr);
+  const uintptr_t addr = runtime_addr - load_bias;
 
-  if (iter == symbols_.begin() || symbols_.empty()) {
-    symbol_str = absl::StrFormat("0x%016llx", addr);
+  if (addrs_.empty() || addr < addrs_.front()) {
+    symbol_str = absl::StrFormat("0x%016llx", runtime_addr);
     return symbol_str;
   }
 
-  // std::upper_bound will make us overshoot our potential match,
-  // so go back by one, and check if it is indeed a match.
-  --iter;
-  if (addr >= iter->first && addr < iter->first + iter->second.size) {
-    return iter->second.name;
+  // Branchless binary search for the last symbol that starts at or before addr.
+  // Invariant: base[0] <= addr, and the answer is within [base, base + n).
+  const uintptr_t* base = addrs_.data();
+  size_t n = addrs_.size();
+  while (n > 1) {
+    const size_t half = n / 2;
+    base = (base[half] <= addr) ? base + half : base;
+    n -= half;
+  }
+  const size_t idx = base - addrs_.data();
+
+  if (addr < addrs_[idx] + sizes_[idx]) {
+    const uint32_t pos = name_offsets_[idx];
+    return std::string_view(names_).substr(pos, name_offsets_[idx + 1] - pos);
   }
 
   // Couldn't find the address.
-  symbol_str = absl::StrFormat("0x%016llx", addr);
+  symbol_str = absl::StrFormat("0x%016llx", runtime_addr);
   return symbol_str;
 }
 
@@ -21,9 +21,9 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include <absl/container/btree_map.h>
 #include <absl/container/flat_hash_map.h>
 
 #include <elfio/elfio.hpp>
@@ -63,6 +63,18 @@ class ElfReader {
 
   std::filesystem::path& debug_symbols_path() { return debug_symbols_path_; }
 
+  /**
+   * Returns the build-id of the binary as a lowercase hex string,
+   * or an empty string if the binary has no build-id note.
+   */
+  const std::string& build_id() const { return build_id_; }
+
+  /**
+   * Returns the ELF object type (e.g. ELFIO::ET_EXEC, or ELFIO::ET_DYN for position independent
+   * executables and shared libraries).
+   */
+  ELFIO::Elf_Half ELFType() const { return elf_reader_.get_type(); }
+
   struct SymbolInfo {
     std::string name;
     int type = -1;
@@ -119,27 +131,60 @@ class ElfReader {
    */
   StatusOr<std::optional<std::string>> InstrAddrToSymbol(size_t addr);
 
+  /**
+   * An immutable address-to-symbol index. Entries are staged with AddEntry() and indexed by
+   * Finalize(), after which the symbolizer is read-only. Addresses and sizes are kept in
+   * parallel sorted arrays and all names share one string pool, which keeps the index compact
+   * for binaries with hundreds of thousands of symbols.
+   */
   class Symbolizer {
    public:
     /**
      * Associate the address range [addr, addr+size] with the provided symbol name.
      * No checking is performed for overlapping regions, which will result in undefined behavior.
+     * If several entries share an address, the first one added is kept.
      */
-    void AddEntry(uintptr_t addr, size_t size, std::string name);
+    void AddEntry(uintptr_t addr, size_t size, std::string_view name);
+
+    /**
+     * Builds the index from the staged entries. Must be called once, before any Lookup().
+     */
+    void Finalize();
 
     /**
      * Lookup the symbol for the specified address.
+     *
+     * @param addr The address to symbolize.
+     * @param load_bias Subtracted from addr before the lookup, to translate a runtime address
+     *                  of a relocated binary into the address space of its symbol table.
+     * @return The symbol, or addr formatted as hex if no symbol contains it.
+     */
+    std::string_view Lookup(uintptr_t addr, uintptr_t load_bias = 0) const;
+
+    /**
+     * Returns the number of indexed symbols.
      */
-    std::string_view Lookup(uintptr_t addr) const;
+    size_t NumSymbols() const { return addrs_.size(); }
 
    private:
-    struct SymbolAddrInfo {
+    struct StagedEntry {
+      uintptr_t addr;
       size_t size;
-      std::string name;
+      uint32_t name_pos;
+      uint32_t name_len;
     };
 
-    // Key is an address.
-    absl::btree_map<uintptr_t, SymbolAddrInfo> symbols_;
+    // Entries added before Finalize(); names are held in names_.
+    std::vector<StagedEntry> staged_entries_;
+    bool finalized_ = false;
+
+    // Sorted symbol start addresses, and the sizes of the corresponding symbols.
+    std::vector<uintptr_t> addrs_;
+    std::vector<uint32_t> sizes_;
+
+    // The name of symbol i is names_[name_offsets_[i], name_offsets_[i+1]).
+    std::vector<uint32_t> name_offsets_;
+    std::string names_;
   };
 
   StatusOr<std::unique_ptr<Symbolizer>> GetSymbolizer();
@@ -172,6 +217,8 @@ class ElfReader {
 
   std::filesystem::path debug_symbols_path_;
 
+  std::string build_id_;
+
   // Set up an elf reader, so we can extract debug symbols.
   ELFIO::elfio elf_reader_;
 };
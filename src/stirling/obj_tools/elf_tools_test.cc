@@ -180,6 +180,36 @@ TEST(ElfReaderTest, InstrAddrToSymbol) {
   }
 }
 
+TEST(ElfReaderTest, SymbolizerLookup) {
+  ElfReader::Symbolizer symbolizer;
+  symbolizer.AddEntry(0x3000, 0x10, "baz");
+  symbolizer.AddEntry(0x1000, 0x100, "foo");
+  symbolizer.AddEntry(0x2000, 0x20, "bar");
+  // Duplicate address: the first entry is kept.
+  symbolizer.AddEntry(0x1000, 0x100, "foo_alias");
+  symbolizer.Finalize();
+
+  EXPECT_EQ(symbolizer.NumSymbols(), 3);
+  EXPECT_EQ(symbolizer.Lookup(0x1000), "foo");
+  EXPECT_EQ(symbolizer.Lookup(0x10ff), "foo");
+  EXPECT_EQ(symbolizer.Lookup(0x2010), "bar");
+  EXPECT_EQ(symbolizer.Lookup(0x300f), "baz");
+  EXPECT_EQ(symbolizer.Lookup(0x5010, /* load_bias */ 0x3000), "bar");
+
+  // Before the first symbol, in a gap between symbols, and past the last symbol.
+  EXPECT_EQ(symbolizer.Lookup(0x0fff), "0x0000000000000fff");
+  EXPECT_EQ(symbolizer.Lookup(0x1100), "0x0000000000001100");
+  EXPECT_EQ(symbolizer.Lookup(0x3010), "0x0000000000003010");
+  EXPECT_EQ(symbolizer.Lookup(0x3100, /* load_bias */ 0x3000), "0x0000000000003100");
+}
+
+TEST(ElfReaderTest, SymbolizerEmpty) {
+  ElfReader::Symbolizer symbolizer;
+  symbolizer.Finalize();
+  EXPECT_EQ(symbolizer.NumSymbols(), 0);
+  EXPECT_EQ(symbolizer.Lookup(0x1000), "0x0000000000001000");
+}
+
 TEST(ElfReaderTest, ExternalDebugSymbolsBuildID) {
   const std::string stripped_bin =
       px::testing::TestFilePath("src/stirling/obj_tools/testdata/stripped_dummy_exe");
@@ -369,8 +369,8 @@ TEST_F(DynamicTraceGolangTest, TraceString) {
                               FindFieldIndex(info_class_.schema(), "something"));
 
   types::ColumnWrapperRecordBatch& rb = *record_batches_[0];
-  EXPECT_EQ(rb[something_field_idx]->Get<types::StringValue>(0), "Hello");
-  EXPECT_EQ(rb[name_field_idx]->Get<types::StringValue>(0), "pixienaut");
+  EXPECT_EQ(std::as_const(*rb[something_field_idx]).Get<types::StringValue>(0), "Hello");
+  EXPECT_EQ(std::as_const(*rb[name_field_idx]).Get<types::StringValue>(0), "pixienaut");
 }
 
 TEST_F(DynamicTraceGolangTest, TraceLongString) {
@@ -414,7 +414,8 @@ TEST_F(DynamicTraceGolangTest, TraceLongString) {
   ASSERT_HAS_VALUE_AND_ASSIGN(int value_field_idx, FindFieldIndex(info_class_.schema(), "value"));
 
   types::ColumnWrapperRecordBatch& rb = *record_batches_[0];
-  EXPECT_EQ(rb[value_field_idx]->Get<types::StringValue>(0), "This is a loooooooooooo<truncated>");
+  EXPECT_EQ(std::as_const(*rb[value_field_idx]).Get<types::StringValue>(0),
+            "This is a loooooooooooo<truncated>");
 }
 
 // Tests tracing StructBlob variables.
@@ -472,9 +473,9 @@ TEST_F(DynamicTraceGolangTest, TraceStructBlob) {
 
   types::ColumnWrapperRecordBatch& rb = *record_batches_[0];
   EXPECT_EQ(
-      rb[struct_blob_field_idx]->Get<types::StringValue>(0),
+      std::as_const(*rb[struct_blob_field_idx]).Get<types::StringValue>(0),
       R"({"O0":1,"O1":{"M0":{"L0":true,"L1":2,"L2":0},"M1":false,"M2":{"L0":true,"L1":3,"L2":0}}})");
-  EXPECT_EQ(rb[ret_field_idx]->Get<types::StringValue>(0), R"({"X":3,"Y":4})");
+  EXPECT_EQ(std::as_const(*rb[ret_field_idx]).Get<types::StringValue>(0), R"({"X":3,"Y":4})");
 }
 
 struct ReturnedErrorInterfaceTestCase {
@@ -507,7 +508,8 @@ TEST_P(ReturnedErrorInterfaceTest, TraceError) {
   EXPECT_THAT(record_batches_, SizeIs(1));
   const auto& rb = *record_batches_[0];
   for (size_t i = 0; i < rb[err_field_idx]->Size(); ++i) {
-    EXPECT_THAT(std::string(rb[err_field_idx]->Get<types::StringValue>(i)), StrEq(expected_output));
+    EXPECT_THAT(std::string(std::as_const(*rb[err_field_idx]).Get<types::StringValue>(i)),
+                StrEq(expected_output));
   }
 }
 
@@ -611,8 +613,9 @@ TEST_P(DynamicTraceGolangTestWithParam, TraceByteArray) {
   ASSERT_HAS_VALUE_AND_ASSIGN(int name_field_idx, FindFieldIndex(info_class_.schema(), "name"));
 
   types::ColumnWrapperRecordBatch& rb = *record_batches_[0];
-  EXPECT_EQ(rb[uuid_field_idx]->Get<types::StringValue>(0), "000102030405060708090A0B0C0D0E0F");
-  EXPECT_EQ(rb[name_field_idx]->Get<types::StringValue>(0), params.value);
+  EXPECT_EQ(std::as_const(*rb[uuid_field_idx]).Get<types::StringValue>(0),
+            "000102030405060708090A0B0C0D0E0F");
+  EXPECT_EQ(std::as_const(*rb[name_field_idx]).Get<types::StringValue>(0), params.value);
 }
 
 INSTANTIATE_TEST_SUITE_P(GolangByteArrayTests, DynamicTraceGolangTestWithParam,
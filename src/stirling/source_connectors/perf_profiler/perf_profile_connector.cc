@@ -32,6 +32,13 @@ BPF_SRC_STRVIEW(profiler_bcc_script, profiler);
 DEFINE_string(stirling_profiler_symbolizer, "bcc",
               "Choice of which symbolizer to use. Options: bcc, elf");
 DEFINE_bool(stirling_profiler_cache_symbols, true, "Whether to cache symbols");
+DEFINE_bool(stirling_profiler_intern_stack_frames, false,
+            "If true, stack traces are recorded as lists of frame IDs in the frame_ids column, "
+            "and the frames are recorded once in the stack_frames.beta table, instead of "
+            "recording the folded stack trace string of every stack trace.");
+DEFINE_uint32(stirling_profiler_stack_trace_str_cache_size, 4096,
+              "Number of folded stack trace strings kept across profiler iterations, per "
+              "generation. Set to 0 to disable the cache.");
 
 DEFINE_uint32(stirling_perf_profiler_stats_logging_ratio,
               std::chrono::minutes(10) / px::stirling::PerfProfileConnector::kSamplingPeriod,
@@ -41,7 +48,8 @@ namespace px {
 namespace stirling {
 
 PerfProfileConnector::PerfProfileConnector(std::string_view source_name)
-    : SourceConnector(source_name, kTables) {}
+    : SourceConnector(source_name, kTables),
+      stack_trace_strs_(FLAGS_stirling_profiler_stack_trace_str_cache_size) {}
 
 Status PerfProfileConnector::InitImpl() {
   sampling_freq_mgr_.set_period(kSamplingPeriod);
@@ -150,7 +158,11 @@ PerfProfileConnector::StackTraceHisto PerfProfileConnector::AggregateStackTraces
   const absl::flat_hash_set<md::UPID>& upids_for_symbolization = ctx->GetUPIDs();
 
   // Create a new stringifier for this iteration of the continuous perf profiler.
-  Stringifier stringifier(u_symbolizer_.get(), k_symbolizer_.get(), stack_traces);
+  // Recurring stack traces are served from stack_trace_strs_, which outlives the stringifier.
+  StackTraceStringCache* stack_trace_strs =
+      FLAGS_stirling_profiler_stack_trace_str_cache_size > 0 ? &stack_trace_strs_ : nullptr;
+  Stringifier stringifier(u_symbolizer_.get(), k_symbolizer_.get(), stack_traces,
+                          stack_trace_strs);
 
   absl::flat_hash_set<int> k_stack_ids_to_remove;
 
@@ -213,7 +225,7 @@ PerfProfileConnector::StackTraceHisto PerfProfileConnector::AggregateStackTraces
 }
 
 void PerfProfileConnector::CreateRecords(ebpf::BPFStackTable* stack_traces, ConnectorContext* ctx,
-                                         DataTable* data_table) {
+                                         DataTable* data_table, DataTable* frames_table) {
   constexpr size_t kMaxSymbolSize = 512;
   constexpr size_t kMaxStackDepth = 64;
   constexpr size_t kMaxStackTraceSize = kMaxStackDepth * kMaxSymbolSize;
@@ -231,20 +243,39 @@ void PerfProfileConnector::CreateRecords(ebpf::BPFStackTable* stack_traces, Conn
   constexpr auto age_tick_period = std::chrono::minutes(5);
   if (sampling_freq_mgr_.count() % (age_tick_period / kSamplingPeriod) == 0) {
     stack_trace_ids_.AgeTick();
+    stack_trace_strs_.AgeTick();
+    stack_frames_.AgeTick();
   }
 
+  std::vector<StackFrameInterner::Frame> new_frames;
+
   for (const auto& [key, count] : stack_trace_histogram) {
     DataTable::RecordBuilder<&kStackTraceTable> r(data_table, timestamp_ns);
 
     r.Append<r.ColIndex("time_")>(timestamp_ns);
     r.Append<r.ColIndex("upid")>(key.upid.value());
     r.Append<r.ColIndex("stack_trace_id")>(stack_trace_ids_.Lookup(key));
-    r.Append<r.ColIndex("stack_trace"), kMaxStackTraceSize>(key.stack_trace_str);
+    if (frames_table != nullptr) {
+      r.Append<r.ColIndex("stack_trace")>("");
+      r.Append<r.ColIndex("frame_ids"), kMaxStackTraceSize>(
+          stack_frames_.Intern(key.stack_trace_str, &new_frames));
+    } else {
+      r.Append<r.ColIndex("stack_trace"), kMaxStackTraceSize>(key.stack_trace_str);
+      r.Append<r.ColIndex("frame_ids")>("");
+    }
     r.Append<r.ColIndex("count")>(count);
   }
+
+  for (const auto& frame : new_frames) {
+    DataTable::RecordBuilder<&kStackFramesTable> r(frames_table, timestamp_ns);
+    r.Append<r.ColIndex("time_")>(timestamp_ns);
+    r.Append<r.ColIndex("frame_id")>(frame.id);
+    r.Append<r.ColIndex("frame"), kMaxSymbolSize>(std::string(frame.symbol));
+  }
 }
 
-void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table) {
+void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table,
+                                                 DataTable* frames_table) {
   // Choose the maps to consume.
   const bool using_map_set_a = transfer_count_ % 2 == 0;
   auto& stack_traces = using_map_set_a ? stack_traces_a_ : stack_traces_b_;
@@ -263,7 +294,7 @@ void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTabl
   LOG_IF(ERROR, !s.ok()) << "Error writing transfer_count_";
 
   // Read BPF stack traces & histogram, build records, incorporate records to data table.
-  CreateRecords(stack_traces.get(), ctx, data_table);
+  CreateRecords(stack_traces.get(), ctx, data_table, frames_table);
 
   // Now that we've consumed the data, reset the sample count in BPF.
   profiler_state_->update_value(sample_count_idx, 0);
@@ -271,15 +302,19 @@ void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTabl
 
 void PerfProfileConnector::TransferDataImpl(ConnectorContext* ctx,
                                             const std::vector<DataTable*>& data_tables) {
-  DCHECK_EQ(data_tables.size(), 1);
+  DCHECK_EQ(data_tables.size(), kTables.size());
 
-  auto* data_table = data_tables[0];
+  auto* data_table = data_tables[kPerfProfileTableNum];
 
   if (data_table == nullptr) {
     return;
   }
 
-  ProcessBPFStackTraces(ctx, data_table);
+  // Stack frames can only be interned if the frame dictionary is also being collected.
+  DataTable* frames_table =
+      FLAGS_stirling_profiler_intern_stack_frames ? data_tables[kStackFramesTableNum] : nullptr;
+
+  ProcessBPFStackTraces(ctx, data_table, frames_table);
 
   // Cleanup the symbolizer so we don't leak memory.
   proc_tracker_.Update(ctx->GetUPIDs());
@@ -289,6 +324,9 @@ void PerfProfileConnector::TransferDataImpl(ConnectorContext* ctx,
 
   if (sampling_freq_mgr_.count() % FLAGS_stirling_perf_profiler_stats_logging_ratio == 0) {
     VLOG(1) << "PerfProfileConnector statistics: " << stats_.Print();
+    VLOG(1) << absl::Substitute(
+        "PerfProfileConnector stack trace string cache: entries=$0 accesses=$1 hits=$2",
+        stack_trace_strs_.size(), stack_trace_strs_.stat_accesses(), stack_trace_strs_.stat_hits());
   }
 }
 
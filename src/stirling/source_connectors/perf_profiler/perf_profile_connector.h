@@ -29,7 +29,9 @@
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/core/types.h"
 #include "src/stirling/source_connectors/perf_profiler/bcc_bpf_intf/stack_event.h"
+#include "src/stirling/source_connectors/perf_profiler/stack_frame_interner.h"
 #include "src/stirling/source_connectors/perf_profiler/stack_trace_id_cache.h"
+#include "src/stirling/source_connectors/perf_profiler/stack_trace_string_cache.h"
 #include "src/stirling/source_connectors/perf_profiler/stack_traces_table.h"
 #include "src/stirling/source_connectors/perf_profiler/stringifier.h"
 #include "src/stirling/source_connectors/perf_profiler/symbolizer.h"
@@ -46,8 +48,9 @@ static constexpr std::string_view kNotSymbolizedMessage = "<not symbolized>";
 class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrapper {
  public:
   static constexpr std::string_view kName = "perf_profiler";
-  static constexpr auto kTables = MakeArray(kStackTraceTable);
+  static constexpr auto kTables = MakeArray(kStackTraceTable, kStackFramesTable);
   static constexpr uint32_t kPerfProfileTableNum = TableNum(kTables, kStackTraceTable);
+  static constexpr uint32_t kStackFramesTableNum = TableNum(kTables, kStackFramesTable);
 
   // kBPFSamplingPeriod: the time interval in between stack trace samples.
   static constexpr auto kBPFSamplingPeriod = std::chrono::milliseconds{11};
@@ -75,11 +78,14 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   explicit PerfProfileConnector(std::string_view source_name);
 
-  void ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table);
+  void ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table,
+                             DataTable* frames_table);
 
   // Read BPF data structures, build & incorporate records to the table.
+  // If frames_table is not null, stack frames are interned: stack traces are recorded as
+  // lists of frame IDs, and new frames are recorded in frames_table.
   void CreateRecords(ebpf::BPFStackTable* stack_traces, ConnectorContext* ctx,
-                     DataTable* data_table);
+                     DataTable* data_table, DataTable* frames_table);
 
   StackTraceHisto AggregateStackTraces(ConnectorContext* ctx, ebpf::BPFStackTable* stack_traces);
 
@@ -97,6 +103,13 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // Tracks unique stack trace ids, for the lifetime of Stirling:
   StackTraceIDCache stack_trace_ids_;
 
+  // Folded stack trace strings of recently seen stack traces, kept across iterations so that
+  // recurring stack traces are not symbolized again.
+  StackTraceStringCache stack_trace_strs_;
+
+  // Assigns IDs to stack frames, when stack frames are interned.
+  StackFrameInterner stack_frames_;
+
   // The raw histogram from BPF; it is populated on each iteration by a call to PollPerfBuffer().
   RawHistoData raw_histo_data_;
 
@@ -230,7 +230,8 @@ class PerfProfileBPFTest : public ::testing::Test {
   std::unique_ptr<SourceConnector> source_;
   std::unique_ptr<StandaloneContext> ctx_;
   DataTable data_table_;
-  const std::vector<DataTable*> data_tables_{&data_table_};
+  // The stack frames table is not collected, so stack traces are recorded as folded strings.
+  const std::vector<DataTable*> data_tables_{&data_table_, nullptr};
 
   bool column_ptrs_populated_ = false;
   std::shared_ptr<types::ColumnWrapper> trace_ids_column_;
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/perf_profiler/stack_frame_interner.h"
+
+#include <utility>
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+
+#include "src/stirling/source_connectors/perf_profiler/stringifier.h"
+
+namespace px {
+namespace stirling {
+
+uint64_t StackFrameInterner::InternFrame(std::string_view symbol, std::vector<Frame>* new_frames) {
+  // Case 1: The frame is in the current set. Just return its ID.
+  auto iter = frame_ids_.find(symbol);
+  if (iter != frame_ids_.end()) {
+    return iter->second;
+  }
+
+  // Case 2: The frame is in the previous set. Move it to the current set, and re-emit it.
+  auto node = prev_frame_ids_.extract(symbol);
+  if (node.empty()) {
+    // Case 3: The frame is in neither set. Create a new ID.
+    iter = frame_ids_.emplace(std::string(symbol), ++next_frame_id_).first;
+  } else {
+    iter = frame_ids_.insert(std::move(node)).position;
+  }
+
+  new_frames->push_back(Frame{iter->second, iter->first});
+  return iter->second;
+}
+
+std::string StackFrameInterner::Intern(std::string_view folded_stack_trace,
+                                       std::vector<Frame>* new_frames) {
+  std::string frame_ids;
+  if (folded_stack_trace.empty()) {
+    return frame_ids;
+  }
+  for (std::string_view symbol : absl::StrSplit(folded_stack_trace, stringifier::kSeparator)) {
+    if (!frame_ids.empty()) {
+      frame_ids += stringifier::kSeparator;
+    }
+    absl::StrAppend(&frame_ids, InternFrame(symbol, new_frames));
+  }
+  return frame_ids;
+}
+
+void StackFrameInterner::AgeTick() {
+  prev_frame_ids_ = std::move(frame_ids_);
+  frame_ids_.clear();
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <absl/container/node_hash_map.h>
+
+namespace px {
+namespace stirling {
+
+// The StackFrameInterner assigns integer IDs to stack frames (symbols), so that a stack trace
+// can be recorded as a short list of frame IDs rather than as its folded string; the frames
+// themselves are recorded once, in a separate dictionary table.
+//
+// IDs are never reused, so a frame ID always maps to the same frame. Like StackTraceIDCache,
+// frames are kept for two generations: a frame that is not used for two AgeTick() periods is
+// forgotten and gets a new ID when next seen. A frame is reported as new the first time it is
+// used in a generation, so that its dictionary entry is periodically re-emitted while in use
+// and does not age out of the table store before the stack traces that reference it.
+class StackFrameInterner {
+ public:
+  struct Frame {
+    uint64_t id;
+    std::string_view symbol;
+  };
+
+  /**
+   * Interns each frame of a folded stack trace string.
+   *
+   * @param folded_stack_trace The stack trace, with frames separated by stringifier::kSeparator.
+   * @param new_frames Frames that need to be (re-)emitted to the dictionary are appended here.
+   *                   The symbols are owned by the interner and valid until the next AgeTick().
+   * @return The frame IDs, separated by stringifier::kSeparator.
+   */
+  std::string Intern(std::string_view folded_stack_trace, std::vector<Frame>* new_frames);
+
+  void AgeTick();
+
+  size_t size() const { return frame_ids_.size() + prev_frame_ids_.size(); }
+
+ private:
+  uint64_t InternFrame(std::string_view symbol, std::vector<Frame>* new_frames);
+
+  // Node based, so that the symbols handed out in new_frames have stable addresses.
+  absl::node_hash_map<std::string, uint64_t> frame_ids_;
+  absl::node_hash_map<std::string, uint64_t> prev_frame_ids_;
+
+  // Tracks the next frame ID to be assigned; incremented by 1 for each such assignment.
+  uint64_t next_frame_id_ = 0;
+};
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "src/stirling/source_connectors/perf_profiler/stack_frame_interner.h"
+
+namespace px {
+namespace stirling {
+
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::IsEmpty;
+
+auto FrameIs(uint64_t id, std::string_view symbol) {
+  return AllOf(Field(&StackFrameInterner::Frame::id, id),
+               Field(&StackFrameInterner::Frame::symbol, symbol));
+}
+
+TEST(StackFrameInterner, Basic) {
+  StackFrameInterner interner;
+  std::vector<StackFrameInterner::Frame> new_frames;
+
+  EXPECT_EQ(interner.Intern("main;foo;bar", &new_frames), "1;2;3");
+  EXPECT_THAT(new_frames, ElementsAre(FrameIs(1, "main"), FrameIs(2, "foo"), FrameIs(3, "bar")));
+
+  // Known frames are not emitted again.
+  new_frames.clear();
+  EXPECT_EQ(interner.Intern("main;foo;baz;bar", &new_frames), "1;2;4;3");
+  EXPECT_THAT(new_frames, ElementsAre(FrameIs(4, "baz")));
+
+  new_frames.clear();
+  EXPECT_EQ(interner.Intern("", &new_frames), "");
+  EXPECT_THAT(new_frames, IsEmpty());
+}
+
+TEST(StackFrameInterner, Aging) {
+  StackFrameInterner interner;
+  std::vector<StackFrameInterner::Frame> new_frames;
+
+  EXPECT_EQ(interner.Intern("main;foo", &new_frames), "1;2");
+  interner.AgeTick();
+
+  // Frames keep their IDs across one generation, but are re-emitted.
+  new_frames.clear();
+  EXPECT_EQ(interner.Intern("main", &new_frames), "1");
+  EXPECT_THAT(new_frames, ElementsAre(FrameIs(1, "main")));
+
+  interner.AgeTick();
+  interner.AgeTick();
+
+  // Frames unused for too long get new IDs; IDs are never reused.
+  new_frames.clear();
+  EXPECT_EQ(interner.Intern("foo;main", &new_frames), "3;4");
+  EXPECT_THAT(new_frames, ElementsAre(FrameIs(3, "foo"), FrameIs(4, "main")));
+  EXPECT_EQ(interner.size(), 2);
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/perf_profiler/stack_trace_string_cache.h"
+
+#include <utility>
+
+namespace px {
+namespace stirling {
+
+const std::string* StackTraceStringCache::Lookup(const struct upid_t& upid,
+                                                 const std::vector<uintptr_t>& addrs) {
+  ++stat_accesses_;
+
+  const KeyView key{upid, addrs};
+
+  // Case 1: The stack trace is in the current generation.
+  auto iter = cache_.find(key);
+  if (iter != cache_.end()) {
+    ++stat_hits_;
+    return &iter->second;
+  }
+
+  // Case 2: The stack trace is in the previous generation. Promote it to the current generation.
+  auto node = prev_cache_.extract(key);
+  if (!node.empty()) {
+    ++stat_hits_;
+    if (cache_.size() >= max_entries_) {
+      AgeTick();
+    }
+    return &cache_.insert(std::move(node)).position->second;
+  }
+
+  return nullptr;
+}
+
+void StackTraceStringCache::Insert(const struct upid_t& upid, std::vector<uintptr_t> addrs,
+                                   std::string stack_trace_str) {
+  if (cache_.size() >= max_entries_) {
+    AgeTick();
+  }
+  cache_.insert_or_assign(Key{upid, std::move(addrs)}, std::move(stack_trace_str));
+}
+
+void StackTraceStringCache::AgeTick() {
+  prev_cache_ = std::move(cache_);
+  cache_.clear();
+}
+
+}  // namespace stirling
+}  // namespace px
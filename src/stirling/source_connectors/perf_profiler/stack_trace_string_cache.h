@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
+#include <absl/types/span.h>
+
+#include "src/stirling/bpf_tools/bcc_bpf_intf/upid.h"
+
+namespace px {
+namespace stirling {
+
+// The StackTraceStringCache maps a raw stack trace (the upid and its list of addresses)
+// to its folded stack trace string. Unlike the memoization inside the Stringifier, which is
+// keyed by the BPF stack-trace-id and only valid for one iteration, this cache lives across
+// iterations of the profiler, so that recurring stacks are not re-symbolized on every push.
+//
+// Like StackTraceIDCache, entries are kept for two generations: AgeTick() drops anything that
+// was not used since the previous tick. The cache also ages early when the current generation
+// reaches max_entries, which bounds its memory to roughly 2*max_entries stack traces.
+class StackTraceStringCache {
+ public:
+  explicit StackTraceStringCache(size_t max_entries) : max_entries_(max_entries) {}
+
+  /**
+   * Returns the cached folded stack trace string, or nullptr if the stack trace is not cached.
+   */
+  const std::string* Lookup(const struct upid_t& upid, const std::vector<uintptr_t>& addrs);
+
+  /**
+   * Caches the folded stack trace string of a stack trace.
+   */
+  void Insert(const struct upid_t& upid, std::vector<uintptr_t> addrs, std::string stack_trace_str);
+
+  void AgeTick();
+
+  size_t size() const { return cache_.size() + prev_cache_.size(); }
+  uint64_t stat_accesses() const { return stat_accesses_; }
+  uint64_t stat_hits() const { return stat_hits_; }
+
+ private:
+  struct Key {
+    struct upid_t upid;
+    std::vector<uintptr_t> addrs;
+  };
+
+  // Allows lookups by (upid, span of addresses), without copying the addresses into a Key.
+  struct KeyView {
+    struct upid_t upid;
+    absl::Span<const uintptr_t> addrs;
+  };
+
+  struct KeyHash {
+    using is_transparent = void;
+    size_t operator()(const KeyView& k) const {
+      return absl::Hash<std::tuple<struct upid_t, absl::Span<const uintptr_t>>>()(
+          std::make_tuple(k.upid, k.addrs));
+    }
+    size_t operator()(const Key& k) const { return (*this)(KeyView{k.upid, k.addrs}); }
+  };
+
+  struct KeyEq {
+    using is_transparent = void;
+    static KeyView View(const Key& k) { return KeyView{k.upid, k.addrs}; }
+    static KeyView View(const KeyView& k) { return k; }
+
+    template <typename TLHS, typename TRHS>
+    bool operator()(const TLHS& lhs, const TRHS& rhs) const {
+      const KeyView l = View(lhs);
+      const KeyView r = View(rhs);
+      return l.upid == r.upid && l.addrs == r.addrs;
+    }
+  };
+
+  using Cache = absl::flat_hash_map<Key, std::string, KeyHash, KeyEq>;
+
+  const size_t max_entries_;
+
+  Cache cache_;
+  Cache prev_cache_;
+
+  uint64_t stat_accesses_ = 0;
+  uint64_t stat_hits_ = 0;
+};
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+
+#include "src/stirling/source_connectors/perf_profiler/stack_trace_string_cache.h"
+
+namespace px {
+namespace stirling {
+
+TEST(StackTraceStringCache, Basic) {
+  StackTraceStringCache cache(/* max_entries */ 16);
+
+  const struct upid_t kUPID1 = {.pid = 1, .start_time_ticks = 1};
+  const struct upid_t kUPID2 = {.pid = 2, .start_time_ticks = 1};
+  const std::vector<uintptr_t> kAddrs1 = {0x1000, 0x2000, 0x3000};
+  const std::vector<uintptr_t> kAddrs2 = {0x1000, 0x2000};
+
+  EXPECT_EQ(cache.Lookup(kUPID1, kAddrs1), nullptr);
+  cache.Insert(kUPID1, kAddrs1, "a();b();c()");
+  cache.Insert(kUPID1, kAddrs2, "a();b()");
+
+  ASSERT_NE(cache.Lookup(kUPID1, kAddrs1), nullptr);
+  EXPECT_EQ(*cache.Lookup(kUPID1, kAddrs1), "a();b();c()");
+  EXPECT_EQ(*cache.Lookup(kUPID1, kAddrs2), "a();b()");
+
+  // The same addresses in a different process are a different stack trace.
+  EXPECT_EQ(cache.Lookup(kUPID2, kAddrs1), nullptr);
+
+  cache.AgeTick();
+
+  // Entries are kept across one generation.
+  ASSERT_NE(cache.Lookup(kUPID1, kAddrs1), nullptr);
+  EXPECT_EQ(*cache.Lookup(kUPID1, kAddrs1), "a();b();c()");
+
+  cache.AgeTick();
+
+  // kAddrs1 was used in the previous generation, kAddrs2 was not.
+  EXPECT_NE(cache.Lookup(kUPID1, kAddrs1), nullptr);
+  EXPECT_EQ(cache.Lookup(kUPID1, kAddrs2), nullptr);
+
+  EXPECT_EQ(cache.stat_accesses(), 9);
+  EXPECT_EQ(cache.stat_hits(), 6);
+}
+
+TEST(StackTraceStringCache, BoundedSize) {
+  constexpr size_t kMaxEntries = 4;
+  StackTraceStringCache cache(kMaxEntries);
+
+  const struct upid_t kUPID = {.pid = 1, .start_time_ticks = 1};
+  for (uintptr_t i = 0; i < 100; ++i) {
+    cache.Insert(kUPID, {i}, absl::StrCat(i));
+    EXPECT_LE(cache.size(), 2 * kMaxEntries);
+  }
+
+  // The most recent entries are still available.
+  ASSERT_NE(cache.Lookup(kUPID, {99}), nullptr);
+  EXPECT_EQ(*cache.Lookup(kUPID, {99}), "99");
+  EXPECT_EQ(cache.Lookup(kUPID, {0}), nullptr);
+}
+
+}  // namespace stirling
+}  // namespace px
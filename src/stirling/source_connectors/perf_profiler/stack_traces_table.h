@@ -41,7 +41,12 @@ static constexpr DataElement kElements[] = {
      types::DataType::STRING, types::SemanticType::ST_NONE, types::PatternType::GENERAL},
     {"count",
      "Number of times the stack trace has been sampled.",
-     types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE}
+     types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE},
+    {"frame_ids",
+     "The stack trace as a semicolon separated list of frame IDs, in the same order as "
+     "`stack_trace`. Only populated when stack frames are interned, in which case `stack_trace` "
+     "is empty. The frames are in the `stack_frames.beta` table.",
+     types::DataType::STRING, types::SemanticType::ST_NONE, types::PatternType::GENERAL}
 };
 
 constexpr auto kStackTraceTable = DataTableSchema(
@@ -58,6 +63,32 @@ constexpr int kStackTraceUPIDIdx = kStackTraceTable.ColIndex("upid");
 constexpr int kStackTraceStackTraceIDIdx = kStackTraceTable.ColIndex("stack_trace_id");
 constexpr int kStackTraceStackTraceStrIdx = kStackTraceTable.ColIndex("stack_trace");
 constexpr int kStackTraceCountIdx = kStackTraceTable.ColIndex("count");
+constexpr int kStackTraceFrameIDsIdx = kStackTraceTable.ColIndex("frame_ids");
+
+// clang-format off
+static constexpr DataElement kStackFrameElements[] = {
+    canonical_data_elements::kTime,
+    {"frame_id",
+     "The ID of the stack frame, as referenced by the `frame_ids` column of `stack_traces.beta`. "
+     "IDs are local to the node that produced them.",
+     types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::GENERAL},
+    {"frame",
+     "The symbol of the stack frame.",
+     types::DataType::STRING, types::SemanticType::ST_NONE, types::PatternType::GENERAL},
+};
+
+constexpr auto kStackFramesTable = DataTableSchema(
+        "stack_frames.beta",
+        "Dictionary of the interned stack frames in `stack_traces.beta`. "
+        "A frame is re-emitted periodically for as long as it is in use.",
+        kStackFrameElements
+);
+// clang-format on
+DEFINE_PRINT_TABLE(StackFrames)
+
+constexpr int kStackFramesTimeIdx = kStackFramesTable.ColIndex("time_");
+constexpr int kStackFramesFrameIDIdx = kStackFramesTable.ColIndex("frame_id");
+constexpr int kStackFramesFrameIdx = kStackFramesTable.ColIndex("frame");
 
 }  // namespace stirling
 }  // namespace px
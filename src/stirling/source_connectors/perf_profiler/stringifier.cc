@@ -19,14 +19,19 @@
 #include "src/stirling/source_connectors/perf_profiler/stringifier.h"
 #include <stdint.h>
 
+#include <utility>
 #include <vector>
 
 namespace px {
 namespace stirling {
 
 Stringifier::Stringifier(Symbolizer* u_symbolizer, Symbolizer* k_symbolizer,
-                         ebpf::BPFStackTable* stack_traces)
-    : u_symbolizer_(u_symbolizer), k_symbolizer_(k_symbolizer), stack_traces_(stack_traces) {}
+                         ebpf::BPFStackTable* stack_traces,
+                         StackTraceStringCache* stack_trace_strs)
+    : u_symbolizer_(u_symbolizer),
+      k_symbolizer_(k_symbolizer),
+      stack_traces_(stack_traces),
+      persistent_stack_trace_strs_(stack_trace_strs) {}
 
 std::string Stringifier::BuildStackTraceString(const std::vector<uintptr_t>& addrs,
                                                SymbolizerFn symbolize_fn,
@@ -61,7 +66,8 @@ std::string Stringifier::BuildStackTraceString(const std::vector<uintptr_t>& add
   return stack_trace_str;
 }
 
-std::string Stringifier::FindOrBuildStackTraceString(const int stack_id, SymbolizerFn symbolize_fn,
+std::string Stringifier::FindOrBuildStackTraceString(const int stack_id, const struct upid_t& upid,
+                                                     Symbolizer* symbolizer,
                                                      const std::string_view& suffix) {
   // First try to find the memoized result in the stack_trace_strs_ map,
   // if no memoized result is available, build the folded stack trace string.
@@ -72,10 +78,23 @@ std::string Stringifier::FindOrBuildStackTraceString(const int stack_id, Symboli
     constexpr bool kClearStackId = true;
 
     // Get the stack trace (as a vector of addresses) from the shared BPF stack trace table.
-    const std::vector<uintptr_t> addrs = stack_traces_->get_stack_addr(stack_id, kClearStackId);
+    std::vector<uintptr_t> addrs = stack_traces_->get_stack_addr(stack_id, kClearStackId);
     VLOG_IF(1, addrs.empty()) << absl::Substitute("[empty_stack_trace] stack_id: $0", stack_id);
 
-    iter->second = BuildStackTraceString(addrs, symbolize_fn, suffix);
+    // A stack trace seen on a previous iteration does not need to be symbolized again.
+    if (persistent_stack_trace_strs_ != nullptr) {
+      const std::string* stack_trace_str = persistent_stack_trace_strs_->Lookup(upid, addrs);
+      if (stack_trace_str != nullptr) {
+        iter->second = *stack_trace_str;
+        return iter->second;
+      }
+    }
+
+    iter->second = BuildStackTraceString(addrs, symbolizer->GetSymbolizerFn(upid), suffix);
+
+    if (persistent_stack_trace_strs_ != nullptr) {
+      persistent_stack_trace_strs_->Insert(upid, std::move(addrs), iter->second);
+    }
   }
   return iter->second;
 }
@@ -90,15 +109,12 @@ std::string Stringifier::FoldedStackTraceString(const stack_trace_key_t& key) {
   const struct upid_t& u_upid = key.upid;
   const struct upid_t& k_upid = profiler::kKernelUPID;
 
-  auto u_symbolizer_fn = u_symbolizer_->GetSymbolizerFn(u_upid);
-  auto k_symbolizer_fn = k_symbolizer_->GetSymbolizerFn(k_upid);
-
   // Using bind because it helps the reduce redundant information in the if/else chain below.
   // Also, it is easier to read, e.g.:
   // stack_trace_str = u_stack_str_fn() + ";" + k_stack_str_fn();
   auto fn_addr = &Stringifier::FindOrBuildStackTraceString;
-  auto u_stack_str_fn = std::bind(fn_addr, this, u_stack_id, u_symbolizer_fn, kUserSuffix);
-  auto k_stack_str_fn = std::bind(fn_addr, this, k_stack_id, k_symbolizer_fn, kKernSuffix);
+  auto u_stack_str_fn = std::bind(fn_addr, this, u_stack_id, u_upid, u_symbolizer_, kUserSuffix);
+  auto k_stack_str_fn = std::bind(fn_addr, this, k_stack_id, k_upid, k_symbolizer_, kKernSuffix);
 
   std::string stack_trace_str;
   stack_trace_str.reserve(128);
@@ -23,6 +23,7 @@
 
 #include "src/stirling/bpf_tools/bcc_bpf_intf/upid.h"
 #include "src/stirling/source_connectors/perf_profiler/bcc_bpf_intf/stack_event.h"
+#include "src/stirling/source_connectors/perf_profiler/stack_trace_string_cache.h"
 #include "src/stirling/source_connectors/perf_profiler/symbolizer.h"
 
 namespace px {
@@ -63,6 +64,10 @@ static constexpr std::string_view kDropMessage = "<stack trace lost>";
 // Because of stack-trace-id reuse and the destructive read, the stringifier memoizes
 // its stringified results. A new stringifier is created (and destroyed) on each iteration
 // of the continuous perf. profiler.
+//
+// Stack-trace-ids are only meaningful for one iteration, but the stack traces themselves recur.
+// If given a StackTraceStringCache, which outlives the stringifier, the stringifier looks up the
+// raw stack trace there before symbolizing it, and stores the results it builds.
 class Stringifier {
  public:
   /**
@@ -71,9 +76,11 @@ class Stringifier {
    * @param u_symbolizer A symbolizer for user-space addresses.
    * @param k_symbolizer A symbolizer for kernel-space addresses.
    * @param stack_traces Pointer to the BCC collected stack traces.
+   * @param stack_trace_strs Optional cache of folded stack trace strings, kept across iterations.
    */
   Stringifier(Symbolizer* u_symbolizer, Symbolizer* k_symbolizer,
-              ebpf::BPFStackTable* stack_traces);
+              ebpf::BPFStackTable* stack_traces,
+              StackTraceStringCache* stack_trace_strs = nullptr);
 
   // Returns a folded stack trace string based on the stack trace histogram key.
   // The key contains both a user & kernel stack-trace-id, which are subsequently
@@ -83,8 +90,8 @@ class Stringifier {
  private:
   std::string BuildStackTraceString(const std::vector<uintptr_t>& addrs, SymbolizerFn symbolize_fn,
                                     const std::string_view& suffix);
-  std::string FindOrBuildStackTraceString(const int stack_id, SymbolizerFn symbolize_fn,
-                                          const std::string_view& suffix);
+  std::string FindOrBuildStackTraceString(const int stack_id, const struct upid_t& upid,
+                                          Symbolizer* symbolizer, const std::string_view& suffix);
 
   // Memoized results of previous calls to FindOrBuildStackTraceString():
   // a map from stack-trace-id to folded stack trace string.
@@ -100,6 +107,9 @@ class Stringifier {
   // to be explicitly cleared (by re-iterating the histogram) after an iteration
   // of the continuous perf. profiler is completed.
   ebpf::BPFStackTable* const stack_traces_;
+
+  // Folded stack trace strings that persist across iterations; may be nullptr.
+  StackTraceStringCache* const persistent_stack_trace_strs_;
 };
 
 }  // namespace stirling
@@ -16,8 +16,16 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <sys/stat.h>
+
+#include <charconv>
 #include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/strings/str_split.h>
 
+#include "src/common/base/file.h"
 #include "src/stirling/bpf_tools/bcc_symbolizer.h"
 #include "src/stirling/source_connectors/perf_profiler/symbolizer.h"
 #include "src/stirling/utils/proc_path_tools.h"
@@ -60,17 +68,137 @@ StatusOr<std::unique_ptr<Symbolizer>> ElfSymbolizer::Create() {
   return symbolizer;
 }
 
-void ElfSymbolizer::DeleteUPID(const struct upid_t& upid) { symbolizers_.erase(upid); }
+void ElfSymbolizer::DeleteUPID(const struct upid_t& upid) {
+  auto iter = symbolizers_.find(upid);
+  if (iter == symbolizers_.end()) {
+    return;
+  }
+  const bool last_reference = iter->second.symbol_table.use_count() == 1;
+  symbolizers_.erase(iter);
+
+  // The table was freed, so remove the keys that pointed to it.
+  if (last_reference) {
+    for (auto table_iter = symbol_tables_.begin(); table_iter != symbol_tables_.end();) {
+      if (table_iter->second.expired()) {
+        symbol_tables_.erase(table_iter++);
+      } else {
+        ++table_iter;
+      }
+    }
+  }
+}
+
+size_t ElfSymbolizer::NumSymbolTables() const {
+  absl::flat_hash_set<const SymbolTable*> tables;
+  for (const auto& [upid, upid_symbolizer] : symbolizers_) {
+    PL_UNUSED(upid);
+    tables.insert(upid_symbolizer.symbol_table.get());
+  }
+  return tables.size();
+}
+
+namespace {
+
+// Identifies a file by device, inode and modification time; used to share symbol tables
+// for binaries that have no build-id.
+StatusOr<std::string> FileIdentityKey(const std::filesystem::path& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return error::Internal("Could not stat $0.", path.string());
+  }
+  return absl::Substitute("file:$0:$1:$2.$3", st.st_dev, st.st_ino, st.st_mtim.tv_sec,
+                          st.st_mtim.tv_nsec);
+}
+
+bool ParseHex(std::string_view str, uintptr_t* val) {
+  auto res = std::from_chars(str.data(), str.data() + str.size(), *val, 16);
+  return res.ec == std::errc() && res.ptr == str.data() + str.size();
+}
+
+// Returns the load bias of the executable of a process: the address at which the start of the
+// file is mapped, as found in /proc/<pid>/maps. This assumes that the first loadable segment of
+// the executable has virtual address 0, which is what linkers produce for position independent
+// executables.
+StatusOr<uintptr_t> ExeLoadBias(uint32_t pid, const std::filesystem::path& proc_exe) {
+  static constexpr int kProcMapNumFields = 6;
+
+  const std::filesystem::path maps_path =
+      system::Config::GetInstance().proc_path() / std::to_string(pid) / "maps";
+  PL_ASSIGN_OR_RETURN(std::string content, px::ReadFileToString(maps_path));
+
+  for (std::string_view line : absl::StrSplit(content, "\n", absl::SkipWhitespace())) {
+    // Line format: <start>-<end> <perms> <offset> <dev> <inode> <path>
+    std::vector<std::string_view> fields =
+        absl::StrSplit(line, absl::MaxSplits(' ', kProcMapNumFields - 1), absl::SkipWhitespace());
+    if (fields.size() != kProcMapNumFields ||
+        absl::StripAsciiWhitespace(fields[5]) != proc_exe.string()) {
+      continue;
+    }
+
+    uintptr_t offset = 0;
+    if (!ParseHex(fields[2], &offset) || offset != 0) {
+      continue;
+    }
+
+    std::vector<std::string_view> range = absl::StrSplit(fields[0], "-");
+    uintptr_t start = 0;
+    if (range.size() != 2 || !ParseHex(range[0], &start)) {
+      return error::Internal("Unexpected address range $0 in $1.", fields[0], maps_path.string());
+    }
+    return start;
+  }
+  return error::NotFound("Could not find the mapping of $0 in $1.", proc_exe.string(),
+                         maps_path.string());
+}
+
+}  // namespace
 
-StatusOr<std::unique_ptr<ElfReader::Symbolizer>> CreateUPIDSymbolizer(const struct upid_t& upid) {
+std::shared_ptr<ElfSymbolizer::SymbolTable> ElfSymbolizer::FindSymbolTable(
+    const std::string& key) const {
+  auto iter = symbol_tables_.find(key);
+  if (iter == symbol_tables_.end()) {
+    return nullptr;
+  }
+  return iter->second.lock();
+}
+
+StatusOr<ElfSymbolizer::UPIDSymbolizer> ElfSymbolizer::CreateUPIDSymbolizer(
+    const struct upid_t& upid) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<FilePathResolver> fp_resolver,
                       FilePathResolver::Create(upid.pid));
   PL_ASSIGN_OR_RETURN(std::filesystem::path proc_exe, ProcExe(upid.pid));
   PL_ASSIGN_OR_RETURN(std::filesystem::path host_proc_exe, fp_resolver->ResolvePath(proc_exe));
   host_proc_exe = system::Config::GetInstance().ToHostPath(host_proc_exe);
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<ElfReader> elf_reader, ElfReader::Create(host_proc_exe));
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<ElfReader::Symbolizer> upid_symbolizer,
-                      elf_reader->GetSymbolizer());
+
+  // First look for the table by file identity, which avoids reading the binary altogether.
+  PL_ASSIGN_OR_RETURN(const std::string file_key, FileIdentityKey(host_proc_exe));
+  std::shared_ptr<SymbolTable> symbol_table = FindSymbolTable(file_key);
+
+  if (symbol_table == nullptr) {
+    // Then by build-id, which also matches copies of the binary, e.g. in different images.
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<ElfReader> elf_reader, ElfReader::Create(host_proc_exe));
+    std::string build_id_key;
+    if (!elf_reader->build_id().empty()) {
+      build_id_key = absl::StrCat("build-id:", elf_reader->build_id());
+      symbol_table = FindSymbolTable(build_id_key);
+    }
+
+    if (symbol_table == nullptr) {
+      symbol_table = std::make_shared<SymbolTable>();
+      PL_ASSIGN_OR_RETURN(symbol_table->symbolizer, elf_reader->GetSymbolizer());
+      symbol_table->position_independent = elf_reader->ELFType() == ELFIO::ET_DYN;
+      if (!build_id_key.empty()) {
+        symbol_tables_[build_id_key] = symbol_table;
+      }
+    }
+    symbol_tables_[file_key] = symbol_table;
+  }
+
+  UPIDSymbolizer upid_symbolizer;
+  if (symbol_table->position_independent) {
+    PL_ASSIGN_OR_RETURN(upid_symbolizer.load_bias, ExeLoadBias(upid.pid, proc_exe));
+  }
+  upid_symbolizer.symbol_table = std::move(symbol_table);
   return upid_symbolizer;
 }
 
@@ -88,20 +216,23 @@ SymbolizerFn ElfSymbolizer::GetSymbolizerFn(const struct upid_t& upid) {
     return SymbolizerFn(&(DummyKernelSymbolizerFn));
   }
 
-  std::unique_ptr<ElfReader::Symbolizer>& upid_symbolizer = symbolizers_[upid];
-  if (upid_symbolizer == nullptr) {
-    StatusOr<std::unique_ptr<ElfReader::Symbolizer>> upid_symbolizer_status =
-        CreateUPIDSymbolizer(upid);
+  auto iter = symbolizers_.find(upid);
+  if (iter == symbolizers_.end()) {
+    StatusOr<UPIDSymbolizer> upid_symbolizer_status = CreateUPIDSymbolizer(upid);
     if (!upid_symbolizer_status.ok()) {
       VLOG(1) << absl::Substitute("Failed to create Symbolizer function for $0 [error=$1]",
                                   upid.pid, upid_symbolizer_status.ToString());
       return SymbolizerFn(&(EmptySymbolizerFn));
     }
 
-    upid_symbolizer = upid_symbolizer_status.ConsumeValueOrDie();
+    iter = symbolizers_.emplace(upid, upid_symbolizer_status.ConsumeValueOrDie()).first;
   }
 
-  return std::bind(&ElfReader::Symbolizer::Lookup, upid_symbolizer.get(), std::placeholders::_1);
+  const ElfReader::Symbolizer* symbolizer = iter->second.symbol_table->symbolizer.get();
+  const uintptr_t load_bias = iter->second.load_bias;
+  return [symbolizer, load_bias](const uintptr_t addr) {
+    return symbolizer->Lookup(addr, load_bias);
+  };
 }
 
 StatusOr<std::unique_ptr<Symbolizer>> CachingSymbolizer::Create(
@@ -81,6 +81,11 @@ class BCCSymbolizer : public Symbolizer, public NotCopyMoveable {
 
 /**
  * A Symbolizer using the ElfReader symbolization core.
+ *
+ * Symbol tables are shared by all processes that run the same binary, so that many replicas of a
+ * binary on a node only parse and hold its symbols once. Tables are keyed by the ELF build-id,
+ * and by the file identity (device, inode, mtime) of the binary, which also covers binaries
+ * without a build-id. Only the per-process load bias is applied at lookup time.
  */
 class ElfSymbolizer : public Symbolizer, public NotCopyMoveable {
  public:
@@ -89,13 +94,39 @@ class ElfSymbolizer : public Symbolizer, public NotCopyMoveable {
   SymbolizerFn GetSymbolizerFn(const struct upid_t& upid) override;
   void DeleteUPID(const struct upid_t& upid) override;
 
+  /**
+   * Returns the number of distinct symbol tables in use by all UPIDs.
+   */
+  size_t NumSymbolTables() const;
+
  private:
+  // The symbols of one binary, shared across the processes that run it.
+  struct SymbolTable {
+    std::unique_ptr<obj_tools::ElfReader::Symbolizer> symbolizer;
+
+    // Position independent executables are relocated when loaded, so their processes
+    // need a load bias.
+    bool position_independent = false;
+  };
+
+  struct UPIDSymbolizer {
+    std::shared_ptr<SymbolTable> symbol_table;
+    uintptr_t load_bias = 0;
+  };
+
   ElfSymbolizer() = default;
 
-  // A symbolizer per UPID.
-  absl::flat_hash_map<struct upid_t,
-                      std::unique_ptr<px::stirling::obj_tools::ElfReader::Symbolizer>>
-      symbolizers_;
+  StatusOr<UPIDSymbolizer> CreateUPIDSymbolizer(const struct upid_t& upid);
+
+  // Returns the live symbol table for the key, or nullptr.
+  std::shared_ptr<SymbolTable> FindSymbolTable(const std::string& key) const;
+
+  // A symbolizer per UPID. Each one holds a reference to its symbol table.
+  absl::flat_hash_map<struct upid_t, UPIDSymbolizer> symbolizers_;
+
+  // Symbol tables by build-id and by file identity; a table may appear under both keys.
+  // Entries expire once the last UPID referencing the table is deleted.
+  absl::flat_hash_map<std::string, std::weak_ptr<SymbolTable>> symbol_tables_;
 };
 
 /**
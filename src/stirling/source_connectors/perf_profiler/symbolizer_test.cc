@@ -65,6 +65,30 @@ TYPED_TEST(SymbolizerTest, UserSymbols) {
   EXPECT_EQ(symbolize(2), std::string("0x0000000000000002"));
 }
 
+// Processes running the same binary should share one symbol table.
+TEST_F(ElfSymbolizerTest, SharedSymbolTables) {
+  auto* elf_symbolizer = static_cast<ElfSymbolizer*>(symbolizer_.get());
+
+  const uint32_t pid = static_cast<uint32_t>(getpid());
+  const struct upid_t upid1 = {.pid = pid, .start_time_ticks = 1};
+  const struct upid_t upid2 = {.pid = pid, .start_time_ticks = 2};
+
+  auto symbolize1 = elf_symbolizer->GetSymbolizerFn(upid1);
+  auto symbolize2 = elf_symbolizer->GetSymbolizerFn(upid2);
+  EXPECT_EQ(elf_symbolizer->NumSymbolTables(), 1);
+
+  EXPECT_EQ(symbolize1(kFooAddr), "test::foo()");
+  EXPECT_EQ(symbolize2(kFooAddr), "test::foo()");
+  EXPECT_EQ(symbolize2(kBarAddr), "test::bar()");
+
+  elf_symbolizer->DeleteUPID(upid1);
+  EXPECT_EQ(elf_symbolizer->NumSymbolTables(), 1);
+  EXPECT_EQ(symbolize2(kFooAddr), "test::foo()");
+
+  elf_symbolizer->DeleteUPID(upid2);
+  EXPECT_EQ(elf_symbolizer->NumSymbolTables(), 0);
+}
+
 TEST_F(BCCSymbolizerTest, KernelSymbols) {
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<Symbolizer> symbolizer, BCCSymbolizer::Create());
 
@@ -289,6 +289,17 @@ static __inline bool is_stirling_tgid(const uint32_t tgid) {
   return *stirling_tgid == tgid;
 }
 
+// Returns true if user-space load shedding has sampled out the connection. Such connections still
+// report their control events and stats, but not their data.
+static __inline bool is_sampled_out(const struct conn_info_t* conn_info) {
+  int idx = kSamplingMaskIndex;
+  int64_t* sampling_mask = control_values.lookup(&idx);
+  if (sampling_mask == NULL || *sampling_mask == 0) {
+    return false;
+  }
+  return (conn_id_sampling_hash(&conn_info->conn_id) & *sampling_mask) != 0;
+}
+
 enum target_tgid_match_result_t {
   TARGET_TGID_UNSPECIFIED,
   TARGET_TGID_ALL,
@@ -733,6 +744,12 @@ static __inline bool should_send_data(uint32_t tgid, uint64_t conn_disabled_tsid
     return false;
   }
 
+  // Drop the data of connections that are sampled out before it reaches the perf buffer.
+  // The test-only target PID is always traced in full.
+  if (!force_trace_tgid && is_sampled_out(conn_info)) {
+    return false;
+  }
+
   // Only trace data for protocols of interest, or if forced on.
   return (force_trace_tgid || should_trace_protocol_data(conn_info));
 }
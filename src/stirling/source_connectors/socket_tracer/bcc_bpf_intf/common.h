@@ -114,6 +114,20 @@ inline bool operator==(const struct conn_id_t& a, const struct conn_id_t& b) {
 inline bool operator!=(const struct conn_id_t& a, const struct conn_id_t& b) { return !(a == b); }
 #endif
 
+// A fixed (unseeded) hash of a conn_id, used to sample connections under load. BPF and user-space
+// both compute it, so they must agree on every bit. Uses the splitmix64 finalizer.
+static inline uint64_t conn_id_sampling_hash(const struct conn_id_t* conn_id) {
+  uint64_t x = ((uint64_t)conn_id->upid.tgid << 32) | (uint32_t)conn_id->fd;
+  x ^= conn_id->upid.start_time_ticks * 0x9e3779b97f4a7c15ULL;
+  x ^= conn_id->tsid * 0xc2b2ae3d27d4eb4fULL;
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
 // Specifies the corresponding indexes of the entries of a per-cpu array.
 enum ControlValueIndex {
   // This specify one pid to monitor. This is used during test to eliminate noise.
@@ -122,5 +136,8 @@ enum ControlValueIndex {
   // * Support efficient lookup inside bpf to minimize overhead.
   kTargetTGIDIndex = 0,
   kStirlingTGIDIndex,
+  // Connections are only traced if these bits of their conn_id_sampling_hash() are all zero.
+  // Zero traces all connections. Set by user-space load shedding.
+  kSamplingMaskIndex,
   kNumControlValues,
 };
@@ -45,7 +45,14 @@ namespace stirling {
  */
 struct SocketDataEvent {
   SocketDataEvent() : attr{}, msg{} {}
-  explicit SocketDataEvent(const void* data) {
+  explicit SocketDataEvent(const void* data) { Assign(data); }
+
+  /**
+   * Populates this event from a raw perf buffer submission.
+   * The msg buffer is reused, so recycling an event avoids a heap allocation per submission
+   * once msg has grown to the typical event size.
+   */
+  void Assign(const void* data) {
     // Work around the memory alignment issue by using memcopy, instead of structure assignment.
     //
     // A known fact is that perf buffer's memory region is 8 bytes aligned. But each submission
@@ -122,23 +122,23 @@ void ConnTracker::AddConnCloseEvent(const close_event_t& close_event, uint64_t t
   MarkForDeath();
 }
 
-void ConnTracker::AddDataEvent(std::unique_ptr<SocketDataEvent> event) {
-  SetRole(event->attr.role, "inferred from data_event");
-  SetProtocol(event->attr.protocol, "inferred from data_event");
+void ConnTracker::AddDataEvent(const SocketDataEvent& event) {
+  SetRole(event.attr.role, "inferred from data_event");
+  SetProtocol(event.attr.protocol, "inferred from data_event");
 
   CheckTracker();
-  UpdateTimestamps(event->attr.timestamp_ns);
-  UpdateDataStats(*event);
+  UpdateTimestamps(event.attr.timestamp_ns);
+  UpdateDataStats(event);
 
-  CONN_TRACE(1) << absl::Substitute("Data event received: $0", event->ToString());
+  CONN_TRACE(1) << absl::Substitute("Data event received: $0", event.ToString());
 
   // TODO(yzhao): Change to let userspace resolve the connection type and signal back to BPF.
   // Then we need at least one data event to let ConnTracker know the field descriptor.
-  if (event->attr.protocol == kProtocolUnknown) {
+  if (event.attr.protocol == kProtocolUnknown) {
     return;
   }
 
-  if (event->attr.protocol != protocol_) {
+  if (event.attr.protocol != protocol_) {
     return;
   }
 
@@ -147,12 +147,12 @@ void ConnTracker::AddDataEvent(std::unique_ptr<SocketDataEvent> event) {
     return;
   }
 
-  switch (event->attr.direction) {
+  switch (event.attr.direction) {
     case TrafficDirection::kEgress: {
-      send_data_.AddData(std::move(event));
+      send_data_.AddData(event);
     } break;
     case TrafficDirection::kIngress: {
-      recv_data_.AddData(std::move(event));
+      recv_data_.AddData(event);
     } break;
   }
 }
@@ -552,13 +552,11 @@ bool ConnTracker::ReadyForDestruction() const {
   return (death_countdown_ == 0) && final_conn_stats_reported_;
 }
 
-bool ConnTracker::IsRemoteAddrInCluster(const std::vector<CIDRBlock>& cluster_cidrs) {
+bool ConnTracker::IsRemoteAddrInCluster(const CIDRIndex<CIDRBlock>& cluster_cidrs) {
   PL_ASSIGN_OR(InetAddr remote_addr, open_info_.remote_addr.ToInetAddr(), return false);
 
-  for (const auto& cluster_cidr : cluster_cidrs) {
-    if (CIDRContainsIPAddr(cluster_cidr, remote_addr)) {
-      return true;
-    }
+  if (cluster_cidrs.LongestPrefixMatch(remote_addr) != nullptr) {
+    return true;
   }
 
   if (remote_addr.IsLoopback() && FLAGS_treat_loopback_as_in_cluster) {
@@ -605,7 +603,7 @@ bool ShouldTraceProtocolRole(TrafficProtocol protocol, EndpointRole role) {
 
 }  // namespace
 
-void ConnTracker::UpdateState(const std::vector<CIDRBlock>& cluster_cidrs) {
+void ConnTracker::UpdateState(const CIDRIndex<CIDRBlock>& cluster_cidrs) {
   if (state_ == State::kDisabled) {
     return;
   }
@@ -689,7 +687,7 @@ void ConnTracker::UpdateDataStats(const SocketDataEvent& event) {
 
 void ConnTracker::IterationPreTick(
     const std::chrono::time_point<std::chrono::steady_clock>& iteration_time,
-    const std::vector<CIDRBlock>& cluster_cidrs, system::ProcParser* proc_parser,
+    const CIDRIndex<CIDRBlock>& cluster_cidrs, system::ProcParser* proc_parser,
     system::SocketInfoManager* socket_info_mgr) {
   set_current_time(iteration_time);
 
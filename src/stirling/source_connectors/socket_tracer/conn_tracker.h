@@ -30,6 +30,7 @@
 
 #include <magic_enum.hpp>
 
+#include "src/common/base/cidr_index.h"
 #include "src/common/system/proc_parser.h"
 #include "src/common/system/socket_info.h"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/go_grpc_types.hpp"
@@ -196,10 +197,12 @@ class ConnTracker : NotCopyMoveable {
 
   /**
    * Registers a BPF data event into the tracker.
+   * The event's data is copied, so the event may be reused by the caller afterwards.
    *
    * @param event The data event from BPF.
    */
-  void AddDataEvent(std::unique_ptr<SocketDataEvent> event);
+  void AddDataEvent(const SocketDataEvent& event);
+  void AddDataEvent(std::unique_ptr<SocketDataEvent> event) { AddDataEvent(*event); }
 
   /**
    * Registers a BPF connection stats event into the tracker.
@@ -248,10 +251,11 @@ class ConnTracker : NotCopyMoveable {
     using TRecordType = typename TProtocolTraits::record_type;
     using TFrameType = typename TProtocolTraits::frame_type;
     using TStateType = typename TProtocolTraits::state_type;
+    using TPartialFrameStateType = typename TProtocolTraits::partial_frame_state_type;
 
     InitProtocolState<TStateType>();
 
-    DataStreamsToFrames<TFrameType, TStateType>();
+    DataStreamsToFrames<TFrameType, TStateType, TPartialFrameStateType>();
 
     auto& req_frames = req_data()->Frames<TFrameType>();
     auto& resp_frames = resp_data()->Frames<TFrameType>();
@@ -435,7 +439,7 @@ class ConnTracker : NotCopyMoveable {
    * @param connections A map of inodes to endpoint information.
    */
   void IterationPreTick(const std::chrono::time_point<std::chrono::steady_clock>& iteration_time,
-                        const std::vector<CIDRBlock>& cluster_cidrs,
+                        const CIDRIndex<CIDRBlock>& cluster_cidrs,
                         system::ProcParser* proc_parser,
                         system::SocketInfoManager* socket_info_mgr);
 
@@ -589,24 +593,24 @@ class ConnTracker : NotCopyMoveable {
 
   void CheckProcForConnClose();
   void HandleInactivity();
-  bool IsRemoteAddrInCluster(const std::vector<CIDRBlock>& cluster_cidrs);
-  void UpdateState(const std::vector<CIDRBlock>& cluster_cidrs);
+  bool IsRemoteAddrInCluster(const CIDRIndex<CIDRBlock>& cluster_cidrs);
+  void UpdateState(const CIDRIndex<CIDRBlock>& cluster_cidrs);
 
   void UpdateDataStats(const SocketDataEvent& event);
 
-  template <typename TFrameType, typename TStateType>
+  template <typename TFrameType, typename TStateType, typename TPartialFrameStateType>
   void DataStreamsToFrames() {
     auto state_ptr = protocol_state<TStateType>();
 
     DataStream* req_data_ptr = req_data();
     DCHECK_NE(req_data_ptr, nullptr);
-    req_data_ptr->template ProcessBytesToFrames<TFrameType, TStateType>(MessageType::kRequest,
-                                                                        state_ptr);
+    req_data_ptr->template ProcessBytesToFrames<TFrameType, TStateType, TPartialFrameStateType>(
+        MessageType::kRequest, state_ptr);
 
     DataStream* resp_data_ptr = resp_data();
     DCHECK_NE(resp_data_ptr, nullptr);
-    resp_data_ptr->template ProcessBytesToFrames<TFrameType, TStateType>(MessageType::kResponse,
-                                                                         state_ptr);
+    resp_data_ptr->template ProcessBytesToFrames<TFrameType, TStateType, TPartialFrameStateType>(
+        MessageType::kResponse, state_ptr);
   }
 
   template <typename TRecordType>
@@ -428,7 +428,8 @@ TEST_F(ConnTrackerTest, TrackerDisabledForIntraClusterRemoteEndpoint) {
 
   CIDRBlock cidr;
   ASSERT_OK(ParseCIDRBlock("1.2.3.4/14", &cidr));
-  std::vector cidrs = {cidr};
+  CIDRIndex<CIDRBlock> cidrs;
+  cidrs.Insert(cidr, cidr);
 
   ConnTracker tracker;
   tracker.AddControlEvent(conn);
@@ -447,7 +448,8 @@ TEST_F(ConnTrackerTest, TrackerDisabledForLocalhostRemoteEndpoint) {
 
   CIDRBlock cidr;
   ASSERT_OK(ParseCIDRBlock("1.2.3.4/14", &cidr));
-  std::vector cidrs = {cidr};
+  CIDRIndex<CIDRBlock> cidrs;
+  cidrs.Insert(cidr, cidr);
 
   ConnTracker tracker;
   tracker.AddControlEvent(conn);
@@ -480,7 +482,8 @@ TEST_F(ConnTrackerTest, TrackerDisabledForUnixDomainSocket) {
 
   CIDRBlock cidr;
   ASSERT_OK(ParseCIDRBlock("1.2.3.4/14", &cidr));
-  std::vector cidrs = {cidr};
+  CIDRIndex<CIDRBlock> cidrs;
+  cidrs.Insert(cidr, cidr);
 
   ConnTracker tracker;
   tracker.AddControlEvent(conn);
@@ -497,7 +500,8 @@ TEST_F(ConnTrackerTest, TrackerDisabledForOtherSockAddrFamily) {
 
   CIDRBlock cidr;
   ASSERT_OK(ParseCIDRBlock("1.2.3.4/14", &cidr));
-  std::vector cidrs = {cidr};
+  CIDRIndex<CIDRBlock> cidrs;
+  cidrs.Insert(cidr, cidr);
 
   ConnTracker tracker;
   tracker.AddControlEvent(conn);
@@ -514,12 +518,14 @@ TEST_F(ConnTrackerTest, TrackerDisabledAfterMapping) {
 
     CIDRBlock cidr;
     ASSERT_OK(ParseCIDRBlock("1.2.3.4/14", &cidr));
+    CIDRIndex<CIDRBlock> cidrs;
+    cidrs.Insert(cidr, cidr);
 
     ConnTracker tracker;
     tracker.AddControlEvent(conn);
     tracker.SetProtocol(kProtocolHTTP, "testing");
     tracker.SetRole(kRoleClient, "testing");
-    tracker.IterationPreTick(now_, {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+    tracker.IterationPreTick(now_, cidrs, /*proc_parser*/ nullptr, /*connections*/ nullptr);
     EXPECT_EQ(ConnTracker::State::kDisabled, tracker.state())
         << "Got: " << magic_enum::enum_name(tracker.state());
   }
@@ -530,12 +536,14 @@ TEST_F(ConnTrackerTest, TrackerDisabledAfterMapping) {
 
     CIDRBlock cidr;
     ASSERT_OK(ParseCIDRBlock("::ffff:1.2.3.4/120", &cidr));
+    CIDRIndex<CIDRBlock> cidrs;
+    cidrs.Insert(cidr, cidr);
 
     ConnTracker tracker;
     tracker.AddControlEvent(conn);
     tracker.SetProtocol(kProtocolHTTP, "testing");
     tracker.SetRole(kRoleClient, "testing");
-    tracker.IterationPreTick(now_, {cidr}, /*proc_parser*/ nullptr, /*connections*/ nullptr);
+    tracker.IterationPreTick(now_, cidrs, /*proc_parser*/ nullptr, /*connections*/ nullptr);
     EXPECT_EQ(ConnTracker::State::kDisabled, tracker.state())
         << "Got: " << magic_enum::enum_name(tracker.state());
   }
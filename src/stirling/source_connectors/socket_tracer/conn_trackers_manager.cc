@@ -21,6 +21,9 @@
 DEFINE_double(
     stirling_conn_tracker_cleanup_threshold, 0.2,
     "Percentage of trackers that are ready for destruction that will trigger a memory cleanup");
+DEFINE_double(stirling_socket_tracer_cpu_budget, 0,
+              "Fraction of a CPU core that the Stirling thread may use before the socket tracer "
+              "starts shedding load by sampling connections. A value of 0 disables load shedding.");
 
 namespace px {
 namespace stirling {
@@ -109,6 +112,13 @@ constexpr size_t kMaxConnTrackerPoolSize = 2048;
 
 uint64_t GetConnMapKey(uint32_t pid, int32_t fd) { return (static_cast<uint64_t>(pid) << 32) | fd; }
 
+// Sampling rates go down to 1/2^kMaxLoadSheddingLevel.
+constexpr int kMaxLoadSheddingLevel = 6;
+
+// The sampling rate is only raised again once CPU usage drops below this fraction of the budget,
+// to avoid oscillating around the budget.
+constexpr double kLoadSheddingRecoveryFraction = 0.5;
+
 }  // namespace
 
 ConnTrackersManager::ConnTrackersManager() : trackers_pool_(kMaxConnTrackerPoolSize) {}
@@ -159,6 +169,7 @@ void ConnTrackersManager::CleanupTrackers() {
     while (iter != active_trackers_.end()) {
       const auto& tracker = *iter;
       if (tracker->ReadyForDestruction()) {
+        AccumulateDataStats(*tracker, &retired_data_stats_);
         active_trackers_.erase(iter++);
         stats_.Increment(StatKey::kReadyForDestruction);
       } else {
@@ -218,7 +229,60 @@ std::string ConnTrackersManager::DebugInfo() const {
 }
 
 std::string ConnTrackersManager::StatsString() const {
-  return absl::StrCat(stats_.Print(), protocol_stats_.Print());
+  return absl::StrCat(stats_.Print(), protocol_stats_.Print(),
+                      absl::Substitute("sampling_rate=$0", sampling_rate()));
+}
+
+void ConnTrackersManager::AccumulateDataStats(const ConnTracker& tracker,
+                                              ProtocolDataStats* stats) {
+  using CTStatKey = ConnTracker::StatKey;
+
+  auto& protocol_stats = (*stats)[tracker.protocol()];
+  protocol_stats.Increment(DataStatKey::kBytesCaptured,
+                           tracker.GetStat(CTStatKey::kBytesSentTransferred) +
+                               tracker.GetStat(CTStatKey::kBytesRecvTransferred));
+  protocol_stats.Increment(DataStatKey::kBytesParsed, tracker.send_data().stat_frame_bytes() +
+                                                          tracker.recv_data().stat_frame_bytes());
+  protocol_stats.Increment(DataStatKey::kBytesDiscarded,
+                           tracker.send_data().stat_discarded_bytes() +
+                               tracker.recv_data().stat_discarded_bytes());
+  protocol_stats.Increment(DataStatKey::kBytesDropped,
+                           tracker.send_data().stat_dropped_bytes() +
+                               tracker.recv_data().stat_dropped_bytes());
+  protocol_stats.Increment(DataStatKey::kRecords, tracker.GetStat(CTStatKey::kValidRecords));
+}
+
+ConnTrackersManager::ProtocolDataStats ConnTrackersManager::ComputeProtocolDataStats() const {
+  ProtocolDataStats stats = retired_data_stats_;
+  for (const auto* tracker : active_trackers_) {
+    AccumulateDataStats(*tracker, &stats);
+  }
+  return stats;
+}
+
+void ConnTrackersManager::UpdateLoadShedding(double cpu_utilization) {
+  const double cpu_budget = FLAGS_stirling_socket_tracer_cpu_budget;
+  if (cpu_budget <= 0) {
+    load_shedding_level_ = 0;
+    return;
+  }
+
+  const int prev_level = load_shedding_level_;
+  if (cpu_utilization > cpu_budget) {
+    load_shedding_level_ = std::min(load_shedding_level_ + 1, kMaxLoadSheddingLevel);
+  } else if (cpu_utilization < cpu_budget * kLoadSheddingRecoveryFraction) {
+    load_shedding_level_ = std::max(load_shedding_level_ - 1, 0);
+  }
+
+  LOG_IF(INFO, load_shedding_level_ != prev_level) << absl::Substitute(
+      "Socket tracer CPU utilization is $0 (budget=$1). Connection sampling rate is now $2.",
+      cpu_utilization, cpu_budget, sampling_rate());
+}
+
+bool ConnTrackersManager::ShouldSample(const struct conn_id_t& conn_id) const {
+  // Keep the connections whose low load_shedding_level_ hash bits are all zero.
+  // Raising the level only ever removes connections from the kept set.
+  return (conn_id_sampling_hash(&conn_id) & sampling_mask()) == 0;
 }
 
 void ConnTrackersManager::ComputeProtocolStats() {
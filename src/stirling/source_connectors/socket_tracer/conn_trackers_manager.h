@@ -26,11 +26,14 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/stirling/source_connectors/socket_tracer/conn_tracker.h"
 #include "src/stirling/utils/obj_pool.h"
 #include "src/stirling/utils/stat_counter.h"
 
 DECLARE_double(stirling_conn_tracker_cleanup_threshold);
+DECLARE_double(stirling_socket_tracer_cpu_budget);
 
 namespace px {
 namespace stirling {
@@ -97,6 +100,24 @@ class ConnTrackersManager {
     kDestroyedGens,
   };
 
+  // Per-protocol counters of what happens to the data captured by BPF.
+  enum class DataStatKey {
+    // Bytes transferred from BPF to user-space.
+    kBytesCaptured,
+    // Bytes that the user-space parsers turned into frames.
+    kBytesParsed,
+    // Bytes dropped by the parsers without producing frames: skipped while resyncing to a frame
+    // boundary, unparseable, or cut off by a gap in the stream.
+    kBytesDiscarded,
+    // Bytes dropped before reaching the parsers: overflowed the connection's data buffer, or
+    // flushed when the tracker was reset.
+    kBytesDropped,
+    // Records produced from the parsed frames.
+    kRecords,
+  };
+
+  using ProtocolDataStats = absl::flat_hash_map<TrafficProtocol, utils::StatCounter<DataStatKey>>;
+
   ConnTrackersManager();
 
   /**
@@ -135,10 +156,51 @@ class ConnTrackersManager {
    */
   std::string StatsString() const;
 
+  /**
+   * Returns the per-protocol data counters, accumulated since the beginning of tracing over all
+   * trackers, including the ones that were already destroyed.
+   */
+  ProtocolDataStats ComputeProtocolDataStats() const;
+
+  /**
+   * Adjusts the connection sampling rate to keep the socket tracer within its CPU budget
+   * (see --stirling_socket_tracer_cpu_budget). The rate is halved for every iteration over
+   * the budget, and doubled again once usage falls well below it.
+   *
+   * @param cpu_utilization Fraction of a CPU core used by the Stirling thread since the last call.
+   */
+  void UpdateLoadShedding(double cpu_utilization);
+
+  /**
+   * Returns true if the connection should be traced under the current sampling rate.
+   *
+   * The decision is a deterministic function of the conn_id, and the connections kept at a lower
+   * sampling rate are a subset of those kept at a higher rate. So the rate reported by
+   * sampling_rate() is exactly the probability of a connection being traced, which lets the
+   * query side scale counts accordingly.
+   */
+  bool ShouldSample(const struct conn_id_t& conn_id) const;
+
+  /**
+   * The mask that BPF applies to conn_id_sampling_hash() to sample connections, see
+   * kSamplingMaskIndex. BPF drops the data of connections that are not sampled before it reaches
+   * the perf buffers, so their trackers keep the frames they already parsed and resync to the
+   * stream once the sampling rate recovers.
+   */
+  uint64_t sampling_mask() const { return (1ULL << load_shedding_level_) - 1; }
+
+  /**
+   * The fraction of connections that are currently traced. Always a power of 1/2.
+   */
+  double sampling_rate() const { return 1.0 / (1ULL << load_shedding_level_); }
+
  private:
   // Simple consistency DCHECKs meant for enforcing invariants.
   void DebugChecks() const;
 
+  // Adds the data counters of the tracker into stats, under the tracker's protocol.
+  static void AccumulateDataStats(const ConnTracker& tracker, ProtocolDataStats* stats);
+
   // A map from conn_id (PID+FD+TSID) to tracker. This is for easy update on BPF events.
   // Structured as two nested maps to be explicit about "generations" of trackers per PID+FD.
   // Key is {PID, FD} for outer map, and tsid for inner map.
@@ -153,6 +215,13 @@ class ConnTrackersManager {
   // Records statistics of ConnTracker for reporting and consistency check.
   utils::StatCounter<StatKey> stats_;
   utils::StatCounter<TrafficProtocol> protocol_stats_;
+
+  // Data counters of trackers that are no longer active. Trackers stop processing data once they
+  // leave active_trackers_, so their counters are final at that point.
+  ProtocolDataStats retired_data_stats_;
+
+  // Connections are sampled at a rate of 1/2^load_shedding_level_.
+  int load_shedding_level_ = 0;
 };
 
 }  // namespace stirling
@@ -16,10 +16,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 #include "src/common/testing/testing.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_trackers_manager.h"
+#include "src/stirling/source_connectors/socket_tracer/testing/event_generator.h"
 
 namespace px {
 namespace stirling {
@@ -111,13 +114,115 @@ TEST_F(ConnTrackersManagerTest, DebugInfo) {
             "kCreated=1 kDestroyed=0 kDestroyedGens=0 "
             "kProtocolUnknown=0 kProtocolHTTP=0 kProtocolHTTP2=0 kProtocolMySQL=0 kProtocolCQL=0 "
             "kProtocolPGSQL=0 kProtocolDNS=0 kProtocolRedis=0 kProtocolNATS=0 kProtocolMongo=0 "
-            "kProtocolKafka=0 kNumProtocols=0 \n"
+            "kProtocolKafka=0 kNumProtocols=0 sampling_rate=1\n"
             "Detailed statistics of individual ConnTracker:\n"
             "  conn_tracker=conn_id=[pid=1 start_time_ticks=1 fd=1 gen=1] state=kCollecting "
             "remote_addr=-:-1 role=kRoleUnknown protocol=kProtocolUnknown zombie=false "
             "ready_for_destruction=false\n"));
 }
 
+// Tests that connection sampling follows the CPU budget, and that the sampled connections are
+// kept consistently as the sampling rate changes.
+TEST_F(ConnTrackersManagerTest, LoadShedding) {
+  FLAGS_stirling_socket_tracer_cpu_budget = 0.1;
+
+  std::vector<struct conn_id_t> conn_ids;
+  for (int i = 0; i < 4096; ++i) {
+    struct conn_id_t conn_id = {};
+    conn_id.upid.pid = 1 + i / 64;
+    conn_id.upid.start_time_ticks = 1;
+    conn_id.fd = i % 64;
+    conn_id.tsid = 1;
+    conn_ids.push_back(conn_id);
+  }
+
+  auto count_sampled = [&]() {
+    return static_cast<size_t>(
+        std::count_if(conn_ids.begin(), conn_ids.end(),
+                      [&](const auto& conn_id) { return trackers_mgr_.ShouldSample(conn_id); }));
+  };
+
+  // Under budget: everything is traced.
+  trackers_mgr_.UpdateLoadShedding(0.05);
+  EXPECT_EQ(trackers_mgr_.sampling_rate(), 1.0);
+  EXPECT_EQ(count_sampled(), conn_ids.size());
+
+  // Over budget: the sampling rate halves every iteration.
+  trackers_mgr_.UpdateLoadShedding(0.2);
+  EXPECT_EQ(trackers_mgr_.sampling_rate(), 0.5);
+  std::vector<bool> sampled_at_half;
+  for (const auto& conn_id : conn_ids) {
+    sampled_at_half.push_back(trackers_mgr_.ShouldSample(conn_id));
+  }
+
+  trackers_mgr_.UpdateLoadShedding(0.2);
+  EXPECT_EQ(trackers_mgr_.sampling_rate(), 0.25);
+  EXPECT_NEAR(1.0 * count_sampled() / conn_ids.size(), 0.25, 0.05);
+  for (size_t i = 0; i < conn_ids.size(); ++i) {
+    if (trackers_mgr_.ShouldSample(conn_ids[i])) {
+      EXPECT_TRUE(sampled_at_half[i]);
+    }
+  }
+
+  // Between the recovery threshold and the budget: no change.
+  trackers_mgr_.UpdateLoadShedding(0.08);
+  EXPECT_EQ(trackers_mgr_.sampling_rate(), 0.25);
+
+  // Well below budget: the sampling rate recovers.
+  trackers_mgr_.UpdateLoadShedding(0.01);
+  EXPECT_EQ(trackers_mgr_.sampling_rate(), 0.5);
+
+  // The mask handed to BPF keeps exactly the sampled connections.
+  EXPECT_EQ(trackers_mgr_.sampling_mask(), 1);
+  for (const auto& conn_id : conn_ids) {
+    EXPECT_EQ((conn_id_sampling_hash(&conn_id) & trackers_mgr_.sampling_mask()) == 0,
+              trackers_mgr_.ShouldSample(conn_id));
+  }
+
+  // Once the sampling rate fully recovers, all the connections are traced again.
+  trackers_mgr_.UpdateLoadShedding(0.01);
+  EXPECT_EQ(trackers_mgr_.sampling_rate(), 1.0);
+  EXPECT_EQ(trackers_mgr_.sampling_mask(), 0);
+  EXPECT_EQ(count_sampled(), conn_ids.size());
+
+  FLAGS_stirling_socket_tracer_cpu_budget = 0;
+}
+
+// Tests that the per protocol data stats account for the bytes captured and parsed by the
+// trackers, and for the records they produce.
+TEST_F(ConnTrackersManagerTest, ProtocolDataStats) {
+  using DataStatKey = ConnTrackersManager::DataStatKey;
+
+  testing::RealClock real_clock;
+  testing::EventGenerator event_gen(&real_clock);
+  struct socket_control_event_t conn = event_gen.InitConn();
+
+  ConnTracker& tracker = trackers_mgr_.GetOrCreateConnTracker(conn.conn_id);
+  tracker.AddControlEvent(conn);
+  tracker.AddDataEvent(event_gen.InitSendEvent<kProtocolHTTP>(testing::kHTTPReq0));
+  tracker.AddDataEvent(event_gen.InitRecvEvent<kProtocolHTTP>(testing::kHTTPResp0));
+  const int64_t total_bytes = testing::kHTTPReq0.size() + testing::kHTTPResp0.size();
+
+  // Nothing is parsed until the tracker processes its data.
+  {
+    ConnTrackersManager::ProtocolDataStats stats = trackers_mgr_.ComputeProtocolDataStats();
+    ASSERT_TRUE(stats.contains(kProtocolHTTP));
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kBytesCaptured), total_bytes);
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kBytesParsed), 0);
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kRecords), 0);
+  }
+
+  tracker.ProcessToRecords<protocols::http::ProtocolTraits>();
+
+  {
+    ConnTrackersManager::ProtocolDataStats stats = trackers_mgr_.ComputeProtocolDataStats();
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kBytesCaptured), total_bytes);
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kBytesParsed), total_bytes);
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kBytesDiscarded), 0);
+    EXPECT_EQ(stats[kProtocolHTTP].Get(DataStatKey::kRecords), 1);
+  }
+}
+
 class ConnTrackerGenerationsTest : public ::testing::Test {
  protected:
   ConnTrackerGenerationsTest() : tracker_pool(1024) {
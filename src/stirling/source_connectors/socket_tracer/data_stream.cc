@@ -18,6 +18,7 @@
 
 #include "src/stirling/source_connectors/socket_tracer/data_stream.h"
 
+#include <type_traits>
 #include <utility>
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/types.h"
@@ -27,12 +28,12 @@ DEFINE_uint32(datastream_buffer_size, 1024 * 1024, "The maximum size of a data s
 namespace px {
 namespace stirling {
 
-void DataStream::AddData(std::unique_ptr<SocketDataEvent> event) {
-  LOG_IF(WARNING, event->attr.msg_size > event->msg.size() && !event->msg.empty())
+void DataStream::AddData(const SocketDataEvent& event) {
+  LOG_IF(WARNING, event.attr.msg_size > event.msg.size() && !event.msg.empty())
       << absl::Substitute("Message truncated, original size: $0, transferred size: $1",
-                          event->attr.msg_size, event->msg.size());
+                          event.attr.msg_size, event.msg.size());
 
-  data_buffer_.Add(event->attr.pos, event->msg, event->attr.timestamp_ns);
+  data_buffer_.Add(event.attr.pos, event.msg, event.attr.timestamp_ns);
 
   has_new_events_ = true;
 }
@@ -78,7 +79,7 @@ bool IsSyncRequired(int64_t stuck_count) {
 // To be robust to lost events, which are not necessarily aligned to parseable entity boundaries,
 // ProcessBytesToFrames() will invoke a call to ParseFrames() with a stream recovery argument when
 // necessary.
-template <typename TFrameType, typename TStateType = protocols::NoState>
+template <typename TFrameType, typename TStateType, typename TPartialFrameStateType>
 void DataStream::ProcessBytesToFrames(MessageType type, TStateType* state) {
   auto& typed_messages = Frames<TFrameType>();
 
@@ -87,6 +88,13 @@ void DataStream::ProcessBytesToFrames(MessageType type, TStateType* state) {
 
   const size_t orig_pos = data_buffer_.position();
 
+  // The partial frame state is only meaningful for the exact head it was recorded against.
+  // The head may have moved since the last call (e.g. when the buffer drops old data to stay
+  // within its capacity), in which case parsing has to start over.
+  if (orig_pos != partial_frame_state_pos_) {
+    partial_frame_state_ = std::monostate();
+  }
+
   // A description of some key variables in this function:
   //
   // - stuck_count_: Number of calls to where no new frames were produced.
@@ -120,15 +128,33 @@ void DataStream::ProcessBytesToFrames(MessageType type, TStateType* state) {
     size_t contiguous_bytes = data_buffer_.Head().size();
 
     // Now parse the raw data.
-    parse_result = protocols::ParseFrames(type, data_buffer_, &typed_messages,
-                                          IsSyncRequired(stuck_count_), state);
+    if constexpr (std::is_same_v<TPartialFrameStateType, protocols::NoPartialFrameState>) {
+      parse_result = protocols::ParseFrames(type, data_buffer_, &typed_messages,
+                                            IsSyncRequired(stuck_count_), state);
+    } else {
+      // The parser takes a single state, so a protocol that resumes partial frames can't also
+      // have a protocol state.
+      static_assert(std::is_same_v<TStateType, protocols::NoState>);
+      PL_UNUSED(state);
+      parse_result = protocols::ParseFrames(type, data_buffer_, &typed_messages,
+                                            IsSyncRequired(stuck_count_),
+                                            PartialFrameState<TPartialFrameStateType>());
+    }
+
+    size_t frame_bytes = 0;
+    for (const auto& pos : parse_result.frame_positions) {
+      frame_bytes += pos.end - pos.start + 1;
+    }
+    stat_frame_bytes_ += frame_bytes;
 
     if (contiguous_bytes != data_buffer_.size()) {
       // We weren't able to submit all bytes, which means we ran into a missing event.
       // We don't expect missing events to arrive in the future, so just cut our losses.
       // Drop all events up to this point, and then try to resume.
+      stat_discarded_bytes_ += contiguous_bytes - frame_bytes;
       data_buffer_.RemovePrefix(contiguous_bytes);
       data_buffer_.Trim();
+      partial_frame_state_ = std::monostate();
 
       // Update stuck count so we use the correct sync type on the next iteration.
       stuck_count_ = 0;
@@ -139,6 +165,8 @@ void DataStream::ProcessBytesToFrames(MessageType type, TStateType* state) {
       // Erase bytes that have been fully processed.
       // If anything was processed at all, reset stuck count.
       if (parse_result.end_position != 0) {
+        // Consumed bytes that are not part of a frame were skipped over while resyncing.
+        stat_discarded_bytes_ += parse_result.end_position - frame_bytes;
         data_buffer_.RemovePrefix(parse_result.end_position);
         stuck_count_ = 0;
       }
@@ -169,10 +197,14 @@ void DataStream::ProcessBytesToFrames(MessageType type, TStateType* state) {
     // Alternative is to find the next frame boundary, rather than discarding all data.
 
     // TODO(oazizi): A dedicated data_buffer_.Flush() implementation would be more efficient.
+    stat_discarded_bytes_ += data_buffer_.size();
     data_buffer_.RemovePrefix(data_buffer_.size());
     stuck_count_ = 0;
+    partial_frame_state_ = std::monostate();
   }
 
+  partial_frame_state_pos_ = data_buffer_.position();
+
   last_parse_state_ = parse_result.state;
 
   // has_new_events_ should be false for the next transfer cycle.
@@ -182,6 +214,9 @@ void DataStream::ProcessBytesToFrames(MessageType type, TStateType* state) {
 // PROTOCOL_LIST: Requires update on new protocols.
 template void DataStream::ProcessBytesToFrames<protocols::http::Message, protocols::NoState>(
     MessageType type, protocols::NoState* state);
+template void DataStream::ProcessBytesToFrames<protocols::http::Message, protocols::NoState,
+                                               protocols::http::StreamParseState>(
+    MessageType type, protocols::NoState* state);
 template void
 DataStream::ProcessBytesToFrames<protocols::mysql::Packet, protocols::mysql::StateWrapper>(
     MessageType type, protocols::mysql::StateWrapper* state);
@@ -201,11 +236,14 @@ template void DataStream::ProcessBytesToFrames<protocols::nats::Message, protoco
     MessageType type, protocols::NoState* state);
 
 void DataStream::Reset() {
+  // Anything still buffered is dropped before the parser gets to it.
+  stat_dropped_bytes_ += data_buffer_.size();
   data_buffer_.Reset();
   has_new_events_ = false;
   stuck_count_ = 0;
 
   frames_ = std::monostate();
+  partial_frame_state_ = std::monostate();
 }
 
 }  // namespace stirling
@@ -23,6 +23,9 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <variant>
+
+#include <gtest/gtest_prod.h>
 
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/data_stream_buffer.h"
@@ -49,16 +52,20 @@ class DataStream : NotCopyMoveable {
 
   /**
    * Adds a raw (unparsed) chunk of data into the stream.
+   * The data is copied, so the event may be reused by the caller afterwards.
    */
-  void AddData(std::unique_ptr<SocketDataEvent> event);
+  void AddData(const SocketDataEvent& event);
+  void AddData(std::unique_ptr<SocketDataEvent> event) { AddData(*event); }
 
   /**
    * Parses as many messages as it can from the raw events into the messages container.
    * @tparam TFrameType The parsed message type within the deque.
+   * @tparam TPartialFrameStateType The protocol's ProtocolTraits::partial_frame_state_type.
    * @param type whether to parse as requests, responses or mixed traffic.
    * @return deque of parsed messages.
    */
-  template <typename TFrameType, typename TStateType>
+  template <typename TFrameType, typename TStateType,
+            typename TPartialFrameStateType = protocols::NoPartialFrameState>
   void ProcessBytesToFrames(MessageType type, TStateType* state);
 
   /**
@@ -136,6 +143,9 @@ class DataStream : NotCopyMoveable {
   int stat_invalid_frames() const { return stat_invalid_frames_; }
   int stat_valid_frames() const { return stat_valid_frames_; }
   int stat_raw_data_gaps() const { return stat_raw_data_gaps_; }
+  int64_t stat_frame_bytes() const { return stat_frame_bytes_; }
+  int64_t stat_discarded_bytes() const { return stat_discarded_bytes_; }
+  int64_t stat_dropped_bytes() const { return stat_dropped_bytes_ + data_buffer_.dropped_bytes(); }
 
   /**
    * Fraction of frame parsing attempts that resulted in an invalid frame.
@@ -199,6 +209,18 @@ class DataStream : NotCopyMoveable {
   const protocols::DataStreamBuffer& data_buffer() const { return data_buffer_; }
 
  private:
+  /**
+   * Returns the state of the partially parsed frame at the head of the stream,
+   * creating it on first use.
+   */
+  template <typename TPartialFrameStateType>
+  TPartialFrameStateType* PartialFrameState() {
+    if (!std::holds_alternative<TPartialFrameStateType>(partial_frame_state_)) {
+      partial_frame_state_ = TPartialFrameStateType();
+    }
+    return &std::get<TPartialFrameStateType>(partial_frame_state_);
+  }
+
   template <typename TFrameType>
   static void EraseExpiredFrames(
       std::chrono::time_point<std::chrono::steady_clock> expiry_timestamp,
@@ -232,6 +254,13 @@ class DataStream : NotCopyMoveable {
   // bug, so we add std::monostate as the default type. And switch to the right time in runtime.
   protocols::FrameDequeVariant frames_;
 
+  // Progress on the partially received frame at the head of data_buffer_, for protocols that can
+  // resume parsing a frame rather than starting over. Holds the ProtocolTraits'
+  // partial_frame_state_type, or std::monostate while there is no progress to resume from.
+  // Only valid while the head of data_buffer_ remains at partial_frame_state_pos_.
+  protocols::PartialFrameStateVariant partial_frame_state_;
+  size_t partial_frame_state_pos_ = 0;
+
   // The following state keeps track of whether the raw events were touched or not since the last
   // call to ProcessBytesToFrames(). It enables ProcessToRecords() to exit early if nothing has
   // changed.
@@ -248,11 +277,21 @@ class DataStream : NotCopyMoveable {
   int stat_invalid_frames_ = 0;
   int stat_raw_data_gaps_ = 0;
 
+  // Bytes that were parsed into frames, and bytes that the parser discarded without producing a
+  // frame (skipped to resync, invalid, or cut off by a gap in the stream).
+  int64_t stat_frame_bytes_ = 0;
+  int64_t stat_discarded_bytes_ = 0;
+  // Bytes that were flushed by Reset() before reaching the parser. Bytes that overflowed the data
+  // buffer are counted by the buffer itself.
+  int64_t stat_dropped_bytes_ = 0;
+
   // A copy of the parse state from the last call to ProcessToRecords().
   ParseState last_parse_state_ = ParseState::kInvalid;
 
   template <typename TFrameType>
   friend std::string DebugString(const DataStream& d, std::string_view prefix);
+
+  FRIEND_TEST(DataStreamTest, ResumesPartialHTTPMessage);
 };
 
 // Note: can't make DebugString a class member because of GCC restrictions.
@@ -83,6 +83,35 @@ TEST_F(DataStreamTest, LostEvent) {
   EXPECT_FALSE(stream.IsStuck());
 }
 
+// Tests that a single event object can be recycled across perf buffer submissions,
+// as done by SocketTraceConnector::HandleDataEvent().
+TEST_F(DataStreamTest, RecycledEvent) {
+  auto raw_event = std::make_unique<socket_data_event_t>();
+  SocketDataEvent event;
+  protocols::NoState state{};
+
+  DataStream stream;
+
+  size_t pos = 0;
+  for (std::string_view req : {kHTTPReq0, kHTTPReq1}) {
+    raw_event->attr.pos = pos;
+    raw_event->attr.msg_size = req.size();
+    raw_event->attr.msg_buf_size = req.size();
+    memcpy(raw_event->msg, req.data(), req.size());
+    pos += req.size();
+
+    event.Assign(raw_event.get());
+    EXPECT_EQ(event.msg, req);
+    stream.AddData(event);
+  }
+
+  stream.ProcessBytesToFrames<http::Message>(MessageType::kRequest, &state);
+  const auto& requests = stream.Frames<http::Message>();
+  ASSERT_THAT(requests, SizeIs(2));
+  EXPECT_EQ(requests[0].req_path, "/index.html");
+  EXPECT_EQ(requests[1].req_path, "/foo.html");
+}
+
 TEST_F(DataStreamTest, StuckTemporarily) {
   testing::EventGenerator event_gen(&real_clock_);
 
@@ -169,6 +198,10 @@ TEST_F(DataStreamTest, PartialMessageRecovery) {
   ASSERT_THAT(requests, SizeIs(2));
   EXPECT_EQ(requests[0].req_path, "/index.html");
   EXPECT_EQ(requests[1].req_path, "/bar.html");
+
+  // The partial request before the missing event could never be parsed, so it is discarded.
+  EXPECT_EQ(stream.stat_frame_bytes(), kHTTPReq0.length() + kHTTPReq2.length());
+  EXPECT_EQ(stream.stat_discarded_bytes(), kHTTPReq1.length() / 2);
 }
 
 TEST_F(DataStreamTest, HeadAndMiddleMissing) {
@@ -295,6 +328,97 @@ TEST_F(DataStreamTest, Stats) {
   EXPECT_EQ(stream.stat_raw_data_gaps(), 1);
   EXPECT_EQ(stream.stat_invalid_frames(), 2);
   EXPECT_EQ(stream.stat_valid_frames(), 5);
+
+  // Every byte that was added, except the missing req4, is either parsed, discarded or still
+  // buffered.
+  const size_t total_bytes = 2 * kHTTPReq0.length() + 3 * kHTTPReq1.length() +
+                             std::string_view("This is not a valid HTTP message").length() +
+                             std::string_view("Another malformed message").length();
+  EXPECT_EQ(stream.stat_frame_bytes(), 2 * kHTTPReq0.length() + 3 * kHTTPReq1.length());
+  EXPECT_EQ(stream.stat_frame_bytes() + stream.stat_discarded_bytes() + stream.data_buffer().size(),
+            total_bytes);
+}
+
+// Tests that the unparsed bytes flushed by Reset() are counted as dropped, not as discarded by
+// the parser.
+TEST_F(DataStreamTest, ResetDropsBufferedBytes) {
+  testing::EventGenerator event_gen(&real_clock_);
+  std::unique_ptr<SocketDataEvent> req0 = event_gen.InitSendEvent<kProtocolHTTP>(kHTTPReq0);
+  std::unique_ptr<SocketDataEvent> req1a =
+      event_gen.InitSendEvent<kProtocolHTTP>(kHTTPReq1.substr(0, kHTTPReq1.length() / 2));
+  protocols::NoState state{};
+
+  DataStream stream;
+  stream.AddData(std::move(req0));
+  stream.AddData(std::move(req1a));
+
+  // The partial request waits in the buffer for the rest of its bytes.
+  stream.ProcessBytesToFrames<http::Message>(MessageType::kRequest, &state);
+  EXPECT_THAT(stream.Frames<http::Message>(), SizeIs(1));
+  EXPECT_EQ(stream.stat_frame_bytes(), kHTTPReq0.length());
+  EXPECT_EQ(stream.stat_discarded_bytes(), 0);
+  EXPECT_EQ(stream.stat_dropped_bytes(), 0);
+  EXPECT_EQ(stream.data_buffer().size(), kHTTPReq1.length() / 2);
+
+  stream.Reset();
+  EXPECT_TRUE(stream.data_buffer().empty());
+  EXPECT_EQ(stream.stat_frame_bytes(), kHTTPReq0.length());
+  EXPECT_EQ(stream.stat_discarded_bytes(), 0);
+  EXPECT_EQ(stream.stat_dropped_bytes(), kHTTPReq1.length() / 2);
+}
+
+// Tests that a chunked response that arrives over several transfer cycles is resumed where the
+// previous cycle stopped, instead of being decoded from the start each time.
+TEST_F(DataStreamTest, ResumesPartialHTTPMessage) {
+  constexpr std::string_view kHeaders =
+      "HTTP/1.1 200 OK\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n";
+  constexpr std::string_view kBody0 = "5\r\npix";
+  constexpr std::string_view kBody1 = "ie\r\n3\r\nfo";
+  constexpr std::string_view kBody2 = "o\r\n0\r\n\r\n";
+
+  testing::EventGenerator event_gen(&real_clock_);
+  std::unique_ptr<SocketDataEvent> resp0 =
+      event_gen.InitRecvEvent<kProtocolHTTP>(absl::StrCat(kHeaders, kBody0));
+  std::unique_ptr<SocketDataEvent> resp1 = event_gen.InitRecvEvent<kProtocolHTTP>(kBody1);
+  std::unique_ptr<SocketDataEvent> resp2 = event_gen.InitRecvEvent<kProtocolHTTP>(kBody2);
+  protocols::NoState state{};
+
+  DataStream stream;
+  auto process = [&]() {
+    stream.ProcessBytesToFrames<http::Message, protocols::NoState, http::StreamParseState>(
+        MessageType::kResponse, &state);
+  };
+
+  stream.AddData(std::move(resp0));
+  process();
+  EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+  auto* partial = std::get_if<http::StreamParseState>(&stream.partial_frame_state_);
+  ASSERT_NE(partial, nullptr);
+  EXPECT_TRUE(partial->headers_complete);
+  EXPECT_EQ(partial->chunked_body_consumed_bytes, kBody0.size());
+  EXPECT_EQ(partial->message.body, "pix");
+
+  // Only the new bytes are fed to the chunk decoder.
+  stream.AddData(std::move(resp1));
+  process();
+  EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+  partial = std::get_if<http::StreamParseState>(&stream.partial_frame_state_);
+  ASSERT_NE(partial, nullptr);
+  EXPECT_EQ(partial->chunked_body_consumed_bytes, kBody0.size() + kBody1.size());
+  EXPECT_EQ(partial->message.body, "pixiefo");
+
+  stream.AddData(std::move(resp2));
+  process();
+  const auto& responses = stream.Frames<http::Message>();
+  ASSERT_THAT(responses, SizeIs(1));
+  EXPECT_EQ(responses[0].resp_status, 200);
+  EXPECT_EQ(responses[0].body, "pixiefoo");
+  EXPECT_TRUE(stream.data_buffer().empty());
+  EXPECT_EQ(stream.stat_frame_bytes(),
+            kHeaders.size() + kBody0.size() + kBody1.size() + kBody2.size());
+  EXPECT_TRUE(std::holds_alternative<std::monostate>(stream.partial_frame_state_));
 }
 
 TEST_F(DataStreamTest, Stress) {
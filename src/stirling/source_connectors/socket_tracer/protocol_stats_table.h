@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "src/stirling/core/types.h"
+#include "src/stirling/source_connectors/socket_tracer/canonical_types.h"
+
+namespace px {
+namespace stirling {
+
+// clang-format off
+constexpr DataElement kProtocolStatsElements[] = {
+        canonical_data_elements::kTime,
+        {"protocol", "The protocol that the traced connections were inferred to carry.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::GENERAL_ENUM,
+         &kTrafficProtocolDecoder},
+        {"bytes_captured", "The number of bytes transferred from the kernel to user-space.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_COUNTER},
+        {"bytes_parsed", "The number of captured bytes that were parsed into frames.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_COUNTER},
+        {"bytes_discarded", "The number of captured bytes that were discarded without producing "
+         "frames, because they were unparseable or skipped to resync the stream.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_COUNTER},
+        {"bytes_dropped", "The number of captured bytes that were dropped before being parsed, "
+         "because they overflowed the connection's data buffer or were flushed when the "
+         "connection was reset.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_COUNTER},
+        {"records", "The number of records produced from the parsed frames.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_COUNTER},
+        {"sampling_rate", "The fraction of connections currently traced, as lowered by load "
+         "shedding when the socket tracer exceeds its CPU budget. Divide counts from the "
+         "protocol tables by it to estimate the true counts.",
+         types::DataType::FLOAT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE},
+};
+// clang-format on
+
+constexpr DataTableSchema kProtocolStatsTable(
+    "stirling_protocol_stats",
+    "Stirling internal stats on how the socket tracer uses the data it captures, per protocol. "
+    "Protocols with many bytes captured but few parsed waste capture bandwidth, and are "
+    "candidates for being disabled.",
+    kProtocolStatsElements);
+DEFINE_PRINT_TABLE(ProtocolStats)
+
+namespace protocol_stats_idx {
+
+constexpr int kTime = kProtocolStatsTable.ColIndex("time_");
+constexpr int kProtocol = kProtocolStatsTable.ColIndex("protocol");
+constexpr int kBytesCaptured = kProtocolStatsTable.ColIndex("bytes_captured");
+constexpr int kBytesParsed = kProtocolStatsTable.ColIndex("bytes_parsed");
+constexpr int kBytesDiscarded = kProtocolStatsTable.ColIndex("bytes_discarded");
+constexpr int kBytesDropped = kProtocolStatsTable.ColIndex("bytes_dropped");
+constexpr int kRecords = kProtocolStatsTable.ColIndex("records");
+constexpr int kSamplingRate = kProtocolStatsTable.ColIndex("sampling_rate");
+
+}  // namespace protocol_stats_idx
+
+}  // namespace stirling
+}  // namespace px
@@ -106,11 +106,23 @@ void DataStreamBuffer::AddNewTimestamp(size_t pos, uint64_t timestamp) {
   timestamps_[pos] = timestamp;
 }
 
+size_t DataStreamBuffer::PopulatedBytesBefore(size_t end_pos) const {
+  size_t bytes = 0;
+  for (const auto& [chunk_pos, chunk_size] : chunks_) {
+    if (chunk_pos >= end_pos) {
+      break;
+    }
+    bytes += std::min(chunk_pos + chunk_size, end_pos) - chunk_pos;
+  }
+  return bytes;
+}
+
 void DataStreamBuffer::Add(size_t pos, std::string_view data, uint64_t timestamp) {
   if (data.size() > capacity_) {
     size_t oversize_amount = data.size() - capacity_;
     data.remove_prefix(oversize_amount);
     pos += oversize_amount;
+    dropped_bytes_ += oversize_amount;
   }
 
   // Calculate physical positions (ppos) where the data would live in the physical buffer.
@@ -126,6 +138,7 @@ void DataStreamBuffer::Add(size_t pos, std::string_view data, uint64_t timestamp
     VLOG(1) << absl::Substitute(
         "Ignoring event that has already been skipped [event pos=$0, current pos=$1].", pos,
         position_);
+    dropped_bytes_ += data.size();
     return;
   } else if (ppos_front < 0) {
     // Case 2: Data being added is straddling the front-side of the buffer. Cut-off the prefix.
@@ -135,6 +148,7 @@ void DataStreamBuffer::Add(size_t pos, std::string_view data, uint64_t timestamp
 
     ssize_t prefix = 0 - ppos_front;
     data.remove_prefix(prefix);
+    dropped_bytes_ += prefix;
     pos += prefix;
     ppos_front = 0;
   } else if (ppos_back > static_cast<ssize_t>(buffer_.size())) {
@@ -156,6 +170,8 @@ void DataStreamBuffer::Add(size_t pos, std::string_view data, uint64_t timestamp
 
       VLOG(1) << absl::Substitute("Event bytes to be dropped [count=$0].", remove_count);
 
+      // Only count the bytes that were populated; the rest of the prefix is gaps.
+      dropped_bytes_ += PopulatedBytesBefore(position_ + remove_count);
       RemovePrefix(remove_count);
       ppos_front -= remove_count;
       ppos_back -= remove_count;
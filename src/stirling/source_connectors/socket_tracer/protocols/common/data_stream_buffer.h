@@ -107,6 +107,12 @@ class DataStreamBuffer {
    */
   size_t position() const { return position_; }
 
+  /**
+   * Number of added bytes that the buffer dropped without them being consumed, because they fell
+   * behind its head or outside its capacity. Monotonic; not cleared by Reset().
+   */
+  size_t dropped_bytes() const { return dropped_bytes_; }
+
   std::string DebugInfo() const;
 
   /**
@@ -120,6 +126,9 @@ class DataStreamBuffer {
   void AddNewChunk(size_t pos, size_t size);
   void AddNewTimestamp(size_t pos, uint64_t timestamp);
 
+  // Number of populated bytes between the head of the buffer and end_pos.
+  size_t PopulatedBytesBefore(size_t end_pos) const;
+
   void CleanupTimestamps();
   void CleanupChunks();
 
@@ -145,6 +154,9 @@ class DataStreamBuffer {
   // Unlike chunks_, which will fuse when adjacent, timestamps never fuse.
   // Also, we don't track gaps in the buffer with timestamps; must use chunks_ for that.
   std::map<size_t, uint64_t> timestamps_;
+
+  // See dropped_bytes().
+  size_t dropped_bytes_ = 0;
 };
 
 }  // namespace protocols
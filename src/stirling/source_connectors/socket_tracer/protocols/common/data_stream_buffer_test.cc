@@ -291,6 +291,38 @@ TEST(DataStreamTest, SizeAndGetPos) {
   EXPECT_FALSE(stream_buffer.empty());
 }
 
+// Tests that bytes dropped to keep the buffer within its capacity are counted, but gaps are not.
+TEST(DataStreamTest, DroppedBytes) {
+  DataStreamBuffer stream_buffer(15);
+
+  stream_buffer.Add(0, "0123", 0);
+  stream_buffer.Add(8, "89", 8);
+  EXPECT_EQ(stream_buffer.dropped_bytes(), 0);
+
+  // Moves the head to position 7: "0123" falls off, the gap at 4-6 is not counted.
+  stream_buffer.Add(20, "kl", 20);
+  EXPECT_EQ(stream_buffer.position(), 7);
+  EXPECT_EQ(stream_buffer.dropped_bytes(), 4);
+
+  // Straddles the head: only the part behind it is dropped.
+  stream_buffer.Add(6, "67", 6);
+  EXPECT_EQ(stream_buffer.dropped_bytes(), 5);
+
+  // Entirely behind the head.
+  stream_buffer.Add(0, "01", 0);
+  EXPECT_EQ(stream_buffer.dropped_bytes(), 7);
+
+  // Larger than the capacity: the 5 oversized bytes are dropped, and so are the 5 populated
+  // bytes ("789" and "kl") that the new data pushes out.
+  stream_buffer.Add(100, "abcdefghijklmnopqrst", 100);
+  EXPECT_EQ(stream_buffer.dropped_bytes(), 17);
+
+  // Consumed bytes are not dropped, and the count survives a Reset().
+  stream_buffer.RemovePrefix(stream_buffer.size());
+  stream_buffer.Reset();
+  EXPECT_EQ(stream_buffer.dropped_bytes(), 17);
+}
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -52,6 +52,10 @@ struct RecordsWithErrorCount {
 // - record_type: This is the request response pair, the content of which has been interpreted.
 //                This struct will be passed to the SocketTraceConnector to be appended to the
 //                appropriate table.
+// - partial_frame_state_type: The progress on a partially received frame, kept per DataStream
+//                             so that the parser can resume the frame on the next call instead
+//                             of starting over. A convenience NoPartialFrameState struct is
+//                             defined for protocols that always parse frames from the start.
 //
 // Example for HTTP protocol:
 //
@@ -60,6 +64,7 @@ struct RecordsWithErrorCount {
 //   using frame_type = Message;
 //   using record_type = Record;
 //   using state_type = NoState;
+//   using partial_frame_state_type = StreamParseState;
 // };
 // }
 //
@@ -75,6 +80,11 @@ struct NoState {
   std::monostate recv;
 };
 
+// Setting ProtocolTraits::partial_frame_state_type to NoPartialFrameState indicates that the
+// protocol does not resume partially received frames. The parser is then handed the protocol
+// state instead.
+struct NoPartialFrameState {};
+
 // NOTE: FindFrameBoundary(), ParseFrame(), and StitchFrames() must be implemented per protocol.
 
 /**
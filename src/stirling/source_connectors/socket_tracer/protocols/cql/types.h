@@ -157,6 +157,7 @@ struct ProtocolTraits {
   using frame_type = Frame;
   using record_type = Record;
   using state_type = NoState;
+  using partial_frame_state_type = NoPartialFrameState;
 };
 
 }  // namespace cass
@@ -57,33 +57,43 @@ namespace {
 //               this needs to be done in a way that doesn't mess up the rest of
 //               the parsing, since there will be "unused" bytes at the end of the
 //               chunk, but before the rest of the data in the DataStreamBuffer.
-//               Note that the copy is not overhead when a complete message is found,
-//               since the data is std::moved to the result.
-ParseState ParseChunk(std::string_view* data, Message* result) {
-  phr_chunked_decoder chunk_decoder = {};
-  std::string data_copy(*data);
+//               Only the bytes that were not fed to the decoder on a previous attempt
+//               are copied, so each byte is copied at most once.
+ParseState ParseChunk(std::string_view* data, StreamParseState* state) {
+  if (state->chunked_body_consumed_bytes > data->size()) {
+    LOG(DFATAL) << "Chunked body progress is beyond the end of the buffer.";
+    return ParseState::kInvalid;
+  }
+
+  std::string data_copy(data->substr(state->chunked_body_consumed_bytes));
   char* buf = data_copy.data();
   size_t buf_size = data_copy.size();
-  ssize_t retval = phr_decode_chunked(&chunk_decoder, buf, &buf_size);
+  ssize_t retval = phr_decode_chunked(&state->chunk_decoder, buf, &buf_size);
   if (retval == -1) {
     // Parse failed.
     return ParseState::kInvalid;
-  } else if (retval >= 0) {
+  }
+
+  // phr_decode_chunked rewrites the buffer in place, removing chunked-encoding headers,
+  // and leaves buf_size set to the number of decoded bytes.
+  state->message.body.append(buf, buf_size);
+
+  if (retval == -2) {
+    // Incomplete message. The decoder has consumed all the bytes it was given,
+    // and remembers where it is within the chunk encoding.
+    state->chunked_body_consumed_bytes += data_copy.size();
+    return ParseState::kNeedsMoreData;
+  }
+
+  if (retval >= 0) {
     // Complete message.
-    data_copy.resize(buf_size);
-    result->body = std::move(data_copy);
-    // phr_decode_chunked rewrites the buffer in place, removing chunked-encoding headers.
-    // So we cannot simply remove the prefix, but rather have to shorten the buffer too.
-    // This is done via retval, which specifies how many unprocessed bytes are left.
-    data->remove_prefix(data->size() - retval);
+    // retval specifies how many unprocessed bytes are left at the end of the buffer.
+    data->remove_prefix(state->chunked_body_consumed_bytes + data_copy.size() - retval);
     // Pico claims that the last \r\n are unparsed, manually remove them.
     while (!data->empty() && (data->front() == '\r' || data->front() == '\n')) {
       data->remove_prefix(1);
     }
     return ParseState::kSuccess;
-  } else if (retval == -2) {
-    // Incomplete message.
-    return ParseState::kNeedsMoreData;
   }
   LOG(DFATAL) << "Unexpected retval from phr_decode_chunked()";
   return ParseState::kUnknown;
@@ -91,7 +101,9 @@ ParseState ParseChunk(std::string_view* data, Message* result) {
 
 }  // namespace
 
-ParseState ParseBody(std::string_view* buf, Message* result) {
+ParseState ParseBody(std::string_view* buf, StreamParseState* state) {
+  Message* result = &state->message;
+
   // Try to find boundary of message by looking at Content-Length and Transfer-Encoding.
 
   // From https://tools.ietf.org/html/rfc7230:
@@ -130,7 +142,7 @@ ParseState ParseBody(std::string_view* buf, Message* result) {
   const auto transfer_encoding_iter = result->headers.find(kTransferEncoding);
   if (transfer_encoding_iter != result->headers.end() &&
       transfer_encoding_iter->second == "chunked") {
-    return ParseChunk(buf, result);
+    return ParseChunk(buf, state);
   }
 
   // Case 3: Message has content, but no Content-Length or Transfer-Encoding.
@@ -200,8 +212,12 @@ ParseState ParseBody(std::string_view* buf, Message* result) {
   return ParseState::kInvalid;
 }
 
-ParseState ParseRequest(std::string_view* buf, Message* result) {
-  // Fields populated by phr_parse_response.
+namespace {
+
+// Parses the request line and headers into state->message.
+// Returns the number of header bytes consumed, -1 on invalid input, or -2 on partial input.
+int ParseRequestHeaders(std::string_view buf, StreamParseState* state) {
+  // Fields populated by phr_parse_request.
   const char* method = nullptr;
   size_t method_len;
   const char* path = nullptr;
@@ -215,27 +231,22 @@ ParseState ParseRequest(std::string_view* buf, Message* result) {
   size_t num_headers = kMaxNumHeaders;
 
   const int retval =
-      phr_parse_request(buf->data(), buf->size(), &method, &method_len, &path, &path_len,
-                        &minor_version, headers, &num_headers, /*last_len*/ 0);
+      phr_parse_request(buf.data(), buf.size(), &method, &method_len, &path, &path_len,
+                        &minor_version, headers, &num_headers, state->headers_scanned_bytes);
   if (retval >= 0) {
-    buf->remove_prefix(retval);
-
+    Message* result = &state->message;
     result->type = MessageType::kRequest;
     result->minor_version = minor_version;
     result->headers = GetHTTPHeadersMap(headers, num_headers);
     result->req_method = std::string(method, method_len);
     result->req_path = std::string(path, path_len);
-    result->headers_byte_size = retval;
-
-    return ParseBody(buf, result);
-  }
-  if (retval == -2) {
-    return ParseState::kNeedsMoreData;
   }
-  return ParseState::kInvalid;
+  return retval;
 }
 
-ParseState ParseResponse(std::string_view* buf, Message* result) {
+// Parses the status line and headers into state->message.
+// Returns the number of header bytes consumed, -1 on invalid input, or -2 on partial input.
+int ParseResponseHeaders(std::string_view buf, StreamParseState* state) {
   // Fields populated by phr_parse_response.
   const char* msg = nullptr;
   size_t msg_len = 0;
@@ -247,24 +258,78 @@ ParseState ParseResponse(std::string_view* buf, Message* result) {
   // Set header number to maximum we can accept.
   // Pico will change it to the number of headers parsed for us.
   size_t num_headers = kMaxNumHeaders;
-  const int retval = phr_parse_response(buf->data(), buf->size(), &minor_version, &status, &msg,
-                                        &msg_len, headers, &num_headers, /*last_len*/ 0);
+  const int retval =
+      phr_parse_response(buf.data(), buf.size(), &minor_version, &status, &msg, &msg_len, headers,
+                         &num_headers, state->headers_scanned_bytes);
   if (retval >= 0) {
-    buf->remove_prefix(retval);
-
+    Message* result = &state->message;
     result->type = MessageType::kResponse;
     result->minor_version = minor_version;
     result->headers = GetHTTPHeadersMap(headers, num_headers);
     result->resp_status = status;
     result->resp_message = std::string(msg, msg_len);
-    result->headers_byte_size = retval;
+  }
+  return retval;
+}
+
+}  // namespace
 
-    return ParseBody(buf, result);
+ParseState ParseMessage(MessageType type, std::string_view* buf, Message* result,
+                        StreamParseState* state) {
+  // The state always describes the message at the head of buf. If the buffer is somehow
+  // shorter than what was already processed, the state is stale and we start over.
+  if (buf->size() < state->headers_scanned_bytes ||
+      (state->headers_complete && buf->size() < state->message.headers_byte_size)) {
+    state->Reset();
   }
-  if (retval == -2) {
-    return ParseState::kNeedsMoreData;
+
+  if (!state->headers_complete) {
+    int retval = -1;
+    switch (type) {
+      case MessageType::kRequest:
+        retval = ParseRequestHeaders(*buf, state);
+        break;
+      case MessageType::kResponse:
+        retval = ParseResponseHeaders(*buf, state);
+        break;
+      default:
+        break;
+    }
+
+    if (retval == -2) {
+      // Remember how much was scanned, so the next attempt only looks at the new bytes.
+      state->headers_scanned_bytes = buf->size();
+      return ParseState::kNeedsMoreData;
+    }
+    if (retval < 0) {
+      state->Reset();
+      return ParseState::kInvalid;
+    }
+
+    state->headers_complete = true;
+    state->message.headers_byte_size = retval;
+    // Chunked bodies are accumulated piecewise into the body.
+    state->message.body.clear();
   }
-  return ParseState::kInvalid;
+
+  std::string_view body_buf = buf->substr(state->message.headers_byte_size);
+  ParseState parse_state = ParseBody(&body_buf, state);
+
+  switch (parse_state) {
+    case ParseState::kNeedsMoreData:
+      // Keep the state, so that parsing resumes from here once more data arrives.
+      break;
+    case ParseState::kSuccess:
+    case ParseState::kEOS:
+      buf->remove_prefix(buf->size() - body_buf.size());
+      *result = std::move(state->message);
+      state->Reset();
+      break;
+    default:
+      state->Reset();
+      break;
+  }
+  return parse_state;
 }
 
 }  // namespace pico_wrapper
@@ -277,17 +342,19 @@ ParseState ParseResponse(std::string_view* buf, Message* result) {
  * @param buf: The source buffer to parse. The prefix of this buffer will be consumed to indicate
  * the point until which the parse has progressed.
  * @param result: A parsed HTTP message, if parse was successful (must consider return value).
+ * @param state: Progress on a partially received message at the head of buf. Updated so that a
+ * subsequent call with more data resumes where this one stopped.
  * @return parse state indicating how the parse progressed.
  */
+ParseState ParseFrame(MessageType type, std::string_view* buf, Message* result,
+                      StreamParseState* state) {
+  return pico_wrapper::ParseMessage(type, buf, result, state);
+}
+
 ParseState ParseFrame(MessageType type, std::string_view* buf, Message* result) {
-  switch (type) {
-    case MessageType::kRequest:
-      return pico_wrapper::ParseRequest(buf, result);
-    case MessageType::kResponse:
-      return pico_wrapper::ParseResponse(buf, result);
-    default:
-      return ParseState::kInvalid;
-  }
+  // Without a state that persists across calls, a partial message is re-parsed from the start.
+  StreamParseState state;
+  return ParseFrame(type, buf, result, &state);
 }
 
 // TODO(oazizi/yzhao): This function should use is_http_{response,request} inside
@@ -381,6 +448,23 @@ size_t FindFrameBoundary<http::Message>(MessageType type, std::string_view buf,
   return http::FindFrameBoundary(type, buf, start_pos);
 }
 
+template <>
+ParseState ParseFrame(MessageType type, std::string_view* buf, http::Message* result,
+                      http::StreamParseState* state) {
+  return http::ParseFrame(type, buf, result, state);
+}
+
+template <>
+size_t FindFrameBoundary<http::Message>(MessageType type, std::string_view buf, size_t start_pos,
+                                        http::StreamParseState* state) {
+  size_t pos = http::FindFrameBoundary(type, buf, start_pos);
+  if (pos != std::string::npos) {
+    // Parsing moves to a new message start, so progress on the old head no longer applies.
+    state->Reset();
+  }
+  return pos;
+}
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -39,6 +39,18 @@ template <>
 size_t FindFrameBoundary<http::Message>(MessageType type, std::string_view buf, size_t start_pos,
                                         NoState* state);
 
+/**
+ * Parses a single HTTP message from the input string, resuming from the progress recorded in
+ * state if the message at the head of the input was partially parsed before.
+ */
+template <>
+ParseState ParseFrame(MessageType type, std::string_view* buf, http::Message* frame,
+                      http::StreamParseState* state);
+
+template <>
+size_t FindFrameBoundary<http::Message>(MessageType type, std::string_view buf, size_t start_pos,
+                                        http::StreamParseState* state);
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
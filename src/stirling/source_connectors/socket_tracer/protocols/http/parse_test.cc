@@ -541,6 +541,60 @@ TEST_F(HTTPParserTest, PartialMessageInTheMiddleOfStream) {
   EXPECT_THAT(parsed_messages, ElementsAre(HasBody("foobar"), HasBody("pixielabs rocks!")));
 }
 
+// Tests that a chunked response arriving in pieces is resumed from the recorded state,
+// rather than re-parsed from the start of the message on every attempt.
+TEST_F(HTTPParserTest, ResumeChunkedResponse) {
+  const std::string msg = HTTPRespWithChunkedBody({"pixielabs ", "rocks!"});
+  StreamParseState state;
+  std::deque<Message> parsed_messages;
+
+  // Headers only partially available.
+  std::string_view buf = std::string_view(msg).substr(0, 10);
+  ParseResult result = ParseFramesLoop(MessageType::kResponse, buf, &parsed_messages, &state);
+  EXPECT_EQ(ParseState::kNeedsMoreData, result.state);
+  EXPECT_EQ(0, result.end_position);
+  EXPECT_FALSE(state.headers_complete);
+  EXPECT_EQ(state.headers_scanned_bytes, 10);
+
+  // Headers and the first chunk, but not the rest of the body.
+  buf = std::string_view(msg).substr(0, msg.size() - 10);
+  result = ParseFramesLoop(MessageType::kResponse, buf, &parsed_messages, &state);
+  EXPECT_EQ(ParseState::kNeedsMoreData, result.state);
+  EXPECT_EQ(0, result.end_position);
+  EXPECT_TRUE(state.headers_complete);
+  EXPECT_GT(state.chunked_body_consumed_bytes, 0);
+  EXPECT_THAT(parsed_messages, IsEmpty());
+
+  // The whole message.
+  result = ParseFramesLoop(MessageType::kResponse, msg, &parsed_messages, &state);
+  EXPECT_EQ(ParseState::kSuccess, result.state);
+  EXPECT_EQ(msg.size(), result.end_position);
+  EXPECT_THAT(parsed_messages, ElementsAre(HasBody("pixielabs rocks!")));
+  EXPECT_FALSE(state.headers_complete);
+}
+
+// Tests that resuming with the state produces the same messages as parsing without it,
+// for every possible split point of the stream.
+TEST_F(HTTPParserTest, ResumeAtEverySplitPoint) {
+  const std::string msg = absl::StrCat(HTTPRespWithSizedBody("foobar"),
+                                       HTTPRespWithChunkedBody({"pixielabs ", "rocks!"}));
+
+  for (size_t split = 0; split < msg.size(); ++split) {
+    StreamParseState state;
+    std::deque<Message> parsed_messages;
+
+    ParseResult result = ParseFramesLoop(MessageType::kResponse,
+                                         std::string_view(msg).substr(0, split),
+                                         &parsed_messages, &state);
+
+    // Like DataStream, only drop the bytes of complete messages before the next attempt.
+    std::string_view rest = std::string_view(msg).substr(result.end_position);
+    ParseFramesLoop(MessageType::kResponse, rest, &parsed_messages, &state);
+    EXPECT_THAT(parsed_messages, ElementsAre(HasBody("foobar"), HasBody("pixielabs rocks!")))
+        << absl::Substitute("split=$0", split);
+  }
+}
+
 //=============================================================================
 // HTTP Parsing Stress Tests
 //=============================================================================
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <picohttpparser.h>
+
 #include <chrono>
 #include <string>
 
@@ -78,6 +80,36 @@ struct Message : public FrameBase {
   }
 };
 
+//-----------------------------------------------------------------------------
+// Incremental Parse State
+//-----------------------------------------------------------------------------
+
+/**
+ * StreamParseState records how far the parser got on a message that was only partially received,
+ * so that the next parse attempt can resume where it stopped instead of starting over.
+ *
+ * There is one instance per DataStream (i.e. per direction of a connection), and it always
+ * describes the message at the head of that stream's buffer. All offsets are relative to the
+ * start of that message, since the underlying buffer may be moved between parse attempts.
+ */
+struct StreamParseState {
+  // Number of bytes at the head that were already scanned for the end of the headers.
+  // Handed to pico as last_len, so that only newly arrived bytes are scanned.
+  size_t headers_scanned_bytes = 0;
+
+  // Set once the headers have been parsed; message then holds all the non-body fields.
+  bool headers_complete = false;
+  Message message;
+
+  // Progress of a chunked body: the decoder state and the number of raw body bytes
+  // (i.e. after the headers) that have already been fed to the decoder.
+  // The decoded bytes are accumulated in message.body.
+  phr_chunked_decoder chunk_decoder = {};
+  size_t chunked_body_consumed_bytes = 0;
+
+  void Reset() { *this = StreamParseState(); }
+};
+
 //-----------------------------------------------------------------------------
 // Table Store Entry Level Structs
 //-----------------------------------------------------------------------------
@@ -103,6 +135,7 @@ struct ProtocolTraits {
   using frame_type = Message;
   using record_type = Record;
   using state_type = NoState;
+  using partial_frame_state_type = StreamParseState;
 };
 
 }  // namespace http
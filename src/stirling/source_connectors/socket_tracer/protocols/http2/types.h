@@ -186,6 +186,7 @@ struct ProtocolTraits {
   using frame_type = Stream;
   using record_type = Record;
   using state_type = NoState;
+  using partial_frame_state_type = NoPartialFrameState;
 };
 
 }  // namespace http2
@@ -426,6 +426,7 @@ struct ProtocolTraits {
   using frame_type = Packet;
   using record_type = Record;
   using state_type = StateWrapper;
+  using partial_frame_state_type = NoPartialFrameState;
 };
 
 }  // namespace mysql
@@ -547,6 +547,7 @@ struct ProtocolTraits {
   using frame_type = RegularMessage;
   using record_type = Record;
   using state_type = StateWrapper;
+  using partial_frame_state_type = NoPartialFrameState;
 };
 
 using MsgDeqIter = std::deque<RegularMessage>::iterator;
@@ -60,6 +60,7 @@ struct ProtocolTraits {
   using frame_type = Message;
   using record_type = Record;
   using state_type = NoState;
+  using partial_frame_state_type = NoPartialFrameState;
 };
 
 }  // namespace redis
@@ -48,6 +48,11 @@ using FrameDequeVariant = std::variant<std::monostate,
                                        std::deque<nats::Message>>;
 // clang-format off
 
+// The partial frame states of the protocols whose ProtocolTraits::partial_frame_state_type is not
+// NoPartialFrameState.
+// PROTOCOL_LIST: Requires update on new protocols.
+using PartialFrameStateVariant = std::variant<std::monostate, http::StreamParseState>;
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -19,6 +19,7 @@
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_connector.h"
 
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <filesystem>
@@ -378,10 +379,41 @@ void SocketTraceConnector::UpdateTrackerTraceLevel(ConnTracker* tracker) {
   }
 }
 
+void SocketTraceConnector::UpdateLoadShedding() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return;
+  }
+  const std::chrono::nanoseconds thread_cpu_time =
+      std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+
+  // The first iteration only establishes the baseline.
+  if (load_shedding_wall_time_.time_since_epoch().count() != 0) {
+    const double wall_secs =
+        std::chrono::duration<double>(iteration_time_ - load_shedding_wall_time_).count();
+    const double cpu_secs =
+        std::chrono::duration<double>(thread_cpu_time - load_shedding_cpu_time_).count();
+    if (wall_secs > 0) {
+      const uint64_t prev_sampling_mask = conn_trackers_mgr_.sampling_mask();
+      conn_trackers_mgr_.UpdateLoadShedding(cpu_secs / wall_secs);
+      if (conn_trackers_mgr_.sampling_mask() != prev_sampling_mask) {
+        Status s = UpdateBPFSamplingMask(conn_trackers_mgr_.sampling_mask());
+        LOG_IF(WARNING, !s.ok()) << absl::Substitute("Failed to update the sampling mask: $0",
+                                                     s.msg());
+      }
+    }
+  }
+
+  load_shedding_wall_time_ = iteration_time_;
+  load_shedding_cpu_time_ = thread_cpu_time;
+}
+
 void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
                                             const std::vector<DataTable*>& data_tables) {
   set_iteration_time(std::chrono::steady_clock::now());
 
+  UpdateLoadShedding();
+
   UpdateCommonState(ctx);
 
   DataTable* conn_stats_table = data_tables[kConnStatsTableNum];
@@ -390,10 +422,29 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     TransferConnStats(ctx, conn_stats_table);
   }
 
+  DataTable* protocol_stats_table = data_tables[kProtocolStatsTableNum];
+  if (protocol_stats_table != nullptr &&
+      sampling_freq_mgr_.count() % FLAGS_stirling_conn_stats_sampling_ratio == 0) {
+    TransferProtocolStats(protocol_stats_table);
+  }
+
   if ((sampling_freq_mgr_.count() + 1) % FLAGS_stirling_socket_tracer_stats_logging_ratio == 0) {
     conn_trackers_mgr_.ComputeProtocolStats();
     LOG(INFO) << "ConnTracker statistics: " << conn_trackers_mgr_.StatsString();
     LOG(INFO) << "SocketTracer statistics: " << stats_.Print();
+
+    // Data event allocations are reported as a rate over the logging period.
+    const double elapsed_secs =
+        std::chrono::duration<double>(iteration_time_ - stats_logging_time_).count();
+    if (stats_logging_time_.time_since_epoch().count() != 0 && elapsed_secs > 0) {
+      LOG(INFO) << absl::Substitute(
+          "SocketTracer data events: $0/s, allocations: $1/s",
+          (stats_.Get(StatKey::kDataEvents) - stats_logged_data_events_) / elapsed_secs,
+          (stats_.Get(StatKey::kDataEventAllocs) - stats_logged_data_event_allocs_) / elapsed_secs);
+    }
+    stats_logging_time_ = iteration_time_;
+    stats_logged_data_events_ = stats_.Get(StatKey::kDataEvents);
+    stats_logged_data_event_allocs_ = stats_.Get(StatKey::kDataEventAllocs);
   }
 
   constexpr auto kDebugDumpPeriod = std::chrono::minutes(1);
@@ -404,15 +455,15 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     }
   }
 
-  std::vector<CIDRBlock> cluster_cidrs = ctx->GetClusterCIDRs();
+  const CIDRIndex<CIDRBlock>& cluster_cidrs = ctx->GetClusterCIDRIndex();
 
   for (size_t i = 0; i < data_tables.size(); ++i) {
     DataTable* data_table = data_tables[i];
 
     // Ensure records are within the time window, in order to ensure the order between record
-    // batches. Exception: conn_stats table does not need cutoff time, because its timestamps
-    // are assigned artificially.
-    if (i != kConnStatsTableNum && data_table != nullptr) {
+    // batches. Exception: the conn_stats and protocol stats tables do not need cutoff time,
+    // because their timestamps are assigned artificially.
+    if (i != kConnStatsTableNum && i != kProtocolStatsTableNum && data_table != nullptr) {
       data_table->SetConsumeRecordsCutoffTime(perf_buffer_drain_time_);
     }
   }
@@ -463,6 +514,12 @@ Status SocketTraceConnector::DisableSelfTracing() {
   return UpdatePerCPUArrayValue(kStirlingTGIDIndex, self_pid, &control_map_handle);
 }
 
+Status SocketTraceConnector::UpdateBPFSamplingMask(uint64_t sampling_mask) {
+  auto control_map_handle = GetPerCPUArrayTable<int64_t>(kControlValuesArrayName);
+  return UpdatePerCPUArrayValue(kSamplingMaskIndex, static_cast<int64_t>(sampling_mask),
+                                &control_map_handle);
+}
+
 //-----------------------------------------------------------------------------
 // Perf Buffer Polling and Callback functions.
 //-----------------------------------------------------------------------------
@@ -470,8 +527,24 @@ Status SocketTraceConnector::DisableSelfTracing() {
 void SocketTraceConnector::HandleDataEvent(void* cb_cookie, void* data, int /*data_size*/) {
   DCHECK(cb_cookie != nullptr) << "Perf buffer callback not set-up properly. Missing cb_cookie.";
   auto* connector = static_cast<SocketTraceConnector*>(cb_cookie);
-  auto data_event_ptr = std::make_unique<SocketDataEvent>(data);
-  connector->AcceptDataEvent(std::move(data_event_ptr));
+
+  // Perf buffer callbacks run synchronously on the Stirling thread, and each event is fully
+  // consumed (copied into its DataStream) before the next callback. So a single event object is
+  // recycled for every submission, which avoids an allocation per captured syscall.
+  SocketDataEvent* event = &connector->recycled_data_event_;
+  const size_t prev_capacity = event->msg.capacity();
+  event->Assign(data);
+  if (event->msg.capacity() != prev_capacity) {
+    connector->stats_.Increment(StatKey::kDataEventAllocs);
+  }
+  connector->stats_.Increment(StatKey::kDataEvents);
+
+  connector->AcceptDataEvent(event);
+
+  // Don't hold on to the memory of unusually large events (e.g. sendfile fillers).
+  if (event->msg.capacity() > kMaxRecycledDataEventBytes) {
+    event->msg = std::string();
+  }
 }
 
 void SocketTraceConnector::HandleDataEventLoss(void* cb_cookie, uint64_t lost) {
@@ -568,7 +641,7 @@ ConnTracker& SocketTraceConnector::GetOrCreateConnTracker(struct conn_id_t conn_
   return tracker;
 }
 
-void SocketTraceConnector::AcceptDataEvent(std::unique_ptr<SocketDataEvent> event) {
+void SocketTraceConnector::AcceptDataEvent(SocketDataEvent* event) {
   event->attr.timestamp_ns += ClockRealTimeOffset();
 
   if (perf_buffer_events_output_stream_ != nullptr) {
@@ -576,7 +649,7 @@ void SocketTraceConnector::AcceptDataEvent(std::unique_ptr<SocketDataEvent> even
   }
 
   ConnTracker& tracker = GetOrCreateConnTracker(event->attr.conn_id);
-  tracker.AddDataEvent(std::move(event));
+  tracker.AddDataEvent(*event);
 }
 
 void SocketTraceConnector::AcceptControlEvent(socket_control_event_t event) {
@@ -1071,5 +1144,29 @@ void SocketTraceConnector::TransferConnStats(ConnectorContext* ctx, DataTable* d
   }
 }
 
+void SocketTraceConnector::TransferProtocolStats(DataTable* data_table) {
+  namespace idx = ::px::stirling::protocol_stats_idx;
+  using DataStatKey = ConnTrackersManager::DataStatKey;
+
+  uint64_t time = CurrentTimeNS();
+
+  for (const auto& [protocol, stats] : conn_trackers_mgr_.ComputeProtocolDataStats()) {
+    // Skip protocols that never had any data captured.
+    if (stats.Get(DataStatKey::kBytesCaptured) == 0) {
+      continue;
+    }
+
+    DataTable::RecordBuilder<&kProtocolStatsTable> r(data_table, time);
+    r.Append<idx::kTime>(time);
+    r.Append<idx::kProtocol>(static_cast<int64_t>(protocol));
+    r.Append<idx::kBytesCaptured>(stats.Get(DataStatKey::kBytesCaptured));
+    r.Append<idx::kBytesParsed>(stats.Get(DataStatKey::kBytesParsed));
+    r.Append<idx::kBytesDiscarded>(stats.Get(DataStatKey::kBytesDiscarded));
+    r.Append<idx::kBytesDropped>(stats.Get(DataStatKey::kBytesDropped));
+    r.Append<idx::kRecords>(stats.Get(DataStatKey::kRecords));
+    r.Append<idx::kSamplingRate>(conn_trackers_mgr_.sampling_rate());
+  }
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -72,7 +72,7 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   static constexpr std::string_view kName = "socket_tracer";
   static constexpr auto kTables =
       MakeArray(kConnStatsTable, kHTTPTable, kMySQLTable, kCQLTable, kPGSQLTable, kDNSTable,
-                kRedisTable, kNATSTable, kKafkaTable);
+                kRedisTable, kNATSTable, kKafkaTable, kProtocolStatsTable);
 
   static constexpr uint32_t kConnStatsTableNum = TableNum(kTables, kConnStatsTable);
   static constexpr uint32_t kHTTPTableNum = TableNum(kTables, kHTTPTable);
@@ -83,6 +83,7 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   static constexpr uint32_t kRedisTableNum = TableNum(kTables, kRedisTable);
   static constexpr uint32_t kNATSTableNum = TableNum(kTables, kNATSTable);
   static constexpr uint32_t kKafkaTableNum = TableNum(kTables, kKafkaTable);
+  static constexpr uint32_t kProtocolStatsTableNum = TableNum(kTables, kProtocolStatsTable);
 
   static constexpr auto kSamplingPeriod = std::chrono::milliseconds{200};
   // TODO(yzhao): This is not used right now. Eventually use this to control data push frequency.
@@ -112,6 +113,7 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   Status UpdateBPFProtocolTraceRole(TrafficProtocol protocol, uint64_t role_mask);
   Status TestOnlySetTargetPID(int64_t pid);
   Status DisableSelfTracing();
+  Status UpdateBPFSamplingMask(uint64_t sampling_mask);
 
   void DisablePIDTrace(int pid) override {
     SourceConnector::DisablePIDTrace(pid);
@@ -244,7 +246,8 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   ConnTracker& GetOrCreateConnTracker(struct conn_id_t conn_id);
 
   // Events from BPF.
-  void AcceptDataEvent(std::unique_ptr<SocketDataEvent> event);
+  void AcceptDataEvent(SocketDataEvent* event);
+  void AcceptDataEvent(std::unique_ptr<SocketDataEvent> event) { AcceptDataEvent(event.get()); }
   void AcceptControlEvent(socket_control_event_t event);
   void AcceptConnStatsEvent(conn_stats_event_t event);
   void AcceptHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> event);
@@ -253,6 +256,7 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // Transfer of messages to the data table.
   void TransferStreams(ConnectorContext* ctx, uint32_t table_num, DataTable* data_table);
   void TransferConnStats(ConnectorContext* ctx, DataTable* data_table);
+  void TransferProtocolStats(DataTable* data_table);
 
   template <typename TProtocolTraits>
   void TransferStream(ConnectorContext* ctx, ConnTracker* tracker, DataTable* data_table);
@@ -265,6 +269,10 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   void UpdateTrackerTraceLevel(ConnTracker* tracker);
 
+  // Measures the CPU utilization of the Stirling thread since the last iteration,
+  // and adjusts the connection sampling rate accordingly, in user-space and in BPF.
+  void UpdateLoadShedding();
+
   template <typename TRecordType>
   static void AppendMessage(ConnectorContext* ctx, const ConnTracker& conn_tracker,
                             TRecordType record, DataTable* data_table);
@@ -325,7 +333,15 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   UProbeManager uprobe_mgr_;
 
+  // Perf buffer data events are decoded into this object, which is reused across callbacks.
+  SocketDataEvent recycled_data_event_;
+
+  // Recycled events whose msg buffer grows beyond this size are shrunk back after use.
+  static constexpr size_t kMaxRecycledDataEventBytes = 64 * 1024;
+
   enum class StatKey {
+    kDataEvents,
+    kDataEventAllocs,
     kLossSocketDataEvent,
     kLossSocketControlEvent,
     kLossConnStatsEvent,
@@ -336,6 +352,15 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   utils::StatCounter<StatKey> stats_;
 
+  // Thread CPU time and wall time at the previous UpdateLoadShedding().
+  std::chrono::time_point<std::chrono::steady_clock> load_shedding_wall_time_;
+  std::chrono::nanoseconds load_shedding_cpu_time_{0};
+
+  // Snapshot of stats_ at the last time it was logged, to report rates.
+  std::chrono::time_point<std::chrono::steady_clock> stats_logging_time_;
+  int64_t stats_logged_data_events_ = 0;
+  int64_t stats_logged_data_event_allocs_ = 0;
+
   FRIEND_TEST(SocketTraceConnectorTest, AppendNonContiguousEvents);
   FRIEND_TEST(SocketTraceConnectorTest, NoEvents);
   FRIEND_TEST(SocketTraceConnectorTest, SortedByResponseTime);
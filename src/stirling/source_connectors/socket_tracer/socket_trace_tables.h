@@ -19,6 +19,7 @@
 #pragma once
 
 #include "src/stirling/source_connectors/socket_tracer/conn_stats_table.h"
+#include "src/stirling/source_connectors/socket_tracer/protocol_stats_table.h"
 
 // PROTOCOL_LIST: Requires update on new protocols.
 #include "src/stirling/source_connectors/socket_tracer/cass_table.h"
@@ -33,12 +33,14 @@
 #include "src/common/base/base.h"
 #include "src/common/perf/elapsed_timer.h"
 #include "src/common/system/system_info.h"
+#include "src/shared/metadata/proc_lifecycle_feed.h"
 
 #include "src/stirling/bpf_tools/probe_cleaner.h"
 #include "src/stirling/core/data_table.h"
 #include "src/stirling/core/pub_sub_manager.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/core/source_registry.h"
+#include "src/stirling/utils/proc_tracker.h"
 #include "src/stirling/proto/stirling.pb.h"
 
 #include "src/stirling/source_connectors/dynamic_bpftrace/dynamic_bpftrace_connector.h"
@@ -232,6 +234,12 @@ class StirlingImpl final : public Stirling {
   AgentMetadataCallback agent_metadata_callback_ = nullptr;
   AgentMetadataType agent_metadata_;
 
+  // The processes of the StandaloneContext, used when there is no agent metadata.
+  absl::base_internal::SpinLock standalone_procs_lock_;
+  std::unique_ptr<md::ProcLifecycleFeed> standalone_proc_feed_
+      ABSL_GUARDED_BY(standalone_procs_lock_);
+  ProcTracker standalone_proc_tracker_ ABSL_GUARDED_BY(standalone_procs_lock_);
+
   absl::base_internal::SpinLock dynamic_trace_status_map_lock_;
   absl::flat_hash_map<sole::uuid, StatusOr<stirlingpb::Publish>> dynamic_trace_status_map_
       ABSL_GUARDED_BY(dynamic_trace_status_map_lock_);
@@ -358,10 +366,22 @@ Status StirlingImpl::Init() {
 }
 
 std::unique_ptr<ConnectorContext> StirlingImpl::GetContext() {
+  // The agent's metadata tracks the processes with its own ProcLifecycleFeed, so the processes are
+  // only scanned once per agent.
   if (agent_metadata_callback_ != nullptr) {
     return std::unique_ptr<ConnectorContext>(new AgentContext(agent_metadata_callback_()));
   }
-  return std::unique_ptr<ConnectorContext>(new StandaloneContext());
+
+  // Without an agent, track processes incrementally rather than listing /proc from scratch
+  // for every context.
+  absl::base_internal::SpinLockHolder lock(&standalone_procs_lock_);
+  if (standalone_proc_feed_ == nullptr) {
+    standalone_proc_feed_ = std::make_unique<md::ProcScanLifecycleFeed>(
+        system::Config::GetInstance().proc_path(), /* asid */ 0);
+  }
+  standalone_proc_tracker_.Update(standalone_proc_feed_->Poll());
+  return std::unique_ptr<ConnectorContext>(
+      new StandaloneContext(standalone_proc_tracker_.upids()));
 }
 
 namespace {
@@ -39,5 +39,20 @@ void ProcTracker::Update(absl::flat_hash_set<md::UPID> upids) {
   upids_ = std::move(upids);
 }
 
+void ProcTracker::Update(const md::ProcLifecycleDelta& delta) {
+  new_upids_.clear();
+  deleted_upids_.clear();
+  for (const auto& upid : delta.exits) {
+    if (upids_.erase(upid) > 0) {
+      deleted_upids_.insert(upid);
+    }
+  }
+  for (const auto& upid : delta.execs) {
+    if (upids_.insert(upid).second) {
+      new_upids_.insert(upid);
+    }
+  }
+}
+
 }  // namespace stirling
 }  // namespace px
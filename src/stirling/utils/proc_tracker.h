@@ -21,6 +21,7 @@
 #include <absl/container/flat_hash_set.h>
 
 #include "src/common/system/proc_parser.h"
+#include "src/shared/metadata/proc_lifecycle_feed.h"
 #include "src/shared/upid/upid.h"
 
 namespace px {
@@ -38,6 +39,12 @@ class ProcTracker : NotCopyMoveable {
    */
   void Update(absl::flat_hash_set<md::UPID> upids);
 
+  /**
+   * Applies the process starts and terminations reported by a ProcLifecycleFeed, without
+   * requiring the full set of UPIDs. new_upids() and deleted_upids() reflect this delta only.
+   */
+  void Update(const md::ProcLifecycleDelta& delta);
+
   /**
    * Returns all current upids, as set by last call to Update().
    */
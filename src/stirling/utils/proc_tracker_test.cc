@@ -61,5 +61,28 @@ TEST_F(ProcTrackerTest, Basic) {
   EXPECT_THAT(proc_tracker_.deleted_upids(), UnorderedElementsAre(kUPID3));
 }
 
+TEST_F(ProcTrackerTest, Delta) {
+  const md::UPID kUPID1 = md::UPID(0, 1, 111);
+  const md::UPID kUPID2 = md::UPID(0, 2, 222);
+  const md::UPID kUPID3 = md::UPID(0, 3, 333);
+
+  proc_tracker_.Update(md::ProcLifecycleDelta{.execs = {kUPID1, kUPID2}, .exits = {}});
+  EXPECT_THAT(proc_tracker_.upids(), UnorderedElementsAre(kUPID1, kUPID2));
+  EXPECT_THAT(proc_tracker_.new_upids(), UnorderedElementsAre(kUPID1, kUPID2));
+  EXPECT_THAT(proc_tracker_.deleted_upids(), IsEmpty());
+
+  // Exits of unknown processes, and repeated execs, are ignored.
+  proc_tracker_.Update(
+      md::ProcLifecycleDelta{.execs = {kUPID2, kUPID3}, .exits = {kUPID1, kUPID3}});
+  EXPECT_THAT(proc_tracker_.upids(), UnorderedElementsAre(kUPID2, kUPID3));
+  EXPECT_THAT(proc_tracker_.new_upids(), UnorderedElementsAre(kUPID3));
+  EXPECT_THAT(proc_tracker_.deleted_upids(), UnorderedElementsAre(kUPID1));
+
+  proc_tracker_.Update(md::ProcLifecycleDelta{});
+  EXPECT_THAT(proc_tracker_.upids(), UnorderedElementsAre(kUPID2, kUPID3));
+  EXPECT_THAT(proc_tracker_.new_upids(), IsEmpty());
+  EXPECT_THAT(proc_tracker_.deleted_upids(), IsEmpty());
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -39,8 +39,8 @@ namespace utils {
 template <typename TKeyType>
 class StatCounter {
  public:
-  void Increment(TKeyType key, int count = 1) { counts_[static_cast<int>(key)] += count; }
-  void Decrement(TKeyType key, int count = 1) { counts_[static_cast<int>(key)] -= count; }
+  void Increment(TKeyType key, int64_t count = 1) { counts_[static_cast<int>(key)] += count; }
+  void Decrement(TKeyType key, int64_t count = 1) { counts_[static_cast<int>(key)] -= count; }
   void Reset(TKeyType key) { counts_[static_cast<int>(key)] = 0; }
   int64_t Get(TKeyType key) const { return counts_[static_cast<int>(key)]; }
   std::string Print() const {
@@ -299,6 +299,10 @@ schema::Relation Table::GetRelation() const { return rel_; }
 TableStats Table::GetTableStats() const {
   TableStats info;
   auto num_batches = NumBatches();
+  // Row IDs are assigned contiguously, so the rows held are the ones from the oldest batch that
+  // hasn't expired to the end of the table.
+  auto first_batch = FirstBatch();
+  info.num_rows = first_batch.IsValid() ? End() - first_batch.uniq_row_start_idx : 0;
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
 
   info.batches_added = batches_added_;
@@ -334,6 +338,15 @@ Status Table::WriteHot(RecordBatchPtr record_batch) {
       std::vector<ArrowArrayPtr>(rel_.NumColumns()),
       std::vector<bool>(rel_.NumColumns(), false),
   };
+  // Arena-backed string columns already have arrow's layout, so adopt their buffers right away
+  // instead of converting them lazily.
+  for (size_t col_idx = 0; col_idx < rb.record_batch->size(); ++col_idx) {
+    auto& col = rb.record_batch->at(col_idx);
+    if (col->IsStringArena()) {
+      rb.arrow_cache[col_idx] = col->ConvertToArrow(arrow::default_memory_pool());
+      rb.cache_validity[col_idx] = true;
+    }
+  }
   hot_batches_.emplace_back(std::move(rb));
   return Status::OK();
 }
@@ -55,6 +55,8 @@ struct TableStats {
   int64_t batches_expired;
   int64_t compacted_batches;
   int64_t max_table_size;
+  // The number of rows currently held by the table, after expiry.
+  int64_t num_rows;
 };
 
 struct BatchSlice {
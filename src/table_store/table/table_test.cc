@@ -237,6 +237,7 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb1));
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 3);
 
   schema::RowBatch rb2(rd, 2);
   std::vector<types::Int64Value> col1_rb2 = {4, 5};
@@ -249,6 +250,7 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb2));
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 5);
 
   schema::RowBatch rb3(rd, 2);
   std::vector<types::Int64Value> col1_rb3 = {4, 5};
@@ -261,6 +263,7 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb3));
   EXPECT_EQ(table.GetTableStats().bytes, rb3_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 2);
 
   std::vector<types::Int64Value> time_hot_col1 = {1};
   std::vector<types::StringValue> time_hot_col2 = {"a"};
@@ -282,6 +285,7 @@ TEST(TableTest, expiry_test) {
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1)));
 
   EXPECT_EQ(table.GetTableStats().bytes, rb3_size + rb4_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 3);
 
   std::vector<types::Int64Value> time_hot_col1_2 = {1, 2, 3, 4, 5};
   std::vector<types::StringValue> time_hot_col2_2 = {"abcdef", "ghi", "jklmno", "pqr", "tu"};
@@ -303,6 +307,7 @@ TEST(TableTest, expiry_test) {
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1_2)));
 
   EXPECT_EQ(table.GetTableStats().bytes, rb5_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 5);
 }
 
 TEST(TableTest, expiry_test_w_compaction) {
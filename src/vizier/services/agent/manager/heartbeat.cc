@@ -19,6 +19,7 @@
 #include "src/vizier/services/agent/manager/heartbeat.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -34,12 +35,14 @@ using ::px::shared::k8s::metadatapb::ResourceUpdate;
 HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
                                                  px::md::AgentMetadataStateManager* mds_manager,
                                                  RelationInfoManager* relation_info_manager,
+                                                 const table_store::TableStore* table_store,
                                                  Info* agent_info,
                                                  Manager::VizierNATSConnector* nats_conn)
     : MessageHandler(d, agent_info, nats_conn),
       time_source_(dispatcher()->GetTimeSource()),
       mds_manager_(mds_manager),
       relation_info_manager_(relation_info_manager),
+      table_store_(table_store),
       heartbeat_send_timer_(
           dispatcher()->CreateTimer(std::bind(&HeartbeatMessageHandler::SendHeartbeat, this))),
       heartbeat_watchdog_timer_(
@@ -50,6 +53,7 @@ HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
 void HeartbeatMessageHandler::DisableHeartbeats() {
   last_metadata_epoch_id_ = 0;
   sent_schema_ = false;
+  sent_num_rows_buckets_.clear();
   heartbeat_send_timer_->DisableTimer();
   heartbeat_watchdog_timer_->DisableTimer();
 }
@@ -102,6 +106,9 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
     sent_schema_ = true;
     relation_info_manager_->AddSchemaToUpdateInfo(update_info);
   }
+  if (agent_info()->capabilities.collects_data()) {
+    AddTableNumRows(update_info);
+  }
 
   // We skip sending the metadata update when there have been no changes.
   auto current_epoch = mds_manager_->metadata_filter()->epoch_id();
@@ -117,6 +124,46 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
   return nats_conn()->Publish(req);
 }
 
+namespace {
+// The index of the highest set bit, so that row counts within a factor of two of each other share
+// a bucket.
+int NumRowsBucket(int64_t num_rows) {
+  int bucket = 0;
+  for (; num_rows > 0; num_rows >>= 1) {
+    ++bucket;
+  }
+  return bucket;
+}
+}  // namespace
+
+void HeartbeatMessageHandler::AddTableNumRows(messages::AgentUpdateInfo* update_info) {
+  absl::flat_hash_map<std::string, int64_t> num_rows;
+  for (uint64_t table_id : table_store_->GetTableIDs()) {
+    const auto* table = table_store_->GetTable(table_id);
+    if (table == nullptr) {
+      continue;
+    }
+    num_rows[table_store_->GetTableName(table_id)] += table->GetTableStats().num_rows;
+  }
+
+  // The planner only uses the row counts as size estimates, so they are only sent when one of them
+  // changes by about a factor of two. Otherwise every heartbeat would rewrite the agent's data info
+  // in the metadata service.
+  absl::flat_hash_map<std::string, int> buckets;
+  for (const auto& [table_name, rows] : num_rows) {
+    buckets[table_name] = NumRowsBucket(rows);
+  }
+  if (buckets == sent_num_rows_buckets_) {
+    return;
+  }
+  sent_num_rows_buckets_ = std::move(buckets);
+
+  auto* table_num_rows = update_info->mutable_data()->mutable_table_num_rows();
+  for (const auto& [table_name, rows] : num_rows) {
+    (*table_num_rows)[table_name] = rows;
+  }
+}
+
 void HeartbeatMessageHandler::HeartbeatWatchdog() {
   if (heartbeat_info_.last_ackd_seq_num < heartbeat_info_.last_sent_seq_num) {
     auto diff = time_source_.MonotonicTime() - heartbeat_info_.last_heartbeat_send_time_;
@@ -19,6 +19,9 @@
 #pragma once
 
 #include <memory>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
 
 #include "src/vizier/services/agent/manager/manager.h"
 
@@ -31,7 +34,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   HeartbeatMessageHandler() = delete;
   HeartbeatMessageHandler(px::event::Dispatcher* dispatcher,
                           px::md::AgentMetadataStateManager* mds_manager,
-                          RelationInfoManager* relation_info_manager, Info* agent_info,
+                          RelationInfoManager* relation_info_manager,
+                          const table_store::TableStore* table_store, Info* agent_info,
                           Manager::VizierNATSConnector* nats_conn);
 
   ~HeartbeatMessageHandler() override = default;
@@ -47,6 +51,9 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
 
   void ProcessPIDTerminatedEvent(const px::md::PIDTerminatedEvent& ev,
                                  messages::AgentUpdateInfo* update_info);
+  // Adds the number of rows held in each table, if any of them changed significantly since they
+  // were last sent.
+  void AddTableNumRows(messages::AgentUpdateInfo* update_info);
 
   void DoHeartbeats();
 
@@ -64,11 +71,14 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   std::unique_ptr<px::vizier::messages::VizierMessage> last_sent_hb_;
   int64_t last_metadata_epoch_id_ = 0;
   bool sent_schema_ = false;
+  // The power of two bucket of each table's row count, as of the last heartbeat that sent them.
+  absl::flat_hash_map<std::string, int> sent_num_rows_buckets_;
 
   HeartbeatInfo heartbeat_info_;
   const px::event::TimeSource& time_source_;
   px::md::AgentMetadataStateManager* mds_manager_;
   RelationInfoManager* relation_info_manager_;
+  const table_store::TableStore* table_store_;
   std::chrono::duration<double> heartbeat_latency_moving_average_{0};
 
   px::event::TimerUPtr heartbeat_send_timer_;
@@ -18,6 +18,7 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,6 +30,7 @@
 #include "src/common/testing/event/simulated_time_system.h"
 #include "src/common/testing/testing.h"
 #include "src/shared/metadatapb/metadata.pb.h"
+#include "src/table_store/table_store.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/heartbeat.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -42,6 +44,8 @@ using ::px::table_store::schema::Relation;
 using ::px::testing::proto::EqualsProto;
 using ::px::testing::proto::Partially;
 using shared::metadatapb::MetadataType;
+using ::testing::ElementsAre;
+using ::testing::Pair;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::UnorderedElementsAreArray;
@@ -134,12 +138,38 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
       EXPECT_OK(relation_info_manager_->AddRelationInfo(relation_info));
     }
 
+    table_store_ = std::make_shared<table_store::TableStore>();
+    for (const auto& relation_info : relation_info_vec) {
+      table_store_->AddTable(table_store::Table::Create(relation_info.relation), relation_info.name,
+                             relation_info.id);
+    }
+
     agent_info_ = agent::Info{};
     agent_info_.capabilities.set_collects_data(true);
 
     heartbeat_handler_ = std::make_unique<HeartbeatMessageHandler>(
-        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), &agent_info_,
-        nats_conn_.get());
+        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), table_store_.get(),
+        &agent_info_, nats_conn_.get());
+  }
+
+  // Writes num_rows rows to relation0.
+  void WriteRelation0Rows(int64_t num_rows) {
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(num_rows);
+    auto count_col = std::make_shared<types::Int64ValueColumnWrapper>(num_rows);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      (*time_col)[i] = i;
+      (*count_col)[i] = i;
+    }
+    auto record_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    record_batch->push_back(time_col);
+    record_batch->push_back(count_col);
+    EXPECT_OK(table_store_->GetTable("relation0")->TransferRecordBatch(std::move(record_batch)));
+  }
+
+  void AckHeartbeat(int64_t sequence_number) {
+    auto hb_ack = std::make_unique<messages::VizierMessage>();
+    hb_ack->mutable_heartbeat_ack()->set_sequence_number(sequence_number);
+    EXPECT_OK(heartbeat_handler_->HandleMessage(std::move(hb_ack)));
   }
 
   void CheckFilterElements(const messages::AgentDataInfo& data_info,
@@ -161,6 +191,7 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
   std::unique_ptr<event::Dispatcher> dispatcher_;
   std::unique_ptr<FakeAgentMetadataStateManager> mds_manager_;
   std::unique_ptr<RelationInfoManager> relation_info_manager_;
+  std::shared_ptr<table_store::TableStore> table_store_;
   std::unique_ptr<HeartbeatMessageHandler> heartbeat_handler_;
   std::unique_ptr<FakeNATSConnector<px::vizier::messages::VizierMessage>> nats_conn_;
   agent::Info agent_info_;
@@ -248,6 +279,35 @@ TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatMetadataChange) {
                       {"pl/another_service_2"});
 }
 
+TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatTableNumRows) {
+  WriteRelation0Rows(4);
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(1, nats_conn_->published_msgs().size());
+  const auto& table_num_rows =
+      nats_conn_->published_msgs()[0].heartbeat().update_info().data().table_num_rows();
+  EXPECT_THAT((std::map<std::string, int64_t>(table_num_rows.begin(), table_num_rows.end())),
+              ElementsAre(Pair("relation0", 4), Pair("relation1", 0)));
+  AckHeartbeat(0);
+
+  // The row counts aren't resent until one of them changes by about a factor of two.
+  WriteRelation0Rows(3);
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::milliseconds(5 * 1000 + 1));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(2, nats_conn_->published_msgs().size());
+  EXPECT_FALSE(nats_conn_->published_msgs()[1].heartbeat().update_info().has_data());
+  AckHeartbeat(1);
+
+  WriteRelation0Rows(1);
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::milliseconds(5 * 2000 + 2));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(3, nats_conn_->published_msgs().size());
+  const auto& new_table_num_rows =
+      nats_conn_->published_msgs()[2].heartbeat().update_info().data().table_num_rows();
+  EXPECT_THAT(
+      (std::map<std::string, int64_t>(new_table_num_rows.begin(), new_table_num_rows.end())),
+      ElementsAre(Pair("relation0", 8), Pair("relation1", 0)));
+}
+
 TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatMetadataAfterDisable) {
   // Even if the metadata info didn't change, if the heartbeat was disabled then re-enabled,
   // the metadata info should be resent.
@@ -53,6 +53,7 @@ type Store interface {
 	GetAgentIDFromPodName(podName string) (string, error)
 
 	GetAgentsDataInfo() (map[uuid.UUID]*messagespb.AgentDataInfo, error)
+	GetAgentDataInfo(agentID uuid.UUID) (*messagespb.AgentDataInfo, error)
 	UpdateAgentDataInfo(agentID uuid.UUID, dataInfo *messagespb.AgentDataInfo) error
 
 	GetComputedSchema() (*storepb.ComputedSchema, error)
@@ -351,6 +352,32 @@ func (m *ManagerImpl) updateAgentDataInfoWrapper(agentID uuid.UUID, agentDataInf
 	return nil
 }
 
+// mergeAgentDataInfo fills in the parts of an agent's data info update that the agent left out
+// because they haven't changed since its last update, using the data info that is already stored.
+func (m *ManagerImpl) mergeAgentDataInfo(agentID uuid.UUID, dataInfo *messagespb.AgentDataInfo) (*messagespb.AgentDataInfo, error) {
+	if dataInfo.MetadataInfo != nil && len(dataInfo.TableNumRows) > 0 {
+		return dataInfo, nil
+	}
+	prevDataInfo, err := m.agtStore.GetAgentDataInfo(agentID)
+	if err != nil {
+		return nil, err
+	}
+	if prevDataInfo == nil {
+		return dataInfo, nil
+	}
+	merged := &messagespb.AgentDataInfo{
+		MetadataInfo: dataInfo.MetadataInfo,
+		TableNumRows: dataInfo.TableNumRows,
+	}
+	if merged.MetadataInfo == nil {
+		merged.MetadataInfo = prevDataInfo.MetadataInfo
+	}
+	if len(merged.TableNumRows) == 0 {
+		merged.TableNumRows = prevDataInfo.TableNumRows
+	}
+	return merged, nil
+}
+
 // ApplyAgentUpdate updates the metadata store with the information from the agent update.
 func (m *ManagerImpl) ApplyAgentUpdate(update *Update) error {
 	resp, err := m.agtStore.GetAgent(update.AgentID)
@@ -372,7 +399,12 @@ func (m *ManagerImpl) ApplyAgentUpdate(update *Update) error {
 		log.WithError(err).Error("Error when updating terminated processes")
 	}
 	if update.UpdateInfo.Data != nil {
-		err = m.updateAgentDataInfoWrapper(update.AgentID, update.UpdateInfo.Data)
+		dataInfo, err := m.mergeAgentDataInfo(update.AgentID, update.UpdateInfo.Data)
+		if err != nil {
+			log.WithError(err).Errorf("Failed to get agent data info for agent %s", update.AgentID.String())
+			return err
+		}
+		err = m.updateAgentDataInfoWrapper(update.AgentID, dataInfo)
 		if err != nil {
 			return err
 		}
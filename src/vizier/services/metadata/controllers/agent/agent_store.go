@@ -316,6 +316,24 @@ func (a *Datastore) GetAgentsDataInfo() (map[uuid.UUID]*messagespb.AgentDataInfo
 	return dataInfos, nil
 }
 
+// GetAgentDataInfo returns the information about data tables that a particular agent has, or nil if
+// the agent hasn't reported any.
+func (a *Datastore) GetAgentDataInfo(agentID uuid.UUID) (*messagespb.AgentDataInfo, error) {
+	resp, err := a.ds.Get(getAgentDataInfoKey(agentID))
+	if err != nil {
+		return nil, err
+	}
+	if resp == nil {
+		return nil, nil
+	}
+	pb := &messagespb.AgentDataInfo{}
+	err = proto.Unmarshal(resp, pb)
+	if err != nil {
+		return nil, err
+	}
+	return pb, nil
+}
+
 // UpdateAgentDataInfo updates the information about data tables that a particular agent has.
 func (a *Datastore) UpdateAgentDataInfo(agentID uuid.UUID, dataInfo *messagespb.AgentDataInfo) error {
 	i, err := dataInfo.Marshal()
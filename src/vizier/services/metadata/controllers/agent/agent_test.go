@@ -423,6 +423,52 @@ func TestApplyUpdates(t *testing.T) {
 	assert.Equal(t, dataInfo, expectedDataInfo)
 }
 
+func TestApplyUpdatesMergesDataInfo(t *testing.T) {
+	ads, agtMgr, _, cleanup := setupManager(t)
+	defer cleanup()
+
+	u, err := uuid.FromString(testutils.ExistingAgentUUID)
+	if err != nil {
+		t.Fatal("Could not parse UUID from string.")
+	}
+
+	metadataInfo := &distributedpb.MetadataInfo{
+		MetadataFields: []metadatapb.MetadataType{
+			metadatapb.CONTAINER_ID,
+		},
+		Filter: &distributedpb.MetadataInfo_XXHash64BloomFilter{
+			XXHash64BloomFilter: &bloomfilterpb.XXHash64BloomFilter{
+				Data:      []byte("1234"),
+				NumHashes: 4,
+			},
+		},
+	}
+	applyDataInfo := func(dataInfo *messagespb.AgentDataInfo) *messagespb.AgentDataInfo {
+		err := agtMgr.ApplyAgentUpdate(&agent.Update{
+			UpdateInfo: &messagespb.AgentUpdateInfo{Data: dataInfo},
+			AgentID:    u,
+		})
+		require.NoError(t, err)
+		stored, err := ads.GetAgentDataInfo(u)
+		require.NoError(t, err)
+		return stored
+	}
+
+	stored := applyDataInfo(&messagespb.AgentDataInfo{MetadataInfo: metadataInfo})
+	assert.Equal(t, metadataInfo, stored.MetadataInfo)
+	assert.Empty(t, stored.TableNumRows)
+
+	// Agents only send the row counts when they change, without the unchanged metadata info.
+	stored = applyDataInfo(&messagespb.AgentDataInfo{TableNumRows: map[string]int64{"http_events": 1024}})
+	assert.Equal(t, metadataInfo, stored.MetadataInfo)
+	assert.Equal(t, map[string]int64{"http_events": 1024}, stored.TableNumRows)
+
+	// And the metadata info without the unchanged row counts.
+	stored = applyDataInfo(&messagespb.AgentDataInfo{MetadataInfo: &distributedpb.MetadataInfo{}})
+	assert.Equal(t, &distributedpb.MetadataInfo{}, stored.MetadataInfo)
+	assert.Equal(t, map[string]int64{"http_events": 1024}, stored.TableNumRows)
+}
+
 func TestApplyUpdatesDeleted(t *testing.T) {
 	ads, agtMgr, _, cleanup := setupManager(t)
 	defer cleanup()
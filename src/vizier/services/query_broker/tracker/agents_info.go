@@ -50,6 +50,9 @@ type AgentsInfoImpl struct {
 	dsMutex sync.Mutex
 
 	pendingDs *distributedpb.DistributedState
+	// The number of rows in each table of each agent, as last reported by the agent. Used to fill
+	// in the NumRows of the pending SchemaInfo.
+	pendingTableNumRows map[uuid.UUID]map[string]int64
 }
 
 // NewAgentsInfo creates an empty agents info.
@@ -60,6 +63,7 @@ func NewAgentsInfo() AgentsInfo {
 			SchemaInfo: []*distributedpb.SchemaInfo{},
 			CarnotInfo: []*distributedpb.CarnotInfo{},
 		},
+		pendingTableNumRows: make(map[uuid.UUID]map[string]int64),
 	}
 }
 
@@ -78,6 +82,7 @@ func (a *AgentsInfoImpl) ClearPendingState() {
 		SchemaInfo: []*distributedpb.SchemaInfo{},
 		CarnotInfo: []*distributedpb.CarnotInfo{},
 	}
+	a.pendingTableNumRows = make(map[uuid.UUID]map[string]int64)
 }
 
 // UpdateAgentsInfo creates a new agent info.
@@ -103,6 +108,7 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 	deletedAgents := 0
 	updatedAgents := 0
 	updatedAgentsDataInfo := 0
+	tableNumRowsUpdated := update.AgentSchemasUpdated
 
 	for _, agentUpdate := range update.AgentUpdates {
 		agentUUID, err := utils.UUIDFromProto(agentUpdate.AgentID)
@@ -146,11 +152,19 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 			if dataInfo.MetadataInfo != nil {
 				carnotInfo.MetadataInfo = dataInfo.MetadataInfo
 			}
+			if len(dataInfo.TableNumRows) > 0 {
+				a.pendingTableNumRows[agentUUID] = dataInfo.TableNumRows
+				tableNumRowsUpdated = true
+			}
 		}
 		// case 3: agent deleted
 		if agentUpdate.GetDeleted() {
 			deletedAgents++
 			delete(carnotInfoMap, agentUUID)
+			if _, present := a.pendingTableNumRows[agentUUID]; present {
+				delete(a.pendingTableNumRows, agentUUID)
+				tableNumRowsUpdated = true
+			}
 		}
 	}
 
@@ -164,6 +178,10 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 		a.pendingDs.CarnotInfo = append(a.pendingDs.CarnotInfo, carnotInfo)
 	}
 
+	if tableNumRowsUpdated {
+		a.pendingDs.SchemaInfo = a.withTableNumRows(a.pendingDs.SchemaInfo)
+	}
+
 	// If we have reached the end of version, promote the pending DistributedState to the current external-facing
 	// distributed state accessible by clients of `Agents`.
 	if update.EndOfVersion {
@@ -184,6 +202,26 @@ func (a *AgentsInfoImpl) DistributedState() distributedpb.DistributedState {
 	return a.ds
 }
 
+// withTableNumRows returns copies of the given schemas with NumRows set to the number of rows
+// that the agents in the schema's agent list hold. The schemas are copied rather than updated in
+// place because they may be shared with the current distributed state.
+func (a *AgentsInfoImpl) withTableNumRows(schemas []*distributedpb.SchemaInfo) []*distributedpb.SchemaInfo {
+	updated := make([]*distributedpb.SchemaInfo, len(schemas))
+	for i, schema := range schemas {
+		numRows := int64(0)
+		for _, agentID := range schema.AgentList {
+			numRows += a.pendingTableNumRows[utils.UUIDFromProtoOrNil(agentID)][schema.Name]
+		}
+		updated[i] = &distributedpb.SchemaInfo{
+			Name:      schema.Name,
+			Relation:  schema.Relation,
+			AgentList: schema.AgentList,
+			NumRows:   numRows,
+		}
+	}
+	return updated
+}
+
 func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distributedpb.MetadataInfo) *distributedpb.CarnotInfo {
 	return &distributedpb.CarnotInfo{
 		QueryBrokerAddress:   agentID.String(),
@@ -350,3 +350,81 @@ func TestAgentsInfo_UpdateAgentsInfo(t *testing.T) {
 	require.NoError(t, err)
 	assert.Equal(t, 0, len(agentsInfo.DistributedState().SchemaInfo))
 }
+
+func TestAgentsInfo_TableNumRows(t *testing.T) {
+	viper.Set("pod_namespace", "pl")
+	testSchema := makeTestSchema(t)
+	uuidpbs := makeTestAgentIDs(t)
+	agents := makeTestAgents(t)
+
+	agentsInfo := tracker.NewAgentsInfo()
+
+	// table1 is held by agents 1 and 3.
+	err := agentsInfo.UpdateAgentsInfo(&metadatapb.AgentUpdatesResponse{
+		AgentUpdates: []*metadatapb.AgentUpdate{
+			{
+				AgentID: uuidpbs[0],
+				Update:  &metadatapb.AgentUpdate_Agent{Agent: agents[0]},
+			},
+			{
+				AgentID: uuidpbs[0],
+				Update: &metadatapb.AgentUpdate_DataInfo{
+					DataInfo: &messagespb.AgentDataInfo{
+						TableNumRows: map[string]int64{"table1": 100, "table2": 7},
+					},
+				},
+			},
+			{
+				AgentID: uuidpbs[2],
+				Update:  &metadatapb.AgentUpdate_Agent{Agent: agents[2]},
+			},
+			{
+				AgentID: uuidpbs[2],
+				Update: &metadatapb.AgentUpdate_DataInfo{
+					DataInfo: &messagespb.AgentDataInfo{
+						TableNumRows: map[string]int64{"table1": 20},
+					},
+				},
+			},
+		},
+		AgentSchemas:        testSchema,
+		AgentSchemasUpdated: true,
+		EndOfVersion:        true,
+	})
+	require.NoError(t, err)
+	schemaInfo := agentsInfo.DistributedState().SchemaInfo
+	require.Equal(t, 1, len(schemaInfo))
+	assert.Equal(t, int64(120), schemaInfo[0].NumRows)
+	// The schemas from the update should not have been modified.
+	assert.Equal(t, int64(0), testSchema[0].NumRows)
+
+	// A data info update without row counts keeps the previous counts.
+	err = agentsInfo.UpdateAgentsInfo(&metadatapb.AgentUpdatesResponse{
+		AgentUpdates: []*metadatapb.AgentUpdate{
+			{
+				AgentID: uuidpbs[0],
+				Update: &metadatapb.AgentUpdate_DataInfo{
+					DataInfo: &messagespb.AgentDataInfo{
+						MetadataInfo: &distributedpb.MetadataInfo{},
+					},
+				},
+			},
+		},
+		EndOfVersion: true,
+	})
+	require.NoError(t, err)
+	assert.Equal(t, int64(120), agentsInfo.DistributedState().SchemaInfo[0].NumRows)
+
+	// Deleting an agent removes its rows.
+	err = agentsInfo.UpdateAgentsInfo(&metadatapb.AgentUpdatesResponse{
+		AgentUpdates: []*metadatapb.AgentUpdate{
+			{
+				AgentID: uuidpbs[2],
+				Update:  &metadatapb.AgentUpdate_Deleted{Deleted: true},
+			},
+		},
+		EndOfVersion: true,
+	})
+	require.NoError(t, err)
+	assert.Equal(t, int64(100), agentsInfo.DistributedState().SchemaInfo[0].NumRows)
+}